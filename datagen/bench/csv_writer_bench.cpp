@@ -0,0 +1,162 @@
+/*
+ * The implementation of the GTPC graph data generator was built on
+ * Florian Wolf's implementation of the CH-benCHmark data generator
+ * (https://db.in.tum.de/research/projects/CHbenCHmark/) and
+ * Alexander van Renen's implementation of the TPC-C data generator
+ * (https://github.com/alexandervanrenen/tpcc-generator)
+ * See the README file.
+ */
+
+// Micro-benchmark for csv::CsvWriter: formats stock- and order-line-like rows once with the iostream based writer the
+// generator used before and once with csv::CsvWriter, and reports MB/s for both.
+//
+// usage: csv_writer_bench [directory] [rows]
+// The files are written to directory (default /dev/shm); they are compared and removed afterwards.
+
+#include "csv_writer.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <random>
+#include <vector>
+
+namespace {
+
+// The previous std::ofstream based writer, kept here as the baseline.
+class StreamWriter {
+   std::ofstream out;
+   bool firstWordInLine = true;
+
+   void prePrint() {
+      if (firstWordInLine) {
+         firstWordInLine = false;
+      } else {
+         out << '|';
+      }
+   }
+
+public:
+   explicit StreamWriter(const std::string &path) : out(path) {}
+
+   StreamWriter &operator<<(int64_t num) {
+      prePrint();
+      out << num;
+      return *this;
+   }
+   StreamWriter &operator<<(float num) {
+      prePrint();
+      out << std::fixed << num;
+      return *this;
+   }
+   template<unsigned long len>
+   StreamWriter &operator<<(const std::array<char, len> &data) {
+      prePrint();
+      out.write(data.data(), strnlen(data.data(), len));
+      return *this;
+   }
+   StreamWriter &operator<<(csv::Precision precision) {
+      out << std::setprecision(precision.p);
+      return *this;
+   }
+   StreamWriter &operator<<(csv::EndlStruct) {
+      out << "\n";
+      firstWordInLine = true;
+      return *this;
+   }
+};
+
+struct Row {
+   int64_t id;
+   int64_t quantity;
+   std::array<std::array<char, 24>, 10> dist;
+   std::array<char, 50> data;
+   float amount;
+};
+
+std::vector<Row> makeRows(size_t count) {
+   const char *alphabet = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
+   std::mt19937 ranny(42);
+   std::vector<Row> rows(count);
+   for (size_t i = 0; i<count; i++) {
+      Row &row = rows[i];
+      row.id = i + 1;
+      row.quantity = 10 + ranny() % 91;
+      for (auto &dist : row.dist) {
+         for (char &c : dist) {
+            c = alphabet[ranny() % 62];
+         }
+      }
+      uint32_t len = 26 + ranny() % 25;
+      for (uint32_t j = 0; j<len; j++) {
+         row.data[j] = alphabet[ranny() % 62];
+      }
+      if (len<row.data.size()) {
+         row.data[len] = '\0';
+      }
+      row.amount = float(10 + ranny() % 9991) / 100.0f;
+   }
+   return rows;
+}
+
+template<typename Writer>
+double run(const std::vector<Row> &rows, const std::string &path) {
+   auto start = std::chrono::steady_clock::now();
+   {
+      Writer out(path);
+      for (const Row &row : rows) {
+         // @formatter:off
+         out << row.id << row.quantity << row.dist[0] << row.dist[1] << row.dist[2] << row.dist[3] << row.dist[4]
+             << row.dist[5] << row.dist[6] << row.dist[7] << row.dist[8] << row.dist[9] << int64_t(0) << int64_t(0)
+             << int64_t(0) << row.data << csv::Precision(2) << row.amount << csv::endl;
+         // @formatter:on
+      }
+   }
+   auto end = std::chrono::steady_clock::now();
+   return std::chrono::duration<double>(end - start).count();
+}
+
+size_t fileSize(const std::string &path) {
+   std::ifstream in(path, std::ios::binary | std::ios::ate);
+   return in.good() ? size_t(in.tellg()) : 0;
+}
+
+bool sameContent(const std::string &a, const std::string &b) {
+   std::ifstream in_a(a, std::ios::binary), in_b(b, std::ios::binary);
+   return std::equal(std::istreambuf_iterator<char>(in_a), std::istreambuf_iterator<char>(),
+                     std::istreambuf_iterator<char>(in_b), std::istreambuf_iterator<char>());
+}
+
+}
+
+int main(int argc, char **argv) {
+   std::string directory = argc>1 ? argv[1] : "/dev/shm";
+   size_t row_count = argc>2 ? std::stoull(argv[2]) : 1000000;
+
+   std::vector<Row> rows = makeRows(row_count);
+   std::string stream_path = directory + "/csv_writer_bench_stream.csv";
+   std::string buffered_path = directory + "/csv_writer_bench_buffered.csv";
+
+   double stream_time = run<StreamWriter>(rows, stream_path);
+   double buffered_time = run<csv::CsvWriter>(rows, buffered_path);
+   double megabytes = fileSize(buffered_path) / (1024.0 * 1024.0);
+
+   std::printf("rows: %zu, output: %.1f MB\n", row_count, megabytes);
+   std::printf("std::ofstream writer:  %8.3f s %10.1f MB/s\n", stream_time, megabytes / stream_time);
+   std::printf("csv::CsvWriter:        %8.3f s %10.1f MB/s (%.2fx)\n", buffered_time, megabytes / buffered_time,
+               stream_time / buffered_time);
+
+   bool identical = sameContent(stream_path, buffered_path);
+   std::remove(stream_path.c_str());
+   std::remove(buffered_path.c_str());
+   if (!identical) {
+      std::printf("ERROR: outputs differ\n");
+      return 1;
+   }
+   return 0;
+}
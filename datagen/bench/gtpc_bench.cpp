@@ -0,0 +1,418 @@
+/*
+ * The implementation of the GTPC graph data generator was built on
+ * Florian Wolf's implementation of the CH-benCHmark data generator
+ * (https://db.in.tum.de/research/projects/CHbenCHmark/) and
+ * Alexander van Renen's implementation of the TPC-C data generator
+ * (https://github.com/alexandervanrenen/tpcc-generator)
+ * See the README file.
+ */
+
+// Benchmark suite of the generator, to catch throughput regressions.
+//
+// Micro-benchmarks time the building blocks of every row: random strings, numbers and dates, the customer
+// permutation, the CsvWriter formatting of integers, floats and strings and the TPC-H text of DataSource. End-to-end
+// benchmarks run every generate* step at fixed warehouse counts, once writing to a tmpfs directory and once to
+// /dev/null (every output file is a symlink to it), and take rows and bytes from the stats::Recorder.
+//
+// Every result is the best of --repeat runs and is reported as rows/s (operations/s for the micro-benchmarks) and
+// MB/s. --save stores the results as a baseline, --compare reports the change against a baseline and fails if a
+// result lost more than --tolerance of its rows/s.
+//
+// usage: gtpc_bench [--micro] [--e2e] [--filter substring] [--warehouses 1,4] [--threads n] [--repeat n]
+//                   [--tmpfs directory] [--save file] [--compare file] [--tolerance fraction]
+
+#include "csv_writer.hpp"
+#include "data_source.hpp"
+#include "generator.hpp"
+#include "instrumentation.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+namespace {
+
+struct Result {
+   std::string name;
+   uint64_t rows;
+   uint64_t bytes;
+   double seconds;
+
+   double rowsPerSecond() const { return seconds>0 ? rows / seconds : 0; }
+   double megabytesPerSecond() const { return seconds>0 ? bytes / (1024.0 * 1024.0) / seconds : 0; }
+};
+
+struct Options {
+   bool micro = true;
+   bool e2e = true;
+   std::string filter;
+   std::vector<int64_t> warehouses = {1, 4};
+   uint32_t threads = 1;
+   uint32_t repeat = 3;
+   std::string tmpfs = "/dev/shm";
+   std::string save;
+   std::string compare;
+   double tolerance = 0.1;
+};
+
+// Keeps values the compiler could otherwise drop.
+volatile uint64_t sink;
+
+void usage() {
+   std::cerr << "usage: gtpc_bench [--micro] [--e2e] [--filter substring] [--warehouses 1,4] [--threads n] "
+                "[--repeat n] [--tmpfs directory] [--save file] [--compare file] [--tolerance fraction]" << std::endl;
+   exit(1);
+}
+
+Options parseOptions(int argc, char **argv) {
+   Options options;
+   bool micro = false;
+   bool e2e = false;
+   for (int i = 1; i<argc; i++) {
+      std::string arg = argv[i];
+      auto value = [&]() -> std::string {
+         if (i + 1>=argc) {
+            usage();
+         }
+         return argv[++i];
+      };
+      if (arg == "--micro") {
+         micro = true;
+      } else if (arg == "--e2e") {
+         e2e = true;
+      } else if (arg == "--filter") {
+         options.filter = value();
+      } else if (arg == "--warehouses") {
+         options.warehouses.clear();
+         std::istringstream list(value());
+         std::string count;
+         while (std::getline(list, count, ',')) {
+            options.warehouses.push_back(std::stoll(count));
+         }
+      } else if (arg == "--threads") {
+         options.threads = std::stoul(value());
+      } else if (arg == "--repeat") {
+         options.repeat = std::max(1ul, std::stoul(value()));
+      } else if (arg == "--tmpfs") {
+         options.tmpfs = value();
+      } else if (arg == "--save") {
+         options.save = value();
+      } else if (arg == "--compare") {
+         options.compare = value();
+      } else if (arg == "--tolerance") {
+         options.tolerance = std::stod(value());
+      } else {
+         usage();
+      }
+   }
+   // Without a selection both kinds run.
+   if (micro || e2e) {
+      options.micro = micro;
+      options.e2e = e2e;
+   }
+   return options;
+}
+
+// Best of repeat runs of function, which returns rows and bytes of one run.
+Result measure(const std::string &name, uint32_t repeat, const std::function<std::pair<uint64_t, uint64_t>()> &function) {
+   Result best = {name, 0, 0, 0};
+   for (uint32_t r = 0; r<repeat; r++) {
+      auto start = std::chrono::steady_clock::now();
+      auto [rows, bytes] = function();
+      double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+      if (r == 0 || seconds<best.seconds) {
+         best = {name, rows, bytes, seconds};
+      }
+   }
+   return best;
+}
+
+void print(const Result &result, const std::map<std::string, double> &baseline) {
+   std::printf("%-40s %14.0f rows/s %10.1f MB/s", result.name.c_str(), result.rowsPerSecond(),
+               result.megabytesPerSecond());
+   auto entry = baseline.find(result.name);
+   if (entry != baseline.end() && entry->second>0) {
+      std::printf(" %+7.1f%%", (result.rowsPerSecond() / entry->second - 1) * 100);
+   }
+   std::printf("\n");
+   std::fflush(stdout);
+}
+
+// Baseline files hold one "name rows/s MB/s" line per result.
+std::map<std::string, double> loadBaseline(const std::string &path) {
+   std::map<std::string, double> baseline;
+   std::ifstream in(path);
+   if (!in) {
+      std::cerr << "Cannot read baseline '" << path << "'." << std::endl;
+      exit(1);
+   }
+   std::string name;
+   double rows_per_second;
+   double megabytes_per_second;
+   while (in >> name >> rows_per_second >> megabytes_per_second) {
+      baseline[name] = rows_per_second;
+   }
+   return baseline;
+}
+
+void saveBaseline(const std::string &path, const std::vector<Result> &results) {
+   std::ofstream out(path);
+   for (const Result &result : results) {
+      out << result.name << " " << std::fixed << result.rowsPerSecond() << " " << result.megabytesPerSecond() << "\n";
+   }
+   if (!out) {
+      std::cerr << "Cannot write baseline '" << path << "'." << std::endl;
+      exit(1);
+   }
+}
+
+}
+
+// Friend of GtpcGenerator and DataSource, so the make* functions can be timed on their own.
+class GeneratorBench {
+   const Options &options;
+   const std::map<std::string, double> &baseline;
+   std::vector<Result> &results;
+
+   bool selected(const std::string &name) const {
+      return name.find(options.filter) != std::string::npos;
+   }
+
+   void run(const std::string &name, const std::function<std::pair<uint64_t, uint64_t>()> &function) {
+      if (!selected(name)) {
+         return;
+      }
+      results.push_back(measure(name, options.repeat, function));
+      print(results.back(), baseline);
+   }
+
+   // Runs one generate* step with the output of the Phase messages suppressed; rows and bytes are those of the phase.
+   static std::pair<uint64_t, uint64_t> generate(GtpcGenerator &generator, void (GtpcGenerator::*step)()) {
+      std::cout.setstate(std::ios::failbit);
+      (generator.*step)();
+      std::cout.clear();
+      const stats::PhaseStats &phase = stats::Recorder::instance().getPhases().back();
+      uint64_t rows = 0;
+      uint64_t bytes = 0;
+      for (const stats::TableStats &table : phase.tables) {
+         rows += table.rows;
+         bytes += table.bytes;
+      }
+      return {rows, bytes};
+   }
+
+public:
+   GeneratorBench(const Options &options, const std::map<std::string, double> &baseline, std::vector<Result> &results)
+           : options(options), baseline(baseline), results(results) {
+   }
+
+   void micro(const std::string &directory) {
+      GtpcGenerator generator(1, directory, 1);
+      GtpcGenerator::RandomEngine ranny(42, 0, 1, 1);
+
+      const uint64_t strings = 2000000;
+      run("micro/makeAlphaString", [&] {
+         std::array<char, 24> name;
+         uint64_t bytes = 0;
+         for (uint64_t i = 0; i<strings; i++) {
+            bytes += generator.makeAlphaString(ranny, 14, 24, name.data());
+         }
+         sink = name[0];
+         return std::make_pair(strings, bytes);
+      });
+      run("micro/makeAlphaString/legacy", [&] {
+         generator.setLegacyStrings(true);
+         std::array<char, 24> name;
+         uint64_t bytes = 0;
+         for (uint64_t i = 0; i<strings; i++) {
+            bytes += generator.makeAlphaString(ranny, 14, 24, name.data());
+         }
+         generator.setLegacyStrings(false);
+         sink = name[0];
+         return std::make_pair(strings, bytes);
+      });
+      run("micro/makeAlphaStrings/s_dist", [&] {
+         std::array<std::array<char, 24>, 10> dist;
+         for (uint64_t i = 0; i<strings / 10; i++) {
+            generator.makeAlphaStrings(ranny, 24, 24, {dist[0].data(), dist[1].data(), dist[2].data(), dist[3].data(),
+                                                       dist[4].data(), dist[5].data(), dist[6].data(), dist[7].data(),
+                                                       dist[8].data(), dist[9].data()});
+         }
+         sink = dist[9][0];
+         return std::make_pair(strings, strings * 24);
+      });
+
+      const uint64_t numbers = 20000000;
+      run("micro/makeNumber", [&] {
+         uint64_t sum = 0;
+         for (uint64_t i = 0; i<numbers; i++) {
+            sum += generator.makeNumber(ranny, GtpcGenerator::kItemIds);
+         }
+         sink = sum;
+         return std::make_pair(numbers, uint64_t(0));
+      });
+      run("micro/makeNumber/legacy", [&] {
+         GtpcGenerator::RandomEngine legacy(42, 0, 1, 1, rng::UniformMethod::Modulo);
+         uint64_t sum = 0;
+         for (uint64_t i = 0; i<numbers; i++) {
+            sum += generator.makeNumber(legacy, GtpcGenerator::kItemIds);
+         }
+         sink = sum;
+         return std::make_pair(numbers, uint64_t(0));
+      });
+
+      const uint64_t dates = 10000000;
+      run("micro/makeDate", [&] {
+         int64_t sum = 0;
+         for (uint64_t i = 0; i<dates; i++) {
+            sum += generator.makeDate(ranny, GtpcGenerator::kEntryYears).millis;
+         }
+         sink = sum;
+         return std::make_pair(dates, uint64_t(0));
+      });
+
+      // The customer permutation of the order generation at 1000 warehouses.
+      const uint64_t lookups = 10000000;
+      run("micro/permutation", [&] {
+         rng::Permutation permutation(42, static_cast<uint32_t>(GtpcGenerator::Stream::CustomerPermutation),
+                                      1000ull * GtpcGenerator::kDistrictsPerWarehouse *
+                                      GtpcGenerator::kCustomerPerDistrict);
+         uint64_t sum = 0;
+         for (uint64_t i = 0; i<lookups; i++) {
+            sum += permutation(i);
+         }
+         sink = sum;
+         return std::make_pair(lookups, uint64_t(0));
+      });
+
+      // Rows of eight fields, formatted into blocks that are written to /dev/null.
+      const uint64_t rows = 2000000;
+      run("micro/csv/int64", [&] {
+         csv::CsvWriter writer("/dev/null");
+         for (uint64_t i = 0; i<rows; i++) {
+            int64_t value = i * 7919;
+            writer << value << value + 1 << value + 2 << value + 3 << value + 4 << value + 5 << value + 6
+                   << value + 7 << csv::endl;
+         }
+         return std::make_pair(rows, writer.getBytesWritten());
+      });
+      run("micro/csv/float", [&] {
+         csv::CsvWriter writer("/dev/null");
+         writer << csv::Precision(2);
+         for (uint64_t i = 0; i<rows; i++) {
+            float value = (i % 1000000) / 100.0f;
+            writer << value << value + 1 << value + 2 << value + 3 << value + 4 << value + 5 << value + 6
+                   << value + 7 << csv::endl;
+         }
+         return std::make_pair(rows, writer.getBytesWritten());
+      });
+      run("micro/csv/string", [&] {
+         std::array<char, 24> field;
+         std::fill(field.begin(), field.end(), 'x');
+         std::array<char, 24> shorter = field;
+         shorter[14] = '\0';
+         csv::CsvWriter writer("/dev/null");
+         for (uint64_t i = 0; i<rows; i++) {
+            writer << field << shorter << field << shorter << field << shorter << field << shorter << csv::endl;
+         }
+         return std::make_pair(rows, writer.getBytesWritten());
+      });
+
+      const uint64_t texts = 100000;
+      run("micro/tpchText", [&] {
+         DataSource::initialize(42, 0, 0, 0);
+         uint64_t bytes = 0;
+         for (uint64_t i = 0; i<texts; i++) {
+            bytes += DataSource::tpchText(300).size();
+         }
+         return std::make_pair(texts, bytes);
+      });
+   }
+
+   void endToEnd(const std::string &directory, const std::string &null_directory) {
+      static const std::pair<const char *, void (GtpcGenerator::*)()> kSteps[] = {
+         {"warehouse", &GtpcGenerator::generateWarehouses},
+         {"district",  &GtpcGenerator::generateDistricts},
+         {"customer",  &GtpcGenerator::generateCustomerAndHistory},
+         {"item",      &GtpcGenerator::generateItems},
+         {"supplier",  &GtpcGenerator::generateSuppliers},
+         {"stock",     &GtpcGenerator::generateStock},
+         {"order",     &GtpcGenerator::generateOrdersAndOrderLines},
+         {"region",    &GtpcGenerator::generateRegions},
+         {"nation",    &GtpcGenerator::generateNations},
+      };
+
+      for (int64_t warehouses : options.warehouses) {
+         // tmpfs first: its files tell which names have to be linked to /dev/null.
+         for (bool null_output : {false, true}) {
+            std::string folder = null_output ? null_directory : directory;
+            GtpcGenerator generator(warehouses, folder, options.threads);
+            generator.setOutputFormat(csv::Format::Csv, 0);
+            for (auto &[step, function] : kSteps) {
+               std::string name = std::string("e2e/") + step + "/w" + std::to_string(warehouses) +
+                                  (null_output ? "/null" : "/tmpfs");
+               run(name, [&] { return generate(generator, function); });
+            }
+            if (!null_output) {
+               for (auto &entry : std::filesystem::directory_iterator(directory)) {
+                  std::filesystem::path link = std::filesystem::path(null_directory) / entry.path().filename();
+                  if (!std::filesystem::is_symlink(link)) {
+                     std::filesystem::create_symlink("/dev/null", link);
+                  }
+                  std::filesystem::remove(entry.path());
+               }
+            }
+         }
+      }
+   }
+};
+
+int main(int argc, char **argv) {
+   Options options = parseOptions(argc, argv);
+   std::map<std::string, double> baseline;
+   if (!options.compare.empty()) {
+      baseline = loadBaseline(options.compare);
+   }
+
+   std::string directory = options.tmpfs + "/gtpc_bench_" + std::to_string(getpid());
+   std::string null_directory = directory + "_null";
+   std::filesystem::create_directories(directory);
+   std::filesystem::create_directories(null_directory);
+
+   std::vector<Result> results;
+   GeneratorBench bench(options, baseline, results);
+   if (options.micro) {
+      bench.micro(directory);
+   }
+   if (options.e2e) {
+      bench.endToEnd(directory, null_directory);
+   }
+   std::filesystem::remove_all(directory);
+   std::filesystem::remove_all(null_directory);
+
+   if (!options.save.empty()) {
+      saveBaseline(options.save, results);
+   }
+
+   int regressions = 0;
+   for (const Result &result : results) {
+      auto entry = baseline.find(result.name);
+      if (entry != baseline.end() && result.rowsPerSecond()<entry->second * (1 - options.tolerance)) {
+         std::printf("REGRESSION: %s %.0f rows/s, baseline %.0f rows/s\n", result.name.c_str(), result.rowsPerSecond(),
+                     entry->second);
+         regressions++;
+      }
+   }
+   return regressions>0 ? 1 : 0;
+}
@@ -0,0 +1,140 @@
+/*
+ * The implementation of the GTPC graph data generator was built on
+ * Florian Wolf's implementation of the CH-benCHmark data generator
+ * (https://db.in.tum.de/research/projects/CHbenCHmark/) and
+ * Alexander van Renen's implementation of the TPC-C data generator
+ * (https://github.com/alexandervanrenen/tpcc-generator)
+ * See the README file.
+ */
+
+// Micro-benchmark for the random string kernels: fills the ten 24 character s_dist fields and the 26-50 character
+// s_data field of stock rows once with the per-character loop of the original generator and once per string kernel,
+// and reports MB/s of generated text. The map-only lines exclude drawing the random values. All kernels have to
+// produce the same bytes.
+//
+// usage: string_kernel_bench [rows]
+
+#include "string_kernel.hpp"
+
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Row {
+   std::array<std::array<char, 24>, 10> dist;
+   std::array<char, 50> data;
+};
+
+// The loop of GtpcGenerator::makeAlphaString with --legacy-strings.
+uint32_t legacyAlphaString(rng::Random &ranny, uint32_t min, uint32_t max, char *dest) {
+   const static char *possible_values = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
+
+   uint32_t len = ranny.uniform(min, max);
+   for (uint32_t i = 0; i<len; i++) {
+      dest[i] = possible_values[ranny() % 62];
+   }
+   if (len<max) {
+      dest[len] = '\0';
+   }
+   return len;
+}
+
+// Returns the number of generated characters.
+size_t runLegacy(std::vector<Row> &rows) {
+   size_t bytes = 0;
+   for (size_t r = 0; r<rows.size(); r++) {
+      rng::Random ranny(42, 0, 1, r);
+      for (auto &dist : rows[r].dist) {
+         bytes += legacyAlphaString(ranny, 24, 24, dist.data());
+      }
+      bytes += legacyAlphaString(ranny, 26, 50, rows[r].data.data());
+   }
+   return bytes;
+}
+
+size_t runKernel(std::vector<Row> &rows) {
+   size_t bytes = 0;
+   std::array<rng::StringField, 11> fields;
+   for (size_t r = 0; r<rows.size(); r++) {
+      rng::Random ranny(42, 0, 1, r);
+      Row &row = rows[r];
+      for (size_t i = 0; i<row.dist.size(); i++) {
+         fields[i] = {row.dist[i].data(), ranny.uniform(24, 24)};
+      }
+      fields[10] = {row.data.data(), ranny.uniform(26, 50)};
+      rng::fillAlphaNumeric(ranny, fields);
+      for (const rng::StringField &field : fields) {
+         bytes += field.length;
+      }
+      if (fields[10].length<row.data.size()) {
+         row.data[fields[10].length] = '\0';
+      }
+   }
+   return bytes;
+}
+
+template<typename Function>
+double measure(Function function) {
+   auto start = std::chrono::steady_clock::now();
+   function();
+   auto end = std::chrono::steady_clock::now();
+   return std::chrono::duration<double>(end - start).count();
+}
+
+void report(const char *name, double seconds, size_t bytes, double baseline) {
+   double megabytes = bytes / (1024.0 * 1024.0);
+   std::printf("%-22s %8.3f s %10.1f MB/s (%.2fx)\n", name, seconds, megabytes / seconds, baseline / seconds);
+}
+
+bool sameRows(const std::vector<Row> &a, const std::vector<Row> &b) {
+   return std::equal(a.begin(), a.end(), b.begin(), [](const Row &x, const Row &y) {
+      return x.dist == y.dist && x.data == y.data;
+   });
+}
+
+}
+
+int main(int argc, char **argv) {
+   size_t row_count = argc>1 ? std::stoull(argv[1]) : 1000000;
+
+   std::vector<Row> legacy_rows(row_count);
+   size_t bytes = 0;
+   double legacy_time = measure([&] { bytes = runLegacy(legacy_rows); });
+   std::printf("rows: %zu, text: %.1f MB\n", row_count, bytes / (1024.0 * 1024.0));
+   report("per-character loop:", legacy_time, bytes, legacy_time);
+
+   std::vector<uint16_t> values(bytes);
+   rng::Random ranny(42, 0, 0, 0);
+   ranny.fill(values.data(), values.size() / 2);
+   std::vector<char> text(values.size());
+
+   bool identical = true;
+   std::vector<Row> reference;
+   for (rng::StringKernel kernel : {rng::StringKernel::Scalar, rng::StringKernel::Avx2, rng::StringKernel::Avx512}) {
+      std::string name = rng::kernelName(kernel);
+      if (!rng::isSupported(kernel)) {
+         std::printf("%-22s not supported by this CPU\n", (name + ":").c_str());
+         continue;
+      }
+      rng::setStringKernel(kernel);
+
+      std::vector<Row> rows(row_count);
+      size_t kernel_bytes = 0;
+      double time = measure([&] { kernel_bytes = runKernel(rows); });
+      report((name + " kernel:").c_str(), time, kernel_bytes, legacy_time);
+      double map_time = measure([&] { rng::mapAlphaNumeric(values.data(), values.size(), text.data()); });
+      report((name + " map only:").c_str(), map_time, values.size(), legacy_time * values.size() / bytes);
+
+      if (reference.empty()) {
+         reference = std::move(rows);
+      } else if (!sameRows(reference, rows)) {
+         std::printf("ERROR: %s output differs from the scalar kernel\n", name.c_str());
+         identical = false;
+      }
+   }
+   return identical ? 0 : 1;
+}
@@ -0,0 +1,63 @@
+/*
+ * The implementation of the GTPC graph data generator was built on
+ * Florian Wolf's implementation of the CH-benCHmark data generator
+ * (https://db.in.tum.de/research/projects/CHbenCHmark/) and
+ * Alexander van Renen's implementation of the TPC-C data generator
+ * (https://github.com/alexandervanrenen/tpcc-generator)
+ * See the README file.
+ */
+
+#ifndef binary_format_hpp_
+#define binary_format_hpp_
+
+#include <bit>
+#include <cstdint>
+
+// Layout of the files written with --format binary. Everything is little-endian and meant to be mmap'ed.
+//
+// Every file starts with a 64 byte FileHeader followed by a dense array of fixed-width elements; the element count
+// follows from the file size. Per table and part the generator writes:
+//
+//   Node tables, one file per column:     <table>_<part>.<column>.col
+//      Int64     -> int64_t per row
+//      Float32   -> float per row
+//      Timestamp -> int64_t milliseconds since 1970-01-01T00:00:00Z per row
+//      Char      -> header.width bytes per row, padded with NULs if the value is shorter
+//
+//   Relationship tables, a CSR (grouped by start node) or CSC (grouped by end node) pair:
+//      <table>_<part>.offsets   uint64_t, one entry per key in [first_key, first_key + count - 1) plus a final one;
+//                               the neighbours of key k are targets[offsets[k - first_key], offsets[k - first_key + 1])
+//      <table>_<part>.targets   int64_t ids of the neighbours
+//
+// Ids are the same as in the CSV output, so the files of all parts of a sharded run cover consecutive key ranges.
+namespace binary {
+
+static_assert(std::endian::native == std::endian::little, "The binary format is written in native byte order.");
+
+constexpr char kMagic[8] = {'G', 'T', 'P', 'C', 'B', 'I', 'N', '\0'};
+constexpr uint32_t kVersion = 1;
+
+enum class Kind : uint32_t {
+   Column, Offsets, Targets
+};
+
+enum class Type : uint32_t {
+   Int64, Float32, Char, Timestamp
+};
+
+struct FileHeader {
+   char magic[8];
+   uint32_t version;
+   Kind kind;
+   Type type;
+   uint32_t width;     // bytes per element
+   int64_t first_key;  // Offsets only: id of the first key
+   uint32_t by_end;    // Offsets and Targets only: 1 if grouped by the end node (CSC), 0 for CSR
+   uint8_t reserved[28];
+};
+
+static_assert(sizeof(FileHeader) == 64, "The data has to stay 64 byte aligned.");
+
+}
+
+#endif
@@ -0,0 +1,229 @@
+/*
+ * The implementation of the GTPC graph data generator was built on
+ * Florian Wolf's implementation of the CH-benCHmark data generator
+ * (https://db.in.tum.de/research/projects/CHbenCHmark/) and
+ * Alexander van Renen's implementation of the TPC-C data generator
+ * (https://github.com/alexandervanrenen/tpcc-generator)
+ * See the README file.
+ */
+
+#include "binary_reader.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace binary {
+
+MappedFile::~MappedFile() {
+   if (base) {
+      munmap(const_cast<char *>(base), length);
+   }
+}
+
+bool MappedFile::map(const std::string &path) {
+   int fd = ::open(path.c_str(), O_RDONLY);
+   if (fd<0) {
+      message = "Cannot open file: '" + path + "'.";
+      return false;
+   }
+   struct stat st;
+   if (fstat(fd, &st)<0 || static_cast<size_t>(st.st_size)<sizeof(FileHeader)) {
+      close(fd);
+      message = "File is too short: '" + path + "'.";
+      return false;
+   }
+   void *mapping = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+   close(fd);
+   if (mapping == MAP_FAILED) {
+      message = "Cannot map file: '" + path + "'.";
+      return false;
+   }
+   base = static_cast<const char *>(mapping);
+   length = st.st_size;
+   return true;
+}
+
+bool MappedFile::open(const std::string &path, Kind kind) {
+   if (!map(path)) {
+      return false;
+   }
+   const FileHeader &h = header();
+   if (memcmp(h.magic, kMagic, sizeof(kMagic)) != 0 || h.version != kVersion || h.width == 0) {
+      message = "Not a GTPC binary file of version " + std::to_string(kVersion) + ": '" + path + "'.";
+      return false;
+   }
+   if (h.kind != kind) {
+      message = "Unexpected file kind: '" + path + "'.";
+      return false;
+   }
+   return true;
+}
+
+bool Adjacency::open(const std::string &path) {
+   if (!offsets.open(path + ".offsets", Kind::Offsets)) {
+      message = offsets.error();
+      return false;
+   }
+   if (!targets.open(path + ".targets", Kind::Targets)) {
+      message = targets.error();
+      return false;
+   }
+   if (offsets.count() == 0) {
+      message = "Offsets lack the closing entry: '" + path + ".offsets'.";
+      return false;
+   }
+   return true;
+}
+
+bool ColumnarFile::open(const std::string &path) {
+   if (!file.map(path)) {
+      message = file.error();
+      return false;
+   }
+   auto header = reinterpret_cast<const ColumnarHeader *>(file.begin());
+   const char *tail = file.begin() + file.size() - sizeof(kColumnarMagic);
+   if (file.size()<sizeof(ColumnarHeader) + 2 * sizeof(uint64_t) ||
+       memcmp(header->magic, kColumnarMagic, sizeof(kColumnarMagic)) != 0 || header->version != kColumnarVersion ||
+       memcmp(tail, kColumnarMagic, sizeof(kColumnarMagic)) != 0) {
+      message = "Not a complete GTPC columnar file of version " + std::to_string(kColumnarVersion) + ": '" + path + "'.";
+      return false;
+   }
+   // The footer, the row group offsets and their count, has to fit between the schema and the closing magic.
+   uint64_t schema_end = sizeof(ColumnarHeader) + uint64_t(header->column_count) * sizeof(ColumnSchema);
+   uint64_t footer_end = file.size() - sizeof(kColumnarMagic);
+   if (schema_end + sizeof(uint64_t)>footer_end) {
+      message = "Corrupt schema of GTPC columnar file: '" + path + "'.";
+      return false;
+   }
+   column_count = header->column_count;
+   schema = reinterpret_cast<const ColumnSchema *>(file.begin() + sizeof(ColumnarHeader));
+   for (uint32_t c = 0; c<column_count; c++) {
+      uint32_t width = schema[c].type == LogicalType::Char ? schema[c].width : sizeof(int64_t);
+      if (schema[c].type>LogicalType::Char || schema[c].width == 0 || schema[c].width != width) {
+         message = "Corrupt schema of GTPC columnar file: '" + path + "'.";
+         return false;
+      }
+   }
+   row_group_count = *reinterpret_cast<const uint64_t *>(tail - sizeof(uint64_t));
+   if (row_group_count>(footer_end - schema_end) / sizeof(uint64_t) - 1) {
+      message = "Corrupt row group count of GTPC columnar file: '" + path + "'.";
+      return false;
+   }
+   uint64_t footer_begin = footer_end - sizeof(uint64_t) * (row_group_count + 1);
+   row_groups = reinterpret_cast<const uint64_t *>(file.begin() + footer_begin);
+   // Row groups follow each other, each one ends where the next one starts. Every chunk, with its payload, has to end
+   // within its row group, so that chunk() and the read functions stay within the mapping.
+   for (uint64_t g = 0; g<row_group_count; g++) {
+      uint64_t end = g + 1<row_group_count ? row_groups[g + 1] : footer_begin;
+      if (row_groups[g]<schema_end || row_groups[g] % 8 != 0 || row_groups[g]>=end || end>footer_begin ||
+          !checkRowGroup(g, end)) {
+         message = "Corrupt row group " + std::to_string(g) + " of GTPC columnar file: '" + path + "'.";
+         return false;
+      }
+   }
+   return true;
+}
+
+bool ColumnarFile::checkRowGroup(size_t group, uint64_t end) const {
+   uint64_t pos = row_groups[group];
+   if (end - pos<sizeof(uint64_t)) {
+      return false;
+   }
+   uint64_t row_count = rows(group);
+   pos += sizeof(uint64_t);
+   for (uint32_t c = 0; c<column_count; c++) {
+      if (end - pos<sizeof(ChunkHeader)) {
+         return false;
+      }
+      auto header = reinterpret_cast<const ChunkHeader *>(file.begin() + pos);
+      pos += sizeof(ChunkHeader);
+      uint64_t space = end - pos;
+      uint64_t width = schema[c].width;
+      if (header->bytes>space || (header->bytes + 7) / 8 * 8>space) {
+         return false;
+      }
+      if (header->encoding == Encoding::Plain) {
+         if (row_count>space / width || header->bytes != row_count * width) {
+            return false;
+         }
+      } else if (header->encoding == Encoding::Dictionary && schema[c].type == LogicalType::Char) {
+         // The dictionary holds at most 256 values, every code has to name one of them.
+         uint64_t dictionary = uint64_t(header->dictionary_size) * width;
+         if (header->dictionary_size>256 || dictionary>header->bytes || header->bytes - dictionary != row_count) {
+            return false;
+         }
+         auto codes = reinterpret_cast<const uint8_t *>(file.begin() + pos + dictionary);
+         for (uint64_t r = 0; r<row_count; r++) {
+            if (codes[r]>=header->dictionary_size) {
+               return false;
+            }
+         }
+      } else {
+         return false;
+      }
+      pos += (header->bytes + 7) / 8 * 8;
+   }
+   return true;
+}
+
+int ColumnarFile::find(const std::string &name) const {
+   for (uint32_t i = 0; i<column_count; i++) {
+      if (name == schema[i].name) {
+         return i;
+      }
+   }
+   return -1;
+}
+
+const ChunkHeader &ColumnarFile::chunk(size_t group, size_t column) const {
+   const char *pos = file.begin() + row_groups[group] + sizeof(uint64_t);
+   for (size_t i = 0; i<column; i++) {
+      auto header = reinterpret_cast<const ChunkHeader *>(pos);
+      pos += sizeof(ChunkHeader) + (header->bytes + 7) / 8 * 8;
+   }
+   return *reinterpret_cast<const ChunkHeader *>(pos);
+}
+
+void ColumnarFile::readInt64(size_t group, size_t column, std::vector<int64_t> &out) const {
+   auto values = reinterpret_cast<const int64_t *>(&chunk(group, column) + 1);
+   out.assign(values, values + rows(group));
+}
+
+void ColumnarFile::readFloat64(size_t group, size_t column, std::vector<double> &out) const {
+   auto values = reinterpret_cast<const double *>(&chunk(group, column) + 1);
+   out.assign(values, values + rows(group));
+}
+
+void ColumnarFile::readChar(size_t group, size_t column, std::vector<std::string_view> &out) const {
+   const ChunkHeader &header = chunk(group, column);
+   auto payload = reinterpret_cast<const char *>(&header + 1);
+   uint32_t width = schema[column].width;
+   out.resize(rows(group));
+   auto value = [width](const char *pos) {
+      return std::string_view(pos, strnlen(pos, width));
+   };
+   if (header.encoding == Encoding::Dictionary) {
+      auto codes = reinterpret_cast<const uint8_t *>(payload + header.dictionary_size * width);
+      for (size_t r = 0; r<out.size(); r++) {
+         out[r] = value(payload + codes[r] * width);
+      }
+   } else {
+      for (size_t r = 0; r<out.size(); r++) {
+         out[r] = value(payload + r * width);
+      }
+   }
+}
+
+std::span<const int64_t> Adjacency::neighbours(int64_t key) const {
+   if (key<firstKey() || key>=firstKey() + static_cast<int64_t>(keyCount())) {
+      return {};
+   }
+   auto index = reinterpret_cast<const uint64_t *>(offsets.data());
+   auto ids = reinterpret_cast<const int64_t *>(targets.data());
+   size_t k = key - firstKey();
+   return std::span<const int64_t>(ids + index[k], index[k + 1] - index[k]);
+}
+
+}
@@ -0,0 +1,128 @@
+/*
+ * The implementation of the GTPC graph data generator was built on
+ * Florian Wolf's implementation of the CH-benCHmark data generator
+ * (https://db.in.tum.de/research/projects/CHbenCHmark/) and
+ * Alexander van Renen's implementation of the TPC-C data generator
+ * (https://github.com/alexandervanrenen/tpcc-generator)
+ * See the README file.
+ */
+
+#ifndef binary_reader_hpp_
+#define binary_reader_hpp_
+
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "binary_format.hpp"
+#include "columnar_format.hpp"
+
+// Minimal reader for the files of --format binary (see binary_format.hpp) and --format columnar (see
+// columnar_format.hpp). Files are mapped read-only. open() returns false and sets error() if a file is missing or is
+// not of the expected kind.
+namespace binary {
+
+class MappedFile {
+   const char *base = nullptr;
+   size_t length = 0;
+   std::string message;
+
+public:
+   MappedFile() = default;
+   MappedFile(const MappedFile &) = delete;
+   MappedFile &operator=(const MappedFile &) = delete;
+   ~MappedFile();
+
+   // Maps the file without looking at its contents.
+   bool map(const std::string &path);
+   bool open(const std::string &path, Kind kind);
+   const std::string &error() const { return message; }
+
+   const char *begin() const { return base; }
+   size_t size() const { return length; }
+
+   const FileHeader &header() const { return *reinterpret_cast<const FileHeader *>(base); }
+   const char *data() const { return base + sizeof(FileHeader); }
+   size_t count() const { return (length - sizeof(FileHeader)) / header().width; }
+};
+
+// One property column of a node table, e.g. stock_0.quantity.col.
+class Column {
+   MappedFile file;
+
+public:
+   bool open(const std::string &path) { return file.open(path, Kind::Column); }
+   const std::string &error() const { return file.error(); }
+
+   Type type() const { return file.header().type; }
+   size_t size() const { return file.count(); }
+
+   int64_t int64At(size_t row) const { return reinterpret_cast<const int64_t *>(file.data())[row]; }
+   float float32At(size_t row) const { return reinterpret_cast<const float *>(file.data())[row]; }
+   // Fixed width text without the NUL padding.
+   std::string_view charAt(size_t row) const {
+      const char *value = file.data() + row * file.header().width;
+      return std::string_view(value, strnlen(value, file.header().width));
+   }
+};
+
+// CSR (or CSC, see byEnd()) adjacency of one relationship table, from <table>_<part>.offsets and .targets.
+class Adjacency {
+   MappedFile offsets;
+   MappedFile targets;
+   std::string message;
+
+public:
+   // Path without the .offsets/.targets suffix, e.g. <folder>/order_contains_orderLine_0.
+   bool open(const std::string &path);
+   const std::string &error() const { return message; }
+
+   bool byEnd() const { return offsets.header().by_end != 0; }
+   int64_t firstKey() const { return offsets.header().first_key; }
+   // Number of keys, i.e. one past the last key minus firstKey().
+   size_t keyCount() const { return offsets.count() - 1; }
+   size_t edgeCount() const { return targets.count(); }
+
+   // Neighbours of key, empty for keys outside [firstKey(), firstKey() + keyCount()).
+   std::span<const int64_t> neighbours(int64_t key) const;
+};
+
+// A .gcol file of --format columnar. Row groups are decoded one column at a time.
+class ColumnarFile {
+   MappedFile file;
+   std::string message;
+   const ColumnSchema *schema = nullptr;
+   uint32_t column_count = 0;
+   const uint64_t *row_groups = nullptr;
+   uint64_t row_group_count = 0;
+
+   // Header of the column's chunk in the row group, its payload follows.
+   const ChunkHeader &chunk(size_t group, size_t column) const;
+   // Whether the chunks of the row group and their payloads end before end, with as many values as the group has rows.
+   bool checkRowGroup(size_t group, uint64_t end) const;
+
+public:
+   bool open(const std::string &path);
+   const std::string &error() const { return message; }
+
+   size_t columnCount() const { return column_count; }
+   const ColumnSchema &column(size_t index) const { return schema[index]; }
+   // Index of the column with the given name, -1 if there is none.
+   int find(const std::string &name) const;
+
+   size_t rowGroupCount() const { return row_group_count; }
+   uint64_t rows(size_t group) const { return *reinterpret_cast<const uint64_t *>(file.begin() + row_groups[group]); }
+
+   // Int64 and Timestamp columns.
+   void readInt64(size_t group, size_t column, std::vector<int64_t> &out) const;
+   void readFloat64(size_t group, size_t column, std::vector<double> &out) const;
+   // Char columns, the views point into the mapping.
+   void readChar(size_t group, size_t column, std::vector<std::string_view> &out) const;
+};
+
+}
+
+#endif
@@ -0,0 +1,75 @@
+/*
+ * The implementation of the GTPC graph data generator was built on
+ * Florian Wolf's implementation of the CH-benCHmark data generator
+ * (https://db.in.tum.de/research/projects/CHbenCHmark/) and
+ * Alexander van Renen's implementation of the TPC-C data generator
+ * (https://github.com/alexandervanrenen/tpcc-generator)
+ * See the README file.
+ */
+
+#ifndef columnar_format_hpp_
+#define columnar_format_hpp_
+
+#include <cstdint>
+
+#include "binary_format.hpp"
+
+// Layout of the files written with --format columnar, one <table>_<part>.gcol per table. Little-endian, every
+// structure starts 8 byte aligned:
+//
+//   ColumnarHeader
+//   ColumnSchema[column_count]
+//   row groups, each:
+//      uint64_t rows
+//      per column: ChunkHeader followed by bytes of payload, padded to a multiple of 8
+//         Plain       rows values of the column's width
+//         Dictionary  dictionary_size values of the column's width, then one uint8_t code per row
+//   footer:
+//      uint64_t offset of every row group from the start of the file
+//      uint64_t row group count
+//      char magic[8]
+//
+// Row groups hold kRowGroupRows rows (the last one fewer), so the writer only buffers one group per table. Text
+// columns with at most 256 distinct values in a group (credit, middle, state, ...) are dictionary encoded.
+namespace binary {
+
+constexpr char kColumnarMagic[8] = {'G', 'T', 'P', 'C', 'C', 'O', 'L', '\0'};
+constexpr uint32_t kColumnarVersion = 1;
+constexpr uint64_t kRowGroupRows = 1 << 16;
+
+enum class LogicalType : uint32_t {
+   Int64,      // int64_t
+   Float64,    // double
+   Timestamp,  // int64_t milliseconds since 1970-01-01T00:00:00Z
+   Char        // fixed width text, NUL padded
+};
+
+enum class Encoding : uint32_t {
+   Plain, Dictionary
+};
+
+struct ColumnarHeader {
+   char magic[8];
+   uint32_t version;
+   uint32_t column_count;
+   uint8_t reserved[48];
+};
+
+struct ColumnSchema {
+   char name[40];
+   LogicalType type;
+   uint32_t width;  // bytes per value
+};
+
+struct ChunkHeader {
+   Encoding encoding;
+   uint32_t dictionary_size;
+   uint64_t bytes;  // payload without padding
+};
+
+static_assert(sizeof(ColumnarHeader) == 64 && sizeof(ColumnSchema) == 48 && sizeof(ChunkHeader) == 16,
+              "The structures have to stay 8 byte aligned.");
+
+}
+
+#endif
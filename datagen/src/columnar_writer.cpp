@@ -0,0 +1,184 @@
+/*
+ * The implementation of the GTPC graph data generator was built on
+ * Florian Wolf's implementation of the CH-benCHmark data generator
+ * (https://db.in.tum.de/research/projects/CHbenCHmark/) and
+ * Alexander van Renen's implementation of the TPC-C data generator
+ * (https://github.com/alexandervanrenen/tpcc-generator)
+ * See the README file.
+ */
+
+#include "columnar_writer.hpp"
+#include "table_writer.hpp"
+
+#include <charconv>
+#include <sstream>
+#include <string_view>
+#include <unordered_map>
+
+namespace csv {
+
+ColumnarWriter::ColumnarWriter(const std::string &path, const Table &table)
+        : table(table), file(path) {
+}
+
+ColumnarWriter::~ColumnarWriter() {
+   finish();
+}
+
+void ColumnarWriter::finish() {
+   if (finished) {
+      return;
+   }
+   finished = true;
+   if (schema.empty()) {
+      writeSchema({});
+   }
+   if (!pending.empty() && !pending[0].data.empty()) {
+      writeRowGroup(pending[0].data.size() / pending[0].width);
+   }
+   uint64_t count = row_groups.size();
+   put(row_groups.data(), row_groups.size() * sizeof(uint64_t));
+   put(&count, sizeof(count));
+   put(binary::kColumnarMagic, sizeof(binary::kColumnarMagic));
+}
+
+void ColumnarWriter::put(const void *data, size_t size) {
+   file.write(static_cast<const char *>(data), size);
+   position += size;
+}
+
+void ColumnarWriter::pad() {
+   static const char zeros[8] = {};
+   put(zeros, (8 - position % 8) % 8);
+}
+
+void ColumnarWriter::writeSchema(const std::vector<CsvWriter::Column> &columns) {
+   binary::ColumnarHeader header = {};
+   memcpy(header.magic, binary::kColumnarMagic, sizeof(header.magic));
+   header.version = binary::kColumnarVersion;
+   header.column_count = columns.size();
+   put(&header, sizeof(header));
+
+   std::istringstream names(table.header);
+   for (const CsvWriter::Column &column : columns) {
+      std::string name;
+      if (!std::getline(names, name, '|')) {
+         std::cout << "\nTable '" << table.name << "' has more columns than its header." << std::endl;
+         std::cout << "aborting..." << std::endl;
+         exit(-1);
+      }
+      binary::ColumnSchema s = {};
+      strncpy(s.name, name.c_str(), sizeof(s.name) - 1);
+      switch (column.type) {
+         case binary::Type::Int64:
+            s.type = binary::LogicalType::Int64;
+            s.width = sizeof(int64_t);
+            break;
+         case binary::Type::Float32:
+            s.type = binary::LogicalType::Float64;
+            s.width = sizeof(double);
+            break;
+         case binary::Type::Timestamp:
+            s.type = binary::LogicalType::Timestamp;
+            s.width = sizeof(int64_t);
+            break;
+         case binary::Type::Char:
+            s.type = binary::LogicalType::Char;
+            s.width = column.width;
+            break;
+      }
+      schema.push_back(s);
+      put(&s, sizeof(s));
+   }
+}
+
+void ColumnarWriter::append(std::vector<CsvWriter::Column> &columns) {
+   if (schema.empty()) {
+      writeSchema(columns);
+      for (const CsvWriter::Column &column : columns) {
+         pending.push_back(CsvWriter::Column{column.type, column.width, {}});
+      }
+   }
+   if (columns.size() != pending.size()) {
+      std::cout << "\nTable '" << table.name << "' changes its number of columns." << std::endl;
+      std::cout << "aborting..." << std::endl;
+      exit(-1);
+   }
+   for (size_t i = 0; i<columns.size(); i++) {
+      pending[i].data.insert(pending[i].data.end(), columns[i].data.begin(), columns[i].data.end());
+      columns[i].data.clear();
+   }
+   while (pending[0].data.size() / pending[0].width>=binary::kRowGroupRows) {
+      writeRowGroup(binary::kRowGroupRows);
+   }
+}
+
+void ColumnarWriter::writeRowGroup(uint64_t rows) {
+   row_groups.push_back(position);
+   put(&rows, sizeof(rows));
+   for (size_t i = 0; i<schema.size(); i++) {
+      writeChunk(schema[i], pending[i], rows);
+      pending[i].data.erase(pending[i].data.begin(), pending[i].data.begin() + rows * pending[i].width);
+   }
+}
+
+void ColumnarWriter::writeChunk(const binary::ColumnSchema &s, const CsvWriter::Column &column, uint64_t rows) {
+   binary::ChunkHeader header = {binary::Encoding::Plain, 0, rows * s.width};
+   const char *values = column.data.data();
+
+   switch (s.type) {
+      case binary::LogicalType::Int64:
+      case binary::LogicalType::Timestamp: {
+         put(&header, sizeof(header));
+         put(values, header.bytes);
+         break;
+      }
+      case binary::LogicalType::Float64: {
+         // Widen via the shortest decimal representation, so 8.65f becomes 8.65 and not 8.649999618530273.
+         std::vector<double> out(rows);
+         for (uint64_t r = 0; r<rows; r++) {
+            float value;
+            memcpy(&value, values + r * sizeof(float), sizeof(float));
+            char buffer[32];
+            char *end = std::to_chars(buffer, buffer + sizeof(buffer), value).ptr;
+            std::from_chars(buffer, end, out[r]);
+         }
+         put(&header, sizeof(header));
+         put(out.data(), header.bytes);
+         break;
+      }
+      case binary::LogicalType::Char: {
+         std::unordered_map<std::string_view, uint8_t> codes;
+         std::vector<uint8_t> out(rows);
+         std::vector<char> dictionary;
+         for (uint64_t r = 0; r<rows && codes.size()<=256; r++) {
+            std::string_view value(values + r * s.width, s.width);
+            auto it = codes.find(value);
+            if (it == codes.end()) {
+               if (codes.size() == 256) {
+                  codes.emplace(value, 0);  // too many distinct values, stored plain
+                  break;
+               }
+               it = codes.emplace(value, codes.size()).first;
+               dictionary.insert(dictionary.end(), value.begin(), value.end());
+            }
+            out[r] = it->second;
+         }
+         if (codes.size()<=256) {
+            header.encoding = binary::Encoding::Dictionary;
+            header.dictionary_size = codes.size();
+            header.bytes = dictionary.size() + rows;
+            put(&header, sizeof(header));
+            put(dictionary.data(), dictionary.size());
+            put(out.data(), rows);
+         } else {
+            put(&header, sizeof(header));
+            put(values, header.bytes);
+         }
+         break;
+      }
+   }
+   pad();
+}
+
+}
@@ -0,0 +1,54 @@
+/*
+ * The implementation of the GTPC graph data generator was built on
+ * Florian Wolf's implementation of the CH-benCHmark data generator
+ * (https://db.in.tum.de/research/projects/CHbenCHmark/) and
+ * Alexander van Renen's implementation of the TPC-C data generator
+ * (https://github.com/alexandervanrenen/tpcc-generator)
+ * See the README file.
+ */
+
+#ifndef columnar_writer_hpp_
+#define columnar_writer_hpp_
+
+#include <string>
+#include <vector>
+
+#include "columnar_format.hpp"
+#include "csv_writer.hpp"
+
+namespace csv {
+
+struct Table;
+
+// Writes the columns collected by columnar CsvWriters into a .gcol file (see columnar_format.hpp). Floats are widened
+// to double, timestamps keep their epoch value.
+class ColumnarWriter {
+   const Table &table;
+   CsvWriter file;
+   uint64_t position = 0;
+   std::vector<binary::ColumnSchema> schema;
+   std::vector<CsvWriter::Column> pending;  // raw values of the current row group
+   std::vector<uint64_t> row_groups;
+   bool finished = false;
+
+   void put(const void *data, size_t size);
+   void pad();
+   void writeSchema(const std::vector<CsvWriter::Column> &columns);
+   void writeRowGroup(uint64_t rows);
+   void writeChunk(const binary::ColumnSchema &schema, const CsvWriter::Column &column, uint64_t rows);
+
+public:
+   ColumnarWriter(const std::string &path, const Table &table);
+   ~ColumnarWriter();
+
+   // Takes the values of the given columns, leaving them empty.
+   void append(std::vector<CsvWriter::Column> &columns);
+   // Writes the last row group and the footer; done by the destructor if not called before.
+   void finish();
+   // Bytes written to the file so far.
+   uint64_t size() const { return position; }
+};
+
+}
+
+#endif
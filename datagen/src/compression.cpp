@@ -0,0 +1,158 @@
+/*
+ * The implementation of the GTPC graph data generator was built on
+ * Florian Wolf's implementation of the CH-benCHmark data generator
+ * (https://db.in.tum.de/research/projects/CHbenCHmark/) and
+ * Alexander van Renen's implementation of the TPC-C data generator
+ * (https://github.com/alexandervanrenen/tpcc-generator)
+ * See the README file.
+ */
+
+#include "compression.hpp"
+
+#include <iostream>
+
+#ifdef GTPC_WITH_ZLIB
+#include <zlib.h>
+#endif
+#ifdef GTPC_WITH_ZSTD
+#include <zstd.h>
+#endif
+#ifdef GTPC_WITH_LZ4
+#include <lz4frame.h>
+#endif
+
+namespace csv {
+
+namespace {
+
+[[noreturn]] void fail(const char *codec, const std::string &what) {
+   std::cout << "\nCompression with " << codec << " failed: " << what << std::endl;
+   std::cout << "aborting..." << std::endl;
+   exit(-1);
+}
+
+#ifdef GTPC_WITH_ZLIB
+void compressGzip(int level, const char *data, size_t size, std::vector<char> &out) {
+   z_stream stream = {};
+   // 15 window bits plus 16 selects the gzip wrapper instead of the zlib one.
+   if (deflateInit2(&stream, level<0 ? Z_DEFAULT_COMPRESSION : level, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+      fail("gzip", "deflateInit2");
+   }
+   out.resize(deflateBound(&stream, size));
+   stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data));
+   stream.avail_in = size;
+   stream.next_out = reinterpret_cast<Bytef *>(out.data());
+   stream.avail_out = out.size();
+   if (deflate(&stream, Z_FINISH) != Z_STREAM_END) {
+      fail("gzip", "deflate");
+   }
+   out.resize(stream.total_out);
+   deflateEnd(&stream);
+}
+#endif
+
+#ifdef GTPC_WITH_ZSTD
+void compressZstd(int level, const char *data, size_t size, std::vector<char> &out) {
+   out.resize(ZSTD_compressBound(size));
+   size_t written = ZSTD_compress(out.data(), out.size(), data, size, level<0 ? ZSTD_CLEVEL_DEFAULT : level);
+   if (ZSTD_isError(written)) {
+      fail("zstd", ZSTD_getErrorName(written));
+   }
+   out.resize(written);
+}
+#endif
+
+#ifdef GTPC_WITH_LZ4
+void compressLz4(int level, const char *data, size_t size, std::vector<char> &out) {
+   LZ4F_preferences_t preferences = {};
+   preferences.compressionLevel = level<0 ? 0 : level;
+   preferences.frameInfo.contentSize = size;
+   out.resize(LZ4F_compressFrameBound(size, &preferences));
+   size_t written = LZ4F_compressFrame(out.data(), out.size(), data, size, &preferences);
+   if (LZ4F_isError(written)) {
+      fail("lz4", LZ4F_getErrorName(written));
+   }
+   out.resize(written);
+}
+#endif
+
+}
+
+bool parseCompression(const std::string &name, Compression &compression) {
+   if (name == "none") {
+      compression = Compression::None;
+   } else if (name == "gzip") {
+      compression = Compression::Gzip;
+   } else if (name == "zstd") {
+      compression = Compression::Zstd;
+   } else if (name == "lz4") {
+      compression = Compression::Lz4;
+   } else {
+      return false;
+   }
+   return true;
+}
+
+bool isAvailable(Compression compression) {
+   switch (compression) {
+      case Compression::None:
+         return true;
+      case Compression::Gzip:
+#ifdef GTPC_WITH_ZLIB
+         return true;
+#else
+         return false;
+#endif
+      case Compression::Zstd:
+#ifdef GTPC_WITH_ZSTD
+         return true;
+#else
+         return false;
+#endif
+      case Compression::Lz4:
+#ifdef GTPC_WITH_LZ4
+         return true;
+#else
+         return false;
+#endif
+   }
+   return false;
+}
+
+const char *fileSuffix(Compression compression) {
+   switch (compression) {
+      case Compression::None:
+         return "";
+      case Compression::Gzip:
+         return ".gz";
+      case Compression::Zstd:
+         return ".zst";
+      case Compression::Lz4:
+         return ".lz4";
+   }
+   return "";
+}
+
+void compress(Compression compression, int level, const char *data, size_t size, std::vector<char> &out) {
+   switch (compression) {
+#ifdef GTPC_WITH_ZLIB
+      case Compression::Gzip:
+         compressGzip(level, data, size, out);
+         return;
+#endif
+#ifdef GTPC_WITH_ZSTD
+      case Compression::Zstd:
+         compressZstd(level, data, size, out);
+         return;
+#endif
+#ifdef GTPC_WITH_LZ4
+      case Compression::Lz4:
+         compressLz4(level, data, size, out);
+         return;
+#endif
+      default:
+         fail(fileSuffix(compression), "codec not available in this build");
+   }
+}
+
+}
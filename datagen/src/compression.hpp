@@ -0,0 +1,36 @@
+/*
+ * The implementation of the GTPC graph data generator was built on
+ * Florian Wolf's implementation of the CH-benCHmark data generator
+ * (https://db.in.tum.de/research/projects/CHbenCHmark/) and
+ * Alexander van Renen's implementation of the TPC-C data generator
+ * (https://github.com/alexandervanrenen/tpcc-generator)
+ * See the README file.
+ */
+
+#ifndef compression_hpp_
+#define compression_hpp_
+
+#include <string>
+#include <vector>
+
+namespace csv {
+
+// Every output block is compressed on its own into a complete gzip member, zstd frame or lz4 frame. All three formats
+// allow concatenating such units, so the blocks can be compressed in parallel and the file is still a single valid
+// stream (neo4j-admin import reads multi-member .gz files).
+enum class Compression {
+   None, Gzip, Zstd, Lz4
+};
+
+// Parses "none", "gzip", "zstd" or "lz4"; returns false for unknown names.
+bool parseCompression(const std::string &name, Compression &compression);
+// Whether support for the codec was compiled in.
+bool isAvailable(Compression compression);
+// File name suffix, e.g. ".gz".
+const char *fileSuffix(Compression compression);
+// A level below 0 selects the codec's default.
+void compress(Compression compression, int level, const char *data, size_t size, std::vector<char> &out);
+
+}
+
+#endif
@@ -1,7 +1,7 @@
 /*
  * The implementation of the GTPC graph data generator was built on
  * Florian Wolf's implementation of the CH-benCHmark data generator
- * (https://db.in.tum.de/research/projects/CHbenCHmark/) and 
+ * (https://db.in.tum.de/research/projects/CHbenCHmark/) and
  * Alexander van Renen's implementation of the TPC-C data generator
  * (https://github.com/alexandervanrenen/tpcc-generator)
  * See the README file.
@@ -9,58 +9,266 @@
 
 #include "csv_writer.hpp"
 
-#include <iomanip>
-#include <cstring>
+#include <algorithm>
+#include <charconv>
+#include <fcntl.h>
+#include <unistd.h>
 
 namespace csv {
 
+namespace {
+
+// "00" to "99", so two digits are written with a single copy.
+constexpr auto kDigitPairs = [] {
+   std::array<char, 200> pairs = {};
+   for (int i = 0; i<100; i++) {
+      pairs[2 * i] = char('0' + i / 10);
+      pairs[2 * i + 1] = char('0' + i % 10);
+   }
+   return pairs;
+}();
+
+void writeTwoDigits(char *out, int64_t value) {
+   memcpy(out, kDigitPairs.data() + 2 * value, 2);
+}
+
+}
+
+void formatTimestamp(Timestamp timestamp, char *out) {
+   constexpr int64_t kMillisPerDay = 86400000;
+   int64_t days = timestamp.millis / kMillisPerDay;
+   int64_t millis = timestamp.millis % kMillisPerDay;
+   if (millis<0) {
+      days--;
+      millis += kMillisPerDay;
+   }
+   // H. Hinnant's civil_from_days
+   days += 719468;
+   int64_t era = (days>=0 ? days : days - 146096) / 146097;
+   int64_t doe = days - era * 146097;
+   int64_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+   int64_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+   int64_t mp = (5 * doy + 2) / 153;
+   int64_t day = doy - (153 * mp + 2) / 5 + 1;
+   int64_t month = mp<10 ? mp + 3 : mp - 9;
+   int64_t year = yoe + era * 400 + (month<=2);
+
+   writeTwoDigits(out, year / 100);
+   writeTwoDigits(out + 2, year % 100);
+   out[4] = '-';
+   writeTwoDigits(out + 5, month);
+   out[7] = '-';
+   writeTwoDigits(out + 8, day);
+   out[10] = 'T';
+   writeTwoDigits(out + 11, millis / 3600000);
+   out[13] = ':';
+   writeTwoDigits(out + 14, millis / 60000 % 60);
+   out[16] = ':';
+   writeTwoDigits(out + 17, millis / 1000 % 60);
+   out[19] = '.';
+   out[20] = char('0' + millis / 100 % 10);
+   writeTwoDigits(out + 21, millis % 100);
+   memcpy(out + 23, "+0000", 5);
+}
+
 CsvWriter::CsvWriter(const std::string &path)
-        : out(path), firstWordInLine(true) {
-   if (!out.good()) {
-      std::cout << "\nCannot create file: '" << path << "'." << std::endl;
+        : file(std::make_unique<OutputFile>()), block(OutputStage::instance().acquire()), precision(6),
+          firstWordInLine(true) {
+   file->path = path + fileSuffix(OutputStage::instance().getCompression());
+   file->fd = open(file->path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+   if (file->fd<0) {
+      std::cout << "\nCannot create file: '" << file->path << "'." << std::endl;
       std::cout << "aborting..." << std::endl;
       exit(-1);
    }
 }
 
-void CsvWriter::prePrint() {
-   if (firstWordInLine) {
-      firstWordInLine = false;
+CsvWriter::CsvWriter()
+        : block(OutputStage::instance().acquire()), precision(6), firstWordInLine(true) {
+}
+
+CsvWriter::~CsvWriter() {
+   OutputStage &stage = OutputStage::instance();
+   if (file) {
+      flush();
+      stage.wait(*file);
+      close(file->fd);
+   }
+   for (Block &b : full) {
+      stage.release(std::move(b));
+   }
+   if (block.data) {
+      stage.release(std::move(block));
+   }
+}
+
+size_t CsvWriter::size() const {
+   size_t bytes = block.used;
+   for (const Block &b : full) {
+      bytes += b.used;
+   }
+   return bytes;
+}
+
+void CsvWriter::nextBlock() {
+   OutputStage &stage = OutputStage::instance();
+   if (file) {
+      stage.submit(*file, std::move(block));
    } else {
-      out << '|';
+      full.push_back(std::move(block));
    }
+   block = stage.acquire();
 }
 
-CsvWriter &CsvWriter::printString(const char *str, int len) {
-   prePrint();
-   out.write(str, std::min((size_t) len, strnlen(str, len)));
-   return *this;
+void CsvWriter::flush() {
+   if (file && block.used>0) {
+      nextBlock();
+   }
+}
+
+void CsvWriter::append(CsvWriter &other) {
+   OutputStage &stage = OutputStage::instance();
+   rowCount += other.takeRowCount();
+   size_t bytes = other.size();
+   if (block.used + bytes<=OutputStage::kBlockSize) {
+      // Small chunks are copied so that the blocks stay reasonably full.
+      for (Block &b : other.full) {
+         memcpy(block.data.get() + block.used, b.data.get(), b.used);
+         block.used += b.used;
+         stage.release(std::move(b));
+      }
+      memcpy(block.data.get() + block.used, other.block.data.get(), other.block.used);
+      block.used += other.block.used;
+      other.block.used = 0;
+   } else {
+      // Large chunks hand over their blocks as they are.
+      if (file) {
+         flush();
+         for (Block &b : other.full) {
+            stage.submit(*file, std::move(b));
+         }
+         stage.submit(*file, std::move(other.block));
+      } else {
+         full.push_back(std::move(block));
+         for (Block &b : other.full) {
+            full.push_back(std::move(b));
+         }
+         block = std::move(other.block);
+      }
+      other.block = stage.acquire();
+   }
+   other.full.clear();
+}
+
+void CsvWriter::write(const char *data, size_t size) {
+   while (size>0) {
+      size_t room = OutputStage::kBlockSize - block.used;
+      if (room == 0) {
+         nextBlock();
+         continue;
+      }
+      size_t bytes = std::min(room, size);
+      memcpy(block.data.get() + block.used, data, bytes);
+      block.used += bytes;
+      data += bytes;
+      size -= bytes;
+   }
+}
+
+void CsvWriter::putColumn(binary::Type type, const void *data, uint32_t width, size_t len) {
+   if (column == columns.size()) {
+      columns.push_back(Column{type, width, {}});
+   }
+   Column &c = columns[column++];
+   if (c.type != type || c.width != width) {
+      std::cout << "\nColumn " << column << " changes its type between rows." << std::endl;
+      std::cout << "aborting..." << std::endl;
+      exit(-1);
+   }
+   // Zero-filled by resize, so shorter values are NUL padded.
+   size_t pos = c.data.size();
+   c.data.resize(pos + width);
+   memcpy(c.data.data() + pos, data, len);
 }
 
 CsvWriter &operator<<(CsvWriter &csv, int64_t num) {
+   if (csv.columnar) {
+      csv.putColumn(binary::Type::Int64, &num, sizeof(num), sizeof(num));
+      return csv;
+   }
    csv.prePrint();
-   csv.out << num;
+   char *pos = csv.reserve(20);
+   csv.block.used = std::to_chars(pos, pos + 20, num).ptr - csv.block.data.get();
    return csv;
 }
 
 CsvWriter &operator<<(CsvWriter &csv, float num) {
+   if (csv.columnar) {
+      csv.putColumn(binary::Type::Float32, &num, sizeof(num), sizeof(num));
+      return csv;
+   }
+   csv.prePrint();
+   // Same digits as an ostream with std::fixed, which also formats the value as a double.
+   size_t room = 48 + csv.precision;
+   char *pos = csv.reserve(room);
+   csv.block.used = std::to_chars(pos, pos + room, double(num), std::chars_format::fixed, csv.precision).ptr - csv.block.data.get();
+   return csv;
+}
+
+CsvWriter &operator<<(CsvWriter &csv, Timestamp timestamp) {
+   if (csv.columnar) {
+      csv.putColumn(binary::Type::Timestamp, &timestamp.millis, sizeof(int64_t), sizeof(int64_t));
+      return csv;
+   }
    csv.prePrint();
-   csv.out << std::fixed << num;
+   formatTimestamp(timestamp, csv.reserve(kTimestampLength));
+   csv.block.used += kTimestampLength;
    return csv;
 }
 
 CsvWriter &operator<<(CsvWriter &csv, const std::string &str) {
-   return csv.printString(str.c_str(), str.size());
+   if (csv.columnar) {
+      std::cout << "\nVariable length field '" << str << "' cannot be written to a binary column." << std::endl;
+      std::cout << "aborting..." << std::endl;
+      exit(-1);
+   }
+   return csv.printString(str.data(), str.size());
+}
+
+CsvWriter &operator<<(CsvWriter &csv, IdList list) {
+   if (csv.columnar) {
+      std::cout << "\nLists cannot be written to a binary column." << std::endl;
+      std::cout << "aborting..." << std::endl;
+      exit(-1);
+   }
+   csv.prePrint();
+   for (size_t i = 0; i<list.count; i++) {
+      char *pos = csv.reserve(21);
+      if (i>0) {
+         *pos++ = ';';
+      }
+      csv.block.used = std::to_chars(pos, pos + 20, list.ids[i]).ptr - csv.block.data.get();
+   }
+   return csv;
 }
 
 CsvWriter &operator<<(CsvWriter &csv, EndlStruct) {
-   csv.out << "\n";
+   csv.rowCount++;
+   if (csv.columnar) {
+      csv.column = 0;
+      return csv;
+   }
+   if (!csv.rowSuffix.empty()) {
+      csv.printString(csv.rowSuffix.data(), csv.rowSuffix.size());
+   }
+   *csv.reserve(1) = '\n';
+   csv.block.used++;
    csv.firstWordInLine = true;
    return csv;
 }
 
 CsvWriter &operator<<(CsvWriter &csv, Precision precision) {
-   csv.out << std::setprecision(precision.p);
+   csv.precision = precision.p;
    return csv;
 }
 
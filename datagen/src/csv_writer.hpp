@@ -1,7 +1,7 @@
 /*
  * The implementation of the GTPC graph data generator was built on
  * Florian Wolf's implementation of the CH-benCHmark data generator
- * (https://db.in.tum.de/research/projects/CHbenCHmark/) and 
+ * (https://db.in.tum.de/research/projects/CHbenCHmark/) and
  * Alexander van Renen's implementation of the TPC-C data generator
  * (https://github.com/alexandervanrenen/tpcc-generator)
  * See the README file.
@@ -12,7 +12,15 @@
 
 #include <iostream>
 #include <array>
-#include <fstream>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "binary_format.hpp"
+#include "output_stage.hpp"
+#include "timestamp.hpp"
 
 namespace csv {
 
@@ -21,23 +29,102 @@ struct Precision {
    int p;
 };
 
+// Field of ids separated by ';', the array syntax of neo4j-admin import.
+struct IdList {
+   const int64_t *ids;
+   size_t count;
+};
+
 static struct EndlStruct { // Not std way to it but really easy for here.
 } endl;
 
+// Formats rows straight into fixed-size blocks (numbers via std::to_chars, no iostreams or locales involved). Full
+// blocks of a file writer are handed to the OutputStage and written by its I/O threads while this thread continues
+// with a fresh block. Writers without a path keep their blocks in memory until the chunk is appended to a file writer.
+// Columnar in-memory writers collect the raw values of every field in one buffer per column instead, for the binary
+// output format.
 class CsvWriter {
-   std::ofstream out;
+public:
+   struct Column {
+      binary::Type type;
+      uint32_t width;
+      std::vector<char> data;
+   };
+
+private:
+   std::unique_ptr<OutputFile> file;
+   std::vector<Block> full;  // in-memory writers only
+   Block block;
+   int precision;
    bool firstWordInLine;
+   std::string rowSuffix;
+   bool columnar = false;
+   size_t column = 0;
+   std::vector<Column> columns;
+   uint64_t rowCount = 0;
 
-   void prePrint();
-   CsvWriter &printString(const char *str, int len);
+   char *reserve(size_t bytes) {
+      if (block.used + bytes>OutputStage::kBlockSize) {
+         nextBlock();
+      }
+      return block.data.get() + block.used;
+   }
+   void nextBlock();
+   void prePrint() {
+      if (firstWordInLine) {
+         firstWordInLine = false;
+      } else {
+         *reserve(1) = '|';
+         block.used++;
+      }
+   }
+   void putColumn(binary::Type type, const void *data, uint32_t width, size_t len);
+   CsvWriter &printString(const char *str, size_t len) {
+      prePrint();
+      memcpy(reserve(len), str, len);
+      block.used += len;
+      return *this;
+   }
 public:
    CsvWriter(const std::string &path);
+   // Writer that collects its rows in memory, to be appended to a file writer later on.
+   CsvWriter();
+   CsvWriter(CsvWriter &&other) noexcept = default;
+   ~CsvWriter();
+
+   // Field appended to every row, e.g. the :LABEL column of the neo4j-admin format.
+   void setRowSuffix(const std::string &suffix) { rowSuffix = suffix; }
+   void setColumnar() { columnar = true; }
+   bool isColumnar() const { return columnar; }
+   // Values collected by a columnar writer; the caller may consume and clear them.
+   std::vector<Column> &getColumns() { return columns; }
+   // Appends raw bytes, e.g. the binary files.
+   void write(const char *data, size_t size);
+
+   size_t size() const;
+   // Rows ended since the last call; rows moved here by append() count for this writer.
+   uint64_t takeRowCount() { return std::exchange(rowCount, 0); }
+   // File writers only: bytes written to the file so far, before compression.
+   uint64_t getBytesWritten() const { return (file ? file->bytes : 0) + block.used; }
+   // Moves the rows of an in-memory writer to the end of this writer, leaving other empty.
+   void append(CsvWriter &other);
+   void flush();
 
    friend CsvWriter &operator<<(CsvWriter &csv, int64_t num);
    friend CsvWriter &operator<<(CsvWriter &csv, float num);
+   friend CsvWriter &operator<<(CsvWriter &csv, Timestamp timestamp);
+   // Fixed width fields are NUL terminated only if they are shorter than the array.
    template<unsigned long len>
-   friend CsvWriter &operator<<(CsvWriter &csv, const std::array<char, len> &data) { return csv.printString(data.data(), len); }
+   friend CsvWriter &operator<<(CsvWriter &csv, const std::array<char, len> &data) {
+      auto end = static_cast<const char *>(memchr(data.data(), '\0', len));
+      if (csv.columnar) {
+         csv.putColumn(binary::Type::Char, data.data(), len, end ? end - data.data() : len);
+         return csv;
+      }
+      return csv.printString(data.data(), end ? end - data.data() : len);
+   }
    friend CsvWriter &operator<<(CsvWriter &csv, const std::string &str);
+   friend CsvWriter &operator<<(CsvWriter &csv, IdList list);
    friend CsvWriter &operator<<(CsvWriter &csv, EndlStruct);
    friend CsvWriter &operator<<(CsvWriter &csv, Precision);
 };
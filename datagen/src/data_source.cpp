@@ -8,6 +8,7 @@
  */
 
 #include "data_source.hpp"
+#include "text_pool.hpp"
 
 #include <cstdlib>
 #include <ctime>
@@ -120,78 +121,113 @@ std::vector<const char*> DataSource::tpchAuxiliaries={
 
 int DataSource::lastOlCount = 0;
 
+thread_local rng::Random DataSource::random(1382350201, 0, 0, 0);
+
+const rng::TextPool* DataSource::textPool = nullptr;
+
 std::string DataSource::tpchText(int length){
-	std::string s=" ";
+	if(textPool)
+		return std::string(textPool->slice(random, length, length));
+	std::string s;
 	for(int i=0; i<25; i++)
-		s = s + (i==0?"":" ") + tpchSentence();
+		appendTpchSentence(random, s);
 	int pos = randomUniformInt(0,s.length()-length);
 	return s.substr(pos,length);
 }
 
-std::string DataSource::tpchSentence(){
-	if(randomTrue(1/5))
-		return tpchNounPhrase() + " " + tpchVerbPhrase() + " " +
-		tpchTerminators[randomUniformInt(0,tpchTerminators.size()-1)];
-	else if(randomTrue(1/5))
-		return tpchNounPhrase() + " " + tpchVerbPhrase() + " " +
-		tpchPrepositionalPhrase() + " " + tpchTerminators[randomUniformInt(0,tpchTerminators.size()-1)];
-	else if(randomTrue(1/5))
-		return tpchNounPhrase() + " " + tpchVerbPhrase() + " " +
-		tpchNounPhrase() + " " + tpchTerminators[randomUniformInt(0,tpchTerminators.size()-1)];
-	else if(randomTrue(1/5))
-		return tpchNounPhrase() + " " + tpchPrepositionalPhrase()  + " " +
-		tpchVerbPhrase() + " " + tpchNounPhrase() + " " + tpchTerminators[randomUniformInt(0,tpchTerminators.size()-1)];
-	else
-		return tpchNounPhrase() + " " + tpchPrepositionalPhrase()  + " " + tpchVerbPhrase() + " " +
-		tpchPrepositionalPhrase() + " " + tpchTerminators[randomUniformInt(0,tpchTerminators.size()-1)];
-}
-
-std::string DataSource::tpchNounPhrase(){
-	if(randomTrue(1/4))
-		return std::string(tpchNouns[randomUniformInt(0,tpchNouns.size()-1)]);
-	else if(randomTrue(1/4))
-		return std::string(tpchAdjectives[randomUniformInt(0,tpchAdjectives.size()-1)])  + " " +
-		tpchNouns[randomUniformInt(0,tpchNouns.size()-1)];
-	else if(randomTrue(1/4))
-		return std::string(tpchAdjectives[randomUniformInt(0,tpchAdjectives.size()-1)])  + ", " +
-		tpchAdjectives[randomUniformInt(0,tpchAdjectives.size()-1)]  + " " + tpchNouns[randomUniformInt(0,tpchNouns.size()-1)];
-	else
-		return std::string(tpchAdverbs[randomUniformInt(0,tpchAdverbs.size()-1)])  + " " +
-		tpchAdjectives[randomUniformInt(0,tpchAdjectives.size()-1)]  + " " + tpchNouns[randomUniformInt(0,tpchNouns.size()-1)];
-}
-
-std::string DataSource::tpchVerbPhrase(){
-	if(randomTrue(1/4))
-		return std::string(tpchVerbs[randomUniformInt(0,tpchVerbs.size()-1)]);
-	else if(randomTrue(1/4))
-		return std::string(tpchAuxiliaries[randomUniformInt(0,tpchAuxiliaries.size()-1)])  + " " +
-		tpchVerbs[randomUniformInt(0,tpchVerbs.size()-1)];
-	else if(randomTrue(1/4))
-		return std::string(tpchVerbs[randomUniformInt(0,tpchVerbs.size()-1)]) + " " + tpchAdverbs[randomUniformInt(0,tpchAdverbs.size()-1)];
-	else
-		return std::string(tpchAuxiliaries[randomUniformInt(0,tpchAuxiliaries.size()-1)])  + " " +
-		tpchVerbs[randomUniformInt(0,tpchVerbs.size()-1)] + " " + tpchAdverbs[randomUniformInt(0,tpchAdverbs.size()-1)];
-}
-
-std::string DataSource::tpchPrepositionalPhrase(){
-	return std::string(tpchPrepositions[randomUniformInt(0,tpchPrepositions.size()-1)]) + " the " + tpchNounPhrase();
+// The grammar of TPC-H dbgen (grammar.dst, np.dst and vp.dst) with its weights; words are drawn uniformly from the
+// lists above. Everything is appended to out, so a whole text needs no temporaries.
+void DataSource::appendTpchSentence(rng::Random& random, std::string& out){
+	uint32_t r = random.uniform(1, 11);
+	appendNounPhrase(random, out);
+	if(r<=3){
+		appendVerbPhrase(random, out);
+	} else if(r<=6){
+		appendVerbPhrase(random, out);
+		appendPrepositionalPhrase(random, out);
+	} else if(r<=9){
+		appendVerbPhrase(random, out);
+		appendNounPhrase(random, out);
+	} else if(r<=10){
+		appendPrepositionalPhrase(random, out);
+		appendVerbPhrase(random, out);
+		appendNounPhrase(random, out);
+	} else{
+		appendPrepositionalPhrase(random, out);
+		appendVerbPhrase(random, out);
+		appendPrepositionalPhrase(random, out);
+	}
+	// "." has weight 50, the other terminators 1.
+	uint32_t t = random.uniform(1, 55);
+	out += tpchTerminators[t<=50 ? 0 : t-50];
+}
+
+void DataSource::appendWord(rng::Random& random, const std::vector<const char*>& words, std::string& out){
+	if(!out.empty())
+		out += ' ';
+	out += words[random.uniform(0, words.size()-1)];
+}
+
+void DataSource::appendNounPhrase(rng::Random& random, std::string& out){
+	uint32_t r = random.uniform(1, 90);
+	if(r<=10){
+		appendWord(random, tpchNouns, out);
+	} else if(r<=30){
+		appendWord(random, tpchAdjectives, out);
+		appendWord(random, tpchNouns, out);
+	} else if(r<=40){
+		appendWord(random, tpchAdjectives, out);
+		out += ',';
+		appendWord(random, tpchAdjectives, out);
+		appendWord(random, tpchNouns, out);
+	} else{
+		appendWord(random, tpchAdverbs, out);
+		appendWord(random, tpchAdjectives, out);
+		appendWord(random, tpchNouns, out);
+	}
+}
+
+void DataSource::appendVerbPhrase(rng::Random& random, std::string& out){
+	uint32_t r = random.uniform(1, 72);
+	if(r<=30){
+		appendWord(random, tpchVerbs, out);
+	} else if(r<=31){
+		appendWord(random, tpchAuxiliaries, out);
+		appendWord(random, tpchVerbs, out);
+	} else if(r<=71){
+		appendWord(random, tpchVerbs, out);
+		appendWord(random, tpchAdverbs, out);
+	} else{
+		appendWord(random, tpchAuxiliaries, out);
+		appendWord(random, tpchVerbs, out);
+		appendWord(random, tpchAdverbs, out);
+	}
+}
+
+void DataSource::appendPrepositionalPhrase(rng::Random& random, std::string& out){
+	appendWord(random, tpchPrepositions, out);
+	out += " the";
+	appendNounPhrase(random, out);
 }
 
 void DataSource::initialize(){
-	srand(1382350201);
+	initialize(1382350201, 0, 0, 0);
+}
+
+void DataSource::initialize(uint32_t seed, uint32_t table, uint64_t warehouse, uint64_t row, rng::UniformMethod method){
+	random = rng::Random(seed, table, warehouse, row, method);
 }
 
 bool DataSource::randomTrue(double probability){
-	double value = rand() / double(RAND_MAX);
-	return value < probability;
+	return random.chance(probability);
 }
 
 int DataSource::randomUniformInt(int minValue, int maxValue){
-	return (rand()%(maxValue-minValue+1))+minValue;
+	return random.uniform(minValue, maxValue);
 }
 
 void DataSource::randomUniformInt(int minValue, int maxValue, int& ret){
-	ret = (rand()%(maxValue-minValue+1))+minValue;
+	ret = random.uniform(minValue, maxValue);
 }
 
 void DataSource::randomNonUniformInt(int A, int x, int y, int C, int& ret){
@@ -235,9 +271,11 @@ void DataSource::randomCLast(std::string& ret){
 // 	}
 // }
 
+static constexpr rng::Range kOrderLineCounts(5, 15);
+
 int DataSource::nextOderlineCount(){
 	if(lastOlCount==0){
-		randomUniformInt(5,15,lastOlCount);
+		lastOlCount = random.uniform(kOrderLineCounts);
 		return 20-lastOlCount;
 	}
 
@@ -14,6 +14,12 @@
 #include <string>
 #include <vector>
 
+#include "random.hpp"
+
+namespace rng {
+class TextPool;
+}
+
 struct Nation {
 	uint64_t id;
 	std::string name;
@@ -21,6 +27,8 @@ struct Nation {
 };
 
 class DataSource {
+	// bench/gtpc_bench.cpp measures tpchText directly.
+	friend class GeneratorBench;
 
 	private:
 		static std::vector<const char*> cLastParts;
@@ -34,15 +42,26 @@ class DataSource {
 		static const Nation nations[];
 		static const char* regions[];
 		static int lastOlCount;
+		static thread_local rng::Random random;
+
+		static const rng::TextPool* textPool;
 
 		static std::string tpchText(int length);
-		static std::string tpchSentence();
-		static std::string tpchNounPhrase();
-		static std::string tpchVerbPhrase();
-		static std::string tpchPrepositionalPhrase();
+		static void appendWord(rng::Random& random, const std::vector<const char*>& words, std::string& out);
+		static void appendNounPhrase(rng::Random& random, std::string& out);
+		static void appendVerbPhrase(rng::Random& random, std::string& out);
+		static void appendPrepositionalPhrase(rng::Random& random, std::string& out);
 
 	public:
 		static void initialize();
+		// Positions the calling thread's random stream at the given key, see rng::Random. The random* and add* functions
+		// map values to ranges with the given method.
+		static void initialize(uint32_t seed, uint32_t table, uint64_t warehouse, uint64_t row,
+		                       rng::UniformMethod method = rng::UniformMethod::MultiplyShift);
+		// Text of addTextString and addTextStringCustomer is sliced from the pool once one is set.
+		static void setTextPool(const rng::TextPool* pool) { textPool = pool; }
+		// Appends one sentence of the TPC-H text grammar to out.
+		static void appendTpchSentence(rng::Random& random, std::string& out);
 		static bool randomTrue(double probability);
 		static int randomUniformInt(int minValue, int maxValue);
 		static void randomUniformInt(int minValue, int maxValue, int& ret);
@@ -0,0 +1,314 @@
+/*
+ * The implementation of the GTPC graph data generator was built on
+ * Florian Wolf's implementation of the CH-benCHmark data generator
+ * (https://db.in.tum.de/research/projects/CHbenCHmark/) and
+ * Alexander van Renen's implementation of the TPC-C data generator
+ * (https://github.com/alexandervanrenen/tpcc-generator)
+ * See the README file.
+ */
+
+#include "edge_sorter.hpp"
+#include "thread_pool.hpp"
+
+#include <algorithm>
+#include <fcntl.h>
+#include <queue>
+#include <unistd.h>
+#include <utility>
+
+namespace csv {
+
+namespace {
+
+// Edges per partition of the final merge, about 5 MiB of CSV; orderedFor keeps two partitions per thread in flight.
+const uint64_t kPartitionEdges = 1 << 18;
+// Edges read from a run on disk at once, per run and partition.
+const size_t kReadEdges = 1 << 14;
+// Start ids sampled per run for the partition boundaries.
+const uint64_t kSamplesPerRun = 1024;
+
+bool less(const Edge &a, const Edge &b, EdgeOrder order) {
+   return a.start != b.start ? a.start<b.start : order == EdgeOrder::StartEnd && a.end<b.end;
+}
+
+[[noreturn]] void fail(const char *what, const std::string &path) {
+   std::cout << "\nCannot " << what << " file: '" << path << "'." << std::endl;
+   std::cout << "aborting..." << std::endl;
+   exit(-1);
+}
+
+int openRun(const std::string &path) {
+   int fd = open(path.c_str(), O_RDONLY);
+   if (fd<0) {
+      fail("open", path);
+   }
+   return fd;
+}
+
+void readEdges(int fd, const std::string &path, uint64_t index, Edge *out, size_t count) {
+   char *data = reinterpret_cast<char *>(out);
+   size_t bytes = count * sizeof(Edge);
+   uint64_t offset = index * sizeof(Edge);
+   while (bytes>0) {
+      ssize_t done = pread(fd, data, bytes, offset);
+      if (done<=0) {
+         fail("read", path);
+      }
+      data += done;
+      bytes -= done;
+      offset += done;
+   }
+}
+
+// Start id of the index-th edge of a run in memory (fd<0) or on disk.
+int64_t startAt(const std::vector<Edge> &edges, int fd, const std::string &path, uint64_t index) {
+   if (fd<0) {
+      return edges[index].start;
+   }
+   Edge edge;
+   readEdges(fd, path, index, &edge, 1);
+   return edge.start;
+}
+
+// First edge of the run with a start id not less than key.
+uint64_t lowerBound(const std::vector<Edge> &edges, int fd, const std::string &path, uint64_t size, int64_t key) {
+   uint64_t low = 0;
+   uint64_t high = size;
+   while (low<high) {
+      uint64_t middle = low + (high - low) / 2;
+      if (startAt(edges, fd, path, middle)<key) {
+         low = middle + 1;
+      } else {
+         high = middle;
+      }
+   }
+   return low;
+}
+
+// Edges [next, stop) of a run, read from disk in pieces.
+class Cursor {
+   const Edge *pos = nullptr;
+   const Edge *end = nullptr;
+   int fd = -1;
+   std::string path;
+   uint64_t next;
+   uint64_t stop;
+   std::vector<Edge> buffer;
+
+   void refill() {
+      if (fd<0 || next == stop) {
+         return;
+      }
+      size_t count = std::min<uint64_t>(kReadEdges, stop - next);
+      buffer.resize(count);
+      readEdges(fd, path, next, buffer.data(), count);
+      next += count;
+      pos = buffer.data();
+      end = pos + count;
+   }
+
+public:
+   Cursor(const std::vector<Edge> &edges, const std::string &path, uint64_t begin, uint64_t stop)
+      : path(path), next(begin), stop(stop) {
+      if (path.empty()) {
+         pos = edges.data() + begin;
+         end = edges.data() + stop;
+      } else if (begin<stop) {
+         fd = openRun(path);
+         refill();
+      }
+   }
+   ~Cursor() {
+      if (fd>=0) {
+         close(fd);
+      }
+   }
+   Cursor(Cursor &&other) noexcept
+      : pos(other.pos), end(other.end), fd(std::exchange(other.fd, -1)), path(std::move(other.path)),
+        next(other.next), stop(other.stop), buffer(std::move(other.buffer)) {}
+
+   bool valid() const { return pos != end; }
+   const Edge &operator*() const { return *pos; }
+   void advance() {
+      if (++pos == end) {
+         refill();
+      }
+   }
+};
+
+// k-way merge of the cursors into out, ties in the order of the cursors.
+void mergeCursors(std::vector<Cursor> &cursors, EdgeOrder order, const std::function<void(const Edge &)> &out) {
+   auto after = [&](size_t a, size_t b) {
+      return less(*cursors[b], *cursors[a], order) || (!less(*cursors[a], *cursors[b], order) && a>b);
+   };
+   std::priority_queue<size_t, std::vector<size_t>, decltype(after)> heap(after);
+   for (size_t i = 0; i<cursors.size(); i++) {
+      if (cursors[i].valid()) {
+         heap.push(i);
+      }
+   }
+   while (!heap.empty()) {
+      size_t i = heap.top();
+      heap.pop();
+      out(*cursors[i]);
+      cursors[i].advance();
+      if (cursors[i].valid()) {
+         heap.push(i);
+      }
+   }
+}
+
+}
+
+void sortEdges(std::vector<Edge> &edges, EdgeOrder order) {
+   if (order == EdgeOrder::StartEnd) {
+      std::sort(edges.begin(), edges.end(), [](const Edge &a, const Edge &b) {
+         return a.start != b.start ? a.start<b.start : a.end<b.end;
+      });
+   } else {
+      std::stable_sort(edges.begin(), edges.end(), [](const Edge &a, const Edge &b) { return a.start<b.start; });
+   }
+}
+
+EdgeSorter::EdgeSorter(const std::string &spill_prefix, EdgeOrder order, uint64_t memory_limit)
+   : spill_prefix(spill_prefix), order(order), memory_limit(memory_limit) {}
+
+EdgeSorter::~EdgeSorter() {
+   for (const Run &run : runs) {
+      if (!run.path.empty()) {
+         unlink(run.path.c_str());
+      }
+   }
+}
+
+uint64_t EdgeSorter::size() const {
+   uint64_t count = 0;
+   for (const Run &run : runs) {
+      count += run.size;
+   }
+   return count;
+}
+
+void EdgeSorter::add(std::vector<Edge> edges) {
+   if (edges.empty()) {
+      return;
+   }
+   uint64_t bytes = edges.size() * sizeof(Edge);
+   if (memory>0 && memory + bytes>memory_limit) {
+      spill();
+   }
+   memory += bytes;
+   uint64_t count = edges.size();
+   runs.push_back(Run{std::move(edges), "", count});
+}
+
+void EdgeSorter::spill() {
+   // The runs in memory follow all runs on disk, so the merged run takes their place in the order of the runs.
+   auto first = std::find_if(runs.begin(), runs.end(), [](const Run &run) { return run.path.empty(); });
+   std::vector<Cursor> cursors;
+   uint64_t count = 0;
+   for (auto run = first; run != runs.end(); run++) {
+      cursors.emplace_back(run->edges, run->path, 0, run->size);
+      count += run->size;
+   }
+
+   Run merged;
+   merged.path = spill_prefix + std::to_string(spill_count++) + ".tmp";
+   merged.size = count;
+   int fd = open(merged.path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+   if (fd<0) {
+      fail("create", merged.path);
+   }
+   std::vector<Edge> buffer;
+   buffer.reserve(kReadEdges);
+   auto write_buffer = [&] {
+      const char *data = reinterpret_cast<const char *>(buffer.data());
+      size_t bytes = buffer.size() * sizeof(Edge);
+      while (bytes>0) {
+         ssize_t done = write(fd, data, bytes);
+         if (done<=0) {
+            fail("write", merged.path);
+         }
+         data += done;
+         bytes -= done;
+      }
+      buffer.clear();
+   };
+   mergeCursors(cursors, order, [&](const Edge &edge) {
+      buffer.push_back(edge);
+      if (buffer.size() == kReadEdges) {
+         write_buffer();
+      }
+   });
+   write_buffer();
+   close(fd);
+
+   cursors.clear();
+   runs.erase(first, runs.end());
+   runs.push_back(std::move(merged));
+   memory = 0;
+}
+
+void EdgeSorter::merge(ThreadPool &pool, const std::function<CsvWriter(const std::vector<Edge> &)> &format,
+                       const std::function<void(CsvWriter &)> &consume) {
+   uint64_t total = size();
+   if (total == 0) {
+      return;
+   }
+
+   // Partition boundaries at the quantiles of the sampled start ids, every sample weighted by the edges it stands for.
+   uint64_t partitions = (total + kPartitionEdges - 1) / kPartitionEdges;
+   std::vector<std::pair<int64_t, double>> samples;
+   for (const Run &run : runs) {
+      int fd = run.path.empty() ? -1 : openRun(run.path);
+      uint64_t count = std::min(run.size, kSamplesPerRun);
+      for (uint64_t i = 0; i<count; i++) {
+         samples.emplace_back(startAt(run.edges, fd, run.path, i * run.size / count), double(run.size) / count);
+      }
+      if (fd>=0) {
+         close(fd);
+      }
+   }
+   std::sort(samples.begin(), samples.end());
+   std::vector<int64_t> splitters;
+   double cumulative = 0;
+   for (auto &[key, weight] : samples) {
+      cumulative += weight;
+      while (splitters.size() + 1<partitions && cumulative>=double(total) * (splitters.size() + 1) / partitions) {
+         splitters.push_back(key);
+      }
+   }
+   partitions = splitters.size() + 1;
+
+   // bounds[r][p] is the first edge of run r in partition p.
+   std::vector<std::vector<uint64_t>> bounds(runs.size());
+   for (size_t r = 0; r<runs.size(); r++) {
+      const Run &run = runs[r];
+      int fd = run.path.empty() ? -1 : openRun(run.path);
+      bounds[r].push_back(0);
+      for (int64_t splitter : splitters) {
+         bounds[r].push_back(lowerBound(run.edges, fd, run.path, run.size, splitter));
+      }
+      bounds[r].push_back(run.size);
+      if (fd>=0) {
+         close(fd);
+      }
+   }
+
+   pool.orderedFor<CsvWriter>(0, partitions, 2 * pool.size(), [&](uint64_t p) {
+      std::vector<Cursor> cursors;
+      uint64_t count = 0;
+      for (size_t r = 0; r<runs.size(); r++) {
+         cursors.emplace_back(runs[r].edges, runs[r].path, bounds[r][p], bounds[r][p + 1]);
+         count += bounds[r][p + 1] - bounds[r][p];
+      }
+      std::vector<Edge> edges;
+      edges.reserve(count);
+      mergeCursors(cursors, order, [&](const Edge &edge) { edges.push_back(edge); });
+      return format(edges);
+   }, [&](uint64_t, CsvWriter &rows) {
+      consume(rows);
+   });
+}
+
+}
@@ -0,0 +1,77 @@
+/*
+ * The implementation of the GTPC graph data generator was built on
+ * Florian Wolf's implementation of the CH-benCHmark data generator
+ * (https://db.in.tum.de/research/projects/CHbenCHmark/) and
+ * Alexander van Renen's implementation of the TPC-C data generator
+ * (https://github.com/alexandervanrenen/tpcc-generator)
+ * See the README file.
+ */
+
+#ifndef edge_sorter_hpp_
+#define edge_sorter_hpp_
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "csv_writer.hpp"
+
+class ThreadPool;
+
+namespace csv {
+
+// Order of the rows of the relationship files.
+enum class EdgeOrder {
+   Generation,  // as generated, grouped by the node the generator iterates over
+   Start,       // by start node, relationships of the same start node in generation order
+   StartEnd     // by start node, then by end node
+};
+
+struct Edge {
+   int64_t start;
+   int64_t end;
+};
+
+// Sorts one run in place.
+void sortEdges(std::vector<Edge> &edges, EdgeOrder order);
+
+// External merge sort of the relationships of one table with bounded memory. The generator threads sort the rows of
+// every warehouse on their own (sortEdges), add() collects these runs and, once they exceed the memory limit, merges
+// them into one run on disk. merge() splits the key range at sampled start ids into partitions of about the same
+// size and merges every partition from all runs on its own thread, so a start node never spans two partitions. Ties
+// are broken by the order in which the runs were added, which makes the output independent of the number of threads
+// and of the memory limit.
+class EdgeSorter {
+   struct Run {
+      std::vector<Edge> edges;  // empty if the run is on disk
+      std::string path;
+      uint64_t size = 0;
+   };
+
+   const std::string spill_prefix;
+   const EdgeOrder order;
+   const uint64_t memory_limit;
+   std::vector<Run> runs;
+   uint64_t memory = 0;
+   uint64_t spill_count = 0;
+
+   void spill();
+
+public:
+   // Runs that do not fit into memory_limit bytes are written to <spill_prefix><n>.tmp.
+   EdgeSorter(const std::string &spill_prefix, EdgeOrder order, uint64_t memory_limit);
+   ~EdgeSorter();
+
+   // Adds a run sorted by sortEdges().
+   void add(std::vector<Edge> edges);
+   uint64_t size() const;
+   // Merges all runs with the threads of pool. format(edges) turns a partition into rows on the merging thread,
+   // consume(rows) receives them in order.
+   void merge(ThreadPool &pool, const std::function<CsvWriter(const std::vector<Edge> &)> &format,
+              const std::function<void(CsvWriter &)> &consume);
+};
+
+}
+
+#endif
@@ -10,47 +10,313 @@
 #include "generator.hpp"
 #include "csv_writer.hpp"
 #include "data_source.hpp"
+#include "instrumentation.hpp"
+#include "string_kernel.hpp"
+#include "table_writer.hpp"
+#include "thread_pool.hpp"
 
 #include <algorithm>
 #include <array>
 #include <chrono>
 #include <cassert>
 #include <cstring>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <sstream>
+#include <tuple>
+
+namespace {
+
+// @formatter:off
+const csv::Table kWarehouse = {"warehouse", "id|name|street_1|street_2|city|state|zip|tax|ytd",
+   "id:ID(Warehouse)|name|street_1|street_2|city|state|zip|tax:float|ytd:float|:LABEL", "Warehouse", false};
+const csv::Table kDistrict = {"district", "id|name|street_1|street_2|city|state|zip|tax|ytd|next_o_id",
+   "id:ID(District)|name|street_1|street_2|city|state|zip|tax:float|ytd:float|next_o_id:long|:LABEL", "District", false};
+const csv::Table kCovers = {"warehouse_covers_district", "Warehouse_id|District_id",
+   ":START_ID(Warehouse)|:END_ID(District)|:TYPE", "covers", true};
+const csv::Table kCustomer = {"customer",
+   "id|first|middle|last|street_1|street_2|city|state|zip|phone|since|"
+   "credit|credit_lim|discount|balance|ytd_payment|payment_cnt|delivery_cnt|data|"
+   "history_date|history_amount|history_data",
+   "id:ID(Customer)|first|middle|last|street_1|street_2|city|state|zip|phone|since:datetime|"
+   "credit|credit_lim:float|discount:float|balance:float|ytd_payment:float|payment_cnt:long|delivery_cnt:long|data|"
+   "history_date:datetime|history_amount:float|history_data|:LABEL", "Customer", false};
+const csv::Table kServes = {"district_serves_customer", "District_id|Customer_id",
+   ":START_ID(District)|:END_ID(Customer)|:TYPE", "serves", true};
+const csv::Table kCustomerIsLocatedIn = {"customer_isLocatedIn_nation", "Customer_id|Nation_id",
+   ":START_ID(Customer)|:END_ID(Nation)|:TYPE", "isLocatedIn", true};
+const csv::Table kItem = {"item", "id|im_id|name|price|data",
+   "id:ID(Item)|im_id:long|name|price:float|data|:LABEL", "Item", false};
+const csv::Table kStock = {"stock",
+   "id|quantity|dist_01|dist_02|dist_03|dist_04|dist_05|dist_06|dist_07|dist_08|dist_09|"
+   "dist_10|ytd|order_cnt|remote_cnt|data",
+   "id:ID(Stock)|quantity:long|dist_01|dist_02|dist_03|dist_04|dist_05|dist_06|dist_07|dist_08|dist_09|"
+   "dist_10|ytd:long|order_cnt:long|remote_cnt:long|data|:LABEL", "Stock", false};
+const csv::Table kWarehouseHasStock = {"warehouse_hasStock_stock", "Warehouse_id|Stock_id",
+   ":START_ID(Warehouse)|:END_ID(Stock)|:TYPE", "hasStock", true};
+const csv::Table kItemHasStock = {"item_hasStock_stock", "Item_id|Stock_id",
+   ":START_ID(Item)|:END_ID(Stock)|:TYPE", "hasStock", true, true};
+const csv::Table kHasSupplier = {"stock_hasSupplier_supplier", "Stock_id|Supplier_id",
+   ":START_ID(Stock)|:END_ID(Supplier)|:TYPE", "hasSupplier", true};
+const csv::Table kOrder = {"order", "id|entry_d|carrier_id|ol_cnt|all_local|new_order",
+   "id:ID(Order)|entry_d:datetime|carrier_id:long|ol_cnt:long|all_local:long|new_order:long|:LABEL", "Order", false};
+const csv::Table kOrderLine = {"orderLine", "id|number|delivery_d|quantity|amount|dist_info",
+   "id:ID(OrderLine)|number:long|delivery_d:datetime|quantity:long|amount:float|dist_info|:LABEL", "OrderLine", false};
+const csv::Table kHasPlaced = {"customer_hasPlaced_order", "Customer_id|Order_id",
+   ":START_ID(Customer)|:END_ID(Order)|:TYPE", "hasPlaced", true, true};
+const csv::Table kOrderLineHasStock = {"orderLine_hasStock_stock", "OrderLine_id|Stock_id",
+   ":START_ID(OrderLine)|:END_ID(Stock)|:TYPE", "hasStock", true};
+const csv::Table kContains = {"order_contains_orderLine", "Order_id|OrderLine_id",
+   ":START_ID(Order)|:END_ID(OrderLine)|:TYPE", "contains", true};
+const csv::Table kRegion = {"region", "id|name|comment",
+   "id:ID(Region)|name|comment|:LABEL", "Region", false};
+const csv::Table kNation = {"nation", "id|name|comment",
+   "id:ID(Nation)|name|comment|:LABEL", "Nation", false};
+const csv::Table kIsPartOf = {"nation_isPartOf_region", "Nation_id|Region_id",
+   ":START_ID(Nation)|:END_ID(Region)|:TYPE", "isPartOf", true};
+const csv::Table kSupplier = {"supplier", "id|name|address|phone|acctbal|comment",
+   "id:ID(Supplier)|name|address|phone|acctbal:float|comment|:LABEL", "Supplier", false};
+const csv::Table kSupplierIsLocatedIn = {"supplier_isLocatedIn_nation", "Supplier_id|Nation_id",
+   ":START_ID(Supplier)|:END_ID(Nation)|:TYPE", "isLocatedIn", true};
+// @formatter:on
+
+const csv::Table *const kTables[] = {
+   &kWarehouse, &kDistrict, &kCovers, &kCustomer, &kServes, &kCustomerIsLocatedIn, &kItem, &kStock,
+   &kWarehouseHasStock, &kItemHasStock, &kHasSupplier, &kOrder, &kOrderLine, &kHasPlaced, &kOrderLineHasStock,
+   &kContains, &kRegion, &kNation, &kIsPartOf, &kSupplier, &kSupplierIsLocatedIn
+};
+// The tables of a delta, without the ones shared by all warehouses.
+const csv::Table *const kWarehouseTables[] = {
+   &kWarehouse, &kDistrict, &kCovers, &kCustomer, &kServes, &kCustomerIsLocatedIn, &kStock, &kWarehouseHasStock,
+   &kItemHasStock, &kHasSupplier, &kOrder, &kOrderLine, &kHasPlaced, &kOrderLineHasStock, &kContains
+};
 
-GtpcGenerator::GtpcGenerator(int64_t warehouse_count, const std::string &folder)
-   : warehouse_count(warehouse_count), folder(folder), post_fix("_0_0.csv"), ranny(42) {
 }
 
-void GtpcGenerator::generateItems() {
-   std::cout << "Generating 'Item' node objects .. " << std::flush;
-   std::string header_i = "id|im_id|name|price|data";
+GtpcGenerator::GtpcGenerator(int64_t warehouse_count, const std::string &folder, uint32_t thread_count)
+   : warehouse_count(warehouse_count), thread_count(std::max<uint32_t>(thread_count, 1)),
+     order_numbering(ids::OrderNumbering::District), first_warehouse(1), last_warehouse(warehouse_count),
+     segment_first(1), seed(42), legacy_dates(false), legacy_strings(false), legacy_rng(false),
+     pool(std::make_unique<ThreadPool>(this->thread_count)) {
+   layout.folder = folder;
+}
 
-   int64_t i_id;
-   std::array<char, 24> i_name = {};
-   float i_price;
-   std::array<char, 50> i_data = {};
-   uint32_t i_data_size;
-   std::vector<bool> orig(kItemCount, false);
-   int64_t i_im_id;
+GtpcGenerator::~GtpcGenerator() = default;
+
+void GtpcGenerator::setTextPool(uint64_t size, const std::string &path) {
+   if (size == 0) {
+      text_pool.reset();
+   } else if (path.empty()) {
+      text_pool = rng::TextPool::generate(seed, static_cast<uint32_t>(Stream::TextPool), size, *pool);
+   } else {
+      text_pool = rng::TextPool::load(path, seed, static_cast<uint32_t>(Stream::TextPool), size, *pool);
+   }
+   DataSource::setTextPool(text_pool.get());
+}
 
-   csv::CsvWriter i_csv(folder + "/item" + post_fix);
-   i_csv << header_i << csv::endl;
+void GtpcGenerator::setWarehouseRange(int64_t first, int64_t last, uint32_t part) {
+   assert(1<=first && first<=last && last<=warehouse_count);
+   first_warehouse = first;
+   last_warehouse = last;
+   layout.part = part;
+   layout.write_headers = writesSharedTables();
+}
+
+void GtpcGenerator::setAppend(int64_t first) {
+   assert(1<first && first<=warehouse_count);
+   first_warehouse = first;
+   last_warehouse = warehouse_count;
+   segment_first = first;
+   layout.part = first;
+   layout.delta = true;
+   layout.write_headers = true;
+}
+
+void GtpcGenerator::setOutputFormat(csv::Format format, uint64_t chunk_warehouses) {
+   layout.format = format;
+   layout.chunk_warehouses = chunk_warehouses;
+}
+
+void GtpcGenerator::setEdgeOrder(csv::EdgeOrder order, bool grouped, uint64_t sort_memory) {
+   layout.edge_order = order;
+   layout.grouped = grouped;
+   layout.sort_memory = sort_memory;
+   layout.pool = pool.get();
+}
+
+void GtpcGenerator::setIdLayout(ids::Space space, ids::OrderNumbering numbering) {
+   ids = ids::IdLayout(space, warehouse_count);
+   order_numbering = numbering;
+}
+
+void GtpcGenerator::writeImportArguments() {
+   if (layout.delta) {
+      csv::writeImportArguments(layout, kWarehouseTables, sizeof(kWarehouseTables) / sizeof(kWarehouseTables[0]));
+   } else {
+      csv::writeImportArguments(layout, kTables, sizeof(kTables) / sizeof(kTables[0]));
+   }
+}
+
+void GtpcGenerator::writeManifest() {
+   if (orderline_offsets.empty()) {
+      orderline_offsets = makeOrderLineOffsets();
+   }
+   // First and last id per label; with the clustered id space the ranges of the labels interleave.
+   int64_t customers = kDistrictsPerWarehouse * kCustomerPerDistrict;
+   auto range = [&](const char *name, ids::Label label, int64_t first, int64_t last) {
+      return std::make_tuple(name, ids.id(label, first), ids.id(label, last));
+   };
+   std::vector<std::tuple<const char *, int64_t, int64_t>> ranges = {
+      range("Warehouse", ids::Label::Warehouse, first_warehouse, last_warehouse),
+      range("District", ids::Label::District, (first_warehouse - 1) * kDistrictsPerWarehouse + 1,
+            last_warehouse * kDistrictsPerWarehouse),
+      range("Customer", ids::Label::Customer, (first_warehouse - 1) * customers + 1, last_warehouse * customers),
+      range("Stock", ids::Label::Stock, (first_warehouse - 1) * kItemCount + 1, last_warehouse * kItemCount),
+      range("Order", ids::Label::Order, (first_warehouse - 1) * customers + 1, last_warehouse * customers),
+      {"OrderLine", ids.orderLine(first_warehouse, 1, orderline_offsets[first_warehouse] + 1),
+       ids.orderLine(last_warehouse, orderline_offsets[last_warehouse + 1] - orderline_offsets[last_warehouse],
+                     orderline_offsets[last_warehouse + 1])},
+   };
+   if (writesSharedTables()) {
+      int64_t first_nation = DataSource::getNation(0).id;
+      int64_t last_nation = first_nation;
+      for (uint32_t n = 1; n<NationCount; n++) {
+         first_nation = std::min<int64_t>(first_nation, DataSource::getNation(n).id);
+         last_nation = std::max<int64_t>(last_nation, DataSource::getNation(n).id);
+      }
+      ranges.push_back(range("Item", ids::Label::Item, 1, kItemCount));
+      ranges.push_back(range("Supplier", ids::Label::Supplier, 1, SupplierCount));
+      ranges.push_back(range("Region", ids::Label::Region, 0, RegionCount - 1));
+      ranges.push_back(range("Nation", ids::Label::Nation, first_nation, last_nation));
+   }
 
+   std::ostringstream path;
+   path << layout.folder << "/manifest_" << first_warehouse << "_" << last_warehouse << ".json";
+   std::ofstream manifest(path.str());
+   manifest << "{\n";
+   manifest << "  \"seed\": " << seed << ",\n";
+   manifest << "  \"warehouses\": " << warehouse_count << ",\n";
+   manifest << "  \"first_warehouse\": " << first_warehouse << ",\n";
+   manifest << "  \"last_warehouse\": " << last_warehouse << ",\n";
+   manifest << "  \"delta\": " << (layout.delta ? "true" : "false") << ",\n";
+   manifest << "  \"customer_permutation\": [" << segment_first << ", " << warehouse_count << "],\n";
+   manifest << "  \"id_space\": \"" << ids::spaceName(ids.getSpace()) << "\",\n";
+   manifest << "  \"order_ids\": \"" << ids::orderNumberingName(order_numbering) << "\",\n";
+   manifest << "  \"nodes\": {";
+   std::cout << "--------- Node ids:";
+   for (size_t i = 0; i<ranges.size(); i++) {
+      auto &[label, first, last] = ranges[i];
+      manifest << (i>0 ? "," : "") << "\n    \"" << label << "\": [" << first << ", " << last << "]";
+      std::cout << (i>0 ? "," : "") << " " << label << " " << first << "-" << last;
+   }
+   std::cout << std::endl;
+   manifest << "\n  },\n";
+   manifest << "  \"rows\": {";
+   bool first_table = true;
+   for (const stats::PhaseStats &phase : stats::Recorder::instance().getPhases()) {
+      for (const stats::TableStats &table : phase.tables) {
+         manifest << (first_table ? "" : ",") << "\n    \"" << table.name << "\": " << table.rows;
+         first_table = false;
+      }
+   }
+   manifest << "\n  }\n}\n";
+   if (!manifest) {
+      std::cout << "\nCannot write file: '" << path.str() << "'." << std::endl;
+      std::cout << "aborting..." << std::endl;
+      exit(-1);
+   }
+}
+
+GtpcGenerator::RandomEngine GtpcGenerator::makeEngine(Stream stream, int64_t warehouse, int64_t row) const {
+   return RandomEngine(seed, static_cast<uint32_t>(stream), warehouse, row,
+                       legacy_rng ? rng::UniformMethod::Modulo : rng::UniformMethod::MultiplyShift);
+}
+
+rng::Sample GtpcGenerator::makeOriginalSample(int64_t warehouse) const {
+   return rng::Sample(seed, static_cast<uint32_t>(Stream::Original), static_cast<uint32_t>(warehouse), kItemCount,
+                      kItemCount / 10);
+}
+
+// The selection of the original generator: kItemCount / 10 distinct indexes drawn with rejection, which are then read
+// with the 1-based ids (so index 0 is never used). The extra entry keeps the read of id kItemCount in bounds.
+std::vector<bool> GtpcGenerator::makeLegacyOriginals(RandomEngine &ranny) {
+   std::vector<bool> orig(kItemCount + 1, false);
    for (uint32_t i = 0; i<kItemCount / 10; i++) {
       uint32_t pos;
       do {
-         pos = makeNumber(0L, kItemCount - 1);
+         pos = makeNumber(ranny, kItemIndexes);
       } while (orig[pos]);
       orig[pos] = true;
    }
+   return orig;
+}
+
+// Each customer has exactly one order. Order i of the segment starting at segment_first (see setAppend) is placed by
+// customer customers(i - 1) + 1 of that segment; the segments after the first use their own stream.
+rng::Permutation GtpcGenerator::makeCustomerPermutation() const {
+   return rng::Permutation(seed, static_cast<uint32_t>(Stream::CustomerPermutation),
+                           (warehouse_count - segment_first + 1) * kDistrictsPerWarehouse * kCustomerPerDistrict,
+                           static_cast<uint32_t>(segment_first - 1));
+}
+
+std::pair<int64_t, int64_t> GtpcGenerator::locateOrder(const rng::Permutation &customers, int64_t warehouse,
+                                                       int64_t index) const {
+   // Warehouses before an appended segment keep the numbering of their own run, only their total matters here.
+   if (order_numbering == ids::OrderNumbering::District || warehouse<segment_first) {
+      return {warehouse, index};
+   }
+   int64_t per_warehouse = kDistrictsPerWarehouse * kCustomerPerDistrict;
+   int64_t segment_base = (segment_first - 1) * per_warehouse;
+   int64_t order = segment_base + customers.inverse((warehouse - 1) * per_warehouse + index - 1 - segment_base);
+   return {order / per_warehouse + 1, order % per_warehouse + 1};
+}
+
+// Order lines are numbered consecutively across all warehouses, so the first order line id of a warehouse depends on
+// the order line counts of all warehouses before it. The counts come from their own per-order stream and can be
+// summed up front without generating the orders themselves.
+std::vector<int64_t> GtpcGenerator::makeOrderLineOffsets() {
+   std::vector<int64_t> offsets(last_warehouse + 2, 0);
+   rng::Permutation customers = makeCustomerPermutation();
+   pool->orderedFor<int64_t>(1, last_warehouse + 1, 2 * thread_count, [&](uint64_t w_id) {
+      int64_t count = 0;
+      for (uint32_t index = 1; index<=kDistrictsPerWarehouse * kCustomerPerDistrict; index++) {
+         auto [o_w_id, row] = locateOrder(customers, w_id, index);
+         RandomEngine ranny = makeEngine(Stream::OrderLineCount, o_w_id, row);
+         count += makeNumber(ranny, kOrderLineCounts);
+      }
+      return count;
+   }, [&](uint64_t w_id, int64_t &count) {
+      offsets[w_id + 1] = offsets[w_id] + count;
+   });
+   return offsets;
+}
+
+void GtpcGenerator::generateItems() {
+   stats::Phase phase("item", "Generating 'Item' node objects .. ", 1);
+
+   int64_t i_id;
+   std::array<char, 24> i_name = {};
+   float i_price;
+   std::array<char, 50> i_data = {};
+   uint32_t i_data_size;
+   int64_t i_im_id;
+   RandomEngine ranny = makeEngine(Stream::Item, 0, 0);
+   rng::Sample originals = makeOriginalSample(0);
+   std::vector<bool> legacy_orig = legacy_rng ? makeLegacyOriginals(ranny) : std::vector<bool>();
 
+   csv::TableWriter i_table(layout, kItem);
+   csv::CsvWriter &i_csv = i_table.csv();
+
+   stats::Laps laps;
    for (i_id = 1; i_id<=kItemCount; i_id++) {
-      makeAlphaString(14, 24, i_name.data());
-      i_price = ((float) makeNumber(100L, 10000L)) / 100.0f;
-      i_data_size = makeAlphaString(26, 50, i_data.data());
-      i_im_id = makeNumber(0, 10000);
-      if (orig[i_id]) {
-         uint32_t pos = makeNumber(0L, i_data_size - 8);
+      ranny = makeEngine(Stream::Item, 0, i_id);
+      makeAlphaString(ranny, 14, 24, i_name.data());
+      i_price = ((float) makeNumber(ranny, 100L, 10000L)) / 100.0f;
+      i_data_size = makeAlphaString(ranny, 26, 50, i_data.data());
+      i_im_id = makeNumber(ranny, 0, 10000);
+      if (legacy_rng ? legacy_orig[i_id] : originals.contains(i_id - 1)) {
+         uint32_t pos = makeNumber(ranny, 0L, i_data_size - 8);
          i_data[pos] = 'o';
          i_data[pos + 1] = 'r';
          i_data[pos + 2] = 'i';
@@ -61,247 +327,264 @@ void GtpcGenerator::generateItems() {
          i_data[pos + 7] = 'l';
       }
 
+      laps.random(kItem.name);
+
       // @formatter:off
-      i_csv << i_id << i_im_id << i_name << csv::Precision(2) << i_price << i_data << csv::endl;
+      i_csv << ids.id(ids::Label::Item, i_id) << i_im_id << i_name << csv::Precision(2) << i_price << i_data
+            << csv::endl;
       // @formatter:on
+      laps.format(kItem.name);
    }
-
-   std::cout << "done." << std::endl;
 }
 
 void GtpcGenerator::generateWarehouses() {
-   std::cout << "Generating 'Warehouse' node objects .. " << std::flush;
-   std::string header_w = "id|name|street_1|street_2|city|state|zip|tax|ytd";
-
-   int64_t w_id;
-   std::array<char, 10> w_name = {};
-   std::array<char, 20> w_street_1 = {};
-   std::array<char, 20> w_street_2 = {};
-   std::array<char, 20> w_city = {};
-   std::array<char, 2> w_state = {};
-   std::array<char, 9> w_zip = {};
-   float w_tax;
-   float w_ytd;
-
-   csv::CsvWriter w_csv(folder + "/warehouse" + post_fix);
-   w_csv << header_w << csv::endl;
-
-   for (w_id = 1L; w_id<=warehouse_count; w_id++) {
-      makeAlphaString(6, 10, w_name.data());
-      makeAddress(w_street_1.data(), w_street_2.data(), w_city.data(), w_state.data(), w_zip.data());
-      w_tax = ((float) makeNumber(10L, 20L)) / 100.0f;
+   stats::Phase phase("warehouse", "Generating 'Warehouse' node objects .. ",
+                      last_warehouse - first_warehouse + 1);
+
+   csv::TableWriter w_table(layout, kWarehouse);
+
+   using Chunk = std::array<csv::CsvWriter, 1>;
+   pool->orderedFor<Chunk>(first_warehouse, last_warehouse + 1, 2 * thread_count, [&](uint64_t w_id) {
+      std::array<char, 10> w_name = {};
+      std::array<char, 20> w_street_1 = {};
+      std::array<char, 20> w_street_2 = {};
+      std::array<char, 20> w_city = {};
+      std::array<char, 2> w_state = {};
+      std::array<char, 9> w_zip = {};
+      float w_tax;
+      float w_ytd;
+      RandomEngine ranny = makeEngine(Stream::Warehouse, w_id, 1);
+      stats::Laps laps;
+
+      Chunk chunk = {w_table.makeChunk()};
+      auto &[w_chunk] = chunk;
+
+      makeAlphaString(ranny, 6, 10, w_name.data());
+      makeAddress(ranny, w_street_1.data(), w_street_2.data(), w_city.data(), w_state.data(), w_zip.data());
+      w_tax = ((float) makeNumber(ranny, 10L, 20L)) / 100.0f;
       w_ytd = 3000000.00f;
+      laps.random(kWarehouse.name);
 
       // @formatter:off
-      w_csv << w_id << w_name << w_street_1 << w_street_2 << w_city << w_state << w_zip << csv::Precision(4)
-            << w_tax << csv::Precision(2) << w_ytd << csv::endl;
+      w_chunk << ids.id(ids::Label::Warehouse, w_id) << w_name << w_street_1 << w_street_2 << w_city << w_state
+              << w_zip << csv::Precision(4) << w_tax << csv::Precision(2) << w_ytd << csv::endl;
       // @formatter:on
-   }
-
-   std::cout << "done." << std::endl;
+      laps.format(kWarehouse.name);
+      return chunk;
+   }, [&](uint64_t w_id, Chunk &chunk) {
+      w_table.append(w_id - first_warehouse, chunk[0]);
+      stats::Recorder::instance().advance();
+   });
 }
 
 void GtpcGenerator::generateDistricts() {
-   std::cout << "Generating 'District' node objects and ':covers' relationship objects .. " << std::flush;
-   std::string header_d = "id|name|street_1|street_2|city|state|zip|tax|ytd|next_o_id";
-   std::string header_covers = "Warehouse_id|District_id";
-
-   int64_t d_id;
-   int64_t d_w_id;
-   std::array<char, 10> d_name = {};
-   std::array<char, 20> d_street_1 = {};
-   std::array<char, 20> d_street_2 = {};
-   std::array<char, 20> d_city = {};
-   std::array<char, 2> d_state = {};
-   std::array<char, 9> d_zip = {};
-   float d_tax;
-   float d_ytd;
-   int64_t d_next_o_id;
-
-   csv::CsvWriter d_csv(folder + "/district" + post_fix);
-   csv::CsvWriter covers_csv(folder + "/warehouse_covers_district" + post_fix);
-   d_csv << header_d << csv::endl;
-   covers_csv << header_covers << csv::endl;
+   stats::Phase phase("district", "Generating 'District' node objects and ':covers' relationship objects .. ",
+                      last_warehouse - first_warehouse + 1);
+
+   csv::TableWriter d_table(layout, kDistrict);
+   csv::TableWriter covers_table(layout, kCovers);
 
    // Each warehouse has DIST_PER_WARE (10) districts
-   int64_t id = 0;
-   for (d_w_id = 1; d_w_id<=warehouse_count; d_w_id++) {
+   using Chunk = std::array<csv::CsvWriter, 2>;
+   pool->orderedFor<Chunk>(first_warehouse, last_warehouse + 1, 2 * thread_count, [&](uint64_t w_id) {
+      int64_t d_id;
+      int64_t d_w_id = w_id;
+      std::array<char, 10> d_name = {};
+      std::array<char, 20> d_street_1 = {};
+      std::array<char, 20> d_street_2 = {};
+      std::array<char, 20> d_city = {};
+      std::array<char, 2> d_state = {};
+      std::array<char, 9> d_zip = {};
+      float d_tax;
+      float d_ytd;
+      int64_t d_next_o_id;
+
+      Chunk chunk = {d_table.makeChunk(), covers_table.makeChunk()};
+      auto &[d_chunk, covers_chunk] = chunk;
+
+      stats::Laps laps;
+      int64_t id = (d_w_id - 1) * kDistrictsPerWarehouse;
       for (d_id = 1; d_id<=kDistrictsPerWarehouse; d_id++) {
          id++;
+         int64_t district = ids.id(ids::Label::District, id);
+         RandomEngine ranny = makeEngine(Stream::District, w_id, d_id);
          d_ytd = 30000.0;
          d_next_o_id = 3001L;
-         makeAlphaString(6L, 10L, d_name.data());
-         makeAddress(d_street_1.data(), d_street_2.data(), d_city.data(), d_state.data(), d_zip.data());
-         d_tax = ((float) makeNumber(10L, 20L)) / 100.0f;
+         makeAlphaString(ranny, 6L, 10L, d_name.data());
+         makeAddress(ranny, d_street_1.data(), d_street_2.data(), d_city.data(), d_state.data(), d_zip.data());
+         d_tax = ((float) makeNumber(ranny, 10L, 20L)) / 100.0f;
+         laps.random(kDistrict.name);
 
          // @formatter:off
-         d_csv << id /*<< d_w_id*/ << d_name << d_street_1 << d_street_2 << d_city << d_state << d_zip << csv::Precision(4)
-               << d_tax << csv::Precision(2) << d_ytd << d_next_o_id << csv::endl;
-         covers_csv << d_w_id << id << csv::endl;
+         d_chunk << district /*<< d_w_id*/ << d_name << d_street_1 << d_street_2 << d_city << d_state << d_zip << csv::Precision(4)
+                 << d_tax << csv::Precision(2) << d_ytd << d_next_o_id << csv::endl;
+         laps.format(kDistrict.name);
+         covers_chunk << ids.id(ids::Label::Warehouse, d_w_id) << district << csv::endl;
          // @formatter:on
+         laps.format(kCovers.name);
       }
-   }
-
-   std::cout << "done." << std::endl;
+      covers_table.seal(chunk[1]);
+      return chunk;
+   }, [&](uint64_t w_id, Chunk &chunk) {
+      d_table.append(w_id - first_warehouse, chunk[0]);
+      covers_table.append(w_id - first_warehouse, chunk[1]);
+      stats::Recorder::instance().advance();
+   });
 }
 
 void GtpcGenerator::generateCustomerAndHistory() {
-   std::cout << "Generating 'Customer' node objects and ':serves', ':cIsLocatedIn' relationship objects .. " << std::flush;
-   std::string header_c = "id|first|middle|last|street_1|street_2|city|state|zip|phone|since|"
-                        "credit|credit_lim|discount|balance|ytd_payment|payment_cnt|delivery_cnt|data|"
-                        "history_date|history_amount|history_data";
-   std::string header_serves = "District_id|Customer_id";
-   std::string header_isLocatedIn = "Customer_id|Nation_id";
-
-   int64_t c_id;
-   int64_t c_d_id;
-   int64_t c_w_id;
-   std::array<char, 16> c_first = {};
-   std::array<char, 2> c_middle = {};
-   std::array<char, 16> c_last = {};
-   std::array<char, 20> c_street_1 = {};
-   std::array<char, 20> c_street_2 = {};
-   std::array<char, 20> c_city = {};
-   std::array<char, 2> c_state = {};
-   std::array<char, 9> c_zip = {};
-   std::array<char, 16> c_phone = {};
-   // std::array<char, 15> c_since = {}; // XXX used in history and customer and generated over and over again
-   std::array<char, 28> c_since = {}; // XXX used in history and customer and generated over and over again
-   std::array<char, 2> c_credit = {};
-   float c_credit_lim;
-   float c_discount;
-   float c_balance;
-   std::array<char, 500> c_data = {};
-   std::array<char, 28> h_date = {};
-   float h_amount;
-   std::array<char, 24> h_data = {};
-
-   csv::CsvWriter c_csv(folder + "/customer" + post_fix);
-   // csv::CsvWriter h_csv(folder + "/history" + post_fix);
-   csv::CsvWriter serves_csv(folder + "/district_serves_customer" + post_fix);
-   csv::CsvWriter isLocatedIn_csv(folder + "/customer_isLocatedIn_nation" + post_fix);
-   c_csv << header_c << csv::endl;
-   serves_csv << header_serves << csv::endl;
-   isLocatedIn_csv << header_isLocatedIn << csv::endl;
+   stats::Phase phase("customer", "Generating 'Customer' node objects and ':serves', ':cIsLocatedIn' relationship objects .. ",
+                      last_warehouse - first_warehouse + 1);
 
-   // Each warehouse has DIST_PER_WARE (10) districts
-   int64_t id1 = 0;
-   int64_t id2 = 0;
-   for (c_w_id = 1; c_w_id<=warehouse_count; c_w_id++) {
+   csv::TableWriter c_table(layout, kCustomer);
+   // csv::CsvWriter h_csv(folder + "/history" + post_fix);
+   csv::TableWriter serves_table(layout, kServes);
+   csv::TableWriter isLocatedIn_table(layout, kCustomerIsLocatedIn);
+
+   using Chunk = std::array<csv::CsvWriter, 3>;
+   pool->orderedFor<Chunk>(first_warehouse, last_warehouse + 1, 2 * thread_count, [&](uint64_t w_id) {
+      int64_t c_id;
+      int64_t c_d_id;
+      int64_t c_w_id = w_id;
+      std::array<char, 16> c_first = {};
+      std::array<char, 2> c_middle = {};
+      std::array<char, 16> c_last = {};
+      std::array<char, 20> c_street_1 = {};
+      std::array<char, 20> c_street_2 = {};
+      std::array<char, 20> c_city = {};
+      std::array<char, 2> c_state = {};
+      std::array<char, 9> c_zip = {};
+      std::array<char, 16> c_phone = {};
+      // std::array<char, 15> c_since = {}; // XXX used in history and customer and generated over and over again
+      csv::Timestamp c_since; // XXX used in history and customer and generated over and over again
+      std::array<char, 2> c_credit = {};
+      float c_credit_lim;
+      float c_discount;
+      float c_balance;
+      std::array<char, 500> c_data = {};
+      csv::Timestamp h_date;
+      float h_amount;
+      std::array<char, 24> h_data = {};
+
+      Chunk chunk = {c_table.makeChunk(), serves_table.makeChunk(), isLocatedIn_table.makeChunk()};
+      auto &[c_chunk, serves_chunk, isLocatedIn_chunk] = chunk;
+
+      stats::Laps laps;
+      // Each warehouse has DIST_PER_WARE (10) districts
+      int64_t id1 = (c_w_id - 1) * kDistrictsPerWarehouse;
+      int64_t id2 = id1 * kCustomerPerDistrict;
       for (c_d_id = 1; c_d_id<=kDistrictsPerWarehouse; c_d_id++) {
          id1++;
+         int64_t district = ids.id(ids::Label::District, id1);
          for (c_id = 1; c_id<=kCustomerPerDistrict; c_id++) {
             id2++;
-            makeAlphaString(8, 16, c_first.data());
+            int64_t customer = ids.id(ids::Label::Customer, id2);
+            RandomEngine ranny = makeEngine(Stream::Customer, w_id, (c_d_id - 1) * kCustomerPerDistrict + c_id);
+            makeAlphaString(ranny, 8, 16, c_first.data());
             c_middle[0] = 'O';
             c_middle[1] = 'E';
             if (c_id<=1000)
                makeLastName(c_id - 1, c_last.data());
             else
-               makeLastName(makeNonUniformRandom(255, 0, 999), c_last.data());
-            makeAddress(c_street_1.data(), c_street_2.data(), c_city.data(), c_state.data(), c_zip.data());
-            makeNumberString(16, 16, c_phone.data());
-            c_credit[0] = makeNumber(0L, 1L) == 0 ? 'G' : 'B';
+               makeLastName(makeNonUniformRandom(ranny, 255, 0, 999), c_last.data());
+            makeAddress(ranny, c_street_1.data(), c_street_2.data(), c_city.data(), c_state.data(), c_zip.data());
+            makeNumberString(ranny, 16, 16, c_phone.data());
+            c_credit[0] = makeNumber(ranny, 0L, 1L) == 0 ? 'G' : 'B';
             c_credit[1] = 'C';
             c_credit_lim = 50000;
-            c_discount = ((float) makeNumber(0L, 50L)) / 100.0f;
+            c_discount = ((float) makeNumber(ranny, 0L, 50L)) / 100.0f;
             c_balance = -10.0f;
             // makeNow(c_since.data());
-            makeDate(1993, 2012, c_since.data());
-            makeAlphaString(300, 500, c_data.data());
+            c_since = makeDate(ranny, kSinceYears);
+            makeText(ranny, 300, 500, c_data.data());
 
-            makeDate(2012, 2012, h_date.data());
+            h_date = makeDate(ranny, kHistoryYears);
             h_amount = 10.0;
-            makeAlphaString(12, 24, h_data.data());
+            makeAlphaString(ranny, 12, 24, h_data.data());
 
             char n_char = *c_state.data();
             int64_t nid = (int64_t)n_char;
+            laps.random(kCustomer.name);
 
             // @formatter:off
-            c_csv << id2 /*<< c_d_id << c_w_id*/ << c_first << c_middle << c_last << c_street_1 << c_street_2 << c_city
-                  << c_state << c_zip << c_phone << c_since << c_credit << csv::Precision(2) << c_credit_lim
-                  << csv::Precision(4) << c_discount << csv::Precision(2) << c_balance << 10.0f << int64_t(1)
-                  << int64_t(0) << c_data << h_date << h_amount << h_data << csv::endl;
+            c_chunk << customer /*<< c_d_id << c_w_id*/ << c_first << c_middle << c_last << c_street_1 << c_street_2 << c_city
+                    << c_state << c_zip << c_phone << c_since << c_credit << csv::Precision(2) << c_credit_lim
+                    << csv::Precision(4) << c_discount << csv::Precision(2) << c_balance << 10.0f << int64_t(1)
+                    << int64_t(0) << c_data << h_date << h_amount << h_data << csv::endl;
             // @formatter:on
+            laps.format(kCustomer.name);
 
-            serves_csv << id1 << id2 << csv::endl;
-            isLocatedIn_csv << id2 << nid << csv::endl;
+            serves_chunk << district << customer << csv::endl;
+            laps.format(kServes.name);
+            isLocatedIn_chunk << customer << ids.id(ids::Label::Nation, nid) << csv::endl;
+            laps.format(kCustomerIsLocatedIn.name);
 
             // // @formatter:off
             // h_csv << c_id << c_d_id << c_w_id << c_d_id << c_w_id << c_since << h_amount << h_data << csv::endl;
             // // @formatter:on
          }
       }
-   }
-
-   std::cout << "done." << std::endl;
+      serves_table.seal(chunk[1]);
+      isLocatedIn_table.seal(chunk[2]);
+      return chunk;
+   }, [&](uint64_t w_id, Chunk &chunk) {
+      c_table.append(w_id - first_warehouse, chunk[0]);
+      serves_table.append(w_id - first_warehouse, chunk[1]);
+      isLocatedIn_table.append(w_id - first_warehouse, chunk[2]);
+      stats::Recorder::instance().advance();
+   });
 }
 
 void GtpcGenerator::generateStock() {
-   std::cout << "Generating 'Stock' node objects and ':wHasStock', ':iHasStock', ':hasSupplier' relationship objects .. " << std::flush;
-   std::string header_s = "id|quantity|dist_01|dist_02|dist_03|dist_04|dist_05|dist_06|dist_07|dist_08|dist_09|"
-                        "dist_10|ytd|order_cnt|remote_cnt|data";
-   std::string header_wHasStock = "Warehouse_id|Stock_id";
-   std::string header_iHasStock = "Item_id|Stock_id";
-   std::string header_hasSupplier = "Stock_id|Supplier_id";
-
-   int64_t s_i_id;
-   int64_t s_w_id;
-   int64_t s_quantity;
-   std::array<char, 24> s_dist_01 = {};
-   std::array<char, 24> s_dist_02 = {};
-   std::array<char, 24> s_dist_03 = {};
-   std::array<char, 24> s_dist_04 = {};
-   std::array<char, 24> s_dist_05 = {};
-   std::array<char, 24> s_dist_06 = {};
-   std::array<char, 24> s_dist_07 = {};
-   std::array<char, 24> s_dist_08 = {};
-   std::array<char, 24> s_dist_09 = {};
-   std::array<char, 24> s_dist_10 = {};
-   int64_t s_ytd = 0;
-   int64_t s_order_cnt = 0;
-   int64_t s_remote_cnt = 0;
-   std::array<char, 50> s_data = {};
-   std::vector<bool> orig(kItemCount, false);
-
-   csv::CsvWriter s_csv(folder + "/stock" + post_fix);
-   csv::CsvWriter wHasStock_csv(folder + "/warehouse_hasStock_stock" + post_fix);
-   csv::CsvWriter iHasStock_csv(folder + "/item_hasStock_stock" + post_fix);
-   csv::CsvWriter hasSupplier_csv(folder + "/stock_hasSupplier_supplier" + post_fix);
-   s_csv << header_s << csv::endl;
-   wHasStock_csv << header_wHasStock << csv::endl;
-   iHasStock_csv << header_iHasStock << csv::endl;
-   hasSupplier_csv << header_hasSupplier << csv::endl;
-
-   int64_t id = 0;
-   for (s_w_id = 1; s_w_id<=warehouse_count; s_w_id++) {
-      orig.assign(kItemCount, false);
-
-      for (uint32_t i = 0; i<kItemCount / 10; i++) {
-         int64_t pos;
-         do {
-            pos = makeNumber(0L, kItemCount - 1);
-         } while (orig[pos]);
-         orig[pos] = 1;
-      }
-
+   stats::Phase phase("stock", "Generating 'Stock' node objects and ':wHasStock', ':iHasStock', ':hasSupplier' relationship objects .. ",
+                      last_warehouse - first_warehouse + 1);
+
+   csv::TableWriter s_table(layout, kStock);
+   csv::TableWriter wHasStock_table(layout, kWarehouseHasStock);
+   csv::TableWriter iHasStock_table(layout, kItemHasStock);
+   csv::TableWriter hasSupplier_table(layout, kHasSupplier);
+
+   using Chunk = std::array<csv::CsvWriter, 4>;
+   pool->orderedFor<Chunk>(first_warehouse, last_warehouse + 1, 2 * thread_count, [&](uint64_t w_id) {
+      int64_t s_i_id;
+      int64_t s_w_id = w_id;
+      int64_t s_quantity;
+      std::array<char, 24> s_dist_01 = {};
+      std::array<char, 24> s_dist_02 = {};
+      std::array<char, 24> s_dist_03 = {};
+      std::array<char, 24> s_dist_04 = {};
+      std::array<char, 24> s_dist_05 = {};
+      std::array<char, 24> s_dist_06 = {};
+      std::array<char, 24> s_dist_07 = {};
+      std::array<char, 24> s_dist_08 = {};
+      std::array<char, 24> s_dist_09 = {};
+      std::array<char, 24> s_dist_10 = {};
+      int64_t s_ytd = 0;
+      int64_t s_order_cnt = 0;
+      int64_t s_remote_cnt = 0;
+      std::array<char, 50> s_data = {};
+      RandomEngine ranny = makeEngine(Stream::Stock, w_id, 0);
+      rng::Sample originals = makeOriginalSample(w_id);
+      std::vector<bool> legacy_orig = legacy_rng ? makeLegacyOriginals(ranny) : std::vector<bool>();
+
+      Chunk chunk = {s_table.makeChunk(), wHasStock_table.makeChunk(), iHasStock_table.makeChunk(),
+                     hasSupplier_table.makeChunk()};
+      auto &[s_chunk, wHasStock_chunk, iHasStock_chunk, hasSupplier_chunk] = chunk;
+
+      stats::Laps laps;
+      int64_t id = (s_w_id - 1) * kItemCount;
       for (s_i_id = 1; s_i_id<=kItemCount; s_i_id++) {
          id++;
-         s_quantity = makeNumber(10L, 100L);
-         makeAlphaString(24, 24, s_dist_01.data());
-         makeAlphaString(24, 24, s_dist_02.data());
-         makeAlphaString(24, 24, s_dist_03.data());
-         makeAlphaString(24, 24, s_dist_04.data());
-         makeAlphaString(24, 24, s_dist_05.data());
-         makeAlphaString(24, 24, s_dist_06.data());
-         makeAlphaString(24, 24, s_dist_07.data());
-         makeAlphaString(24, 24, s_dist_08.data());
-         makeAlphaString(24, 24, s_dist_09.data());
-         makeAlphaString(24, 24, s_dist_10.data());
-         uint32_t s_data_size = makeAlphaString(26, 50, s_data.data());
+         int64_t s_id = ids.id(ids::Label::Stock, id);
+         ranny = makeEngine(Stream::Stock, w_id, s_i_id);
+         s_quantity = makeNumber(ranny, kStockQuantities);
+         makeAlphaStrings(ranny, 24, 24, {s_dist_01.data(), s_dist_02.data(), s_dist_03.data(), s_dist_04.data(),
+                                          s_dist_05.data(), s_dist_06.data(), s_dist_07.data(), s_dist_08.data(),
+                                          s_dist_09.data(), s_dist_10.data()});
+         uint32_t s_data_size = makeAlphaString(ranny, 26, 50, s_data.data());
          int64_t s_su_id = (s_i_id*s_w_id)%(SupplierCount);
-         if (orig[s_i_id]) {
-            int64_t pos = makeNumber(0L, s_data_size - 8);
+         if (legacy_rng ? legacy_orig[s_i_id] : originals.contains(s_i_id - 1)) {
+            int64_t pos = makeNumber(ranny, 0L, s_data_size - 8);
             s_data[pos] = 'o';
             s_data[pos + 1] = 'r';
             s_data[pos + 2] = 'i';
@@ -311,189 +594,227 @@ void GtpcGenerator::generateStock() {
             s_data[pos + 6] = 'a';
             s_data[pos + 7] = 'l';
          }
+         laps.random(kStock.name);
 
          // @formatter:off
-         s_csv << id /*<< s_i_id << s_w_id*/ << s_quantity << s_dist_01 << s_dist_02 << s_dist_03 << s_dist_04 << s_dist_05
-               << s_dist_06 << s_dist_07 << s_dist_08 << s_dist_09 << s_dist_10 << s_ytd << s_order_cnt
-               << s_remote_cnt << s_data << csv::endl;
+         s_chunk << s_id /*<< s_i_id << s_w_id*/ << s_quantity << s_dist_01 << s_dist_02 << s_dist_03 << s_dist_04 << s_dist_05
+                 << s_dist_06 << s_dist_07 << s_dist_08 << s_dist_09 << s_dist_10 << s_ytd << s_order_cnt
+                 << s_remote_cnt << s_data << csv::endl;
          // @formatter:on
-         wHasStock_csv << s_w_id << id << csv::endl;
-         iHasStock_csv << s_i_id << id << csv::endl;
-         hasSupplier_csv << id << s_su_id << csv::endl;
+         laps.format(kStock.name);
+         wHasStock_chunk << ids.id(ids::Label::Warehouse, s_w_id) << s_id << csv::endl;
+         laps.format(kWarehouseHasStock.name);
+         iHasStock_chunk << ids.id(ids::Label::Item, s_i_id) << s_id << csv::endl;
+         laps.format(kItemHasStock.name);
+         hasSupplier_chunk << s_id << ids.id(ids::Label::Supplier, s_su_id) << csv::endl;
+         laps.format(kHasSupplier.name);
       }
-   }
-
-   std::cout << "done." << std::endl;
+      wHasStock_table.seal(chunk[1]);
+      iHasStock_table.seal(chunk[2]);
+      hasSupplier_table.seal(chunk[3]);
+      return chunk;
+   }, [&](uint64_t w_id, Chunk &chunk) {
+      s_table.append(w_id - first_warehouse, chunk[0]);
+      wHasStock_table.append(w_id - first_warehouse, chunk[1]);
+      iHasStock_table.append(w_id - first_warehouse, chunk[2]);
+      hasSupplier_table.append(w_id - first_warehouse, chunk[3]);
+      stats::Recorder::instance().advance();
+   });
 }
 
 void GtpcGenerator::generateOrdersAndOrderLines() {
-   std::cout << "Generating 'Order', 'OrderLine' node objects and ':hasPlaced', ':olHasStock', ':contains' relationship objects .. " << std::flush;
-   std::string header_o = "id|entry_d|carrier_id|ol_cnt|all_local|new_order";
-   std::string header_ol = "id|number|delivery_d|quantity|amount|dist_info";
-   std::string header_hasPlaced = "Customer_id|Order_id";
-   std::string header_olHasStock = "OrderLine_id|Stock_id";
-//    std::string header_hasItem = "OrderLine.id|Item.id";
-   std::string header_contains = "Order_id|OrderLine_id";
-
-   int64_t o_id;
-   int64_t o_c_id;
-   int64_t o_d_id;
-   int64_t o_w_id;
-   int64_t o_carrier_id;
-   int64_t o_ol_cnt;
-   std::array<char, 28> o_entry_d = {}; // XXX not sure if date is generate correctly
-   int64_t o_all_local = 1;
-
-   int64_t ol_number;
-   int64_t ol_i_id;
-   int64_t ol_s_id;
-   std::array<char, 28> ol_del_d = {}; // XXX not sure if date is generate correctly
-   int64_t ol_quantity;
-   float ol_amount;
-   std::array<char, 24> ol_dist_info = {};
-   std::string kNull = "0";
-   std::string kNullDate = "1970-01-01T00:00:00.000+0000";
-
-   csv::CsvWriter o_csv(folder + "/order" + post_fix);
-   csv::CsvWriter ol_csv(folder + "/orderLine" + post_fix);
+   stats::Phase phase("order", "Generating 'Order', 'OrderLine' node objects and ':hasPlaced', ':olHasStock', ':contains' relationship objects .. ",
+                      last_warehouse - first_warehouse + 1);
+
+   csv::TableWriter o_table(layout, kOrder);
+   csv::TableWriter ol_table(layout, kOrderLine);
    // csv::CsvWriter no_csv(folder + "/newOrder" + post_fix);
-   csv::CsvWriter hasPlaced_csv(folder + "/customer_hasPlaced_order" + post_fix);
-   csv::CsvWriter olHasStock_csv(folder + "/orderLine_hasStock_stock" + post_fix);
+   csv::TableWriter hasPlaced_table(layout, kHasPlaced);
+   csv::TableWriter olHasStock_table(layout, kOrderLineHasStock);
 //    csv::CsvWriter hasItem_csv(folder + "/orderLine_hasItem_item" + post_fix);
-   csv::CsvWriter contains_csv(folder + "/order_contains_orderLine" + post_fix);
-   o_csv << header_o << csv::endl;
-   ol_csv << header_ol << csv::endl;
-   hasPlaced_csv << header_hasPlaced << csv::endl;
-   olHasStock_csv << header_olHasStock << csv::endl;
-//    hasItem_csv << header_hasItem << csv::endl;
-   contains_csv << header_contains << csv::endl;
-
-    // Each customer has exactly one order
-    uint32_t permutation_range = warehouse_count * kDistrictsPerWarehouse * kCustomerPerDistrict;
-    std::vector<uint32_t> customer_id_permutation = makePermutation(1, permutation_range + 1);
+   csv::TableWriter contains_table(layout, kContains);
+
+    // The permutation of the customers (see makeCustomerPermutation) is evaluated per order, so memory does not grow
+    // with the number of warehouses. By district, warehouse w numbers its own orders and the customers placing them
+    // are scattered over the segment; by customer, it numbers the orders placed by its customers, wherever they were
+    // generated, and the rows of an order only depend on the warehouse and row it was generated for.
+    int64_t segment_base = (segment_first - 1) * kDistrictsPerWarehouse * kCustomerPerDistrict;
+    rng::Permutation customer_permutation = makeCustomerPermutation();
+    orderline_offsets = makeOrderLineOffsets();
 
    // Generate ORD_PER_DIST (3000) orders and order line items for each district
-   int64_t id1 = 0;
-   int64_t id2 = 0;
-   int64_t id3 = 0;
-   for (o_w_id = 1L; o_w_id<=warehouse_count; o_w_id++) {
-      for (o_d_id = 1L; o_d_id<=kDistrictsPerWarehouse; o_d_id++) {
-
-         int64_t id4 = 0;
-         //  for (o_id = 1; o_id<=OrdersPerDistrict; o_id++) {
-         for (o_c_id = 1; o_c_id<=kCustomerPerDistrict; o_c_id++) {
-            id1++;
-            id2 = customer_id_permutation[id1 - 1];
-            o_carrier_id = makeNumber(1L, 10L);
-            // o_ol_cnt = DataSource::nextOderlineCount();
-            o_ol_cnt = makeNumber(5L, 15L);
-            // makeNow(o_entry_d.data());
-            makeDate(2010, 2012, o_entry_d.data());
-
-            id4++;
-            // @formatter:off
-             o_csv << id1 /*<< o_d_id << o_w_id << o_c_id*/ << o_entry_d << (id4>2100 ? kNull : std::to_string(o_carrier_id))
-                        << o_ol_cnt << o_all_local << (id4>2100 ? (int64_t)1 : (int64_t)0) << csv::endl;
-            // @formatter:on
+   using Chunk = std::array<csv::CsvWriter, 5>;
+   pool->orderedFor<Chunk>(first_warehouse, last_warehouse + 1, 2 * thread_count, [&](uint64_t w_id) {
+      int64_t o_w_id;
+      int64_t o_carrier_id;
+      int64_t o_ol_cnt;
+      csv::Timestamp o_entry_d; // XXX not sure if date is generate correctly
+      int64_t o_all_local = 1;
+
+      int64_t ol_number;
+      int64_t ol_i_id;
+      int64_t ol_s_id;
+      csv::Timestamp ol_del_d; // XXX not sure if date is generate correctly
+      int64_t ol_quantity;
+      float ol_amount;
+      std::array<char, 24> ol_dist_info = {};
+      csv::Timestamp kNullDate = {0};
+
+      Chunk chunk = {o_table.makeChunk(), ol_table.makeChunk(), hasPlaced_table.makeChunk(),
+                     olHasStock_table.makeChunk(), contains_table.makeChunk()};
+      auto &[o_chunk, ol_chunk, hasPlaced_chunk, olHasStock_chunk, contains_chunk] = chunk;
+
+      int64_t id1 = (w_id - 1) * kDistrictsPerWarehouse * kCustomerPerDistrict;
+      int64_t id2 = 0;
+      int64_t id3 = orderline_offsets[w_id];
+      int64_t ol_index = 0;
+      stats::Laps laps;
+      for (uint32_t index = 1; index<=kDistrictsPerWarehouse * kCustomerPerDistrict; index++) {
+         id1++;
+         int64_t row;
+         std::tie(o_w_id, row) = locateOrder(customer_permutation, w_id, index);
+         if (order_numbering == ids::OrderNumbering::Customer) {
+            id2 = id1;
+         } else {
+            id2 = segment_base + customer_permutation(id1 - segment_base - 1) + 1;
+         }
+         // Position of the order in its district.
+         int64_t id4 = (row - 1) % kCustomerPerDistrict + 1;
+         int64_t o_id = ids.id(ids::Label::Order, id1);
+         RandomEngine ranny = makeEngine(Stream::Order, o_w_id, row);
+         RandomEngine ol_cnt_ranny = makeEngine(Stream::OrderLineCount, o_w_id, row);
+         o_carrier_id = makeNumber(ranny, kCarrierIds);
+         // o_ol_cnt = DataSource::nextOderlineCount();
+         o_ol_cnt = makeNumber(ol_cnt_ranny, kOrderLineCounts);
+         // makeNow(o_entry_d.data());
+         o_entry_d = makeDate(ranny, kEntryYears);
+         laps.random(kOrder.name);
 
-            hasPlaced_csv << id2 << id1 << csv::endl;
-
-            // Order line items
-            for (ol_number = 1; ol_number<=o_ol_cnt; ol_number++) {
-               id3++;
-               ol_i_id = makeNumber(1L, kItemCount);
-               ol_s_id = (kItemCount*(o_w_id-1)) + ol_i_id;
-               ol_quantity = 5;
-               makeAlphaString(24, 24, ol_dist_info.data());
-               makeDate(2011, 2012, ol_del_d.data());
-
-               if (id4>2100) {
-                  ol_amount = (float) (makeNumber(10L, 10000L)) / 100.0f;
-                  // @formatter:off
-                  ol_csv << id3 /*<< o_id << o_d_id << o_w_id*/ << ol_number /*<< ol_i_id << o_w_id*/ << kNullDate
-                         << ol_quantity << csv::Precision(2) << ol_amount << ol_dist_info << csv::endl;
-                  // @formatter:on
-               } else {
-                  ol_amount = 0.0f;
-                  // @formatter:off
-                  ol_csv << id3 /*<< o_id << o_d_id << o_w_id*/ << ol_number /*<< ol_i_id << o_w_id*/
-                         << ol_del_d << ol_quantity << csv::Precision(2) << ol_amount << ol_dist_info << csv::endl;
-                  // @formatter:on
-               }
-               contains_csv << id1 << id3 << csv::endl;
-               olHasStock_csv << id3 << ol_s_id <<  csv::endl;
+         // @formatter:off
+         o_chunk << o_id /*<< o_d_id << o_w_id << o_c_id*/ << o_entry_d << (id4>2100 ? (int64_t)0 : o_carrier_id)
+                 << o_ol_cnt << o_all_local << (id4>2100 ? (int64_t)1 : (int64_t)0) << csv::endl;
+         // @formatter:on
+         laps.format(kOrder.name);
+
+         hasPlaced_chunk << ids.id(ids::Label::Customer, id2) << o_id << csv::endl;
+         laps.format(kHasPlaced.name);
+
+         // Order line items
+         for (ol_number = 1; ol_number<=o_ol_cnt; ol_number++) {
+            id3++;
+            int64_t ol_id = ids.orderLine(w_id, ++ol_index, id3);
+            ol_i_id = makeNumber(ranny, kItemIds);
+            ol_s_id = ids.id(ids::Label::Stock, (kItemCount*(o_w_id-1)) + ol_i_id);
+            ol_quantity = 5;
+            makeAlphaString(ranny, 24, 24, ol_dist_info.data());
+            ol_del_d = makeDate(ranny, kDeliveryYears);
+            laps.random(kOrderLine.name);
+
+            if (id4>2100) {
+               ol_amount = (float) (makeNumber(ranny, kOrderLineAmounts)) / 100.0f;
+               laps.random(kOrderLine.name);
+               // @formatter:off
+               ol_chunk << ol_id /*<< o_id << o_d_id << o_w_id*/ << ol_number /*<< ol_i_id << o_w_id*/ << kNullDate
+                        << ol_quantity << csv::Precision(2) << ol_amount << ol_dist_info << csv::endl;
+               // @formatter:on
+            } else {
+               ol_amount = 0.0f;
+               // @formatter:off
+               ol_chunk << ol_id /*<< o_id << o_d_id << o_w_id*/ << ol_number /*<< ol_i_id << o_w_id*/
+                        << ol_del_d << ol_quantity << csv::Precision(2) << ol_amount << ol_dist_info << csv::endl;
+               // @formatter:on
             }
-
-            // Generate a new order entry for the order for the last 900 rows
-            // if (o_id>2100) {
-            //    no_csv << o_id << o_d_id << o_w_id << csv::endl;
-            // }
+            laps.format(kOrderLine.name);
+            contains_chunk << o_id << ol_id << csv::endl;
+            laps.format(kContains.name);
+            olHasStock_chunk << ol_id << ol_s_id <<  csv::endl;
+            laps.format(kOrderLineHasStock.name);
          }
-      }
-   }
 
-   std::cout << "done." << std::endl;
+         // Generate a new order entry for the order for the last 900 rows
+         // if (o_id>2100) {
+         //    no_csv << o_id << o_d_id << o_w_id << csv::endl;
+         // }
+      }
+      hasPlaced_table.seal(chunk[2]);
+      olHasStock_table.seal(chunk[3]);
+      contains_table.seal(chunk[4]);
+      return chunk;
+   }, [&](uint64_t w_id, Chunk &chunk) {
+      o_table.append(w_id - first_warehouse, chunk[0]);
+      ol_table.append(w_id - first_warehouse, chunk[1]);
+      hasPlaced_table.append(w_id - first_warehouse, chunk[2]);
+      olHasStock_table.append(w_id - first_warehouse, chunk[3]);
+      contains_table.append(w_id - first_warehouse, chunk[4]);
+      stats::Recorder::instance().advance();
+   });
 }
 
 void GtpcGenerator::generateRegions() {
-   std::cout << "Generating 'Region' node objects .. " << std::flush;
-   std::string header_r = "id|name|comment";
+   stats::Phase phase("region", "Generating 'Region' node objects .. ", 1);
 
    int64_t r_id;
    std::array<char, 25> r_name = {};
    std::array<char, 152> r_comment = {};
 
-   csv::CsvWriter r_csv(folder + "/region" + post_fix);
-   r_csv << header_r << csv::endl;
+   csv::TableWriter r_table(layout, kRegion);
+   csv::CsvWriter &r_csv = r_table.csv();
 
+   stats::Laps laps;
    for (r_id = 0L; r_id<RegionCount; r_id++) {
+      RandomEngine ranny = makeEngine(Stream::Region, 0, r_id);
       setRegionName(r_id, 25, r_name.data());
-      makeAlphaString(80, 152, r_comment.data());
+      makeText(ranny, 80, 152, r_comment.data());
+      laps.random(kRegion.name);
 
       // @formatter:off
-      r_csv << r_id << r_name << r_comment << csv::endl;
+      r_csv << ids.id(ids::Label::Region, r_id) << r_name << r_comment << csv::endl;
       // @formatter:on
+      laps.format(kRegion.name);
    }
-
-   std::cout << "done." << std::endl;
 }
 
 void GtpcGenerator::generateNations() {
-   std::cout << "Generating 'Nation' node objects and ':isPartOf' relationship objects .. " << std::flush;
-   std::string header_n = "id|name|comment";
-   std::string header_isPartOf = "Nation_id|Region_id";
+   stats::Phase phase("nation", "Generating 'Nation' node objects and ':isPartOf' relationship objects .. ", 1);
 
    int64_t n_id;
    std::array<char, 25> n_name = {};
    std::array<char, 152> n_comment = {};
    const static char *nation_keys = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
 
-   csv::CsvWriter n_csv(folder + "/nation" + post_fix);
-   csv::CsvWriter isPartOf_csv(folder + "/nation_isPartOf_region" + post_fix);
-   n_csv << header_n << csv::endl;
-   isPartOf_csv << header_isPartOf << csv::endl;
+   csv::TableWriter n_table(layout, kNation);
+   csv::CsvWriter &n_csv = n_table.csv();
+   csv::TableWriter isPartOf_table(layout, kIsPartOf);
+   csv::CsvWriter &isPartOf_csv = isPartOf_table.csv();
 
+   stats::Laps laps;
    for (n_id = 0L; n_id<NationCount; n_id++) {
+      RandomEngine ranny = makeEngine(Stream::Nation, 0, n_id);
       // makeAlphaString(13, 25, n_name.data());
       Nation n = DataSource::getNation(n_id);
-      makeAlphaString(80, 152, n_comment.data());
+      makeText(ranny, 80, 152, n_comment.data());
+      laps.random(kNation.name);
       // char n_key = nation_keys[n_id];
       // int64_t id = (int64_t)n_key;
 
       // @formatter:off
       // n_csv << id << n_name << n_comment << csv::endl;
-      n_csv << (int64_t)n.id << n.name << n_comment << csv::endl;
+      size_t n_name_len = std::min(n.name.size(), n_name.size());
+      memcpy(n_name.data(), n.name.data(), n_name_len);
+      if (n_name_len<n_name.size()) {
+         n_name[n_name_len] = '\0';
+      }
+      n_csv << ids.id(ids::Label::Nation, n.id) << n_name << n_comment << csv::endl;
       // @formatter:on
-      isPartOf_csv << (int64_t)n.id << (int64_t)n.rId << /*id%(RegionCount+1) <<*/ csv::endl;
+      laps.format(kNation.name);
+      isPartOf_csv << ids.id(ids::Label::Nation, n.id) << ids.id(ids::Label::Region, n.rId)
+                   << /*id%(RegionCount+1) <<*/ csv::endl;
+      laps.format(kIsPartOf.name);
    }
-
-   std::cout << "done." << std::endl;
 }
 
 void GtpcGenerator::generateSuppliers() {
-   std::cout << "Generating 'Supplier' node objects and ':sIsLocatedIn' relationship objects .. " << std::flush;
-   std::string header_su = "id|name|address|phone|acctbal|comment";
-   std::string header_isLocatedIn = "Supplier_id|Nation_id";
+   stats::Phase phase("supplier", "Generating 'Supplier' node objects and ':sIsLocatedIn' relationship objects .. ", 1);
 
    int64_t su_id;
    std::array<char, 25> su_name = {};
@@ -504,29 +825,34 @@ void GtpcGenerator::generateSuppliers() {
 
    const static char *n_keys = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
 
-   csv::CsvWriter su_csv(folder + "/supplier" + post_fix);
-   csv::CsvWriter isLocatedIn_csv(folder + "/supplier_isLocatedIn_nation" + post_fix);
-   su_csv << header_su << csv::endl;
-   isLocatedIn_csv << header_isLocatedIn << csv::endl;
+   csv::TableWriter su_table(layout, kSupplier);
+   csv::CsvWriter &su_csv = su_table.csv();
+   csv::TableWriter isLocatedIn_table(layout, kSupplierIsLocatedIn);
+   csv::CsvWriter &isLocatedIn_csv = isLocatedIn_table.csv();
 
+   stats::Laps laps;
    for (su_id = 1; su_id<=SupplierCount; su_id++) {
-      makeAlphaString(14, 24, su_name.data());
-      makeAlphaString(20, 40, su_addr.data());
-      makeAlphaString(50, 101, su_comment.data());
-      makeNumberString(16, 16, su_phone.data());
-      su_acct_bal = ((float) makeNumber(1000L, 10000L)) / 1.0f;
+      RandomEngine ranny = makeEngine(Stream::Supplier, 0, su_id);
+      makeAlphaString(ranny, 14, 24, su_name.data());
+      makeAlphaString(ranny, 20, 40, su_addr.data());
+      makeText(ranny, 50, 101, su_comment.data());
+      makeNumberString(ranny, 16, 16, su_phone.data());
+      su_acct_bal = ((float) makeNumber(ranny, 1000L, 10000L)) / 1.0f;
 
       // char nkey = n_keys[ranny() % 62];
       // int64_t nid = (int64_t)nkey;
-      Nation n = DataSource::getNation((ranny() % 62));
+      Nation n = DataSource::getNation(makeNumber(ranny, kNationIds));
+      laps.random(kSupplier.name);
 
       // @formatter:off
-      su_csv << su_id << su_name << su_addr << su_phone << csv::Precision(2) << su_acct_bal << su_comment << csv::endl;
+      su_csv << ids.id(ids::Label::Supplier, su_id) << su_name << su_addr << su_phone << csv::Precision(2) << su_acct_bal
+             << su_comment << csv::endl;
       // @formatter:on
-      isLocatedIn_csv << su_id << (int64_t)n.id << /*nid <<*/ csv::endl;
+      laps.format(kSupplier.name);
+      isLocatedIn_csv << ids.id(ids::Label::Supplier, su_id) << ids.id(ids::Label::Nation, n.id)
+                      << /*nid <<*/ csv::endl;
+      laps.format(kSupplierIsLocatedIn.name);
    }
-
-   std::cout << "done." << std::endl;
 }
 
 uint32_t GtpcGenerator::setRegionName(int64_t idx, int32_t max, char *dest) {
@@ -542,12 +868,17 @@ uint32_t GtpcGenerator::setRegionName(int64_t idx, int32_t max, char *dest) {
    return len;
 }
 
-uint32_t GtpcGenerator::makeAlphaString(uint32_t min, uint32_t max, char *dest) {
+uint32_t GtpcGenerator::makeAlphaString(RandomEngine &ranny, uint32_t min, uint32_t max, char *dest) {
    const static char *possible_values = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
 
-   uint32_t len = makeNumber(min, max);
-   for (uint32_t i = 0; i<len; i++) {
-      dest[i] = possible_values[ranny() % 62];
+   uint32_t len = makeNumber(ranny, min, max);
+   if (legacy_strings) {
+      for (uint32_t i = 0; i<len; i++) {
+         dest[i] = possible_values[ranny() % 62];
+      }
+   } else {
+      rng::StringField field = {dest, len};
+      rng::fillAlphaNumeric(ranny, {&field, 1});
    }
    if (len<max) {
       dest[len] = '\0';
@@ -555,12 +886,53 @@ uint32_t GtpcGenerator::makeAlphaString(uint32_t min, uint32_t max, char *dest)
    return len;
 }
 
-uint32_t GtpcGenerator::makeNumberString(uint32_t min, uint32_t max, char *dest) {
+void GtpcGenerator::makeAlphaStrings(RandomEngine &ranny, uint32_t min, uint32_t max,
+                                     std::initializer_list<char *> dests) {
+   if (legacy_strings) {
+      for (char *dest : dests) {
+         makeAlphaString(ranny, min, max, dest);
+      }
+      return;
+   }
+
+   // All lengths first, then the characters of all fields from one batch.
+   std::array<rng::StringField, 10> fields;
+   assert(dests.size()<=fields.size());
+   size_t count = 0;
+   for (char *dest : dests) {
+      fields[count++] = {dest, makeNumber(ranny, min, max)};
+   }
+   rng::fillAlphaNumeric(ranny, {fields.data(), count});
+   for (size_t i = 0; i<count; i++) {
+      if (fields[i].length<max) {
+         fields[i].dest[fields[i].length] = '\0';
+      }
+   }
+}
+
+uint32_t GtpcGenerator::makeText(RandomEngine &ranny, uint32_t min, uint32_t max, char *dest) {
+   if (!text_pool) {
+      return makeAlphaString(ranny, min, max, dest);
+   }
+   std::string_view text = text_pool->slice(ranny, min, max);
+   memcpy(dest, text.data(), text.size());
+   if (text.size()<max) {
+      dest[text.size()] = '\0';
+   }
+   return text.size();
+}
+
+uint32_t GtpcGenerator::makeNumberString(RandomEngine &ranny, uint32_t min, uint32_t max, char *dest) {
    const static char *possible_values = "0123456789";
 
-   uint32_t len = makeNumber(min, max);
-   for (uint32_t i = 0; i<len; i++) {
-      dest[i] = possible_values[ranny() % 10];
+   uint32_t len = makeNumber(ranny, min, max);
+   if (legacy_strings) {
+      for (uint32_t i = 0; i<len; i++) {
+         dest[i] = possible_values[ranny() % 10];
+      }
+   } else {
+      rng::StringField field = {dest, len};
+      rng::fillDigits(ranny, {&field, 1});
    }
    if (len<max) {
       dest[len] = '\0';
@@ -568,44 +940,30 @@ uint32_t GtpcGenerator::makeNumberString(uint32_t min, uint32_t max, char *dest)
    return len;
 }
 
-void GtpcGenerator::makeDate(uint32_t min, uint32_t max, char *str) {
-   // TODOmakeNumber
-   std::vector<std::string> mos = {"01", "02", "03", "04", "05", "06",
-                                    "07", "08", "09", "10", "11", "12"};
-   std::string yr = std::to_string(makeNumber(min, max));
-   std::string mo = mos[ranny() % 11];
-   std::string d = std::to_string(makeNumber(10, 28));
-   // string s = "2010-02-14T15:32:10.447+0000";
-   std::string dt = yr + "-" + mo + "-" + d + "T15:32:10.447+0000";
-   strncpy(str, dt.data(), dt.size());
+csv::Timestamp GtpcGenerator::makeDate(RandomEngine &ranny, const rng::Range &years) {
+   uint32_t year = makeNumber(ranny, years);
+   // The original generator drew the month with % 11 and never produced December.
+   uint32_t month = legacy_dates ? ranny() % 11 + 1 : makeNumber(ranny, kMonths);
+   uint32_t day = makeNumber(ranny, kDays);
+   return csv::makeTimestamp(year, month, day, 15, 32, 10, 447);
 }
 
-void GtpcGenerator::makeAddress(char *street1, char *street2, char *city, char *state, char *zip) {
-   makeAlphaString(10, 20, street1);
-   makeAlphaString(10, 20, street2);
-   makeAlphaString(10, 20, city);
-   makeAlphaString(2, 2, state);
-   makeNumberString(9, 9, zip); // XXX
+void GtpcGenerator::makeAddress(RandomEngine &ranny, char *street1, char *street2, char *city, char *state, char *zip) {
+   makeAlphaStrings(ranny, 10, 20, {street1, street2, city});
+   makeAlphaString(ranny, 2, 2, state);
+   makeNumberString(ranny, 9, 9, zip); // XXX
 }
 
-uint32_t GtpcGenerator::makeNumber(uint32_t min, uint32_t max) {
-   return ranny() % (max - min + 1) + min;
+uint32_t GtpcGenerator::makeNumber(RandomEngine &ranny, uint32_t min, uint32_t max) {
+   return ranny.uniform(min, max);
 }
 
-uint32_t GtpcGenerator::makeNonUniformRandom(uint32_t A, uint32_t x, uint32_t y) {
-   return ((makeNumber(0, A) | makeNumber(x, y)) + 42) % (y - x + 1) + x; // XXX
+uint32_t GtpcGenerator::makeNumber(RandomEngine &ranny, const rng::Range &range) {
+   return ranny.uniform(range);
 }
 
-std::vector<uint32_t> GtpcGenerator::makePermutation(uint32_t min, uint32_t max) {
-   assert(max>min);
-   const uint32_t count = max - min;
-   std::vector<uint32_t> result(count);
-   iota(result.begin(), result.end(), min);
-
-   for (uint32_t i = 0; i<count; i++) {
-      std::swap(result[i], result[ranny() % count]);
-   }
-   return result;
+uint32_t GtpcGenerator::makeNonUniformRandom(RandomEngine &ranny, uint32_t A, uint32_t x, uint32_t y) {
+   return ranny.nonUniform(A, x, y, kLoadConstant);
 }
 
 void GtpcGenerator::makeLastName(int64_t num, char *name) {
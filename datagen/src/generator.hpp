@@ -11,43 +11,153 @@
 #define generator_hpp_
 
 #include <cstdint>
+#include <initializer_list>
+#include <memory>
 #include <string>
-#include <random>
+#include <utility>
+#include <vector>
+
+#include "id_layout.hpp"
+#include "random.hpp"
+#include "text_pool.hpp"
+#include "table_writer.hpp"
+
+class ThreadPool;
 
 class GtpcGenerator {
+   // bench/gtpc_bench.cpp measures the make* functions directly.
+   friend class GeneratorBench;
+
    const static uint32_t kItemCount = 100000;
    const static uint32_t kCustomerPerDistrict = 3000;
    const static uint32_t kDistrictsPerWarehouse = 10;
    const static uint32_t OrdersPerDistrict = 3000;
+   const static uint32_t SupplierCount = 10000;
+public:
    const static uint32_t RegionCount = 5;
    const static uint32_t NationCount = 62;
-   const static uint32_t SupplierCount = 10000;
+   // C of NURand(255, 0, 999) for the customer last names; the workload derives its run-time C from it.
+   const static uint32_t kLoadConstant = 42;
+   // Value domains of the dates and carriers, which the OLAP query parameters are drawn from as well.
+   static constexpr rng::Range kSinceYears{1993, 2012};
+   static constexpr rng::Range kHistoryYears{2012, 2012};
+   static constexpr rng::Range kEntryYears{2010, 2012};
+   static constexpr rng::Range kDeliveryYears{2011, 2012};
+   static constexpr rng::Range kMonths{1, 12};
+   static constexpr rng::Range kDays{10, 28};
+   static constexpr rng::Range kCarrierIds{1, 10};
+private:
+
+   // Ranges drawn for every row, their constants for rng::Random::uniform are computed at compile time.
+   static constexpr rng::Range kItemIds{1, kItemCount};
+   static constexpr rng::Range kItemIndexes{0, kItemCount - 1};
+   static constexpr rng::Range kOrderLineCounts{5, 15};
+   static constexpr rng::Range kStockQuantities{10, 100};
+   static constexpr rng::Range kOrderLineAmounts{10, 10000};
+   static constexpr rng::Range kNationIds{0, NationCount - 1};
 
    // If these are different the order generation needs to be changed.
    // Right now there is a 1:1 relationship between customers and orders.
    static_assert(kCustomerPerDistrict == OrdersPerDistrict, "These should match, see comment.");
 
+   // Every row draws from its own random stream keyed by (seed, table, warehouse, row), so any row can be generated
+   // independently and in any order. The output only depends on the seed, not on the number of threads.
+   enum class Stream : uint32_t {
+      Warehouse, District, Customer, Item, Supplier, Stock, Order, OrderLineCount, CustomerPermutation, Region, Nation,
+      Original, TextPool
+   };
+   using RandomEngine = rng::Random;
+
    const int64_t warehouse_count;
-   const std::string folder;
-   const std::string post_fix;
+   const uint32_t thread_count;
+   csv::Layout layout;
+   ids::IdLayout ids;
+   ids::OrderNumbering order_numbering;
+
+   // Warehouses written by this process. Tables that exist per warehouse only contain rows of this range, ids are
+   // still global, so the outputs of all ranges together are identical to a single run over all warehouses.
+   int64_t first_warehouse;
+   int64_t last_warehouse;
+   // Warehouses whose orders are placed by their own customers: all of them, or the ones added by an append.
+   int64_t segment_first;
+   std::vector<int64_t> orderline_offsets;
+
+   uint32_t seed;
+   bool legacy_dates;
+   bool legacy_strings;
+   bool legacy_rng;
+   std::unique_ptr<ThreadPool> pool;
+   std::unique_ptr<rng::TextPool> text_pool;
 
-   std::mt19937 ranny;
+   RandomEngine makeEngine(Stream stream, int64_t warehouse, int64_t row) const;
+   // Customers of the segment in the order of the orders they place, see generateOrdersAndOrderLines.
+   rng::Permutation makeCustomerPermutation() const;
+   // Warehouse and row of the order that is numbered as the index-th (from 1) of the warehouse: the order of that row
+   // itself, or with customer numbering the order placed by that customer.
+   std::pair<int64_t, int64_t> locateOrder(const rng::Permutation &customers, int64_t warehouse, int64_t index) const;
+   // First dense order line id - 1 per warehouse, for the order lines numbered for that warehouse.
+   std::vector<int64_t> makeOrderLineOffsets();
+   // The 10% of the items (warehouse 0) or of a warehouse's stock whose data contains "original".
+   rng::Sample makeOriginalSample(int64_t warehouse) const;
+   std::vector<bool> makeLegacyOriginals(RandomEngine &ranny);
 
    uint32_t setRegionName(int64_t id, int32_t max, char *dest);
-   uint32_t makeAlphaString(uint32_t min, uint32_t max, char *dest);
-   uint32_t makeNumberString(uint32_t min, uint32_t max, char *dest);
-   uint32_t makeNumber(uint32_t min, uint32_t max);
-   uint32_t makeNonUniformRandom(uint32_t A, uint32_t x, uint32_t y);
-   std::vector<uint32_t> makePermutation(uint32_t min, uint32_t max);
-   void makeAddress(char *str1, char *street2, char *city, char *state, char *zip);
+   uint32_t makeAlphaString(RandomEngine &ranny, uint32_t min, uint32_t max, char *dest);
+   // Fills up to 10 fields of the same length range with one call of the string kernel.
+   void makeAlphaStrings(RandomEngine &ranny, uint32_t min, uint32_t max, std::initializer_list<char *> dests);
+   // Comment and data fields: a slice of the text pool if there is one, random characters otherwise.
+   uint32_t makeText(RandomEngine &ranny, uint32_t min, uint32_t max, char *dest);
+   uint32_t makeNumberString(RandomEngine &ranny, uint32_t min, uint32_t max, char *dest);
+   uint32_t makeNumber(RandomEngine &ranny, uint32_t min, uint32_t max);
+   uint32_t makeNumber(RandomEngine &ranny, const rng::Range &range);
+   uint32_t makeNonUniformRandom(RandomEngine &ranny, uint32_t A, uint32_t x, uint32_t y);
+   void makeAddress(RandomEngine &ranny, char *str1, char *street2, char *city, char *state, char *zip);
    void makeLastName(int64_t num, char *name);
-   void makeDate(uint32_t min, uint32_t max, char *str);
+   csv::Timestamp makeDate(RandomEngine &ranny, const rng::Range &years);
    void makeNow(char *str);
 
 public:
-   GtpcGenerator(int64_t warehouse_count, const std::string &folder);
+   GtpcGenerator(int64_t warehouse_count, const std::string &folder, uint32_t thread_count = 1);
+   ~GtpcGenerator();
 
-   void setRandomSeed(uint32_t seed) { ranny.seed(seed); }
+   void setRandomSeed(uint32_t seed) { this->seed = seed; }
+   // Draw the months like the original generator, which never produced December.
+   void setLegacyDates(bool legacy) { legacy_dates = legacy; }
+   // Draw every character of a random string with its own value modulo the alphabet size, like the original generator,
+   // instead of the bulk string kernels (see string_kernel.hpp).
+   void setLegacyStrings(bool legacy) { legacy_strings = legacy; }
+   // Map random values to ranges with value % size like the original generator instead of the division-free
+   // multiply-shift (see rng::Random::uniform), and pick the "original" items and stock with its rejection loop
+   // instead of rng::Sample. Together with the other legacy switches this reproduces old files.
+   void setLegacyRng(bool legacy) { legacy_rng = legacy; }
+   // Draws r_comment, n_comment, su_comment and c_data from a TPC-H text pool of the given size in bytes (0 turns it
+   // off). With a path the pool is mapped from that file, or generated and stored there if the file does not match.
+   void setTextPool(uint64_t size, const std::string &path);
+   // Restricts the per-warehouse tables to [first, last]; files are named <table>_<part>_<chunk>.csv.
+   void setWarehouseRange(int64_t first, int64_t last, uint32_t part);
+   // Adds warehouses first..warehouse_count to a dataset of warehouses 1..first-1, written as delta files
+   // (<table>_delta<first>_<chunk>.csv) with a header each. All ids derive from the warehouse, so they continue the
+   // existing ranges; the orders of the new warehouses are placed by the new customers, existing rows stay unchanged.
+   // The result equals neither a run over all warehouses nor a warehouse range of it.
+   void setAppend(int64_t first);
+   // Plain CSV (default) or neo4j-admin import files; chunk_warehouses > 0 starts a new data file every that many
+   // warehouses.
+   void setOutputFormat(csv::Format format, uint64_t chunk_warehouses);
+   // Sorts the relationship files of the plain and neo4j-admin formats by start id (and end id), with sort_memory bytes
+   // of sorted runs per table before they are merged to disk; grouped files list the end ids per start id. Only
+   // ':hasPlaced' and the ':hasStock' of the items need an actual sort, the others are generated in order.
+   void setEdgeOrder(csv::EdgeOrder order, bool grouped, uint64_t sort_memory);
+   // Maps the node ids to the given id space (see ids::IdLayout) and numbers the orders by district or by the customer
+   // who placed them. The relationships use the same ids, the defaults are the ids of the original generator.
+   void setIdLayout(ids::Space space, ids::OrderNumbering numbering);
+   // Writes neo4j-admin.args listing the header and data files of all tables, for neo4j-admin import @neo4j-admin.args.
+   void writeImportArguments();
+   // Prints the id ranges of the nodes written by this run and stores them with the rows of every table (see
+   // stats::Recorder) in <folder>/manifest_<first>_<last>.json.
+   void writeManifest();
+   // The process covering warehouse 1 writes the CSV header lines and the tables shared by all warehouses (Item,
+   // Supplier, Region, Nation).
+   bool writesSharedTables() const { return first_warehouse == 1; }
 
    void generateGraph();
    void generateWarehouses();
@@ -1,9 +1,16 @@
+#include <chrono>
+#include <filesystem>
+#include <fstream>
 #include <iostream>
 #include <regex>
 #include <random>
+#include <sstream>
 #include "CLI/CLI.hpp"
 
 #include "generator.hpp"
+#include "output_stage.hpp"
+#include "instrumentation.hpp"
+#include "string_kernel.hpp"
 
 #define GTPC_VERSION 0.9
 
@@ -12,32 +19,306 @@
 int main(int argc, char **argv) {
   std::string directory = ".";
   std::size_t warehouses;
+  uint32_t threads = 1;
+  std::string shard;
+  std::string warehouse_range;
+  std::size_t from_warehouse = 0;
+  bool append = false;
+  uint32_t io_threads = 1;
+  std::size_t io_queue = 64;
+  std::string compress = "none";
+  int compress_level = -1;
+  std::string format = "csv";
+  std::size_t chunk_warehouses = 0;
+  std::string sort_edges = "none";
+  bool group_edges = false;
+  std::size_t sort_memory = 1024;
+  std::string id_space = "dense";
+  std::string order_ids = "district";
+  bool legacy_dates = false;
+  bool legacy_strings = false;
+  bool legacy_rng = false;
+  std::string string_kernel = "auto";
+  std::size_t text_pool = 0;
+  std::string text_pool_file;
+  std::string report;
+  bool perf_counters = false;
+  bool no_progress = false;
 
   CLI::App app{"GTPC Graph Database Benchmark Generator"};
 
   app.add_option("-d,--directory", directory, "Path to out directory for generated GTPC CSV files")->required();
   app.add_option("-w,--warehouses", warehouses, "Number of warehouses")->required();
+  app.add_option("-t,--threads", threads, "Number of generator threads (the output does not depend on it)");
+  auto shard_opt = app.add_option("--shard", shard, "Generate only shard i of N (format i/N, 0-based) of the warehouses");
+  auto range_opt = app.add_option("--warehouse-range", warehouse_range,
+                                  "Generate only warehouses a to b (format a-b, inclusive)")->excludes(shard_opt);
+  auto from_opt = app.add_option("--from-warehouse", from_warehouse, "Add warehouses from-warehouse to -w to an "
+                                 "existing dataset as delta files")->excludes(shard_opt)->excludes(range_opt);
+  app.add_flag("--append", append, "Like --from-warehouse, continuing after the last warehouse listed by the "
+               "manifests in the directory")->excludes(shard_opt)->excludes(range_opt)
+     ->excludes(from_opt);
+  app.add_option("--io-threads", io_threads, "Number of threads compressing and writing the output files");
+  app.add_option("--io-queue", io_queue, "Number of 1 MiB blocks that may wait for the disk before generation stalls");
+  app.add_option("--compress", compress, "Compress the output files block by block")
+     ->check(CLI::IsMember({"none", "gzip", "zstd", "lz4"}));
+  app.add_option("--compress-level", compress_level, "Codec specific compression level (default: codec default)");
+
+  app.add_option("--format", format, "Output format: plain CSV, neo4j-admin import files (typed headers in separate "
+                 "files), binary (mmap-able columns and CSR/CSC adjacency) or columnar (typed row groups)")
+     ->check(CLI::IsMember({"csv", "neo4j-admin", "binary", "columnar"}));
+  app.add_option("--chunk-warehouses", chunk_warehouses,
+                 "Start a new data file every N warehouses (default: 0 = one file per table, 16 for neo4j-admin)");
+
+  app.add_option("--sort-edges", sort_edges, "Order the rows of the relationship files by start id (start) or by start "
+                 "and end id (start-end) instead of as generated (csv and neo4j-admin formats)")
+     ->check(CLI::IsMember({"none", "start", "start-end"}));
+  app.add_flag("--group-edges", group_edges, "Write one row per start id with the ';'-separated end ids to "
+               "<table>_grouped files (csv format)");
+  app.add_option("--sort-memory", sort_memory, "MiB of sorted runs per relationship table before they are merged "
+                 "to disk (default: 1024)")->check(CLI::PositiveNumber);
+  app.add_option("--id-space", id_space, "Node ids numbered per label (dense), in one id space label by label "
+                 "(global) or in one id space with a block per warehouse (clustered)")
+     ->check(CLI::IsMember({"dense", "global", "clustered"}));
+  app.add_option("--order-ids", order_ids, "Number the orders and order lines by district like TPC-C (district) or "
+                 "in the order of the customers who placed them (customer)")
+     ->check(CLI::IsMember({"district", "customer"}));
+  auto text_pool_opt = app.add_option("--text-pool", text_pool, "Draw comment and data fields from a TPC-H text pool "
+                                      "of that many MiB (default: 0 = random characters)")
+     ->check(CLI::Range(0, 4095));
+  app.add_option("--text-pool-file", text_pool_file, "Map the text pool from this file, or generate it and store it "
+                 "there for the next run")->needs(text_pool_opt);
+
+  app.add_flag("--legacy-dates", legacy_dates, "Draw months like the original generator (never December)");
+  app.add_flag("--legacy-strings", legacy_strings, "Draw random strings character by character like the original "
+               "generator");
+  app.add_flag("--legacy-rng", legacy_rng, "Map random values to ranges with a modulo and pick the original items "
+               "and stock like the original generator");
+  app.add_option("--string-kernel", string_kernel, "SIMD kernel for random strings (the output is the same for all)")
+     ->check(CLI::IsMember({"auto", "scalar", "avx2", "avx512"}));
+
+  auto report_opt = app.add_option("--report", report, "Write rows, bytes, time split and peak RSS per table and "
+                                   "phase as JSON to this file");
+  app.add_flag("--perf-counters", perf_counters, "Include hardware counters of the whole run in the report "
+               "(needs perf_event_open)")->needs(report_opt);
+  app.add_flag("--no-progress", no_progress, "Do not draw a progress bar on the terminal");
 
   CLI11_PARSE(app, argc, argv);
 
+  // Shards split the warehouses into N contiguous ranges, shard i writes its files as <table>_i_0.csv. A warehouse
+  // range a-b writes <table>_<a-1>_0.csv, so the runs of disjoint ranges can share a directory and their files sort
+  // in warehouse order.
+  std::size_t first_warehouse = 1;
+  std::size_t last_warehouse = warehouses;
+  std::size_t part = 0;
+  std::smatch match;
+  if (!shard.empty()) {
+    if (!std::regex_match(shard, match, std::regex("(\\d+)/(\\d+)"))) {
+      std::cerr << "Invalid shard '" << shard << "', expected i/N." << std::endl;
+      return 1;
+    }
+    std::size_t count = std::stoull(match[2]);
+    part = std::stoull(match[1]);
+    if (count == 0 || part >= count || count > warehouses) {
+      std::cerr << "Invalid shard '" << shard << "' for " << warehouses << " warehouses." << std::endl;
+      return 1;
+    }
+    first_warehouse = part * warehouses / count + 1;
+    last_warehouse = (part + 1) * warehouses / count;
+  } else if (!warehouse_range.empty()) {
+    if (!std::regex_match(warehouse_range, match, std::regex("(\\d+)-(\\d+)"))) {
+      std::cerr << "Invalid warehouse range '" << warehouse_range << "', expected a-b." << std::endl;
+      return 1;
+    }
+    first_warehouse = std::stoull(match[1]);
+    last_warehouse = std::stoull(match[2]);
+    if (first_warehouse < 1 || first_warehouse > last_warehouse || last_warehouse > warehouses) {
+      std::cerr << "Invalid warehouse range '" << warehouse_range << "' for " << warehouses << " warehouses." << std::endl;
+      return 1;
+    }
+    part = first_warehouse - 1;
+  }
+
+  if (append) {
+    // Every run leaves a manifest_<first>_<last>.json behind.
+    std::regex manifest_name("manifest_(\\d+)_(\\d+)\\.json");
+    std::size_t existing = 0;
+    std::error_code error;
+    for (auto &entry : std::filesystem::directory_iterator(directory, error)) {
+      std::string name = entry.path().filename().string();
+      if (!std::regex_match(name, match, manifest_name)) {
+        continue;
+      }
+      existing = std::max<std::size_t>(existing, std::stoull(match[2]));
+      // The new warehouses must use the ids of the dataset; manifests without the fields predate them and are dense.
+      std::ifstream file(entry.path());
+      std::stringstream content;
+      content << file.rdbuf();
+      std::string text = content.str();
+      const struct {
+        const char *key, *option, *implied;
+        const std::string &value;
+      } fields[] = {{"id_space", "--id-space", "dense", id_space}, {"order_ids", "--order-ids", "district", order_ids}};
+      for (auto &field : fields) {
+        std::smatch found;
+        std::string recorded = field.implied;
+        if (std::regex_search(text, found, std::regex(std::string("\"") + field.key + "\": \"(\\w+)\""))) {
+          recorded = found[1];
+        }
+        if (recorded != field.value) {
+          std::cerr << "'" << name << "' was generated with " << field.option << " " << recorded
+                    << ", cannot add warehouses with " << field.value << "." << std::endl;
+          return 1;
+        }
+      }
+    }
+    if (existing == 0) {
+      std::cerr << "No manifest found in '" << directory << "', use --from-warehouse instead." << std::endl;
+      return 1;
+    }
+    from_warehouse = existing + 1;
+  }
+  if (from_warehouse != 0) {
+    if (from_warehouse < 2 || from_warehouse > warehouses) {
+      std::cerr << "Cannot add warehouses " << from_warehouse << "-" << warehouses << " to a dataset." << std::endl;
+      return 1;
+    }
+    first_warehouse = from_warehouse;
+  }
+
+  csv::Compression compression = csv::Compression::None;
+  csv::parseCompression(compress, compression);
+  if ((format == "binary" || format == "columnar") && compression != csv::Compression::None) {
+    std::cerr << "The " << format << " format is meant to be mmap'ed and cannot be compressed." << std::endl;
+    return 1;
+  }
+  if (format == "neo4j-admin" && compression != csv::Compression::None && compression != csv::Compression::Gzip) {
+    std::cerr << "neo4j-admin import reads plain and gzip files only, use --compress gzip or none." << std::endl;
+    return 1;
+  }
+  if ((format == "binary" || format == "columnar") && (sort_edges != "none" || group_edges)) {
+    std::cerr << "The " << format << " format has its own adjacency layout, --sort-edges and --group-edges apply to "
+              << "CSV files." << std::endl;
+    return 1;
+  }
+  if (format == "neo4j-admin" && group_edges) {
+    std::cerr << "neo4j-admin import cannot read grouped relationship files." << std::endl;
+    return 1;
+  }
+  ids::Space space = ids::Space::Dense;
+  ids::parseSpace(id_space, space);
+  ids::OrderNumbering numbering = ids::OrderNumbering::District;
+  ids::parseOrderNumbering(order_ids, numbering);
+  if (format == "binary" && space != ids::Space::Dense) {
+    std::cerr << "The offsets of the binary format are indexed by dense ids, use --id-space dense." << std::endl;
+    return 1;
+  }
+  if (space == ids::Space::Global && from_warehouse != 0) {
+    std::cerr << "The global id space depends on the number of warehouses, a dataset with it cannot be extended."
+              << std::endl;
+    return 1;
+  }
+  if (!csv::isAvailable(compression)) {
+    std::cerr << "Compression '" << compress << "' is not available in this build." << std::endl;
+    return 1;
+  }
+
+  rng::StringKernel kernel = rng::StringKernel::Auto;
+  rng::parseStringKernel(string_kernel, kernel);
+  if (!rng::isSupported(kernel)) {
+    std::cerr << "String kernel '" << string_kernel << "' is not supported by this CPU." << std::endl;
+    return 1;
+  }
+  rng::setStringKernel(kernel);
+
   std::string wstr = (warehouses > 1) ? "warehouses" : "warehouse";
-  std::cout << "--------- Generating GTPC data with " << warehouses << " " << wstr << std::endl;
+  std::cout << "--------- Generating GTPC data with " << warehouses << " " << wstr;
+  if (from_warehouse != 0) {
+    std::cout << " (adding warehouses " << first_warehouse << "-" << last_warehouse << ")";
+  } else if (first_warehouse != 1 || last_warehouse != warehouses) {
+    std::cout << " (warehouses " << first_warehouse << "-" << last_warehouse << ")";
+  }
+  std::cout << std::endl;
   auto start = std::chrono::steady_clock::now();
 
-  GtpcGenerator generator((uint32_t)warehouses, directory);
-  generator.generateWarehouses();
-  generator.generateDistricts();
-  generator.generateCustomerAndHistory();
-  generator.generateItems();
-  generator.generateSuppliers();
-  generator.generateStock();
-  generator.generateOrdersAndOrderLines();
-  generator.generateRegions();
-  generator.generateNations();
+  stats::Recorder &recorder = stats::Recorder::instance();
+  recorder.setProgress(!no_progress);
+  recorder.setTiming(!report.empty());
+  recorder.setParameter("warehouses", std::to_string(warehouses));
+  recorder.setParameter("first_warehouse", std::to_string(first_warehouse));
+  recorder.setParameter("last_warehouse", std::to_string(last_warehouse));
+  recorder.setParameter("threads", std::to_string(threads));
+  recorder.setParameter("io_threads", std::to_string(io_threads));
+  recorder.setParameter("format", format);
+  recorder.setParameter("compress", compress);
+  recorder.setParameter("string_kernel", rng::kernelName(rng::activeStringKernel()));
+  recorder.setParameter("sort_edges", sort_edges + (group_edges ? ",grouped" : ""));
+  recorder.setParameter("id_space", id_space);
+  recorder.setParameter("order_ids", order_ids);
+  recorder.setParameter("text_pool_mib", std::to_string(text_pool));
+
+  // Opened before any thread is started, so the generator and I/O threads inherit the counters.
+  stats::HardwareCounters counters;
+  if (perf_counters && !counters.open()) {
+    std::cerr << "Hardware counters are not available: " << counters.error() << std::endl;
+  }
+
+  csv::OutputStage::configure(io_threads, io_queue, compression, compress_level);
+
+  {
+    GtpcGenerator generator((uint32_t)warehouses, directory, threads);
+    if (from_warehouse != 0) {
+      generator.setAppend(from_warehouse);
+    } else {
+      generator.setWarehouseRange(first_warehouse, last_warehouse, part);
+    }
+    generator.setLegacyDates(legacy_dates);
+    generator.setLegacyStrings(legacy_strings);
+    generator.setLegacyRng(legacy_rng);
+    generator.setTextPool(text_pool << 20, text_pool_file);
+    if (format == "neo4j-admin") {
+      generator.setOutputFormat(csv::Format::Neo4jAdmin, chunk_warehouses > 0 ? chunk_warehouses : 16);
+    } else if (format == "binary") {
+      generator.setOutputFormat(csv::Format::Binary, 0);
+    } else if (format == "columnar") {
+      generator.setOutputFormat(csv::Format::Columnar, 0);
+    } else {
+      generator.setOutputFormat(csv::Format::Csv, chunk_warehouses);
+    }
+    generator.setIdLayout(space, numbering);
+    if (sort_edges != "none" || group_edges) {
+      csv::EdgeOrder order = sort_edges == "start-end" ? csv::EdgeOrder::StartEnd
+                             : sort_edges == "start" ? csv::EdgeOrder::Start : csv::EdgeOrder::Generation;
+      generator.setEdgeOrder(order, group_edges, sort_memory << 20);
+    }
+    generator.generateWarehouses();
+    generator.generateDistricts();
+    generator.generateCustomerAndHistory();
+    if (generator.writesSharedTables()) {
+      generator.generateItems();
+      generator.generateSuppliers();
+    }
+    generator.generateStock();
+    generator.generateOrdersAndOrderLines();
+    if (generator.writesSharedTables()) {
+      generator.generateRegions();
+      generator.generateNations();
+    }
+    if (format == "neo4j-admin" && (generator.writesSharedTables() || from_warehouse != 0)) {
+      generator.writeImportArguments();
+    }
+    generator.writeManifest();
+  }
 
   auto end = std::chrono::steady_clock::now();
   double t = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
   std::cout << "--------- Data generation completed in " << t << " msecs." << std::endl;
 
+  // The counts of the generator threads are complete now that they have exited with the generator.
+  if (!report.empty() && !recorder.writeReport(report, counters.read())) {
+    std::cerr << "Cannot write report '" << report << "'." << std::endl;
+    return 1;
+  }
+
   return 0;
 }
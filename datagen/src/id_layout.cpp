@@ -0,0 +1,154 @@
+/*
+ * The implementation of the GTPC graph data generator was built on
+ * Florian Wolf's implementation of the CH-benCHmark data generator
+ * (https://db.in.tum.de/research/projects/CHbenCHmark/) and
+ * Alexander van Renen's implementation of the TPC-C data generator
+ * (https://github.com/alexandervanrenen/tpcc-generator)
+ * See the README file.
+ */
+
+#include "id_layout.hpp"
+
+#include <utility>
+
+namespace ids {
+
+namespace {
+
+const int64_t kItemCount = 100000;
+const int64_t kSupplierCount = 10000;
+const int64_t kRegionCount = 5;
+// Nations are identified by the character code of their key, '0' to 'z'.
+const int64_t kFirstNationCode = '0';
+const int64_t kLastNationCode = 'z';
+const int64_t kDistrictsPerWarehouse = 10;
+const int64_t kCustomersPerWarehouse = 30000;
+const int64_t kMaxOrderLinesPerWarehouse = 15 * kCustomersPerWarehouse;
+
+// Nodes per warehouse of the labels in a block of Clustered.
+int64_t perWarehouse(Label label) {
+   switch (label) {
+      case Label::District:
+         return kDistrictsPerWarehouse;
+      case Label::Customer:
+      case Label::Order:
+         return kCustomersPerWarehouse;
+      case Label::Stock:
+         return kItemCount;
+      case Label::OrderLine:
+         return kMaxOrderLinesPerWarehouse;
+      default:
+         return 1;
+   }
+}
+
+// Ids per warehouse block of Clustered.
+const int64_t kBlockSize = 1 + kDistrictsPerWarehouse + 2 * kCustomersPerWarehouse + kMaxOrderLinesPerWarehouse +
+                           kItemCount;
+
+bool isShared(Label label) {
+   return label<=Label::Nation;
+}
+
+}
+
+bool parseSpace(const std::string &name, Space &space) {
+   if (name == "dense") {
+      space = Space::Dense;
+   } else if (name == "global") {
+      space = Space::Global;
+   } else if (name == "clustered") {
+      space = Space::Clustered;
+   } else {
+      return false;
+   }
+   return true;
+}
+
+const char *spaceName(Space space) {
+   switch (space) {
+      case Space::Dense:
+         return "dense";
+      case Space::Global:
+         return "global";
+      case Space::Clustered:
+         return "clustered";
+   }
+   return "unknown";
+}
+
+bool parseOrderNumbering(const std::string &name, OrderNumbering &numbering) {
+   if (name == "district") {
+      numbering = OrderNumbering::District;
+   } else if (name == "customer") {
+      numbering = OrderNumbering::Customer;
+   } else {
+      return false;
+   }
+   return true;
+}
+
+const char *orderNumberingName(OrderNumbering numbering) {
+   switch (numbering) {
+      case OrderNumbering::District:
+         return "district";
+      case OrderNumbering::Customer:
+         return "customer";
+   }
+   return "unknown";
+}
+
+IdLayout::IdLayout(Space space, int64_t warehouse_count) : space(space) {
+   if (space == Space::Dense) {
+      return;
+   }
+   // First and last dense id of every label; the supplier of a stock is drawn from 0 to 10000 and the nation of a
+   // customer from all key characters, so both ranges include ids without a node.
+   const std::pair<int64_t, int64_t> ranges[] = {
+      {1, kItemCount}, {0, kSupplierCount}, {0, kRegionCount - 1}, {kFirstNationCode, kLastNationCode},
+      {1, warehouse_count}, {1, warehouse_count * kDistrictsPerWarehouse},
+      {1, warehouse_count * kCustomersPerWarehouse}, {1, warehouse_count * kItemCount},
+      {1, warehouse_count * kCustomersPerWarehouse}, {1, 0}
+   };
+   int64_t next = 1;
+   for (size_t l = 0; l<base.size(); l++) {
+      Label label = static_cast<Label>(l);
+      if (space == Space::Clustered && !isShared(label)) {
+         break;
+      }
+      base[l] = next - ranges[l].first;
+      next += ranges[l].second - ranges[l].first + 1;
+   }
+   if (space == Space::Clustered) {
+      first_block = next;
+      int64_t offset = 0;
+      for (Label label : {Label::Warehouse, Label::District, Label::Customer, Label::Order, Label::OrderLine,
+                          Label::Stock}) {
+         base[static_cast<size_t>(label)] = offset;
+         offset += perWarehouse(label);
+      }
+   }
+}
+
+int64_t IdLayout::mapId(Label label, int64_t dense) const {
+   if (space == Space::Global || isShared(label)) {
+      return base[static_cast<size_t>(label)] + dense;
+   }
+   int64_t count = perWarehouse(label);
+   int64_t warehouse = (dense - 1) / count;
+   return first_block + warehouse * kBlockSize + base[static_cast<size_t>(label)] + (dense - 1) % count;
+}
+
+int64_t IdLayout::orderLine(int64_t warehouse, int64_t index, int64_t dense) const {
+   switch (space) {
+      case Space::Dense:
+         return dense;
+      case Space::Global:
+         return base[static_cast<size_t>(Label::OrderLine)] + dense;
+      case Space::Clustered:
+         return first_block + (warehouse - 1) * kBlockSize + base[static_cast<size_t>(Label::OrderLine)] + index - 1;
+   }
+   return dense;
+}
+
+}
@@ -0,0 +1,74 @@
+/*
+ * The implementation of the GTPC graph data generator was built on
+ * Florian Wolf's implementation of the CH-benCHmark data generator
+ * (https://db.in.tum.de/research/projects/CHbenCHmark/) and
+ * Alexander van Renen's implementation of the TPC-C data generator
+ * (https://github.com/alexandervanrenen/tpcc-generator)
+ * See the README file.
+ */
+
+#ifndef id_layout_hpp_
+#define id_layout_hpp_
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+// Assignment of node ids. The generator numbers every label on its own, in generation order: the nodes of warehouse
+// 1, then the ones of warehouse 2 and so on. These dense ids are what the generator, the workload and the query
+// parameters compute with; IdLayout maps them to the ids that are written, so all tools agree on the ids of a
+// dataset as long as they use the same layout.
+namespace ids {
+
+enum class Label : uint8_t {
+   Item, Supplier, Region, Nation, Warehouse, District, Customer, Stock, Order, OrderLine
+};
+
+enum class Space : uint8_t {
+   Dense,     // every label numbered on its own, 1 to n (Region from 0, Nation by its code)
+   Global,    // one id space, the labels one after the other
+   Clustered  // one id space, all nodes of a warehouse in one block
+};
+
+// Numbering of the orders, and with them of the order lines.
+enum class OrderNumbering : uint8_t {
+   District,  // by warehouse and district, like TPC-C's O_ID
+   Customer   // order n is placed by customer n, its lines follow the ones of the customer before
+};
+
+bool parseSpace(const std::string &name, Space &space);
+const char *spaceName(Space space);
+bool parseOrderNumbering(const std::string &name, OrderNumbering &numbering);
+const char *orderNumberingName(OrderNumbering numbering);
+
+// Global stacks the ranges of the labels in the order of Label, starting with the shared ones, so Item keeps its ids
+// 1 to 100000. It depends on the number of warehouses. Clustered puts the shared labels first as well and then gives
+// every warehouse a block of the same size with its Warehouse, District, Customer, Order, OrderLine and Stock nodes,
+// in that order, so a traversal from a customer to its order lines stays within a few pages. The blocks reserve 15
+// order lines per order, the ids of the order lines are not dense.
+class IdLayout {
+   Space space;
+   // Global and the shared labels of Clustered: id of the dense id 0 of the label. Clustered: offset of the label in
+   // the block of a warehouse.
+   std::array<int64_t, 10> base = {};
+   int64_t first_block = 0;
+
+   int64_t mapId(Label label, int64_t dense) const;
+
+public:
+   // Global needs the number of warehouses of the whole dataset.
+   explicit IdLayout(Space space = Space::Dense, int64_t warehouse_count = 0);
+
+   Space getSpace() const { return space; }
+
+   // Id of the node with the given dense id; not for OrderLine, whose dense ids depend on the order line counts.
+   int64_t id(Label label, int64_t dense) const {
+      return space == Space::Dense ? dense : mapId(label, dense);
+   }
+   // Id of the order line with the given dense id, the index-th (from 1) one numbered for the warehouse.
+   int64_t orderLine(int64_t warehouse, int64_t index, int64_t dense) const;
+};
+
+}
+
+#endif
@@ -0,0 +1,334 @@
+/*
+ * The implementation of the GTPC graph data generator was built on
+ * Florian Wolf's implementation of the CH-benCHmark data generator
+ * (https://db.in.tum.de/research/projects/CHbenCHmark/) and
+ * Alexander van Renen's implementation of the TPC-C data generator
+ * (https://github.com/alexandervanrenen/tpcc-generator)
+ * See the README file.
+ */
+
+#include "instrumentation.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#include <linux/perf_event.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace stats {
+
+namespace {
+
+double seconds(Clock::duration duration) {
+   return std::chrono::duration<double>(duration).count();
+}
+
+double seconds(int64_t ns) {
+   return ns / 1e9;
+}
+
+std::string quote(const std::string &str) {
+   std::string result = "\"";
+   for (char c : str) {
+      if (c == '"' || c == '\\') {
+         result += '\\';
+      }
+      result += c;
+   }
+   return result + "\"";
+}
+
+// 1h02m03s, 2m03s or 3s
+std::string duration(double seconds) {
+   uint64_t s = seconds;
+   char buffer[32];
+   if (s>=3600) {
+      snprintf(buffer, sizeof(buffer), "%luh%02lum%02lus", s / 3600, s / 60 % 60, s % 60);
+   } else if (s>=60) {
+      snprintf(buffer, sizeof(buffer), "%lum%02lus", s / 60, s % 60);
+   } else {
+      snprintf(buffer, sizeof(buffer), "%lus", s);
+   }
+   return buffer;
+}
+
+}
+
+uint64_t peakRssKb() {
+   struct rusage usage;
+   getrusage(RUSAGE_SELF, &usage);
+   return usage.ru_maxrss;
+}
+
+double processCpuSeconds() {
+   struct timespec ts;
+   clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+   return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+Recorder &Recorder::instance() {
+   static Recorder recorder;
+   return recorder;
+}
+
+void Recorder::setProgress(bool enabled) {
+   progress = enabled && isatty(STDERR_FILENO) && isatty(STDOUT_FILENO);
+}
+
+void Recorder::setParameter(const std::string &key, const std::string &value) {
+   std::lock_guard<std::mutex> lock(mutex);
+   parameters.emplace_back(key, value);
+}
+
+void Recorder::beginPhase(const std::string &name, uint64_t units) {
+   std::lock_guard<std::mutex> lock(mutex);
+   phases.push_back(PhaseStats{name});
+   in_phase = true;
+   this->units = units;
+   units_done = 0;
+   generation.clear();
+   io_wait_ns = 0;
+   phase_start = Clock::now();
+   phase_cpu_start = processCpuSeconds();
+   draw(true);
+}
+
+void Recorder::advance(uint64_t done) {
+   std::lock_guard<std::mutex> lock(mutex);
+   units_done += done;
+   draw(false);
+}
+
+void Recorder::endPhase() {
+   std::lock_guard<std::mutex> lock(mutex);
+   if (!in_phase) {
+      return;
+   }
+   PhaseStats &phase = phases.back();
+   phase.wall = seconds(Clock::now() - phase_start);
+   phase.cpu = processCpuSeconds() - phase_cpu_start;
+   for (auto &[name, random, format] : generation) {
+      auto table = std::find_if(phase.tables.begin(), phase.tables.end(), [&](const TableStats &t) {
+         return t.name == name;
+      });
+      if (table == phase.tables.end()) {
+         table = phase.tables.insert(phase.tables.end(), TableStats{name});
+      }
+      table->random += seconds(random);
+      table->format += seconds(format);
+      phase.random += seconds(random);
+      phase.format += seconds(format);
+   }
+   phase.io_wait = seconds(io_wait_ns.load());
+   phase.peak_rss_kb = peakRssKb();
+   in_phase = false;
+   if (progress) {
+      // Save the cursor, clear the bar behind it and restore, so the phase message continues with "done.".
+      std::cerr << "\0337\033[K\0338" << std::flush;
+   }
+}
+
+void Recorder::addTable(const std::string &name, uint64_t rows, uint64_t bytes) {
+   std::lock_guard<std::mutex> lock(mutex);
+   if (phases.empty()) {
+      phases.push_back(PhaseStats{"unnamed"});
+   }
+   phases.back().tables.push_back(TableStats{name, rows, bytes});
+}
+
+void Recorder::addGeneration(const char *table, int64_t random, int64_t format) {
+   std::lock_guard<std::mutex> lock(mutex);
+   auto entry = std::find_if(generation.begin(), generation.end(), [&](const auto &g) {
+      return std::get<0>(g) == table;
+   });
+   if (entry == generation.end()) {
+      generation.emplace_back(table, random, format);
+   } else {
+      std::get<1>(*entry) += random;
+      std::get<2>(*entry) += format;
+   }
+}
+
+void Recorder::draw(bool force) {
+   if (!progress) {
+      return;
+   }
+   Clock::time_point now = Clock::now();
+   if (!force && now - last_draw<std::chrono::milliseconds(100) && units_done<units) {
+      return;
+   }
+   last_draw = now;
+
+   const int width = 20;
+   double fraction = units>0 ? double(units_done) / units : 0;
+   int filled = fraction * width;
+   char bar[width + 3] = {};
+   for (int i = 0; i<width; i++) {
+      bar[i + 1] = i<filled ? '#' : '.';
+   }
+   bar[0] = '[';
+   bar[width + 1] = ']';
+   char buffer[96];
+   double elapsed = seconds(now - phase_start);
+   std::string eta = units_done>0 ? duration(elapsed * (units - units_done) / units_done) : "?";
+   snprintf(buffer, sizeof(buffer), " %s %3d%% %lu/%lu ETA %s", bar, int(fraction * 100), units_done, units,
+            eta.c_str());
+   // Drawn behind the phase message on stdout; the cursor goes back to where the message ended.
+   std::cerr << "\0337" << buffer << "\033[K\0338" << std::flush;
+}
+
+bool Recorder::writeReport(const std::string &path, const std::vector<std::pair<std::string, uint64_t>> &counters) {
+   std::lock_guard<std::mutex> lock(mutex);
+   std::ofstream out(path);
+   char number[64];
+   auto fixed = [&](double value) {
+      snprintf(number, sizeof(number), "%.6f", value);
+      return std::string(number);
+   };
+   auto rate = [&](double amount, double seconds) {
+      return fixed(seconds>0 ? amount / seconds : 0);
+   };
+
+   out << "{\n  \"parameters\": {";
+   for (size_t i = 0; i<parameters.size(); i++) {
+      out << (i>0 ? "," : "") << "\n    " << quote(parameters[i].first) << ": " << quote(parameters[i].second);
+   }
+   out << "\n  },\n";
+
+   uint64_t total_rows = 0;
+   uint64_t total_bytes = 0;
+   out << "  \"phases\": [";
+   for (size_t p = 0; p<phases.size(); p++) {
+      const PhaseStats &phase = phases[p];
+      uint64_t rows = 0;
+      uint64_t bytes = 0;
+      for (const TableStats &table : phase.tables) {
+         rows += table.rows;
+         bytes += table.bytes;
+      }
+      total_rows += rows;
+      total_bytes += bytes;
+
+      out << (p>0 ? "," : "") << "\n    {\n";
+      out << "      \"name\": " << quote(phase.name) << ",\n";
+      out << "      \"wall_seconds\": " << fixed(phase.wall) << ",\n";
+      out << "      \"cpu_seconds\": " << fixed(phase.cpu) << ",\n";
+      out << "      \"rng_seconds\": " << fixed(phase.random) << ",\n";
+      out << "      \"format_seconds\": " << fixed(phase.format) << ",\n";
+      out << "      \"io_wait_seconds\": " << fixed(phase.io_wait) << ",\n";
+      out << "      \"peak_rss_kb\": " << phase.peak_rss_kb << ",\n";
+      out << "      \"rows\": " << rows << ",\n";
+      out << "      \"bytes\": " << bytes << ",\n";
+      out << "      \"rows_per_second\": " << rate(rows, phase.wall) << ",\n";
+      out << "      \"tables\": [";
+      for (size_t t = 0; t<phase.tables.size(); t++) {
+         const TableStats &table = phase.tables[t];
+         out << (t>0 ? "," : "") << "\n        {\"name\": " << quote(table.name) << ", \"rows\": " << table.rows
+             << ", \"bytes\": " << table.bytes << ", \"rows_per_second\": " << rate(table.rows, phase.wall)
+             << ", \"bytes_per_second\": " << rate(table.bytes, phase.wall) << ", \"rng_seconds\": "
+             << fixed(table.random) << ", \"format_seconds\": " << fixed(table.format) << "}";
+      }
+      out << "\n      ]\n    }";
+   }
+   out << "\n  ],\n";
+
+   double wall = seconds(Clock::now() - run_start);
+   out << "  \"total\": {\n";
+   out << "    \"wall_seconds\": " << fixed(wall) << ",\n";
+   out << "    \"cpu_seconds\": " << fixed(processCpuSeconds()) << ",\n";
+   out << "    \"peak_rss_kb\": " << peakRssKb() << ",\n";
+   out << "    \"rows\": " << total_rows << ",\n";
+   out << "    \"bytes\": " << total_bytes << ",\n";
+   out << "    \"rows_per_second\": " << rate(total_rows, wall) << "\n";
+   out << "  },\n";
+
+   out << "  \"hardware_counters\": {";
+   for (size_t i = 0; i<counters.size(); i++) {
+      out << (i>0 ? "," : "") << "\n    " << quote(counters[i].first) << ": " << counters[i].second;
+   }
+   out << (counters.empty() ? "}\n" : "\n  }\n");
+   out << "}\n";
+   return bool(out);
+}
+
+void Laps::charge(const char *table, bool random, int64_t ns) {
+   auto entry = std::find_if(totals.begin(), totals.end(), [&](const Totals &t) { return t.table == table; });
+   if (entry == totals.end()) {
+      entry = totals.insert(totals.end(), Totals{table, 0, 0});
+   }
+   (random ? entry->random_ns : entry->format_ns) += ns;
+}
+
+Laps::~Laps() {
+   for (const Totals &t : totals) {
+      Recorder::instance().addGeneration(t.table, t.random_ns, t.format_ns);
+   }
+}
+
+Phase::Phase(const std::string &name, const std::string &message, uint64_t units) {
+   std::cout << message << std::flush;
+   Recorder::instance().beginPhase(name, units);
+}
+
+Phase::~Phase() {
+   Recorder::instance().endPhase();
+   std::cout << "done." << std::endl;
+}
+
+HardwareCounters::~HardwareCounters() {
+   for (auto &event : events) {
+      close(event.second);
+   }
+}
+
+bool HardwareCounters::open() {
+   struct Event {
+      const char *name;
+      uint64_t config;
+   };
+   static const Event kEvents[] = {
+      {"cycles",           PERF_COUNT_HW_CPU_CYCLES},
+      {"instructions",     PERF_COUNT_HW_INSTRUCTIONS},
+      {"cache_references", PERF_COUNT_HW_CACHE_REFERENCES},
+      {"cache_misses",     PERF_COUNT_HW_CACHE_MISSES},
+      {"branch_misses",    PERF_COUNT_HW_BRANCH_MISSES},
+   };
+
+   for (const Event &event : kEvents) {
+      struct perf_event_attr attr;
+      memset(&attr, 0, sizeof(attr));
+      attr.size = sizeof(attr);
+      attr.type = PERF_TYPE_HARDWARE;
+      attr.config = event.config;
+      attr.inherit = 1;
+      attr.exclude_kernel = 1;
+      attr.exclude_hv = 1;
+      int fd = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+      if (fd<0) {
+         message = std::string("perf_event_open failed for ") + event.name + ": " + strerror(errno);
+         continue;
+      }
+      events.emplace_back(event.name, fd);
+   }
+   return !events.empty();
+}
+
+std::vector<std::pair<std::string, uint64_t>> HardwareCounters::read() const {
+   std::vector<std::pair<std::string, uint64_t>> counts;
+   for (auto &event : events) {
+      uint64_t count = 0;
+      if (::read(event.second, &count, sizeof(count)) == sizeof(count)) {
+         counts.emplace_back(event.first, count);
+      }
+   }
+   return counts;
+}
+
+}
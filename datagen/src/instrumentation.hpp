@@ -0,0 +1,195 @@
+/*
+ * The implementation of the GTPC graph data generator was built on
+ * Florian Wolf's implementation of the CH-benCHmark data generator
+ * (https://db.in.tum.de/research/projects/CHbenCHmark/) and
+ * Alexander van Renen's implementation of the TPC-C data generator
+ * (https://github.com/alexandervanrenen/tpcc-generator)
+ * See the README file.
+ */
+
+#ifndef instrumentation_hpp_
+#define instrumentation_hpp_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+// Where the time of a run goes. Every generate* step of the generator is one phase; per phase the Recorder keeps wall
+// and CPU time, the time the generator threads spent waiting for the output stage, the peak RSS and per table file
+// written its rows and bytes and the time spent drawing its random values and formatting its rows. The result is
+// printed as a progress bar while running and written as a JSON report at the end.
+namespace stats {
+
+using Clock = std::chrono::steady_clock;
+
+struct TableStats {
+   std::string name;
+   uint64_t rows = 0;
+   uint64_t bytes = 0;   // before compression
+   double random = 0;    // seconds, summed over the generator threads, estimated from a sample of the rows
+   double format = 0;
+};
+
+struct PhaseStats {
+   std::string name;
+   double wall = 0;      // seconds
+   double cpu = 0;       // all threads of the process
+   double random = 0;    // sums of the tables
+   double format = 0;
+   double io_wait = 0;
+   uint64_t peak_rss_kb = 0;
+   std::vector<TableStats> tables;
+};
+
+class Recorder {
+   std::mutex mutex;
+   std::vector<PhaseStats> phases;
+   std::vector<std::pair<std::string, std::string>> parameters;
+   bool progress = false;
+   bool timing = false;
+   bool in_phase = false;
+
+   Clock::time_point run_start = Clock::now();
+   Clock::time_point phase_start;
+   double phase_cpu_start = 0;
+   uint64_t units = 0;
+   uint64_t units_done = 0;
+   Clock::time_point last_draw;
+
+   // Nanoseconds drawing random values and formatting rows per table of the phase.
+   std::vector<std::tuple<std::string, int64_t, int64_t>> generation;
+   std::atomic<int64_t> io_wait_ns{0};
+
+   void draw(bool force);
+
+public:
+   static Recorder &instance();
+
+   // Draws a progress bar with ETA on stderr; only honoured if stderr is a terminal.
+   void setProgress(bool enabled);
+   // Splits the generation time into drawing random values and formatting rows (see Laps). Costs a little time per
+   // row, so only turned on for a report. Not thread-safe, call it before generating.
+   void setTiming(bool enabled) { timing = enabled; }
+   bool isTiming() const { return timing; }
+   // Run parameter included in the report, e.g. ("warehouses", "100").
+   void setParameter(const std::string &key, const std::string &value);
+
+   // units is the amount of work of the phase for the progress bar, e.g. the number of warehouses.
+   void beginPhase(const std::string &name, uint64_t units);
+   void advance(uint64_t done = 1);
+   void endPhase();
+
+   void addTable(const std::string &name, uint64_t rows, uint64_t bytes);
+   void addGeneration(const char *table, int64_t random, int64_t format);
+   void addIoWait(int64_t ns) { io_wait_ns.fetch_add(ns, std::memory_order_relaxed); }
+
+   // Completed phases; only to be read while no phase is running.
+   const std::vector<PhaseStats> &getPhases() const { return phases; }
+
+   // Writes the parameters, the phases and the given hardware counters as JSON; returns false if path can't be written.
+   bool writeReport(const std::string &path, const std::vector<std::pair<std::string, uint64_t>> &counters);
+};
+
+// One generate* step: prints message, records the phase until destruction and prints "done.". Declare it before the
+// TableWriters of the step, so their files are closed and counted within the phase.
+class Phase {
+public:
+   Phase(const std::string &name, const std::string &message, uint64_t units);
+   ~Phase();
+};
+
+// Splits the time of a row loop: random(table) charges the time since the previous lap to drawing the random values
+// of the table, format(table) to formatting its rows. Reading the clock twice per row would cost more than formatting
+// a relationship row, so only a random sample of one in kSample laps is timed and counted kSample times; without
+// Recorder::setTiming nothing is timed at all. One per thread and chunk; the totals go to the Recorder on destruction.
+class Laps {
+   static constexpr uint32_t kSample = 64;
+   static constexpr int64_t kPreempted = 1000000;
+
+   struct Totals {
+      const char *table;
+      int64_t random_ns;
+      int64_t format_ns;
+   };
+
+   bool enabled = Recorder::instance().isTiming();
+   bool sampled = false;  // the current lap is timed
+   uint32_t state = 0x9E3779B9;
+   Clock::time_point start;
+   std::vector<Totals> totals;
+
+   void lap(const char *table, bool random) {
+      if (!enabled) {
+         return;
+      }
+      Clock::time_point now;
+      if (sampled) {
+         now = Clock::now();
+         int64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(now - start).count();
+         // A row takes microseconds; a longer lap was descheduled, and counted kSample times it would swamp the rest.
+         if (ns<kPreempted) {
+            charge(table, random, ns * kSample);
+         }
+         sampled = false;
+      }
+      // xorshift32, the rows of a loop alternate between the kinds of laps in patterns a fixed period would follow.
+      state ^= state << 13;
+      state ^= state >> 17;
+      state ^= state << 5;
+      if (state % kSample == 0) {
+         start = now == Clock::time_point() ? Clock::now() : now;
+         sampled = true;
+      }
+   }
+   void charge(const char *table, bool random, int64_t ns);
+
+public:
+   ~Laps();
+
+   void random(const char *table) { lap(table, true); }
+   void format(const char *table) { lap(table, false); }
+};
+
+// Times a wait of a generator thread for the output stage.
+class IoWait {
+   Clock::time_point start = Clock::now();
+
+public:
+   ~IoWait() {
+      Recorder::instance().addIoWait(
+         std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+   }
+};
+
+// Hardware counters of this process via perf_event_open (cycles, instructions, cache and branch misses). Threads
+// inherit the counters, but the counts of a thread only show up once it has exited, so open them before the
+// generator creates its threads and read them after it is gone.
+class HardwareCounters {
+   std::vector<std::pair<std::string, int>> events;
+   std::string message;
+
+public:
+   HardwareCounters() = default;
+   HardwareCounters(const HardwareCounters &) = delete;
+   HardwareCounters &operator=(const HardwareCounters &) = delete;
+   ~HardwareCounters();
+
+   // Returns false and sets error() if no counter could be opened, e.g. due to perf_event_paranoid.
+   bool open();
+   const std::string &error() const { return message; }
+   std::vector<std::pair<std::string, uint64_t>> read() const;
+};
+
+// Peak resident set size of the process so far.
+uint64_t peakRssKb();
+// CPU time of all threads of the process so far, in seconds.
+double processCpuSeconds();
+
+}
+
+#endif
@@ -0,0 +1,185 @@
+/*
+ * The implementation of the GTPC graph data generator was built on
+ * Florian Wolf's implementation of the CH-benCHmark data generator
+ * (https://db.in.tum.de/research/projects/CHbenCHmark/) and
+ * Alexander van Renen's implementation of the TPC-C data generator
+ * (https://github.com/alexandervanrenen/tpcc-generator)
+ * See the README file.
+ */
+
+#include "output_stage.hpp"
+#include "instrumentation.hpp"
+
+#include <cerrno>
+#include <iostream>
+#include <unistd.h>
+
+namespace csv {
+
+uint32_t OutputStage::configured_threads = 1;
+size_t OutputStage::configured_max_queued = 64;
+Compression OutputStage::configured_compression = Compression::None;
+int OutputStage::configured_level = -1;
+
+OutputStage::OutputStage(uint32_t io_threads, size_t max_queued, Compression compression, int level)
+        : max_queued(std::max<size_t>(max_queued, 1)), compression(compression), level(level) {
+   for (uint32_t i = 0; i<std::max<uint32_t>(io_threads, 1); i++) {
+      threads.emplace_back([this] { run(); });
+   }
+}
+
+OutputStage::~OutputStage() {
+   {
+      std::lock_guard<std::mutex> lock(mutex);
+      stopping = true;
+   }
+   job_available.notify_all();
+   for (auto &thread : threads) {
+      thread.join();
+   }
+}
+
+void OutputStage::configure(uint32_t io_threads, size_t max_queued, Compression compression, int level) {
+   configured_threads = io_threads;
+   configured_max_queued = max_queued;
+   configured_compression = compression;
+   configured_level = level;
+}
+
+OutputStage &OutputStage::instance() {
+   static OutputStage stage(configured_threads, configured_max_queued, configured_compression, configured_level);
+   return stage;
+}
+
+Block OutputStage::acquire() {
+   {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (!free_blocks.empty()) {
+         Block block = std::move(free_blocks.back());
+         free_blocks.pop_back();
+         return block;
+      }
+   }
+   Block block;
+   block.data = std::make_unique<char[]>(kBlockSize);
+   return block;
+}
+
+void OutputStage::release(Block block) {
+   block.used = 0;
+   std::lock_guard<std::mutex> lock(mutex);
+   // Keep enough blocks around to refill the queue, free the rest.
+   if (free_blocks.size()<max_queued) {
+      free_blocks.push_back(std::move(block));
+   }
+}
+
+void OutputStage::submit(OutputFile &file, Block block) {
+   if (block.used == 0) {
+      release(std::move(block));
+      return;
+   }
+   {
+      std::unique_lock<std::mutex> lock(mutex);
+      if (jobs.size()>=max_queued) {
+         stats::IoWait stall;
+         space_available.wait(lock, [this] { return jobs.size()<max_queued; });
+      }
+      file.bytes += block.used;
+      uint64_t offset;
+      if (compression == Compression::None) {
+         offset = file.offset;
+         file.offset += block.used;
+      } else {
+         offset = file.submitted++;
+      }
+      file.pending++;
+      jobs.push_back(Job{&file, offset, std::move(block)});
+   }
+   job_available.notify_one();
+}
+
+void OutputStage::wait(OutputFile &file) {
+   std::unique_lock<std::mutex> lock(mutex);
+   if (file.pending>0) {
+      stats::IoWait stall;
+      job_done.wait(lock, [&file] { return file.pending == 0; });
+   }
+}
+
+void OutputStage::write(OutputFile &file, const char *data, size_t size, uint64_t offset) {
+   while (size>0) {
+      ssize_t written = pwrite(file.fd, data, size, offset);
+      if (written<0) {
+         if (errno == EINTR) {
+            continue;
+         }
+         std::cout << "\nCannot write to file: '" << file.path << "'." << std::endl;
+         std::cout << "aborting..." << std::endl;
+         exit(-1);
+      }
+      data += written;
+      size -= written;
+      offset += written;
+   }
+}
+
+void OutputStage::compressAndWrite(Job &job, std::vector<char> &buffer) {
+   OutputFile &file = *job.file;
+   compress(compression, level, job.block.data.get(), job.block.used, buffer);
+   release(std::move(job.block));
+
+   // Place this block and every successor that is already compressed. Each placed block is written by the thread that
+   // placed it, one at a time, so the number of buffers in flight stays bounded by the number of threads.
+   std::unique_lock<std::mutex> lock(mutex);
+   file.compressed.emplace(job.offset, std::move(buffer));
+   while (true) {
+      auto it = file.compressed.find(file.placed);
+      if (it == file.compressed.end()) {
+         break;
+      }
+      std::vector<char> data = std::move(it->second);
+      file.compressed.erase(it);
+      uint64_t offset = file.offset;
+      file.offset += data.size();
+      file.placed++;
+      lock.unlock();
+      write(file, data.data(), data.size(), offset);
+      lock.lock();
+      file.pending--;
+      job_done.notify_all();
+   }
+   buffer.clear();
+}
+
+void OutputStage::run() {
+   std::vector<char> buffer;
+   while (true) {
+      Job job;
+      {
+         std::unique_lock<std::mutex> lock(mutex);
+         job_available.wait(lock, [this] { return stopping || !jobs.empty(); });
+         if (jobs.empty()) {
+            return;
+         }
+         job = std::move(jobs.front());
+         jobs.pop_front();
+      }
+      space_available.notify_one();
+
+      if (compression != Compression::None) {
+         compressAndWrite(job, buffer);
+         continue;
+      }
+
+      write(*job.file, job.block.data.get(), job.block.used, job.offset);
+      release(std::move(job.block));
+      {
+         std::lock_guard<std::mutex> lock(mutex);
+         job.file->pending--;
+      }
+      job_done.notify_all();
+   }
+}
+
+}
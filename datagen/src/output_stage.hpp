@@ -0,0 +1,106 @@
+/*
+ * The implementation of the GTPC graph data generator was built on
+ * Florian Wolf's implementation of the CH-benCHmark data generator
+ * (https://db.in.tum.de/research/projects/CHbenCHmark/) and
+ * Alexander van Renen's implementation of the TPC-C data generator
+ * (https://github.com/alexandervanrenen/tpcc-generator)
+ * See the README file.
+ */
+
+#ifndef output_stage_hpp_
+#define output_stage_hpp_
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "compression.hpp"
+
+namespace csv {
+
+// Fixed-size buffer that is filled by a generator thread and written out by an I/O thread.
+struct Block {
+   std::unique_ptr<char[]> data;
+   size_t used = 0;
+};
+
+// Destination of blocks. The byte offset of every block is fixed when it is submitted, so the I/O threads can write
+// the blocks of one file in any order and concurrently. With compression the size is only known afterwards: blocks
+// are numbered on submit and a compressed block is placed once all blocks before it have been placed.
+struct OutputFile {
+   int fd = -1;
+   std::string path;
+   uint64_t offset = 0;     // end of the data submitted (compression: placed) so far
+   uint64_t bytes = 0;      // uncompressed bytes submitted so far
+   uint64_t pending = 0;    // submitted blocks not yet written
+   uint64_t submitted = 0;  // compression only: sequence number of the next submitted block
+   uint64_t placed = 0;     // compression only: sequence number of the next block to place
+   std::map<uint64_t, std::vector<char>> compressed;  // compressed blocks waiting for their predecessors
+};
+
+// Decouples generation from disk I/O: generator threads hand full blocks to dedicated I/O threads and continue with a
+// recycled block right away. At most max_queued blocks wait for the disk; submit() blocks beyond that, which keeps
+// memory bounded when the disk is slower than the generator. If compression is configured, the same threads compress
+// every block on its own before writing it, so generation does not wait for the codec either.
+class OutputStage {
+   struct Job {
+      OutputFile *file;
+      uint64_t offset;    // sequence number with compression
+      Block block;
+   };
+
+   const size_t max_queued;
+   const Compression compression;
+   const int level;
+
+   std::mutex mutex;
+   std::condition_variable job_available;
+   std::condition_variable space_available;
+   std::condition_variable job_done;
+   std::deque<Job> jobs;
+   std::vector<Block> free_blocks;
+   bool stopping = false;
+   std::vector<std::thread> threads;
+
+   void run();
+   void write(OutputFile &file, const char *data, size_t size, uint64_t offset);
+   void compressAndWrite(Job &job, std::vector<char> &buffer);
+
+   static uint32_t configured_threads;
+   static size_t configured_max_queued;
+   static Compression configured_compression;
+   static int configured_level;
+
+public:
+   static const size_t kBlockSize = 1 << 20;
+
+   OutputStage(uint32_t io_threads, size_t max_queued, Compression compression, int level);
+   ~OutputStage();
+
+   // Must be called before the first writer is created to take effect.
+   static void configure(uint32_t io_threads, size_t max_queued, Compression compression = Compression::None,
+                         int level = -1);
+   static OutputStage &instance();
+
+   // Codec applied to all files; writers append its suffix to their file names.
+   Compression getCompression() const { return compression; }
+
+   // Returns an empty block, recycled if possible. Never blocks.
+   Block acquire();
+   void release(Block block);
+
+   // Queues the block to be written at the current end of the file; waits while the queue is full.
+   void submit(OutputFile &file, Block block);
+   // Waits until all blocks submitted for the file are on disk.
+   void wait(OutputFile &file);
+};
+
+}
+
+#endif
@@ -0,0 +1,94 @@
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include "CLI/CLI.hpp"
+
+#include "query_params.hpp"
+
+#ifndef GTPC_QUERY_DIR
+#define GTPC_QUERY_DIR "queries"
+#endif
+
+int main(int argc, char **argv) {
+  std::string directory = ".";
+  std::size_t warehouses;
+  uint32_t streams = 1;
+  uint32_t first_stream = 0;
+  uint64_t passes = 1;
+  uint32_t seed = 42;
+  std::string templates_path = GTPC_QUERY_DIR "/olap_templates.cypher";
+  std::string format = "cypher";
+  bool in_order = false;
+  std::string id_space = "dense";
+
+  CLI::App app{"GTPC OLAP query stream generator"};
+
+  app.add_option("-d,--directory", directory, "Path to out directory for the query streams")->required();
+  app.add_option("-w,--warehouses", warehouses, "Number of warehouses of the dataset")->required()
+     ->check(CLI::PositiveNumber);
+  app.add_option("-s,--streams", streams, "Number of query streams, one per concurrent client");
+  app.add_option("--first-stream", first_stream, "Number of the first stream, to split the streams over machines");
+  app.add_option("-n,--passes", passes, "Parameter sets per query and stream; a pass runs all 22 queries once");
+  app.add_option("--seed", seed, "Random seed (default: 42, the seed of the data generator)");
+  app.add_option("--templates", templates_path, "Query templates with {{name}} parameters");
+  app.add_option("--format", format, "Output format: ready-to-run Cypher or the parameters as JSON lines")
+     ->check(CLI::IsMember({"cypher", "jsonl"}));
+  app.add_option("--id-space", id_space, "Id space of the dataset (gtpc_datagen --id-space)")
+     ->check(CLI::IsMember({"dense", "global", "clustered"}));
+  app.add_flag("--in-order", in_order, "Run the queries of every pass in the order 1 to 22 instead of shuffled");
+
+  CLI11_PARSE(app, argc, argv);
+
+  std::vector<std::string> templates;
+  if (format == "cypher" && !qgen::loadTemplates(templates_path, templates)) {
+    std::cerr << "Cannot read the 22 query templates from '" << templates_path << "'." << std::endl;
+    return 1;
+  }
+  std::error_code error;
+  std::filesystem::create_directories(directory, error);
+  ids::Space space = ids::Space::Dense;
+  ids::parseSpace(id_space, space);
+
+  std::cout << "--------- Generating " << streams << " OLAP query streams with " << passes << " passes" << std::endl;
+  std::string text;
+  std::string query_text;
+  for (uint32_t stream = first_stream; stream < first_stream + streams; stream++) {
+    std::string path = (std::filesystem::path(directory) / ("olap_stream_" + std::to_string(stream) + "." + format))
+       .string();
+    std::ofstream out(path);
+    if (!out) {
+      std::cerr << "Cannot write '" << path << "'." << std::endl;
+      return 1;
+    }
+
+    qgen::ParameterGenerator generator(seed, stream, warehouses, ids::IdLayout(space, warehouses));
+    for (uint64_t pass = 0; pass < passes; pass++) {
+      std::array<uint32_t, qgen::kQueryCount> order = generator.order(pass);
+      if (in_order) {
+        std::sort(order.begin(), order.end());
+      }
+      for (uint32_t number : order) {
+        qgen::Query query = generator.draw(number, pass);
+        text.clear();
+        if (format == "jsonl") {
+          qgen::appendJson(query, stream, text);
+        } else {
+          if (!qgen::substitute(templates[number - 1], query, query_text)) {
+            std::cerr << "Template of OLAP #" << number << " uses an unknown parameter." << std::endl;
+            return 1;
+          }
+          text = "// stream " + std::to_string(stream) + ", pass " + std::to_string(pass) + ", OLAP #" +
+                 std::to_string(number) + "\n" + query_text + "\n\n";
+        }
+        out << text;
+      }
+    }
+    if (!out) {
+      std::cerr << "Cannot write '" << path << "'." << std::endl;
+      return 1;
+    }
+  }
+  std::cout << "--------- Query streams written to " << directory << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,353 @@
+/*
+ * The implementation of the GTPC graph data generator was built on
+ * Florian Wolf's implementation of the CH-benCHmark data generator
+ * (https://db.in.tum.de/research/projects/CHbenCHmark/) and
+ * Alexander van Renen's implementation of the TPC-C data generator
+ * (https://github.com/alexandervanrenen/tpcc-generator)
+ * See the README file.
+ */
+
+#include "query_params.hpp"
+#include "data_source.hpp"
+#include "generator.hpp"
+#include "random.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <regex>
+#include <sstream>
+
+namespace qgen {
+
+namespace {
+
+// Tables of the random streams, apart from the ones of the generator and the workload.
+enum class Stream : uint32_t {
+   Parameters = 110, Order
+};
+
+// The alphabet of GtpcGenerator::makeAlphaString, i.e. of names, item data and states.
+const char *kAlphabet = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
+const uint32_t kAlphabetSize = 62;
+
+uint32_t lastYear(const rng::Range &years) {
+   return years.min + years.size - 1;
+}
+
+std::string formatDate(uint32_t year, uint32_t month, uint32_t day) {
+   char buffer[16];
+   snprintf(buffer, sizeof(buffer), "%04u-%02u-%02u", year, month, day);
+   return buffer;
+}
+
+class Drawer {
+   rng::Random ranny;
+   Query &query;
+
+   void add(const char *name, Kind kind, std::vector<std::string> values) {
+      query.parameters.push_back(Parameter{name, kind, std::move(values)});
+   }
+
+public:
+   Drawer(rng::Random ranny, Query &query) : ranny(ranny), query(query) {}
+
+   uint32_t number(uint32_t min, uint32_t max) { return ranny.uniform(min, max); }
+
+   // A day of the generated dates, i.e. one of kDays, in the given years.
+   void date(const char *name, const rng::Range &years) {
+      add(name, Kind::Date, {formatDate(ranny.uniform(years), ranny.uniform(GtpcGenerator::kMonths),
+                                        ranny.uniform(GtpcGenerator::kDays))});
+   }
+
+   // date and end_date, months apart. Windows of whole years end within the domain.
+   void window(const rng::Range &years, uint32_t months) {
+      uint32_t year = ranny.uniform(years.min, std::max(years.min, lastYear(years) - months / 12));
+      uint32_t month = ranny.uniform(GtpcGenerator::kMonths);
+      uint32_t day = ranny.uniform(GtpcGenerator::kDays);
+      uint32_t end_month = month - 1 + months;
+      add("date", Kind::Date, {formatDate(year, month, day)});
+      add("end_date", Kind::Date, {formatDate(year + end_month / 12, end_month % 12 + 1, day)});
+   }
+
+   uint32_t region(const char *name) {
+      uint32_t region = ranny.uniform(0, GtpcGenerator::RegionCount - 1);
+      add(name, Kind::String, {DataSource::getRegion(region)});
+      return region;
+   }
+
+   // A nation, of the given region unless it is negative, with a name other than the excluded one.
+   std::string nation(const char *name, int32_t region = -1, const std::string &excluded = "") {
+      Nation nation;
+      do {
+         nation = DataSource::getNation(ranny.uniform(0, GtpcGenerator::NationCount - 1));
+      } while ((region>=0 && nation.rId != uint64_t(region)) || nation.name == excluded);
+      add(name, Kind::String, {nation.name});
+      return nation.name;
+   }
+
+   // length random characters of the alphabet, for prefix and suffix patterns.
+   std::string characters(const char *name, uint32_t length, const std::string &excluded = "") {
+      std::string value;
+      do {
+         value.clear();
+         for (uint32_t i = 0; i<length; i++) {
+            value += kAlphabet[ranny.uniform(0, kAlphabetSize - 1)];
+         }
+      } while (excluded.find(value) != std::string::npos && !value.empty());
+      add(name, Kind::String, {value});
+      return value;
+   }
+
+   // count distinct integers of [min, max], or all of them if there are not enough.
+   std::vector<uint32_t> distinct(uint32_t count, uint32_t min, uint32_t max) {
+      std::vector<uint32_t> values;
+      count = std::min(count, max - min + 1);
+      while (values.size()<count) {
+         uint32_t value = ranny.uniform(min, max);
+         if (std::find(values.begin(), values.end(), value) == values.end()) {
+            values.push_back(value);
+         }
+      }
+      return values;
+   }
+
+   void integer(const char *name, uint32_t value) {
+      add(name, Kind::Integer, {std::to_string(value)});
+   }
+
+   template<typename T>
+   void integers(const char *name, const std::vector<T> &values) {
+      std::vector<std::string> strings;
+      for (T value : values) {
+         strings.push_back(std::to_string(value));
+      }
+      add(name, Kind::IntegerList, std::move(strings));
+   }
+
+   void strings(const char *name, const std::vector<uint32_t> &values) {
+      std::vector<std::string> strings;
+      for (uint32_t value : values) {
+         strings.push_back(std::to_string(value));
+      }
+      add(name, Kind::StringList, std::move(strings));
+   }
+};
+
+std::string quote(const std::string &value, char quote) {
+   std::string result(1, quote);
+   for (char c : value) {
+      if (c == quote || c == '\\') {
+         result += '\\';
+      }
+      result += c;
+   }
+   return result + quote;
+}
+
+}
+
+const Parameter *Query::find(const std::string &name) const {
+   for (const Parameter &parameter : parameters) {
+      if (parameter.name == name) {
+         return &parameter;
+      }
+   }
+   return nullptr;
+}
+
+ParameterGenerator::ParameterGenerator(uint32_t seed, uint32_t stream, int64_t warehouse_count,
+                                       const ids::IdLayout &layout)
+        : seed(seed), stream(stream), warehouse_count(warehouse_count), layout(layout) {
+}
+
+Query ParameterGenerator::draw(uint32_t number, uint64_t pass) const {
+   Query query = {number, pass, {}};
+   Drawer draw(rng::Random(seed, static_cast<uint32_t>(Stream::Parameters), pass * kQueryCount + number - 1, stream),
+               query);
+   const rng::Range &entry = GtpcGenerator::kEntryYears;
+   const rng::Range &delivery = GtpcGenerator::kDeliveryYears;
+   const rng::Range &carriers = GtpcGenerator::kCarrierIds;
+   uint32_t last_carrier = carriers.min + carriers.size - 1;
+
+   switch (number) {
+      case 1:
+      case 15:
+         draw.date("date", delivery);
+         break;
+      case 2:
+         draw.region("region");
+         draw.characters("suffix", 1);
+         break;
+      case 3:
+         draw.characters("state", 1);
+         draw.date("date", entry);
+         break;
+      case 4:
+         draw.window(entry, 3);
+         break;
+      case 5:
+         draw.region("region");
+         draw.date("date", entry);
+         break;
+      case 6:
+         draw.window(delivery, 12);
+         break;
+      case 7: {
+         draw.window(delivery, 12);
+         std::string first = draw.nation("nation1");
+         draw.nation("nation2", -1, first);
+         break;
+      }
+      case 8:
+         draw.characters("suffix", 1);
+         draw.nation("nation", draw.region("region"));
+         draw.window(entry, 24);
+         break;
+      case 9:
+         draw.characters("suffix", 2);
+         break;
+      case 10:
+         draw.date("date", entry);
+         break;
+      case 11:
+      case 21:
+         draw.nation("nation");
+         break;
+      case 12: {
+         draw.date("date", delivery);
+         // Two carriers take the place of the two ship modes of TPC-H.
+         std::vector<uint32_t> modes = draw.distinct(2, carriers.min, last_carrier);
+         draw.integer("carrier1", modes[0]);
+         draw.integer("carrier2", modes[1]);
+         break;
+      }
+      case 13:
+         draw.integer("carrier", draw.number(carriers.min, last_carrier - 1));
+         break;
+      case 14:
+      case 16:
+         draw.characters("prefix", 2);
+         break;
+      case 17:
+         draw.characters("suffix", 1);
+         break;
+      case 18:
+         draw.integer("amount", draw.number(100, 300));
+         break;
+      case 19: {
+         std::string suffixes;
+         for (const char *name : {"suffix1", "suffix2", "suffix3"}) {
+            suffixes += draw.characters(name, 1, suffixes);
+         }
+         for (const char *name : {"warehouses1", "warehouses2", "warehouses3"}) {
+            std::vector<int64_t> warehouses;
+            for (uint32_t warehouse : draw.distinct(3, 1, warehouse_count)) {
+               warehouses.push_back(layout.id(ids::Label::Warehouse, warehouse));
+            }
+            draw.integers(name, warehouses);
+         }
+         break;
+      }
+      case 20:
+         draw.characters("prefix", 2);
+         draw.date("date", delivery);
+         draw.nation("nation");
+         break;
+      case 22:
+         // First digits of the phone numbers, in place of the country codes of TPC-H.
+         draw.strings("codes", draw.distinct(7, 0, 9));
+         break;
+   }
+   return query;
+}
+
+std::array<uint32_t, kQueryCount> ParameterGenerator::order(uint64_t pass) const {
+   std::array<uint32_t, kQueryCount> order;
+   for (uint32_t i = 0; i<kQueryCount; i++) {
+      order[i] = i + 1;
+   }
+   rng::Random ranny(seed, static_cast<uint32_t>(Stream::Order), pass, stream);
+   for (uint32_t i = kQueryCount - 1; i>0; i--) {
+      std::swap(order[i], order[ranny.uniform(0, i)]);
+   }
+   return order;
+}
+
+bool loadTemplates(const std::string &path, std::vector<std::string> &templates) {
+   std::ifstream in(path);
+   if (!in) {
+      return false;
+   }
+   std::stringstream buffer;
+   buffer << in.rdbuf();
+   std::string text = buffer.str();
+
+   templates.assign(kQueryCount, "");
+   std::regex header("/\\*+ OLAP #(\\d+) \\*+/");
+   std::vector<std::pair<uint32_t, size_t>> starts;  // query number, position behind its header
+   std::vector<size_t> ends;
+   for (auto it = std::sregex_iterator(text.begin(), text.end(), header); it != std::sregex_iterator(); ++it) {
+      ends.push_back(it->position());
+      starts.emplace_back(std::stoul((*it)[1]), it->position() + it->length());
+   }
+   ends.push_back(text.size());
+   for (size_t i = 0; i<starts.size(); i++) {
+      uint32_t number = starts[i].first;
+      if (number<1 || number>kQueryCount) {
+         return false;
+      }
+      std::string query = text.substr(starts[i].second, ends[i + 1] - starts[i].second);
+      size_t first = query.find_first_not_of(" \t\r\n");
+      size_t last = query.find_last_not_of(" \t\r\n");
+      templates[number - 1] = first == std::string::npos ? "" : query.substr(first, last - first + 1);
+   }
+   return std::none_of(templates.begin(), templates.end(), [](const std::string &t) { return t.empty(); });
+}
+
+bool substitute(const std::string &text, const Query &query, std::string &out) {
+   out.clear();
+   size_t pos = 0;
+   while (true) {
+      size_t open = text.find("{{", pos);
+      size_t close = open == std::string::npos ? open : text.find("}}", open);
+      if (close == std::string::npos) {
+         out.append(text, pos, std::string::npos);
+         return true;
+      }
+      out.append(text, pos, open - pos);
+      const Parameter *parameter = query.find(text.substr(open + 2, close - open - 2));
+      if (!parameter) {
+         return false;
+      }
+      for (size_t i = 0; i<parameter->values.size(); i++) {
+         if (i>0) {
+            out += ", ";
+         }
+         out += parameter->kind == Kind::StringList ? quote(parameter->values[i], '\'') : parameter->values[i];
+      }
+      pos = close + 2;
+   }
+}
+
+void appendJson(const Query &query, uint32_t stream, std::string &out) {
+   out += "{\"stream\":" + std::to_string(stream) + ",\"pass\":" + std::to_string(query.pass) + ",\"query\":" +
+          std::to_string(query.number) + ",\"parameters\":{";
+   for (size_t p = 0; p<query.parameters.size(); p++) {
+      const Parameter &parameter = query.parameters[p];
+      out += p>0 ? "," : "";
+      out += quote(parameter.name, '"');
+      out += ':';
+      bool list = parameter.kind == Kind::IntegerList || parameter.kind == Kind::StringList;
+      bool number = parameter.kind == Kind::Integer || parameter.kind == Kind::IntegerList;
+      out += list ? "[" : "";
+      for (size_t i = 0; i<parameter.values.size(); i++) {
+         out += i>0 ? "," : "";
+         out += number ? parameter.values[i] : quote(parameter.values[i], '"');
+      }
+      out += list ? "]" : "";
+   }
+   out += "}}\n";
+}
+
+}
@@ -0,0 +1,76 @@
+/*
+ * The implementation of the GTPC graph data generator was built on
+ * Florian Wolf's implementation of the CH-benCHmark data generator
+ * (https://db.in.tum.de/research/projects/CHbenCHmark/) and
+ * Alexander van Renen's implementation of the TPC-C data generator
+ * (https://github.com/alexandervanrenen/tpcc-generator)
+ * See the README file.
+ */
+
+#ifndef query_params_hpp_
+#define query_params_hpp_
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "id_layout.hpp"
+
+// Parameters of the 22 OLAP queries (queries/olap_templates.cypher), like qgen of TPC-H: every execution of a query
+// gets its own dates, regions, nations and string patterns, drawn from the value domains of the generator (the year
+// ranges of GtpcGenerator, the nations and regions of DataSource and the alphabet of the random strings), so a
+// repeated run does not just hit cached results.
+namespace qgen {
+
+const uint32_t kQueryCount = 22;
+
+enum class Kind : uint8_t {
+   Integer, String, Date, IntegerList, StringList
+};
+
+struct Parameter {
+   std::string name;
+   Kind kind;
+   std::vector<std::string> values;  // one value unless it is a list; dates as yyyy-mm-dd
+};
+
+struct Query {
+   uint32_t number;  // 1 to 22
+   uint64_t pass;
+   std::vector<Parameter> parameters;
+
+   // nullptr if the query has no such parameter.
+   const Parameter *find(const std::string &name) const;
+};
+
+// Draws the parameters of one stream. The parameters of query n in pass p only depend on (seed, stream, p, n), so
+// every stream can be regenerated on its own.
+class ParameterGenerator {
+   const uint32_t seed;
+   const uint32_t stream;
+   const int64_t warehouse_count;
+   const ids::IdLayout layout;
+
+public:
+   // The warehouse ids of OLAP #19 follow the id layout of the dataset.
+   ParameterGenerator(uint32_t seed, uint32_t stream, int64_t warehouse_count,
+                      const ids::IdLayout &layout = ids::IdLayout());
+
+   Query draw(uint32_t number, uint64_t pass) const;
+   // Shuffled order of the query numbers for one pass, so concurrent streams do not run the same query at once.
+   std::array<uint32_t, kQueryCount> order(uint64_t pass) const;
+};
+
+// Reads the query texts of a template file, split at the "/***** OLAP #n *****/" headers; templates[n - 1] is
+// query n. Returns false if the file can't be read or does not contain all 22 queries.
+bool loadTemplates(const std::string &path, std::vector<std::string> &templates);
+// Replaces every {{name}} in text by the parameter of the query; list values become comma separated Cypher literals.
+// Returns false if text uses a parameter the query does not have.
+bool substitute(const std::string &text, const Query &query, std::string &out);
+// Appends {"stream":0,"pass":0,"query":1,"parameters":{"date":"2011-03-12",...}} and a newline.
+void appendJson(const Query &query, uint32_t stream, std::string &out);
+
+}
+
+#endif
@@ -0,0 +1,261 @@
+/*
+ * The implementation of the GTPC graph data generator was built on
+ * Florian Wolf's implementation of the CH-benCHmark data generator
+ * (https://db.in.tum.de/research/projects/CHbenCHmark/) and
+ * Alexander van Renen's implementation of the TPC-C data generator
+ * (https://github.com/alexandervanrenen/tpcc-generator)
+ * See the README file.
+ */
+
+#ifndef random_hpp_
+#define random_hpp_
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+namespace rng {
+
+// Philox4x32-10 (Salmon et al., "Parallel Random Numbers: As Easy as 1, 2, 3", SC'11). Maps a 128 bit counter and a
+// 64 bit key to 128 random bits; there is no state besides the counter.
+class Philox4x32 {
+   static constexpr uint32_t kMul0 = 0xD2511F53;
+   static constexpr uint32_t kMul1 = 0xCD9E8D57;
+   static constexpr uint32_t kWeyl0 = 0x9E3779B9;
+   static constexpr uint32_t kWeyl1 = 0xBB67AE85;
+
+public:
+   using Counter = std::array<uint32_t, 4>;
+   using Key = std::array<uint32_t, 2>;
+
+   static Counter block(Counter ctr, Key key) {
+      for (int round = 0; round<10; round++) {
+         uint64_t p0 = uint64_t(kMul0) * ctr[0];
+         uint64_t p1 = uint64_t(kMul1) * ctr[2];
+         ctr = {uint32_t(p1 >> 32) ^ ctr[1] ^ key[0], uint32_t(p1), uint32_t(p0 >> 32) ^ ctr[3] ^ key[1], uint32_t(p0)};
+         key[0] += kWeyl0;
+         key[1] += kWeyl1;
+      }
+      return ctr;
+   }
+
+   // Writes the blocks of the n counters starting at ctr (only the first word counts up) to out.
+   static void blocks(Counter ctr, Key key, size_t n, void *out) {
+      auto pos = static_cast<char *>(out);
+      for (size_t i = 0; i<n; i++, ctr[0]++, pos += sizeof(Counter)) {
+         Counter block = Philox4x32::block(ctr, key);
+         memcpy(pos, block.data(), sizeof(block));
+      }
+   }
+
+   using BlockFunction = void (*)(Counter ctr, Key key, size_t n, void *out);
+};
+
+// Precomputed constants of a range [min, max] for Random::uniform, for the ranges drawn for every row. max - min has
+// to be below 2^32 - 1.
+struct Range {
+   uint32_t min;
+   uint32_t size;
+   uint32_t threshold;  // 2^32 mod size, the values with a lower remainder are redrawn
+
+   constexpr Range(uint32_t min, uint32_t max) : min(min), size(max - min + 1), threshold((0u - size) % size) {}
+};
+
+// How Random::uniform maps a value to a range: Lemire's multiply-shift with rejection (default) or value % size like
+// the original generator (--legacy-rng), which is biased towards the lower values and needs a division.
+enum class UniformMethod : uint8_t {
+   MultiplyShift, Modulo
+};
+
+// Stream of random numbers addressed by (seed, table, warehouse, row). Every value is a pure function of that key
+// and its position in the stream, so any row of any warehouse can be regenerated on its own. Satisfies
+// UniformRandomBitGenerator and is shared by GtpcGenerator and DataSource.
+class Random {
+   Philox4x32::Key key;
+   Philox4x32::Counter counter;
+   Philox4x32::Counter buffer;
+   uint32_t used;
+   UniformMethod method;
+
+   // D. Lemire, "Fast Random Integer Generation in an Interval", ACM TOMACS 2019: the high half of value * size is
+   // uniform in [0, size) once the products whose low half is below threshold are redrawn.
+   uint32_t multiplyShift(uint32_t size, uint32_t threshold) {
+      uint64_t m = uint64_t((*this)()) * size;
+      while (uint32_t(m)<threshold) {
+         m = uint64_t((*this)()) * size;
+      }
+      return uint32_t(m >> 32);
+   }
+
+public:
+   using result_type = uint32_t;
+
+   Random() : Random(0, 0, 0, 0) {}
+   Random(uint32_t seed, uint32_t table, uint64_t warehouse, uint64_t row,
+          UniformMethod method = UniformMethod::MultiplyShift)
+           : key{seed, table}, counter{0, uint32_t(row), uint32_t(warehouse), uint32_t(warehouse >> 32)},
+             buffer{}, used(4), method(method) {
+   }
+
+   static constexpr result_type min() { return 0; }
+   static constexpr result_type max() { return std::numeric_limits<uint32_t>::max(); }
+
+   uint32_t operator()() {
+      if (used == 4) {
+         buffer = Philox4x32::block(counter, key);
+         counter[0]++;
+         used = 0;
+      }
+      return buffer[used++];
+   }
+
+   // Writes the next count values to out in native byte order, the same values as count calls of operator(). Whole
+   // Philox blocks go straight to out, computed by blocks (see string_kernel.cpp for vectorized ones).
+   void fill(void *out, size_t count, Philox4x32::BlockFunction blocks = Philox4x32::blocks) {
+      auto pos = static_cast<char *>(out);
+      for (; count>0 && used<4; count--, pos += sizeof(uint32_t)) {
+         memcpy(pos, &buffer[used++], sizeof(uint32_t));
+      }
+      size_t whole = count / 4;
+      blocks(counter, key, whole, pos);
+      counter[0] += uint32_t(whole);
+      pos += whole * sizeof(Philox4x32::Counter);
+      count %= 4;
+      if (count>0) {
+         buffer = Philox4x32::block(counter, key);
+         counter[0]++;
+         memcpy(pos, buffer.data(), count * sizeof(uint32_t));
+         used = count;
+      }
+   }
+
+   // Jumps to the given position in the stream, i.e. the next call returns the position-th value.
+   void seek(uint64_t position) {
+      counter[0] = uint32_t(position / 4);
+      buffer = Philox4x32::block(counter, key);
+      counter[0]++;
+      used = position % 4;
+   }
+
+   // Uniform integer in [min, max], max - min below 2^32 - 1. The threshold needs a division, but only for the
+   // products whose low half is below max - min + 1, i.e. almost never.
+   uint32_t uniform(uint32_t min, uint32_t max) {
+      uint32_t size = max - min + 1;
+      if (method == UniformMethod::Modulo) {
+         return (*this)() % size + min;
+      }
+      uint64_t m = uint64_t((*this)()) * size;
+      if (uint32_t(m)<size) {
+         uint32_t threshold = (0u - size) % size;
+         while (uint32_t(m)<threshold) {
+            m = uint64_t((*this)()) * size;
+         }
+      }
+      return uint32_t(m >> 32) + min;
+   }
+   // Uniform integer in the precomputed range, without any division.
+   uint32_t uniform(const Range &range) {
+      if (method == UniformMethod::Modulo) {
+         return (*this)() % range.size + range.min;
+      }
+      return multiplyShift(range.size, range.threshold) + range.min;
+   }
+   // True with the given probability.
+   bool chance(double probability) { return (*this)() * (1.0 / 4294967296.0)<probability; }
+   // NURand(A, x, y) of TPC-C (2.1.6) with the constant C: skewed towards the values whose bits are set often.
+   uint32_t nonUniform(uint32_t A, uint32_t x, uint32_t y, uint32_t C) {
+      uint32_t a = uniform(0, A);
+      uint32_t b = uniform(x, y);
+      return ((a | b) + C) % (y - x + 1) + x;
+   }
+};
+
+// Pseudo-random bijection of [0, n), keyed by (seed, table, stream). A 4 round balanced Feistel network with Philox as
+// round function permutes the smallest even power of two domain covering n; values outside [0, n) are mapped again
+// (cycle walking), which takes fewer than 4 rounds trips on average. No state besides the key, any index is evaluated
+// on its own in O(1) memory.
+class Permutation {
+   static constexpr uint32_t kRounds = 4;
+
+   Philox4x32::Key key;
+   uint32_t stream;
+   uint64_t n;
+   uint32_t half_bits;
+   uint64_t half_mask;
+
+   uint64_t round(uint32_t r, uint64_t half) const {
+      Philox4x32::Counter out = Philox4x32::block({uint32_t(half), uint32_t(half >> 32), r, stream}, key);
+      return ((uint64_t(out[1]) << 32) | out[0]) & half_mask;
+   }
+
+   uint64_t encrypt(uint64_t x) const {
+      uint64_t left = x >> half_bits;
+      uint64_t right = x & half_mask;
+      for (uint32_t r = 0; r<kRounds; r++) {
+         uint64_t next = left ^ round(r, right);
+         left = right;
+         right = next;
+      }
+      return (left << half_bits) | right;
+   }
+
+   uint64_t decrypt(uint64_t x) const {
+      uint64_t left = x >> half_bits;
+      uint64_t right = x & half_mask;
+      for (uint32_t r = kRounds; r-->0;) {
+         uint64_t previous = right ^ round(r, left);
+         right = left;
+         left = previous;
+      }
+      return (left << half_bits) | right;
+   }
+
+public:
+   Permutation(uint32_t seed, uint32_t table, uint64_t n, uint32_t stream = 0)
+           : key{seed, table}, stream(stream), n(n), half_bits(std::max<uint32_t>((std::bit_width(n - 1) + 1) / 2, 1)),
+             half_mask((uint64_t(1) << half_bits) - 1) {
+   }
+
+   uint64_t size() const { return n; }
+
+   // Image of index, which has to be in [0, n); n must not be 0.
+   uint64_t operator()(uint64_t index) const {
+      uint64_t x = index;
+      do {
+         x = encrypt(x);
+      } while (x>=n);
+      return x;
+   }
+
+   // Index whose image is value, which has to be in [0, n): walks the cycle of the cipher backwards.
+   uint64_t inverse(uint64_t value) const {
+      uint64_t x = value;
+      do {
+         x = decrypt(x);
+      } while (x>=n);
+      return x;
+   }
+};
+
+// Exactly k of the indexes [0, n), chosen pseudo-randomly: index i is in the sample iff its image under a Permutation
+// keyed by (seed, table, stream) is below k. Like the Permutation there is no state besides the key, so any index is
+// decided on its own and in any order.
+class Sample {
+   Permutation permutation;
+   uint64_t k;
+
+public:
+   Sample(uint32_t seed, uint32_t table, uint32_t stream, uint64_t n, uint64_t k)
+           : permutation(seed, table, n, stream), k(k) {
+   }
+
+   // index has to be in [0, n).
+   bool contains(uint64_t index) const { return permutation(index)<k; }
+};
+
+}
+
+#endif
@@ -0,0 +1,334 @@
+/*
+ * The implementation of the GTPC graph data generator was built on
+ * Florian Wolf's implementation of the CH-benCHmark data generator
+ * (https://db.in.tum.de/research/projects/CHbenCHmark/) and
+ * Alexander van Renen's implementation of the TPC-C data generator
+ * (https://github.com/alexandervanrenen/tpcc-generator)
+ * See the README file.
+ */
+
+#include "string_kernel.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+// GCC 12 reports the _mm512_undefined_* placeholders inside the AVX-512 intrinsics as maybe-uninitialized.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#include <immintrin.h>
+#pragma GCC diagnostic pop
+#define GTPC_X86_KERNELS
+#endif
+
+namespace rng {
+
+namespace {
+
+// Characters per batch of random values, even so that only the last batch of a call can end in half a value.
+constexpr size_t kBatch = 512;
+
+using MapFunction = void (*)(const uint16_t *, size_t, char *);
+
+constexpr char kAlphaNumeric[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
+
+// A table lookup: the compares of the vector kernels become branches in scalar code, which mispredict on random values
+// and made the scalar kernel slower than the per-character loop of the original generator.
+inline char alphaNumeric(uint16_t value) {
+   return kAlphaNumeric[(uint32_t(value) * 62) >> 16];
+}
+
+void mapAlphaNumericScalar(const uint16_t *values, size_t count, char *out) {
+   for (size_t i = 0; i<count; i++) {
+      out[i] = alphaNumeric(values[i]);
+   }
+}
+
+void mapDigitsScalar(const uint16_t *values, size_t count, char *out) {
+   for (size_t i = 0; i<count; i++) {
+      out[i] = char('0' + ((uint32_t(values[i]) * 10) >> 16));
+   }
+}
+
+#ifdef GTPC_X86_KERNELS
+// Philox4x32-10 on 8 (AVX2) or 16 (AVX-512) counters at once, one counter per 32 bit lane and one register per word.
+// The blocks are transposed back into stream order, so the values are those of Philox4x32::blocks.
+constexpr uint32_t kMul0 = 0xD2511F53;
+constexpr uint32_t kMul1 = 0xCD9E8D57;
+constexpr uint32_t kWeyl0 = 0x9E3779B9;
+constexpr uint32_t kWeyl1 = 0xBB67AE85;
+
+__attribute__((target("avx2")))
+void mulAvx2(__m256i x, uint32_t factor, __m256i &high, __m256i &low) {
+   __m256i m = _mm256_set1_epi32(factor);
+   __m256i even = _mm256_mul_epu32(x, m);
+   __m256i odd = _mm256_mul_epu32(_mm256_srli_epi64(x, 32), m);
+   high = _mm256_blend_epi32(_mm256_srli_epi64(even, 32), odd, 0xAA);
+   low = _mm256_mullo_epi32(x, m);
+}
+
+__attribute__((target("avx2")))
+void blocksAvx2(Philox4x32::Counter ctr, Philox4x32::Key key, size_t n, void *out) {
+   auto pos = static_cast<char *>(out);
+   for (; n>=8; n -= 8, ctr[0] += 8, pos += 8 * sizeof(Philox4x32::Counter)) {
+      __m256i x0 = _mm256_add_epi32(_mm256_set1_epi32(ctr[0]), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+      __m256i x1 = _mm256_set1_epi32(ctr[1]);
+      __m256i x2 = _mm256_set1_epi32(ctr[2]);
+      __m256i x3 = _mm256_set1_epi32(ctr[3]);
+      Philox4x32::Key k = key;
+      for (int round = 0; round<10; round++) {
+         __m256i high0, low0, high1, low1;
+         mulAvx2(x0, kMul0, high0, low0);
+         mulAvx2(x2, kMul1, high1, low1);
+         x0 = _mm256_xor_si256(_mm256_xor_si256(high1, x1), _mm256_set1_epi32(k[0]));
+         x1 = low1;
+         x2 = _mm256_xor_si256(_mm256_xor_si256(high0, x3), _mm256_set1_epi32(k[1]));
+         x3 = low0;
+         k[0] += kWeyl0;
+         k[1] += kWeyl1;
+      }
+      // Blocks i and i + 4 share a register after the unpacks, the 128 bit permutes put them in order.
+      __m256i a = _mm256_unpacklo_epi32(x0, x1), b = _mm256_unpacklo_epi32(x2, x3);
+      __m256i c = _mm256_unpackhi_epi32(x0, x1), d = _mm256_unpackhi_epi32(x2, x3);
+      __m256i b04 = _mm256_unpacklo_epi64(a, b), b15 = _mm256_unpackhi_epi64(a, b);
+      __m256i b26 = _mm256_unpacklo_epi64(c, d), b37 = _mm256_unpackhi_epi64(c, d);
+      auto dest = reinterpret_cast<__m256i *>(pos);
+      _mm256_storeu_si256(dest, _mm256_permute2x128_si256(b04, b15, 0x20));
+      _mm256_storeu_si256(dest + 1, _mm256_permute2x128_si256(b26, b37, 0x20));
+      _mm256_storeu_si256(dest + 2, _mm256_permute2x128_si256(b04, b15, 0x31));
+      _mm256_storeu_si256(dest + 3, _mm256_permute2x128_si256(b26, b37, 0x31));
+   }
+   Philox4x32::blocks(ctr, key, n, pos);
+}
+
+__attribute__((target("avx512f,avx512bw")))
+void mulAvx512(__m512i x, uint32_t factor, __m512i &high, __m512i &low) {
+   __m512i m = _mm512_set1_epi32(factor);
+   __m512i even = _mm512_mul_epu32(x, m);
+   __m512i odd = _mm512_mul_epu32(_mm512_srli_epi64(x, 32), m);
+   high = _mm512_mask_blend_epi32(0xAAAA, _mm512_srli_epi64(even, 32), odd);
+   low = _mm512_mullo_epi32(x, m);
+}
+
+__attribute__((target("avx512f,avx512bw")))
+void blocksAvx512(Philox4x32::Counter ctr, Philox4x32::Key key, size_t n, void *out) {
+   auto pos = static_cast<char *>(out);
+   for (; n>=16; n -= 16, ctr[0] += 16, pos += 16 * sizeof(Philox4x32::Counter)) {
+      __m512i x0 = _mm512_add_epi32(_mm512_set1_epi32(ctr[0]),
+                                    _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15));
+      __m512i x1 = _mm512_set1_epi32(ctr[1]);
+      __m512i x2 = _mm512_set1_epi32(ctr[2]);
+      __m512i x3 = _mm512_set1_epi32(ctr[3]);
+      Philox4x32::Key k = key;
+      for (int round = 0; round<10; round++) {
+         __m512i high0, low0, high1, low1;
+         mulAvx512(x0, kMul0, high0, low0);
+         mulAvx512(x2, kMul1, high1, low1);
+         x0 = _mm512_ternarylogic_epi32(high1, x1, _mm512_set1_epi32(k[0]), 0x96);
+         x1 = low1;
+         x2 = _mm512_ternarylogic_epi32(high0, x3, _mm512_set1_epi32(k[1]), 0x96);
+         x3 = low0;
+         k[0] += kWeyl0;
+         k[1] += kWeyl1;
+      }
+      // After the unpacks register j holds the blocks j, j + 4, j + 8 and j + 12; transpose the 128 bit lanes.
+      __m512i a = _mm512_unpacklo_epi32(x0, x1), b = _mm512_unpacklo_epi32(x2, x3);
+      __m512i c = _mm512_unpackhi_epi32(x0, x1), d = _mm512_unpackhi_epi32(x2, x3);
+      __m512i v0 = _mm512_unpacklo_epi64(a, b), v1 = _mm512_unpackhi_epi64(a, b);
+      __m512i v2 = _mm512_unpacklo_epi64(c, d), v3 = _mm512_unpackhi_epi64(c, d);
+      __m512i t0 = _mm512_shuffle_i32x4(v0, v1, 0x44), t1 = _mm512_shuffle_i32x4(v2, v3, 0x44);
+      __m512i t2 = _mm512_shuffle_i32x4(v0, v1, 0xEE), t3 = _mm512_shuffle_i32x4(v2, v3, 0xEE);
+      _mm512_storeu_si512(pos, _mm512_shuffle_i32x4(t0, t1, 0x88));
+      _mm512_storeu_si512(pos + 64, _mm512_shuffle_i32x4(t0, t1, 0xDD));
+      _mm512_storeu_si512(pos + 128, _mm512_shuffle_i32x4(t2, t3, 0x88));
+      _mm512_storeu_si512(pos + 192, _mm512_shuffle_i32x4(t2, t3, 0xDD));
+   }
+   blocksAvx2(ctr, key, n, pos);
+}
+
+// The vector kernels do the same per 16 bit lane: the high half of value * size is the index, two compares add the
+// offsets of the upper case and digit ranges, and the lanes are narrowed to bytes.
+
+__attribute__((target("avx2")))
+__m256i alphaNumericAvx2(__m256i values) {
+   __m256i i = _mm256_mulhi_epu16(values, _mm256_set1_epi16(62));
+   __m256i c = _mm256_add_epi16(i, _mm256_set1_epi16('a'));
+   c = _mm256_add_epi16(c, _mm256_and_si256(_mm256_cmpgt_epi16(i, _mm256_set1_epi16(25)),
+                                            _mm256_set1_epi16('A' - 'a' - 26)));
+   return _mm256_add_epi16(c, _mm256_and_si256(_mm256_cmpgt_epi16(i, _mm256_set1_epi16(51)),
+                                               _mm256_set1_epi16('0' - 'A' - 26)));
+}
+
+__attribute__((target("avx2")))
+__m256i digitsAvx2(__m256i values) {
+   return _mm256_add_epi16(_mm256_mulhi_epu16(values, _mm256_set1_epi16(10)), _mm256_set1_epi16('0'));
+}
+
+template<__m256i (*map)(__m256i), void (*tail)(const uint16_t *, size_t, char *)>
+__attribute__((target("avx2")))
+void mapAvx2(const uint16_t *values, size_t count, char *out) {
+   size_t i = 0;
+   for (; i + 32<=count; i += 32) {
+      __m256i low = map(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(values + i)));
+      __m256i high = map(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(values + i + 16)));
+      // packus interleaves the 128 bit lanes of both inputs, the permute restores the order.
+      __m256i bytes = _mm256_permute4x64_epi64(_mm256_packus_epi16(low, high), 0xD8);
+      _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i), bytes);
+   }
+   tail(values + i, count - i, out + i);
+}
+
+__attribute__((target("avx512f,avx512bw")))
+__m512i alphaNumericAvx512(__m512i values) {
+   __m512i i = _mm512_mulhi_epu16(values, _mm512_set1_epi16(62));
+   __m512i c = _mm512_add_epi16(i, _mm512_set1_epi16('a'));
+   c = _mm512_mask_add_epi16(c, _mm512_cmpgt_epu16_mask(i, _mm512_set1_epi16(25)), c,
+                             _mm512_set1_epi16('A' - 'a' - 26));
+   return _mm512_mask_add_epi16(c, _mm512_cmpgt_epu16_mask(i, _mm512_set1_epi16(51)), c,
+                                _mm512_set1_epi16('0' - 'A' - 26));
+}
+
+__attribute__((target("avx512f,avx512bw")))
+__m512i digitsAvx512(__m512i values) {
+   return _mm512_add_epi16(_mm512_mulhi_epu16(values, _mm512_set1_epi16(10)), _mm512_set1_epi16('0'));
+}
+
+template<__m512i (*map)(__m512i), void (*tail)(const uint16_t *, size_t, char *)>
+__attribute__((target("avx512f,avx512bw")))
+void mapAvx512(const uint16_t *values, size_t count, char *out) {
+   size_t i = 0;
+   for (; i + 32<=count; i += 32) {
+      __m512i c = map(_mm512_loadu_si512(values + i));
+      _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i), _mm512_maskz_cvtepi16_epi8(~0u, c));
+   }
+   tail(values + i, count - i, out + i);
+}
+#endif
+
+struct Kernels {
+   StringKernel kernel;
+   Philox4x32::BlockFunction blocks;
+   MapFunction alpha_numeric;
+   MapFunction digits;
+};
+
+Kernels select(StringKernel kernel) {
+   if (kernel == StringKernel::Auto) {
+      kernel = isSupported(StringKernel::Avx512) ? StringKernel::Avx512 :
+               isSupported(StringKernel::Avx2) ? StringKernel::Avx2 : StringKernel::Scalar;
+   }
+   switch (kernel) {
+#ifdef GTPC_X86_KERNELS
+      case StringKernel::Avx512:
+         return {kernel, blocksAvx512, mapAvx512<alphaNumericAvx512, mapAlphaNumericScalar>,
+                 mapAvx512<digitsAvx512, mapDigitsScalar>};
+      case StringKernel::Avx2:
+         return {kernel, blocksAvx2, mapAvx2<alphaNumericAvx2, mapAlphaNumericScalar>,
+                 mapAvx2<digitsAvx2, mapDigitsScalar>};
+#endif
+      default:
+         return {StringKernel::Scalar, Philox4x32::blocks, mapAlphaNumericScalar, mapDigitsScalar};
+   }
+}
+
+Kernels active = select(StringKernel::Auto);
+
+// Maps each batch into one buffer and copies the fields out of it, fields are often shorter than a vector.
+void fill(Random &ranny, std::span<const StringField> fields, MapFunction map) {
+   size_t remaining = 0;
+   for (const StringField &field : fields) {
+      remaining += field.length;
+   }
+
+   alignas(64) uint16_t values[kBatch];
+   alignas(64) char text[kBatch];
+   auto field = fields.begin();
+   uint32_t written = 0;  // characters of *field done so far
+   while (remaining>0) {
+      size_t count = std::min(remaining, kBatch);
+      ranny.fill(values, (count + 1) / 2, active.blocks);
+      map(values, count, text);
+      remaining -= count;
+      for (size_t pos = 0; pos<count;) {
+         while (written == field->length) {
+            ++field;
+            written = 0;
+         }
+         size_t take = std::min<size_t>(count - pos, field->length - written);
+         memcpy(field->dest + written, text + pos, take);
+         pos += take;
+         written += take;
+      }
+   }
+}
+
+}
+
+bool parseStringKernel(const std::string &name, StringKernel &kernel) {
+   // @formatter:off
+   if (name == "auto") { kernel = StringKernel::Auto; return true; }
+   if (name == "scalar") { kernel = StringKernel::Scalar; return true; }
+   if (name == "avx2") { kernel = StringKernel::Avx2; return true; }
+   if (name == "avx512") { kernel = StringKernel::Avx512; return true; }
+   // @formatter:on
+   return false;
+}
+
+bool isSupported(StringKernel kernel) {
+   switch (kernel) {
+#ifdef GTPC_X86_KERNELS
+      case StringKernel::Avx512:
+         // Also called during static initialization, before the runtime has filled in the CPU model.
+         __builtin_cpu_init();
+         return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw");
+      case StringKernel::Avx2:
+         __builtin_cpu_init();
+         return __builtin_cpu_supports("avx2");
+#else
+      case StringKernel::Avx512:
+      case StringKernel::Avx2:
+         return false;
+#endif
+      default:
+         return true;
+   }
+}
+
+void setStringKernel(StringKernel kernel) {
+   active = select(kernel);
+}
+
+StringKernel activeStringKernel() {
+   return active.kernel;
+}
+
+const char *kernelName(StringKernel kernel) {
+   switch (kernel) {
+      case StringKernel::Scalar:
+         return "scalar";
+      case StringKernel::Avx2:
+         return "avx2";
+      case StringKernel::Avx512:
+         return "avx512";
+      default:
+         return "auto";
+   }
+}
+
+void fillAlphaNumeric(Random &ranny, std::span<const StringField> fields) {
+   fill(ranny, fields, active.alpha_numeric);
+}
+
+void fillDigits(Random &ranny, std::span<const StringField> fields) {
+   fill(ranny, fields, active.digits);
+}
+
+void mapAlphaNumeric(const uint16_t *values, size_t count, char *out) {
+   active.alpha_numeric(values, count, out);
+}
+
+void mapDigits(const uint16_t *values, size_t count, char *out) {
+   active.digits(values, count, out);
+}
+
+}
@@ -0,0 +1,56 @@
+/*
+ * The implementation of the GTPC graph data generator was built on
+ * Florian Wolf's implementation of the CH-benCHmark data generator
+ * (https://db.in.tum.de/research/projects/CHbenCHmark/) and
+ * Alexander van Renen's implementation of the TPC-C data generator
+ * (https://github.com/alexandervanrenen/tpcc-generator)
+ * See the README file.
+ */
+
+#ifndef string_kernel_hpp_
+#define string_kernel_hpp_
+
+#include <cstdint>
+#include <span>
+#include <string>
+
+#include "random.hpp"
+
+// Bulk random strings. The random values of all fields are drawn as one batch of 16 bit values, character i of the
+// batch is alphabet[(value[i] * alphabet size) >> 16]. The mapping is exact integer arithmetic, so the scalar, AVX2
+// and AVX-512 kernels produce the same bytes and the output only depends on the seed, never on the machine.
+namespace rng {
+
+enum class StringKernel {
+   Auto, Scalar, Avx2, Avx512
+};
+
+// Parses "auto", "scalar", "avx2" or "avx512"; returns false for unknown names.
+bool parseStringKernel(const std::string &name, StringKernel &kernel);
+// Whether the CPU can run the kernel; Auto and Scalar always can.
+bool isSupported(StringKernel kernel);
+// Selects the kernel for all following calls, Auto picks the widest one the CPU supports. Not thread-safe, call it
+// before generating.
+void setStringKernel(StringKernel kernel);
+// The kernel in use, never Auto.
+StringKernel activeStringKernel();
+const char *kernelName(StringKernel kernel);
+
+// Destination and length of one field; the kernels do not write a terminating NUL.
+struct StringField {
+   char *dest;
+   uint32_t length;
+};
+
+// Fills the fields with characters of [a-zA-Z0-9], in order, drawing (sum of lengths + 1) / 2 values from ranny.
+void fillAlphaNumeric(Random &ranny, std::span<const StringField> fields);
+// Same for [0-9].
+void fillDigits(Random &ranny, std::span<const StringField> fields);
+
+// The mapping on its own, one character per 16 bit value. Used by the benchmark.
+void mapAlphaNumeric(const uint16_t *values, size_t count, char *out);
+void mapDigits(const uint16_t *values, size_t count, char *out);
+
+}
+
+#endif
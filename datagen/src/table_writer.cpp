@@ -0,0 +1,335 @@
+/*
+ * The implementation of the GTPC graph data generator was built on
+ * Florian Wolf's implementation of the CH-benCHmark data generator
+ * (https://db.in.tum.de/research/projects/CHbenCHmark/) and
+ * Alexander van Renen's implementation of the TPC-C data generator
+ * (https://github.com/alexandervanrenen/tpcc-generator)
+ * See the README file.
+ */
+
+#include "table_writer.hpp"
+#include "instrumentation.hpp"
+
+#include <fstream>
+#include <sstream>
+
+namespace csv {
+
+namespace {
+
+std::vector<Edge> toEdges(const std::vector<CsvWriter::Column> &columns) {
+   auto starts = reinterpret_cast<const int64_t *>(columns[0].data.data());
+   auto ends = reinterpret_cast<const int64_t *>(columns[1].data.data());
+   std::vector<Edge> edges(columns[0].data.size() / sizeof(int64_t));
+   for (size_t i = 0; i<edges.size(); i++) {
+      edges[i] = Edge{starts[i], ends[i]};
+   }
+   return edges;
+}
+
+// Grouped files need the relationships of a start node together, so they are sorted by start at least.
+EdgeOrder sortOrder(const Layout &layout) {
+   return layout.edge_order == EdgeOrder::Generation ? EdgeOrder::Start : layout.edge_order;
+}
+
+void fromEdges(const std::vector<Edge> &edges, std::vector<CsvWriter::Column> &columns) {
+   auto starts = reinterpret_cast<int64_t *>(columns[0].data.data());
+   auto ends = reinterpret_cast<int64_t *>(columns[1].data.data());
+   for (size_t i = 0; i<edges.size(); i++) {
+      starts[i] = edges[i].start;
+      ends[i] = edges[i].end;
+   }
+}
+
+}
+
+std::string Layout::dataPath(const Table &table, uint64_t chunk) const {
+   std::ostringstream path;
+   path << folder << "/" << table.name << (grouped && table.relationship ? "_grouped" : "") << (delta ? "_delta" : "_")
+        << part << "_" << chunk << ".csv";
+   return path.str();
+}
+
+std::string Layout::headerPath(const Table &table) const {
+   return folder + "/" + table.name + "_header.csv";
+}
+
+std::string Layout::binaryPath(const Table &table, const std::string &suffix) const {
+   std::ostringstream path;
+   path << folder << "/" << table.name << (delta ? "_delta" : "_") << part << suffix;
+   return path.str();
+}
+
+std::string Layout::dataPattern(const Table &table) const {
+   // No backslashes, the pattern ends up in an argument file.
+   std::string parts = delta ? "_delta" + std::to_string(part) : "_[0-9]+";
+   std::string suffix = fileSuffix(OutputStage::instance().getCompression());
+   if (!suffix.empty()) {
+      suffix = "[.]" + suffix.substr(1);
+   }
+   return folder + "/" + table.name + (grouped && table.relationship ? "_grouped" : "") + parts + "_[0-9]+[.]csv" +
+          suffix;
+}
+
+std::string Layout::argumentsPath() const {
+   return folder + (delta ? "/neo4j-admin_delta" + std::to_string(part) + ".args" : "/neo4j-admin.args");
+}
+
+TableWriter::TableWriter(const Layout &layout, const Table &table)
+        : layout(layout), table(table), chunk(0) {
+   if (layout.format == Format::Binary || layout.format == Format::Columnar) {
+      writer = std::make_unique<CsvWriter>(makeChunk());
+      if (layout.format == Format::Columnar) {
+         columnar = std::make_unique<ColumnarWriter>(layout.binaryPath(table, ".gcol"), table);
+      }
+      return;
+   }
+   if (layout.write_headers && layout.format == Format::Neo4jAdmin) {
+      CsvWriter header(layout.headerPath(table));
+      header << std::string(table.typed_header) << endl;
+   }
+   open(0);
+   if (layout.write_headers && layout.format == Format::Csv) {
+      // Grouped files name the list column in plural, e.g. Customer_id|Order_ids.
+      *writer << std::string(table.header) + (groups() ? "s" : "") << endl;
+   }
+   if (sorts()) {
+      sorter = std::make_unique<EdgeSorter>(layout.binaryPath(table, ".run"), sortOrder(layout), layout.sort_memory);
+   }
+}
+
+TableWriter::~TableWriter() {
+   if (layout.format != Format::Binary && layout.format != Format::Columnar) {
+      if (sorter) {
+         sorter->merge(*layout.pool, [this](const std::vector<Edge> &edges) { return formatEdges(edges); },
+                       [this](CsvWriter &rows) { writer->append(rows); });
+         sorter.reset();
+      }
+      close();
+      if (layout.write_headers && layout.format == Format::Csv) {
+         row_count--;
+      }
+   } else {
+      // Rows written via csv() and the closing entry of the offsets.
+      appendBinary(*writer);
+      if (table.relationship && !files.empty()) {
+         files[0]->write(reinterpret_cast<const char *>(&edge_count), sizeof(edge_count));
+      }
+      for (auto &file : files) {
+         byte_count += file->getBytesWritten();
+      }
+      if (columnar) {
+         columnar->finish();
+         byte_count += columnar->size();
+      }
+   }
+   stats::Recorder::instance().addTable(table.name, row_count, byte_count);
+}
+
+void TableWriter::close() {
+   if (writer) {
+      row_count += writer->takeRowCount();
+      byte_count += writer->getBytesWritten();
+      writer.reset();
+   }
+}
+
+void TableWriter::open(uint64_t chunk) {
+   // Close the previous file first, so at most one file per table is open.
+   close();
+   writer = std::make_unique<CsvWriter>(layout.dataPath(table, chunk));
+   if (layout.format == Format::Neo4jAdmin) {
+      writer->setRowSuffix(table.label);
+   }
+   this->chunk = chunk;
+}
+
+bool TableWriter::sorts() const {
+   return table.relationship && table.by_end && (layout.edge_order != EdgeOrder::Generation || layout.grouped) &&
+          (layout.format == Format::Csv || layout.format == Format::Neo4jAdmin);
+}
+
+bool TableWriter::groups() const {
+   return table.relationship && layout.grouped && (layout.format == Format::Csv || layout.format == Format::Neo4jAdmin);
+}
+
+CsvWriter TableWriter::makeRows() const {
+   CsvWriter rows;
+   if (layout.format == Format::Neo4jAdmin) {
+      rows.setRowSuffix(table.label);
+   }
+   return rows;
+}
+
+CsvWriter TableWriter::makeChunk() const {
+   CsvWriter rows = makeRows();
+   if (layout.format == Format::Binary || layout.format == Format::Columnar || sorts() || groups()) {
+      rows.setColumnar();
+   }
+   return rows;
+}
+
+CsvWriter TableWriter::formatEdges(const std::vector<Edge> &edges) const {
+   CsvWriter rows = makeRows();
+   if (!groups()) {
+      for (const Edge &edge : edges) {
+         rows << edge.start << edge.end << endl;
+      }
+      return rows;
+   }
+   std::vector<int64_t> ends;
+   for (size_t i = 0; i<edges.size();) {
+      ends.clear();
+      size_t group = i;
+      for (; i<edges.size() && edges[i].start == edges[group].start; i++) {
+         ends.push_back(edges[i].end);
+      }
+      rows << edges[group].start << IdList{ends.data(), ends.size()} << endl;
+   }
+   return rows;
+}
+
+void TableWriter::seal(CsvWriter &rows) const {
+   if (!sorts() && !groups()) {
+      return;
+   }
+   std::vector<CsvWriter::Column> &columns = rows.getColumns();
+   if (columns.empty()) {
+      return;
+   }
+   std::vector<Edge> edges = toEdges(columns);
+   if (sorts()) {
+      sortEdges(edges, sortOrder(layout));
+      fromEdges(edges, columns);
+      return;
+   }
+   // The start nodes of a chunk belong to its warehouse, so no group spans two chunks. The file counts the groups.
+   CsvWriter text = formatEdges(edges);
+   columns.clear();
+   rows.takeRowCount();
+   rows.append(text);
+}
+
+void TableWriter::append(uint64_t index, CsvWriter &rows) {
+   if (layout.format == Format::Binary || layout.format == Format::Columnar) {
+      appendBinary(rows);
+      return;
+   }
+   if (sorter) {
+      // Counted when the merged rows are written.
+      rows.takeRowCount();
+      if (!rows.getColumns().empty()) {
+         sorter->add(toEdges(rows.getColumns()));
+         rows.getColumns().clear();
+      }
+      return;
+   }
+   if (layout.chunk_warehouses>0 && index / layout.chunk_warehouses != chunk) {
+      open(index / layout.chunk_warehouses);
+   }
+   writer->append(rows);
+}
+
+void TableWriter::appendBinary(CsvWriter &rows) {
+   row_count += rows.takeRowCount();
+   std::vector<CsvWriter::Column> &columns = rows.getColumns();
+   if (columns.empty()) {
+      return;
+   }
+   if (columnar) {
+      columnar->append(columns);
+   } else if (table.relationship) {
+      appendEdges(columns);
+   } else {
+      appendColumns(columns);
+   }
+   columns.clear();
+}
+
+std::unique_ptr<CsvWriter> TableWriter::openBinary(const std::string &suffix, binary::Kind kind, binary::Type type,
+                                                   uint32_t width, int64_t first_key) {
+   auto file = std::make_unique<CsvWriter>(layout.binaryPath(table, suffix));
+   binary::FileHeader header = {};
+   memcpy(header.magic, binary::kMagic, sizeof(header.magic));
+   header.version = binary::kVersion;
+   header.kind = kind;
+   header.type = type;
+   header.width = width;
+   header.first_key = first_key;
+   header.by_end = table.by_end;
+   file->write(reinterpret_cast<const char *>(&header), sizeof(header));
+   return file;
+}
+
+void TableWriter::appendColumns(std::vector<CsvWriter::Column> &columns) {
+   if (files.empty()) {
+      std::istringstream names(table.header);
+      std::string name;
+      for (const CsvWriter::Column &column : columns) {
+         if (!std::getline(names, name, '|')) {
+            std::cout << "\nTable '" << table.name << "' has more columns than its header." << std::endl;
+            std::cout << "aborting..." << std::endl;
+            exit(-1);
+         }
+         files.push_back(openBinary("." + name + ".col", binary::Kind::Column, column.type, column.width, 0));
+      }
+   }
+   for (size_t i = 0; i<columns.size(); i++) {
+      files[i]->write(columns[i].data.data(), columns[i].data.size());
+   }
+}
+
+void TableWriter::appendEdges(std::vector<CsvWriter::Column> &columns) {
+   auto starts = reinterpret_cast<const int64_t *>(columns[0].data.data());
+   auto ends = reinterpret_cast<const int64_t *>(columns[1].data.data());
+   const int64_t *keys = table.by_end ? ends : starts;
+   const int64_t *targets = table.by_end ? starts : ends;
+   size_t count = columns[0].data.size() / sizeof(int64_t);
+
+   if (files.empty()) {
+      next_key = keys[0];
+      files.push_back(openBinary(".offsets", binary::Kind::Offsets, binary::Type::Int64, sizeof(uint64_t), next_key));
+      files.push_back(openBinary(".targets", binary::Kind::Targets, binary::Type::Int64, sizeof(int64_t), 0));
+   }
+
+   // Keys without edges get an empty range, so the offsets can be indexed by key - first_key.
+   std::vector<uint64_t> offsets;
+   for (size_t i = 0; i<count; i++) {
+      if (keys[i]<next_key - 1) {
+         std::cout << "\nRelationships of '" << table.name << "' are not grouped by "
+                   << (table.by_end ? "end" : "start") << " node." << std::endl;
+         std::cout << "aborting..." << std::endl;
+         exit(-1);
+      }
+      while (next_key<=keys[i]) {
+         offsets.push_back(edge_count);
+         next_key++;
+      }
+      edge_count++;
+   }
+   files[0]->write(reinterpret_cast<const char *>(offsets.data()), offsets.size() * sizeof(uint64_t));
+   files[1]->write(reinterpret_cast<const char *>(targets), count * sizeof(int64_t));
+}
+
+void writeImportArguments(const Layout &layout, const Table *const *tables, size_t count) {
+   std::string path = layout.argumentsPath();
+   std::ofstream args(path);
+   args << "--delimiter=|" << std::endl;
+   args << "--id-type=INTEGER" << std::endl;
+   // stock_hasSupplier_supplier keeps CH-benCHmark's su_suppkey, (s_i_id * s_w_id) % 10000, whose 0 names no supplier.
+   // The import would abort on these relationships; skip them like the engine does.
+   args << "--skip-bad-relationships=true" << std::endl;
+   for (size_t i = 0; i<count; i++) {
+      const Table &table = *tables[i];
+      std::string header = layout.headerPath(table) + fileSuffix(OutputStage::instance().getCompression());
+      args << (table.relationship ? "--relationships=" : "--nodes=") << header << "," << layout.dataPattern(table)
+           << std::endl;
+   }
+   if (!args) {
+      std::cout << "\nCannot write file: '" << path << "'." << std::endl;
+      std::cout << "aborting..." << std::endl;
+      exit(-1);
+   }
+}
+
+}
@@ -0,0 +1,129 @@
+/*
+ * The implementation of the GTPC graph data generator was built on
+ * Florian Wolf's implementation of the CH-benCHmark data generator
+ * (https://db.in.tum.de/research/projects/CHbenCHmark/) and
+ * Alexander van Renen's implementation of the TPC-C data generator
+ * (https://github.com/alexandervanrenen/tpcc-generator)
+ * See the README file.
+ */
+
+#ifndef table_writer_hpp_
+#define table_writer_hpp_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "columnar_writer.hpp"
+#include "csv_writer.hpp"
+#include "edge_sorter.hpp"
+
+class ThreadPool;
+
+namespace csv {
+
+enum class Format {
+   Csv,        // one file per table, plain header line in the first file
+   Neo4jAdmin, // typed header in a separate file, data split into chunks, ready for neo4j-admin import
+   Binary,     // mmap-able column files and CSR/CSC adjacency, see binary_format.hpp
+   Columnar    // one file per table with typed, dictionary encoded row groups, see columnar_format.hpp
+};
+
+// Schema of one output table.
+struct Table {
+   const char *name;          // file name prefix
+   const char *header;        // header line of the plain format
+   const char *typed_header;  // neo4j-admin header with ID spaces, property types and the :LABEL/:TYPE column
+   const char *label;         // value of the :LABEL (nodes) or :TYPE (relationships) column
+   bool relationship;
+   bool by_end = false;       // rows are grouped by the end node, so the binary format stores them as CSC
+};
+
+// Where and how the tables are written.
+struct Layout {
+   std::string folder;
+   Format format = Format::Csv;
+   uint32_t part = 0;
+   uint64_t chunk_warehouses = 0;  // warehouses per data file, 0 for a single file
+   bool write_headers = true;
+   bool delta = false;             // files added to an existing dataset, part is the first new warehouse
+   // Relationship files of the plain and neo4j-admin formats, see EdgeSorter. Grouped files have one row per start
+   // node with the list of its end nodes, e.g. 3|7;9;12.
+   EdgeOrder edge_order = EdgeOrder::Generation;
+   bool grouped = false;
+   uint64_t sort_memory = 0;       // bytes of sorted runs per table before they are merged to disk
+   ThreadPool *pool = nullptr;     // merges the runs
+
+   // <folder>/<table>_<part>_<chunk>.csv, <folder>/<table>_delta<part>_<chunk>.csv for deltas, <table>_grouped_...
+   // for grouped relationship files
+   std::string dataPath(const Table &table, uint64_t chunk) const;
+   // <folder>/<table>_header.csv
+   std::string headerPath(const Table &table) const;
+   // <folder>/<table>_<part><suffix>, <folder>/<table>_delta<part><suffix> for deltas
+   std::string binaryPath(const Table &table, const std::string &suffix) const;
+   // Pattern matching the data files of all parts and chunks, as accepted by neo4j-admin import. For deltas only the
+   // files of this delta, for an incremental import.
+   std::string dataPattern(const Table &table) const;
+   // <folder>/neo4j-admin.args, <folder>/neo4j-admin_delta<part>.args for deltas
+   std::string argumentsPath() const;
+};
+
+// Writes one table according to the layout. Per-warehouse rows are generated into chunks from makeChunk() and
+// appended in warehouse order; a new data file is started every chunk_warehouses warehouses. In the binary format
+// the rows are collected column-wise and written to one file per column, or to the offsets and targets of the
+// adjacency; in the columnar format they are handed to a ColumnarWriter.
+//
+// Relationships that are generated grouped by the end node (Table::by_end) are sorted by an EdgeSorter if the layout
+// asks for an edge order or grouped files; they end up in a single data file. All other relationships are generated
+// in the order of their start and end nodes already and are only formatted as groups if needed.
+class TableWriter {
+   const Layout &layout;
+   const Table &table;
+   std::unique_ptr<CsvWriter> writer;
+   uint64_t chunk;
+
+   // Binary format, files are created with the first row.
+   std::vector<std::unique_ptr<CsvWriter>> files;
+   int64_t next_key = 0;  // key of the next offsets entry
+   uint64_t edge_count = 0;
+   // Columnar format
+   std::unique_ptr<ColumnarWriter> columnar;
+   // Sorted relationships
+   std::unique_ptr<EdgeSorter> sorter;
+   // Reported to the stats::Recorder when the table is complete.
+   uint64_t row_count = 0;
+   uint64_t byte_count = 0;
+
+   void open(uint64_t chunk);
+   void close();
+   void appendBinary(CsvWriter &rows);
+   void appendColumns(std::vector<CsvWriter::Column> &columns);
+   void appendEdges(std::vector<CsvWriter::Column> &columns);
+   std::unique_ptr<CsvWriter> openBinary(const std::string &suffix, binary::Kind kind, binary::Type type,
+                                         uint32_t width, int64_t first_key);
+   bool sorts() const;
+   bool groups() const;
+   CsvWriter makeRows() const;
+   CsvWriter formatEdges(const std::vector<Edge> &edges) const;
+
+public:
+   TableWriter(const Layout &layout, const Table &table);
+   ~TableWriter();
+
+   // Writer of the current data file, for tables that are not generated per warehouse.
+   CsvWriter &csv() { return *writer; }
+   // In-memory writer for the rows of one warehouse.
+   CsvWriter makeChunk() const;
+   // Prepares a chunk on the thread that generated it: sorts the relationships that are sorted, formats the groups of
+   // grouped files.
+   void seal(CsvWriter &rows) const;
+   // Appends the rows of the index-th warehouse of this process.
+   void append(uint64_t index, CsvWriter &rows);
+};
+
+// Writes the neo4j-admin import arguments for the given tables to layout.argumentsPath().
+void writeImportArguments(const Layout &layout, const Table *const *tables, size_t count);
+
+}
+
+#endif
@@ -0,0 +1,152 @@
+/*
+ * The implementation of the GTPC graph data generator was built on
+ * Florian Wolf's implementation of the CH-benCHmark data generator
+ * (https://db.in.tum.de/research/projects/CHbenCHmark/) and
+ * Alexander van Renen's implementation of the TPC-C data generator
+ * (https://github.com/alexandervanrenen/tpcc-generator)
+ * See the README file.
+ */
+
+#include "text_pool.hpp"
+#include "data_source.hpp"
+#include "thread_pool.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace rng {
+
+namespace {
+
+constexpr char kMagic[8] = {'G', 'T', 'P', 'C', 'T', 'X', 'T', '\0'};
+constexpr uint32_t kVersion = 1;
+
+struct PoolHeader {
+   char magic[8];
+   uint32_t version;
+   uint32_t seed;
+   uint32_t table;
+   uint32_t reserved0;
+   uint64_t size;
+   uint8_t reserved[32];
+};
+
+static_assert(sizeof(PoolHeader) == 64, "The text has to stay 64 byte aligned.");
+
+}
+
+TextPool::~TextPool() {
+   if (mapping) {
+      munmap(mapping, mapping_size);
+   }
+}
+
+std::unique_ptr<TextPool> TextPool::generate(uint32_t seed, uint32_t table, uint64_t size, ThreadPool &pool) {
+   std::unique_ptr<TextPool> result(new TextPool());
+   result->owned.resize(size);
+   result->text = result->owned.data();
+   result->length = size;
+
+   char *out = result->owned.data();
+   for (uint64_t segment = 0; segment * kSegment<size; segment++) {
+      pool.submit([=] {
+         Random ranny(seed, table, 0, segment);
+         uint64_t len = std::min(kSegment, size - segment * kSegment);
+         std::string text;
+         text.reserve(len + 256);
+         while (text.size()<len) {
+            DataSource::appendTpchSentence(ranny, text);
+         }
+         memcpy(out + segment * kSegment, text.data(), len);
+      });
+   }
+   pool.wait();
+   return result;
+}
+
+std::unique_ptr<TextPool> TextPool::load(const std::string &path, uint32_t seed, uint32_t table, uint64_t size,
+                                         ThreadPool &pool) {
+   std::unique_ptr<TextPool> result(new TextPool());
+   if (result->map(path, seed, table, size)) {
+      return result;
+   }
+   result = generate(seed, table, size, pool);
+   result->save(path, seed, table);
+   return result;
+}
+
+bool TextPool::map(const std::string &path, uint32_t seed, uint32_t table, uint64_t size) {
+   int fd = open(path.c_str(), O_RDONLY);
+   if (fd<0) {
+      return false;
+   }
+   struct stat st;
+   if (fstat(fd, &st)<0 || static_cast<uint64_t>(st.st_size) != sizeof(PoolHeader) + size) {
+      close(fd);
+      return false;
+   }
+   void *base = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+   close(fd);
+   if (base == MAP_FAILED) {
+      return false;
+   }
+   auto header = static_cast<const PoolHeader *>(base);
+   if (memcmp(header->magic, kMagic, sizeof(kMagic)) != 0 || header->version != kVersion || header->seed != seed ||
+       header->table != table || header->size != size) {
+      munmap(base, st.st_size);
+      return false;
+   }
+   mapping = base;
+   mapping_size = st.st_size;
+   text = static_cast<const char *>(base) + sizeof(PoolHeader);
+   length = size;
+   return true;
+}
+
+void TextPool::save(const std::string &path, uint32_t seed, uint32_t table) const {
+   PoolHeader header = {};
+   memcpy(header.magic, kMagic, sizeof(kMagic));
+   header.version = kVersion;
+   header.seed = seed;
+   header.table = table;
+   header.size = length;
+
+   // Written under a temporary name and renamed, so a concurrent or interrupted run never maps half a pool.
+   std::string temporary = path + ".tmp";
+   int fd = open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+   if (fd<0) {
+      std::cout << "\nCannot create file: '" << temporary << "'." << std::endl;
+      std::cout << "aborting..." << std::endl;
+      exit(-1);
+   }
+   auto write_all = [&](const char *data, size_t size) {
+      while (size>0) {
+         ssize_t written = ::write(fd, data, size);
+         if (written<0) {
+            std::cout << "\nCannot write file: '" << temporary << "'." << std::endl;
+            std::cout << "aborting..." << std::endl;
+            exit(-1);
+         }
+         data += written;
+         size -= written;
+      }
+   };
+   write_all(reinterpret_cast<const char *>(&header), sizeof(header));
+   write_all(text, length);
+   close(fd);
+   if (rename(temporary.c_str(), path.c_str())<0) {
+      std::cout << "\nCannot rename '" << temporary << "' to '" << path << "'." << std::endl;
+      std::cout << "aborting..." << std::endl;
+      exit(-1);
+   }
+}
+
+}
@@ -0,0 +1,69 @@
+/*
+ * The implementation of the GTPC graph data generator was built on
+ * Florian Wolf's implementation of the CH-benCHmark data generator
+ * (https://db.in.tum.de/research/projects/CHbenCHmark/) and
+ * Alexander van Renen's implementation of the TPC-C data generator
+ * (https://github.com/alexandervanrenen/tpcc-generator)
+ * See the README file.
+ */
+
+#ifndef text_pool_hpp_
+#define text_pool_hpp_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "random.hpp"
+
+class ThreadPool;
+
+namespace rng {
+
+// Text of the TPC-H grammar (see DataSource::appendTpchSentence), generated once and handed out as slices, like the
+// text pool of dbgen. The pool consists of 1 MiB segments that start at a sentence and are generated from their own
+// random stream keyed by (seed, table, segment), so its contents only depend on seed, table and size, not on the
+// number of threads. Read-only once built and shared by all threads.
+//
+// A pool file stores a 64 byte header (magic, version, seed, table, size) followed by the text; it is mapped instead
+// of generating the pool again.
+class TextPool {
+   static constexpr uint64_t kSegment = 1 << 20;
+
+   const char *text = nullptr;
+   uint64_t length = 0;
+   std::vector<char> owned;
+   void *mapping = nullptr;
+   size_t mapping_size = 0;
+
+   TextPool() = default;
+   // Maps path if it holds a pool for the same key and size, returns false otherwise.
+   bool map(const std::string &path, uint32_t seed, uint32_t table, uint64_t size);
+   void save(const std::string &path, uint32_t seed, uint32_t table) const;
+
+public:
+   TextPool(const TextPool &) = delete;
+   TextPool &operator=(const TextPool &) = delete;
+   ~TextPool();
+
+   // size is in bytes and has to be in [1, 2^32 - 1].
+   static std::unique_ptr<TextPool> generate(uint32_t seed, uint32_t table, uint64_t size, ThreadPool &pool);
+   // Maps the pool stored at path, or generates it and stores it there if the file does not hold the same pool.
+   static std::unique_ptr<TextPool> load(const std::string &path, uint32_t seed, uint32_t table, uint64_t size,
+                                         ThreadPool &pool);
+
+   uint64_t size() const { return length; }
+
+   // Slice of a random length in [min, max] at a random position, pointing into the pool. max has to be at most
+   // size().
+   std::string_view slice(Random &ranny, uint32_t min, uint32_t max) const {
+      uint32_t len = ranny.uniform(min, max);
+      return std::string_view(text + ranny.uniform(0, uint32_t(length - len)), len);
+   }
+};
+
+}
+
+#endif
@@ -0,0 +1,109 @@
+/*
+ * The implementation of the GTPC graph data generator was built on
+ * Florian Wolf's implementation of the CH-benCHmark data generator
+ * (https://db.in.tum.de/research/projects/CHbenCHmark/) and
+ * Alexander van Renen's implementation of the TPC-C data generator
+ * (https://github.com/alexandervanrenen/tpcc-generator)
+ * See the README file.
+ */
+
+#include "thread_pool.hpp"
+
+namespace {
+// Index of the worker running on this thread, -1 for threads outside of any pool.
+thread_local int32_t current_worker = -1;
+thread_local const ThreadPool *current_pool = nullptr;
+}
+
+ThreadPool::ThreadPool(uint32_t thread_count) {
+   thread_count = std::max<uint32_t>(thread_count, 1);
+   for (uint32_t i = 0; i<thread_count; i++) {
+      workers.push_back(std::make_unique<Worker>());
+   }
+   for (uint32_t i = 0; i<thread_count; i++) {
+      threads.emplace_back([this, i] { run(i); });
+   }
+}
+
+ThreadPool::~ThreadPool() {
+   {
+      std::lock_guard<std::mutex> lock(mutex);
+      stopping = true;
+   }
+   task_available.notify_all();
+   for (auto &thread : threads) {
+      thread.join();
+   }
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+   uint32_t target;
+   {
+      std::lock_guard<std::mutex> lock(mutex);
+      queued++;
+      unfinished++;
+      // Tasks spawned by a worker stay local, everything else is spread round robin.
+      target = (current_pool == this) ? current_worker : (next_victim++ % workers.size());
+   }
+   {
+      std::lock_guard<std::mutex> lock(workers[target]->mutex);
+      workers[target]->tasks.push_back(std::move(task));
+   }
+   task_available.notify_one();
+}
+
+void ThreadPool::wait() {
+   std::unique_lock<std::mutex> lock(mutex);
+   all_done.wait(lock, [this] { return unfinished == 0; });
+}
+
+bool ThreadPool::take(uint32_t self, std::function<void()> &task) {
+   {
+      Worker &own = *workers[self];
+      std::lock_guard<std::mutex> lock(own.mutex);
+      if (!own.tasks.empty()) {
+         task = std::move(own.tasks.back());
+         own.tasks.pop_back();
+         return true;
+      }
+   }
+   for (uint32_t i = 1; i<workers.size(); i++) {
+      Worker &victim = *workers[(self + i) % workers.size()];
+      std::lock_guard<std::mutex> lock(victim.mutex);
+      if (!victim.tasks.empty()) {
+         task = std::move(victim.tasks.front());
+         victim.tasks.pop_front();
+         return true;
+      }
+   }
+   return false;
+}
+
+void ThreadPool::run(uint32_t self) {
+   current_worker = self;
+   current_pool = this;
+
+   std::function<void()> task;
+   while (true) {
+      {
+         std::unique_lock<std::mutex> lock(mutex);
+         task_available.wait(lock, [this] { return stopping || queued>0; });
+         if (queued == 0 && stopping) {
+            return;
+         }
+         queued--;
+      }
+
+      // A task is guaranteed to be in some deque, but another worker may be about to pop it from there.
+      while (!take(self, task)) {
+         std::this_thread::yield();
+      }
+      task();
+      task = nullptr;
+
+      std::lock_guard<std::mutex> lock(mutex);
+      if (--unfinished == 0) {
+         all_done.notify_all();
+      }
+   }
+}
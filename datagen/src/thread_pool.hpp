@@ -0,0 +1,121 @@
+/*
+ * The implementation of the GTPC graph data generator was built on
+ * Florian Wolf's implementation of the CH-benCHmark data generator
+ * (https://db.in.tum.de/research/projects/CHbenCHmark/) and
+ * Alexander van Renen's implementation of the TPC-C data generator
+ * (https://github.com/alexandervanrenen/tpcc-generator)
+ * See the README file.
+ */
+
+#ifndef thread_pool_hpp_
+#define thread_pool_hpp_
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Work-stealing thread pool. Every worker owns a deque: tasks submitted from a worker go to the back of its own
+// deque and are popped LIFO, idle workers steal FIFO from the front of the other deques.
+class ThreadPool {
+   struct Worker {
+      std::mutex mutex;
+      std::deque<std::function<void()>> tasks;
+   };
+
+   std::vector<std::unique_ptr<Worker>> workers;
+   std::vector<std::thread> threads;
+
+   std::mutex mutex;
+   std::condition_variable task_available;
+   std::condition_variable all_done;
+   uint64_t queued = 0;      // submitted but not yet picked up
+   uint64_t unfinished = 0;  // submitted but not yet completed
+   uint64_t next_victim = 0;
+   bool stopping = false;
+
+   void run(uint32_t self);
+   bool take(uint32_t self, std::function<void()> &task);
+
+public:
+   explicit ThreadPool(uint32_t thread_count);
+   ~ThreadPool();
+
+   ThreadPool(const ThreadPool &) = delete;
+   ThreadPool &operator=(const ThreadPool &) = delete;
+
+   uint32_t size() const { return workers.size(); }
+
+   void submit(std::function<void()> task);
+   // Blocks until every submitted task (including tasks submitted by tasks) has completed.
+   void wait();
+
+   // Runs produce(i) for every i in [begin, end) on the pool and hands the results to consume(i, chunk) strictly in
+   // increasing order of i. At most `window` chunks are produced but not yet consumed at any time, which bounds the
+   // memory held by out-of-order results. consume is never called concurrently.
+   template<typename Chunk>
+   void orderedFor(uint64_t begin, uint64_t end, uint64_t window,
+                   const std::function<Chunk(uint64_t)> &produce,
+                   const std::function<void(uint64_t, Chunk &)> &consume);
+};
+
+template<typename Chunk>
+void ThreadPool::orderedFor(uint64_t begin, uint64_t end, uint64_t window,
+                            const std::function<Chunk(uint64_t)> &produce,
+                            const std::function<void(uint64_t, Chunk &)> &consume) {
+   if (begin>=end) {
+      return;
+   }
+
+   struct State {
+      std::mutex mutex;
+      std::map<uint64_t, Chunk> done;
+      uint64_t next_start;
+      uint64_t next_commit;
+      bool committing = false;
+   };
+   auto state = std::make_shared<State>();
+   state->next_start = begin;
+   state->next_commit = begin;
+
+   // Each task produces one chunk; whoever finds the next chunk in order commits everything that is ready and
+   // refills the window. Tasks that finish early just park their chunk for the active committer.
+   std::function<void(uint64_t)> task = [&, state](uint64_t i) {
+      Chunk chunk = produce(i);
+
+      std::unique_lock<std::mutex> lock(state->mutex);
+      state->done.emplace(i, std::move(chunk));
+      if (state->committing) {
+         return;
+      }
+      state->committing = true;
+      while (!state->done.empty() && state->done.begin()->first == state->next_commit) {
+         auto node = state->done.extract(state->done.begin());
+         lock.unlock();
+         consume(node.key(), node.mapped());
+         lock.lock();
+         state->next_commit++;
+         if (state->next_start<end) {
+            uint64_t next = state->next_start++;
+            submit([&task, next] { task(next); });
+         }
+      }
+      state->committing = false;
+   };
+
+   {
+      std::lock_guard<std::mutex> lock(state->mutex);
+      while (state->next_start<end && state->next_start - begin<std::max<uint64_t>(window, 1)) {
+         uint64_t next = state->next_start++;
+         submit([&task, next] { task(next); });
+      }
+   }
+   wait();
+}
+
+#endif
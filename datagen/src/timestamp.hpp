@@ -0,0 +1,45 @@
+/*
+ * The implementation of the GTPC graph data generator was built on
+ * Florian Wolf's implementation of the CH-benCHmark data generator
+ * (https://db.in.tum.de/research/projects/CHbenCHmark/) and
+ * Alexander van Renen's implementation of the TPC-C data generator
+ * (https://github.com/alexandervanrenen/tpcc-generator)
+ * See the README file.
+ */
+
+#ifndef timestamp_hpp_
+#define timestamp_hpp_
+
+#include <cstdint>
+
+namespace csv {
+
+// Point in time as milliseconds since 1970-01-01T00:00:00Z. Written as text (2010-02-14T15:32:10.447+0000) by the
+// CSV formats and as the raw value by the binary and columnar formats.
+struct Timestamp {
+   int64_t millis;
+};
+
+constexpr uint32_t kTimestampLength = 28;
+
+// Days since 1970-01-01 of a date in the proleptic Gregorian calendar (H. Hinnant's days_from_civil).
+constexpr int64_t daysFromCivil(int64_t y, int64_t m, int64_t d) {
+   y -= m<=2;
+   int64_t era = (y>=0 ? y : y - 399) / 400;
+   int64_t yoe = y - era * 400;
+   int64_t doy = (153 * (m + (m>2 ? -3 : 9)) + 2) / 5 + d - 1;
+   int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+   return era * 146097 + doe - 719468;
+}
+
+constexpr Timestamp makeTimestamp(int64_t year, int64_t month, int64_t day, int64_t hour, int64_t minute,
+                                  int64_t second, int64_t millis) {
+   return Timestamp{(((daysFromCivil(year, month, day) * 24 + hour) * 60 + minute) * 60 + second) * 1000 + millis};
+}
+
+// Writes exactly kTimestampLength characters, no allocation; years have to be in [0, 9999].
+void formatTimestamp(Timestamp timestamp, char *out);
+
+}
+
+#endif
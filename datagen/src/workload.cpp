@@ -0,0 +1,292 @@
+/*
+ * The implementation of the GTPC graph data generator was built on
+ * Florian Wolf's implementation of the CH-benCHmark data generator
+ * (https://db.in.tum.de/research/projects/CHbenCHmark/) and
+ * Alexander van Renen's implementation of the TPC-C data generator
+ * (https://github.com/alexandervanrenen/tpcc-generator)
+ * See the README file.
+ */
+
+#include "workload.hpp"
+#include "data_source.hpp"
+#include "generator.hpp"
+
+#include <charconv>
+#include <cstring>
+
+namespace workload {
+
+namespace {
+
+// Tables of the random streams, apart from the ones of the generator.
+enum class Stream : uint32_t {
+   Constants = 100, Transaction, Deck
+};
+
+const uint32_t kDistrictsPerWarehouse = 10;
+const uint32_t kCustomersPerDistrict = 3000;
+const uint32_t kItemCount = 100000;
+
+void appendNumber(std::string &out, int64_t value) {
+   char buffer[24];
+   out.append(buffer, std::to_chars(buffer, buffer + sizeof(buffer), value).ptr - buffer);
+}
+
+void appendField(std::string &out, const char *name, int64_t value) {
+   out += ",\"";
+   out += name;
+   out += "\":";
+   appendNumber(out, value);
+}
+
+void appendCents(std::string &out, const char *name, int64_t cents) {
+   appendField(out, name, cents / 100);
+   char fraction[3] = {'.', char('0' + cents % 100 / 10), char('0' + cents % 10)};
+   out.append(fraction, sizeof(fraction));
+}
+
+void appendCustomer(std::string &out, const Transaction &tx) {
+   if (tx.by_last_name) {
+      out += ",\"c_last\":\"";
+      out += lastName(tx.last_name);
+      out += '"';
+   } else {
+      appendField(out, "c_id", tx.customer_id);
+   }
+}
+
+template<typename T>
+void appendRaw(std::string &out, const T &value) {
+   out.append(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+}
+
+const char *typeName(TransactionType type) {
+   switch (type) {
+      case TransactionType::NewOrder:
+         return "new_order";
+      case TransactionType::Payment:
+         return "payment";
+      case TransactionType::OrderStatus:
+         return "order_status";
+      case TransactionType::Delivery:
+         return "delivery";
+      case TransactionType::StockLevel:
+         return "stock_level";
+   }
+   return "unknown";
+}
+
+std::string lastName(uint32_t number) {
+   std::string name;
+   DataSource::genCLast(number, name);
+   return name;
+}
+
+TransactionGenerator::TransactionGenerator(uint32_t seed, uint32_t stream, int64_t warehouse_count,
+                                           int64_t first_warehouse, int64_t last_warehouse,
+                                           const ids::IdLayout &layout)
+        : seed(seed), stream(stream), first_warehouse(first_warehouse), last_warehouse(last_warehouse),
+          warehouse_count(warehouse_count), layout(layout) {
+   // The same constants for all streams of a seed. C_LAST has to differ from the one of the data by 65 to 119, but
+   // neither 96 nor 112 (TPC-C 2.1.6.1).
+   rng::Random ranny(seed, static_cast<uint32_t>(Stream::Constants), 0, 0);
+   uint32_t delta;
+   do {
+      delta = ranny.uniform(65, 119);
+   } while (delta == 96 || delta == 112);
+   c_last = (GtpcGenerator::kLoadConstant + delta) % 256;
+   c_id = ranny.uniform(0, 1023);
+   c_item = ranny.uniform(0, 8191);
+}
+
+void TransactionGenerator::shuffleDeck(uint64_t index) {
+   size_t pos = 0;
+   for (auto [type, count] : {std::pair{TransactionType::NewOrder, 45}, std::pair{TransactionType::Payment, 43},
+                              std::pair{TransactionType::OrderStatus, 4}, std::pair{TransactionType::Delivery, 4},
+                              std::pair{TransactionType::StockLevel, 4}}) {
+      std::fill_n(deck.begin() + pos, count, type);
+      pos += count;
+   }
+   rng::Random ranny(seed, static_cast<uint32_t>(Stream::Deck), index, stream);
+   for (uint32_t i = deck.size() - 1; i>0; i--) {
+      std::swap(deck[i], deck[ranny.uniform(0, i)]);
+   }
+   deck_index = index;
+}
+
+int64_t TransactionGenerator::otherWarehouse(rng::Random &ranny, int64_t warehouse) {
+   int64_t other = ranny.uniform(1, warehouse_count - 1);
+   return other>=warehouse ? other + 1 : other;
+}
+
+void TransactionGenerator::selectCustomer(rng::Random &ranny, Transaction &tx, int64_t district_id) {
+   tx.customer_district_id = district_id;
+   tx.by_last_name = ranny.uniform(1, 100)<=60;
+   if (tx.by_last_name) {
+      tx.last_name = ranny.nonUniform(255, 0, 999, c_last);
+   } else {
+      tx.customer_id = (district_id - 1) * kCustomersPerDistrict + ranny.nonUniform(1023, 1, kCustomersPerDistrict, c_id);
+   }
+}
+
+void TransactionGenerator::mapIds(Transaction &tx) const {
+   if (tx.type != TransactionType::Delivery) {
+      tx.district_number = (tx.district_id - 1) % kDistrictsPerWarehouse + 1;
+      tx.district_index = tx.district_id;
+   }
+   if (layout.getSpace() == ids::Space::Dense) {
+      return;
+   }
+   auto map = [&](ids::Label label, int64_t &id) {
+      if (id != 0) {
+         id = layout.id(label, id);
+      }
+   };
+   map(ids::Label::Warehouse, tx.warehouse_id);
+   map(ids::Label::District, tx.district_id);
+   map(ids::Label::Customer, tx.customer_id);
+   map(ids::Label::District, tx.customer_district_id);
+   for (uint32_t i = 0; i<tx.line_count; i++) {
+      map(ids::Label::Item, tx.lines[i].item_id);
+      map(ids::Label::Warehouse, tx.lines[i].supply_warehouse_id);
+      map(ids::Label::Stock, tx.lines[i].stock_id);
+   }
+}
+
+Transaction TransactionGenerator::at(uint64_t sequence) {
+   if (sequence / deck.size() != deck_index) {
+      shuffleDeck(sequence / deck.size());
+   }
+   Transaction tx = {};
+   tx.type = deck[sequence % deck.size()];
+   tx.sequence = sequence;
+
+   rng::Random ranny(seed, static_cast<uint32_t>(Stream::Transaction), sequence, stream);
+   tx.warehouse_id = ranny.uniform(first_warehouse, last_warehouse);
+   int64_t first_district = (tx.warehouse_id - 1) * kDistrictsPerWarehouse;
+   if (tx.type != TransactionType::Delivery) {
+      tx.district_id = first_district + ranny.uniform(1, kDistrictsPerWarehouse);
+   }
+
+   switch (tx.type) {
+      case TransactionType::NewOrder: {
+         tx.customer_district_id = tx.district_id;
+         tx.customer_id = (tx.district_id - 1) * kCustomersPerDistrict +
+                          ranny.nonUniform(1023, 1, kCustomersPerDistrict, c_id);
+         tx.line_count = ranny.uniform(5, 15);
+         tx.rollback = ranny.uniform(1, 100) == 1;
+         for (uint32_t i = 0; i<tx.line_count; i++) {
+            OrderLine &line = tx.lines[i];
+            line.item_id = ranny.nonUniform(8191, 1, kItemCount, c_item);
+            if (tx.rollback && i == tx.line_count - 1) {
+               line.item_id = kInvalidItem;
+            }
+            line.supply_warehouse_id = tx.warehouse_id;
+            if (warehouse_count>1 && ranny.uniform(1, 100) == 1) {
+               line.supply_warehouse_id = otherWarehouse(ranny, tx.warehouse_id);
+            }
+            line.stock_id = (line.supply_warehouse_id - 1) * kItemCount + line.item_id;
+            line.quantity = ranny.uniform(1, 10);
+         }
+         break;
+      }
+      case TransactionType::Payment: {
+         int64_t customer_district = tx.district_id;
+         if (warehouse_count>1 && ranny.uniform(1, 100)>85) {
+            customer_district = (otherWarehouse(ranny, tx.warehouse_id) - 1) * kDistrictsPerWarehouse +
+                                ranny.uniform(1, kDistrictsPerWarehouse);
+         }
+         selectCustomer(ranny, tx, customer_district);
+         tx.amount = ranny.uniform(100, 500000);
+         break;
+      }
+      case TransactionType::OrderStatus:
+         selectCustomer(ranny, tx, tx.district_id);
+         break;
+      case TransactionType::Delivery:
+         tx.carrier_id = ranny.uniform(1, 10);
+         break;
+      case TransactionType::StockLevel:
+         tx.threshold = ranny.uniform(10, 20);
+         break;
+   }
+   mapIds(tx);
+   return tx;
+}
+
+void appendHeader(const StreamHeader &header, Format format, std::string &out) {
+   if (format == Format::Binary) {
+      appendRaw(out, header);
+   }
+}
+
+void append(const Transaction &tx, Format format, std::string &out) {
+   if (format == Format::Binary) {
+      Record record = {};
+      record.type = static_cast<uint8_t>(tx.type);
+      record.flags = (tx.by_last_name ? kByLastName : 0) | (tx.rollback ? kRollback : 0);
+      record.line_count = tx.line_count;
+      record.district_number = tx.district_number;
+      record.last_name = tx.last_name;
+      record.value = tx.type == TransactionType::Delivery ? tx.carrier_id : tx.threshold;
+      record.sequence = tx.sequence;
+      record.warehouse_id = tx.warehouse_id;
+      record.district_id = tx.district_id;
+      record.customer_id = tx.customer_id;
+      record.customer_district_id = tx.customer_district_id;
+      record.amount = tx.amount;
+      appendRaw(out, record);
+      for (uint32_t i = 0; i<tx.line_count; i++) {
+         const OrderLine &line = tx.lines[i];
+         appendRaw(out, OrderLineRecord{line.item_id, line.supply_warehouse_id, line.stock_id, line.quantity, 0});
+      }
+      return;
+   }
+
+   out += "{\"seq\":";
+   appendNumber(out, tx.sequence);
+   out += ",\"type\":\"";
+   out += typeName(tx.type);
+   out += '"';
+   appendField(out, "w_id", tx.warehouse_id);
+   switch (tx.type) {
+      case TransactionType::NewOrder:
+         appendField(out, "d_id", tx.district_id);
+         appendField(out, "c_id", tx.customer_id);
+         out += tx.rollback ? ",\"rollback\":true" : ",\"rollback\":false";
+         out += ",\"lines\":[";
+         for (uint32_t i = 0; i<tx.line_count; i++) {
+            const OrderLine &line = tx.lines[i];
+            out += i>0 ? ",{\"i_id\":" : "{\"i_id\":";
+            appendNumber(out, line.item_id);
+            appendField(out, "supply_w_id", line.supply_warehouse_id);
+            appendField(out, "s_id", line.stock_id);
+            appendField(out, "quantity", line.quantity);
+            out += '}';
+         }
+         out += ']';
+         break;
+      case TransactionType::Payment:
+         appendField(out, "d_id", tx.district_id);
+         appendField(out, "c_d_id", tx.customer_district_id);
+         appendCustomer(out, tx);
+         appendCents(out, "h_amount", tx.amount);
+         break;
+      case TransactionType::OrderStatus:
+         appendField(out, "d_id", tx.district_id);
+         appendCustomer(out, tx);
+         break;
+      case TransactionType::Delivery:
+         appendField(out, "o_carrier_id", tx.carrier_id);
+         break;
+      case TransactionType::StockLevel:
+         appendField(out, "d_id", tx.district_id);
+         appendField(out, "threshold", tx.threshold);
+         break;
+   }
+   out += "}\n";
+}
+
+}
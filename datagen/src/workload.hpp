@@ -0,0 +1,174 @@
+/*
+ * The implementation of the GTPC graph data generator was built on
+ * Florian Wolf's implementation of the CH-benCHmark data generator
+ * (https://db.in.tum.de/research/projects/CHbenCHmark/) and
+ * Alexander van Renen's implementation of the TPC-C data generator
+ * (https://github.com/alexandervanrenen/tpcc-generator)
+ * See the README file.
+ */
+
+#ifndef workload_hpp_
+#define workload_hpp_
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "id_layout.hpp"
+#include "random.hpp"
+
+// Parameters of the OLTP transactions of queries/oltp.cypher (#1 New-Order, #2 Payment, #3 Order-Status, #4 Delivery,
+// #5 Stock-Level) for a dataset of the generator, drawn like TPC-C 2.4-2.8: the mix of 5.2.3, NURand skew for
+// customers, items and last names, remote warehouses and rollbacks. All ids are the global ids of the generated
+// nodes in the id layout of the dataset (see ids::IdLayout), so they go straight into the Cypher parameters.
+namespace workload {
+
+enum class TransactionType : uint8_t {
+   NewOrder, Payment, OrderStatus, Delivery, StockLevel
+};
+
+const char *typeName(TransactionType type);
+
+struct OrderLine {
+   int64_t item_id;              // kInvalidItem for the rollback of a New-Order
+   int64_t supply_warehouse_id;
+   int64_t stock_id;
+   uint32_t quantity;
+};
+
+struct Transaction {
+   TransactionType type;
+   uint64_t sequence;
+   int64_t warehouse_id;
+   int64_t district_id;           // global id; not used by Delivery
+   uint32_t district_number;      // 1 to 10 within the warehouse, for S_DIST_xx; not used by Delivery
+   int64_t district_index;        // dense id of the district, the same in every id space; not used by Delivery
+   // New-Order, Payment and Order-Status. customer_id is 0 if the customer is selected by last name.
+   int64_t customer_id;
+   int64_t customer_district_id;  // Payment: the customer's district, remote in 15% of the cases
+   bool by_last_name;
+   uint16_t last_name;            // number of the name, see lastName()
+   // New-Order
+   bool rollback;
+   uint32_t line_count;
+   std::array<OrderLine, 15> lines;
+   // Payment, in cents
+   int64_t amount;
+   // Delivery
+   uint32_t carrier_id;
+   // Stock-Level
+   uint32_t threshold;
+};
+
+// C_LAST for the number of a last name, e.g. "BARBARBAR" for 0.
+std::string lastName(uint32_t number);
+
+// Draws the transactions of one stream. Transaction n of stream s only depends on (seed, s, n), so streams for
+// several clients can be drawn by independent processes and every run can be reproduced. The type follows a shuffled
+// deck of 100 cards per 100 transactions (45 New-Order, 43 Payment, 4 each of the others), which keeps the mix exact
+// over any window of 100 transactions.
+class TransactionGenerator {
+   const uint32_t seed;
+   const uint32_t stream;
+   const int64_t first_warehouse;
+   const int64_t last_warehouse;
+   const int64_t warehouse_count;
+   const ids::IdLayout layout;
+   // C of NURand(255), NURand(1023) and NURand(8191) for this run, see TPC-C 2.1.6.1.
+   uint32_t c_last;
+   uint32_t c_id;
+   uint32_t c_item;
+
+   uint64_t next = 0;
+   uint64_t deck_index = UINT64_MAX;
+   std::array<TransactionType, 100> deck;
+
+   void shuffleDeck(uint64_t index);
+   int64_t otherWarehouse(rng::Random &ranny, int64_t warehouse);
+   void selectCustomer(rng::Random &ranny, Transaction &tx, int64_t district_id);
+   // The transaction is drawn with dense ids; maps them to the ids of the layout.
+   void mapIds(Transaction &tx) const;
+
+public:
+   static constexpr int64_t kInvalidItem = 100001;
+
+   // Home warehouses are drawn from [first_warehouse, last_warehouse]; remote ones from all warehouse_count.
+   TransactionGenerator(uint32_t seed, uint32_t stream, int64_t warehouse_count, int64_t first_warehouse,
+                        int64_t last_warehouse, const ids::IdLayout &layout = ids::IdLayout());
+
+   // The next transaction of the stream.
+   Transaction operator()() { return at(next++); }
+   Transaction at(uint64_t sequence);
+   // Continues the stream at the given sequence number.
+   void seek(uint64_t sequence) { next = sequence; }
+};
+
+// Formats of the transaction streams.
+//
+// JSONL: one object per line, e.g.
+//    {"seq":0,"type":"new_order","w_id":1,"d_id":3,"c_id":6042,"rollback":false,"lines":[{"i_id":68123,
+//     "supply_w_id":1,"s_id":68123,"quantity":5},...]}
+//    {"seq":1,"type":"payment","w_id":1,"d_id":3,"c_d_id":3,"c_last":"BARBARBAR","h_amount":1234.56}
+// Customers are given by "c_id" or "c_last" (plus the district "c_d_id" for Payment); Delivery has "o_carrier_id",
+// Stock-Level "threshold".
+//
+// Binary: a 64 byte StreamHeader, then per transaction a 64 byte Record followed by line_count OrderLineRecords for
+// New-Order. Little-endian, meant to be read with a plain struct copy. Version 2 added the stock id of the order lines,
+// which does not follow from the item and the warehouse in every id layout.
+enum class Format {
+   Jsonl, Binary
+};
+
+constexpr char kMagic[8] = {'G', 'T', 'P', 'C', 'W', 'R', 'K', '\0'};
+constexpr uint32_t kVersion = 2;
+
+struct StreamHeader {
+   char magic[8];
+   uint32_t version;
+   uint32_t seed;
+   uint32_t stream;
+   uint32_t reserved0;
+   int64_t warehouse_count;
+   uint8_t id_space;              // ids::Space of the ids
+   uint8_t reserved[31];
+};
+
+enum RecordFlags : uint8_t {
+   kByLastName = 1, kRollback = 2
+};
+
+struct Record {
+   uint8_t type;                  // TransactionType
+   uint8_t flags;                 // RecordFlags
+   uint8_t line_count;
+   uint8_t district_number;
+   uint16_t last_name;
+   uint16_t value;                // Delivery: carrier id, Stock-Level: threshold
+   uint64_t sequence;
+   int64_t warehouse_id;
+   int64_t district_id;
+   int64_t customer_id;
+   int64_t customer_district_id;
+   int64_t amount;                // Payment: cents
+   int64_t reserved1;
+};
+
+struct OrderLineRecord {
+   int64_t item_id;
+   int64_t supply_warehouse_id;
+   int64_t stock_id;
+   uint32_t quantity;
+   uint32_t reserved;
+};
+
+static_assert(sizeof(StreamHeader) == 64 && sizeof(Record) == 64 && sizeof(OrderLineRecord) == 32,
+              "The record layout is part of the format.");
+
+// Appends the transaction in the given format to out.
+void append(const Transaction &tx, Format format, std::string &out);
+void appendHeader(const StreamHeader &header, Format format, std::string &out);
+
+}
+
+#endif
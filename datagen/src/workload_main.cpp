@@ -0,0 +1,142 @@
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <iostream>
+#include <regex>
+#include <thread>
+#include <fcntl.h>
+#include <unistd.h>
+#include "CLI/CLI.hpp"
+
+#include "workload.hpp"
+
+// Writes the whole buffer; false once the reader is gone (EPIPE) or the write fails otherwise.
+static bool writeAll(int fd, const std::string &buffer) {
+  const char *data = buffer.data();
+  std::size_t left = buffer.size();
+  while (left > 0) {
+    ssize_t written = write(fd, data, left);
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      if (errno != EPIPE) {
+        std::cerr << "Cannot write transactions: " << strerror(errno) << std::endl;
+      }
+      return false;
+    }
+    data += written;
+    left -= written;
+  }
+  return true;
+}
+
+int main(int argc, char **argv) {
+  std::size_t warehouses;
+  std::string warehouse_range;
+  uint32_t stream = 0;
+  uint32_t seed = 42;
+  uint64_t count = 0;
+  uint64_t start_sequence = 0;
+  double rate = 0;
+  std::string format = "jsonl";
+  std::string output = "-";
+  std::string id_space = "dense";
+
+  CLI::App app{"GTPC OLTP transaction stream generator"};
+
+  app.add_option("-w,--warehouses", warehouses, "Number of warehouses of the dataset")->required();
+  app.add_option("--warehouse-range", warehouse_range,
+                 "Draw the home warehouses from a to b only (format a-b, inclusive), e.g. one range per client");
+  app.add_option("--stream", stream, "Number of the stream; streams with the same seed are independent");
+  app.add_option("--seed", seed, "Random seed (default: 42, the seed of the data generator)");
+  app.add_option("-n,--count", count, "Number of transactions (default: 0 = until the reader goes away)");
+  app.add_option("--start", start_sequence, "Sequence number of the first transaction, to continue a stream");
+  app.add_option("--rate", rate, "Transactions per second (default: 0 = as fast as possible)")
+     ->check(CLI::NonNegativeNumber);
+  app.add_option("--format", format, "Output format: one JSON object per line or fixed-size binary records")
+     ->check(CLI::IsMember({"jsonl", "binary"}));
+  app.add_option("-o,--output", output, "Output file or named pipe, - for stdout");
+  app.add_option("--id-space", id_space, "Id space of the dataset (gtpc_datagen --id-space)")
+     ->check(CLI::IsMember({"dense", "global", "clustered"}));
+
+  CLI11_PARSE(app, argc, argv);
+
+  std::size_t first_warehouse = 1;
+  std::size_t last_warehouse = warehouses;
+  if (warehouses == 0) {
+    std::cerr << "The dataset needs at least one warehouse." << std::endl;
+    return 1;
+  }
+  if (!warehouse_range.empty()) {
+    std::smatch match;
+    if (!std::regex_match(warehouse_range, match, std::regex("(\\d+)-(\\d+)"))) {
+      std::cerr << "Invalid warehouse range '" << warehouse_range << "', expected a-b." << std::endl;
+      return 1;
+    }
+    first_warehouse = std::stoull(match[1]);
+    last_warehouse = std::stoull(match[2]);
+    if (first_warehouse < 1 || first_warehouse > last_warehouse || last_warehouse > warehouses) {
+      std::cerr << "Invalid warehouse range '" << warehouse_range << "' for " << warehouses << " warehouses." << std::endl;
+      return 1;
+    }
+  }
+
+  // A reader closing the pipe ends the stream instead of killing the process.
+  signal(SIGPIPE, SIG_IGN);
+  int fd = STDOUT_FILENO;
+  if (output != "-") {
+    fd = open(output.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+      std::cerr << "Cannot open '" << output << "': " << strerror(errno) << std::endl;
+      return 1;
+    }
+  }
+
+  workload::Format stream_format = format == "binary" ? workload::Format::Binary : workload::Format::Jsonl;
+  ids::Space space = ids::Space::Dense;
+  ids::parseSpace(id_space, space);
+  workload::TransactionGenerator generator(seed, stream, warehouses, first_warehouse, last_warehouse,
+                                           ids::IdLayout(space, warehouses));
+  generator.seek(start_sequence);
+
+  std::string buffer;
+  workload::StreamHeader header = {};
+  memcpy(header.magic, workload::kMagic, sizeof(header.magic));
+  header.version = workload::kVersion;
+  header.seed = seed;
+  header.stream = stream;
+  header.warehouse_count = warehouses;
+  header.id_space = static_cast<uint8_t>(space);
+  workload::appendHeader(header, stream_format, buffer);
+
+  // Paced against the start time, so the rate holds on average even if single writes block for a while.
+  const std::size_t flush_size = 64 << 10;
+  auto start = std::chrono::steady_clock::now();
+  bool open_reader = true;
+  for (uint64_t n = 0; open_reader && (count == 0 || n < count); n++) {
+    if (rate > 0) {
+      auto due = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+         std::chrono::duration<double>(n / rate));
+      if (due > std::chrono::steady_clock::now()) {
+        open_reader = writeAll(fd, buffer);
+        buffer.clear();
+        std::this_thread::sleep_until(due);
+      }
+    }
+    workload::append(generator(), stream_format, buffer);
+    if (buffer.size() >= flush_size) {
+      open_reader = open_reader && writeAll(fd, buffer);
+      buffer.clear();
+    }
+  }
+  if (open_reader) {
+    writeAll(fd, buffer);
+  }
+  if (fd != STDOUT_FILENO) {
+    close(fd);
+  }
+
+  return 0;
+}
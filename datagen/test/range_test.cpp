@@ -0,0 +1,145 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+// Checks that disjoint --warehouse-range and --shard runs into one directory write distinct files, which concatenate
+// per table to the files of a single run over all warehouses. The path of gtpc_datagen is the only argument. Run by
+// ctest.
+
+static int failures = 0;
+
+#define CHECK(condition)                                                                      \
+  do {                                                                                        \
+    if (!(condition)) {                                                                       \
+      std::cerr << __FILE__ << ":" << __LINE__ << ": check failed: " #condition << std::endl; \
+      failures++;                                                                             \
+    }                                                                                         \
+  } while (0)
+
+static const char *const kWarehouses = "3";
+
+// Runs gtpc_datagen with the common arguments and the given ones, returns whether it succeeded.
+static bool generate(const std::string &datagen, const std::string &directory, std::vector<std::string> arguments) {
+  std::vector<std::string> all = {datagen, "-d", directory, "-w", kWarehouses, "--no-progress",
+                                  "-t", std::to_string(std::max(2u, std::thread::hardware_concurrency()))};
+  all.insert(all.end(), arguments.begin(), arguments.end());
+  std::vector<char *> argv;
+  for (std::string &argument : all) {
+    argv.push_back(argument.data());
+  }
+  argv.push_back(nullptr);
+  pid_t pid = fork();
+  if (pid == 0) {
+    // Only the failures are of interest.
+    if (!freopen("/dev/null", "w", stdout)) {
+      _exit(127);
+    }
+    execv(argv[0], argv.data());
+    _exit(127);
+  }
+  int status = 0;
+  return pid>0 && waitpid(pid, &status, 0) == pid && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+// The contents of the data files per table, concatenated in the order of their part and chunk like the engine loads
+// them, and the number of files per table.
+static std::map<std::string, std::pair<std::string, size_t>> readTables(const std::string &directory) {
+  std::regex pattern("(.+)_([0-9]+)_([0-9]+)[.]csv");
+  std::map<std::string, std::vector<std::tuple<uint64_t, uint64_t, std::string>>> files;
+  for (auto &entry : std::filesystem::directory_iterator(directory)) {
+    std::string name = entry.path().filename().string();
+    std::smatch match;
+    if (std::regex_match(name, match, pattern)) {
+      files[match[1]].emplace_back(std::stoull(match[2]), std::stoull(match[3]), entry.path().string());
+    }
+  }
+  std::map<std::string, std::pair<std::string, size_t>> tables;
+  for (auto &[table, paths] : files) {
+    std::sort(paths.begin(), paths.end());
+    std::string content;
+    for (auto &path : paths) {
+      std::ifstream file(std::get<2>(path), std::ios::binary);
+      std::stringstream buffer;
+      buffer << file.rdbuf();
+      content += buffer.str();
+    }
+    tables[table] = {content, paths.size()};
+  }
+  return tables;
+}
+
+// Generates the runs into a directory each and compares the concatenated tables with the ones of a full run.
+static void checkRuns(const std::string &datagen, const std::string &root, const std::string &name,
+                      const std::vector<std::vector<std::string>> &runs, const std::vector<std::string> &options) {
+  std::string full = root + "/" + name + "_full";
+  std::string split = root + "/" + name + "_split";
+  std::filesystem::create_directories(full);
+  std::filesystem::create_directories(split);
+  if (!generate(datagen, full, options)) {
+    std::cerr << name << ": the full run failed" << std::endl;
+    failures++;
+    return;
+  }
+  for (auto &run : runs) {
+    std::vector<std::string> arguments = run;
+    arguments.insert(arguments.end(), options.begin(), options.end());
+    if (!generate(datagen, split, arguments)) {
+      std::cerr << name << ": run " << run.back() << " failed" << std::endl;
+      failures++;
+      return;
+    }
+  }
+  auto expected = readTables(full);
+  auto actual = readTables(split);
+  CHECK(!expected.empty());
+  CHECK(expected.size() == actual.size());
+  for (auto &[table, content] : expected) {
+    auto found = actual.find(table);
+    if (found == actual.end() || found->second.first != content.first) {
+      std::cerr << name << ": table '" << table << "' differs from the full run" << std::endl;
+      failures++;
+    }
+  }
+  // Every per-warehouse table has at least a file per run, none was overwritten.
+  auto warehouses = actual.find("warehouse");
+  CHECK(warehouses != actual.end() && warehouses->second.second >= runs.size());
+}
+
+int main(int argc, char **argv) {
+  if (argc != 2) {
+    std::cerr << "Usage: " << argv[0] << " <path of gtpc_datagen>" << std::endl;
+    return 1;
+  }
+  std::string datagen = argv[1];
+  char root[] = "/tmp/gtpc_range_test_XXXXXX";
+  if (!mkdtemp(root)) {
+    std::cerr << "Cannot create a temporary directory." << std::endl;
+    return 1;
+  }
+
+  checkRuns(datagen, root, "range", {{"--warehouse-range", "1-1"}, {"--warehouse-range", "2-3"}}, {});
+  checkRuns(datagen, root, "range_chunks", {{"--warehouse-range", "1-2"}, {"--warehouse-range", "3-3"}},
+            {"--chunk-warehouses", "1"});
+  checkRuns(datagen, root, "shard", {{"--shard", "0/2"}, {"--shard", "1/2"}}, {});
+
+  std::filesystem::remove_all(root);
+  if (failures>0) {
+    std::cerr << failures << " checks failed." << std::endl;
+    return 1;
+  }
+  std::cout << "All checks passed." << std::endl;
+  return 0;
+}
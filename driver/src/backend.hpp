@@ -0,0 +1,52 @@
+/*
+ * The implementation of the GTPC graph data generator was built on
+ * Florian Wolf's implementation of the CH-benCHmark data generator
+ * (https://db.in.tum.de/research/projects/CHbenCHmark/) and
+ * Alexander van Renen's implementation of the TPC-C data generator
+ * (https://github.com/alexandervanrenen/tpcc-generator)
+ * See the README file.
+ */
+
+#ifndef backend_hpp_
+#define backend_hpp_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "query_params.hpp"
+#include "workload.hpp"
+
+// The database under test, as the driver sees it. Every worker thread opens its own Session and only uses it from
+// that thread; the Backend itself is shared by all workers.
+namespace driver {
+
+enum class Outcome : uint8_t {
+   Committed,   // done, counts for the throughput
+   RolledBack,  // the intended rollback of New-Order (TPC-C 2.4.2.3), counts as well
+   Failed       // error of the backend, e.g. a deadlock or a lost connection
+};
+
+class Session {
+public:
+   virtual ~Session() = default;
+
+   // Runs the transaction of queries/oltp.cypher with the parameters of tx.
+   virtual Outcome execute(const workload::Transaction &tx) = 0;
+   // Runs the OLAP query with its parameters and consumes the whole result.
+   virtual Outcome query(const qgen::Query &query) = 0;
+};
+
+class Backend {
+public:
+   virtual ~Backend() = default;
+
+   virtual std::string name() const = 0;
+   // Number of warehouses of the loaded dataset, the range of the transaction parameters.
+   virtual int64_t warehouseCount() const = 0;
+   virtual std::unique_ptr<Session> connect() = 0;
+};
+
+}
+
+#endif
@@ -0,0 +1,367 @@
+/*
+ * The implementation of the GTPC graph data generator was built on
+ * Florian Wolf's implementation of the CH-benCHmark data generator
+ * (https://db.in.tum.de/research/projects/CHbenCHmark/) and
+ * Alexander van Renen's implementation of the TPC-C data generator
+ * (https://github.com/alexandervanrenen/tpcc-generator)
+ * See the README file.
+ */
+
+#include "bolt_backend.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+
+namespace driver {
+
+namespace {
+
+// Ids of the orders and order lines created by New-Order: far above the generated ids, and unique without a global
+// counter because D_NEXT_O_ID is unique within the district. They build on the dense id of the district, which stays
+// small in every id space, so the order line ids (order id * 100 + line) fit into 63 bits up to 90 million
+// warehouses.
+const int64_t kNewOrderBase = 1000000000000000;
+const int64_t kOrdersPerDistrict = 100000000;
+
+// TPC-C 2.5.2.2: the customer in the middle of the customers of the district with the last name, ordered by first
+// name.
+const std::string kCustomerByName =
+   "MATCH (d:District)-[:serves]->(c:Customer)\n"
+   "WHERE d.id = $c_d_id AND c.last = $c_last\n"
+   "WITH c\n"
+   "ORDER BY c.first\n"
+   "WITH collect(c) AS customers\n"
+   "WITH customers[(size(customers) - 1) / 2] AS c\n";
+
+const std::string kCustomerById =
+   "MATCH (c:Customer)\n"
+   "WHERE c.id = $c_id\n";
+
+const std::string kPayment =
+   "WITH c,\n"
+   "CASE c.credit\n"
+   "   WHEN \"BC\" THEN left(toString(c.id) + \" \" + toString($h_amount) + \" \" + c.data, 500)\n"
+   "   ELSE c.data\n"
+   "END AS c_new_data\n"
+   "SET c.balance = toFloat(c.balance) - $h_amount, c.ytd_payment = toFloat(c.ytd_payment) + $h_amount, "
+   "c.payment_cnt = toInteger(c.payment_cnt) + 1, c.data = c_new_data\n"
+   "RETURN c.id, c.first, c.middle, c.last, c.street_1, c.street_2, c.city, c.state, c.zip, c.phone, c.since, "
+   "c.credit, c.credit_lim, c.discount, c.balance, c.data";
+
+const std::string kOrderStatus =
+   "OPTIONAL MATCH (c)-[:hasPlaced]->(o:Order)\n"
+   "WITH c, o\n"
+   "ORDER BY o.id DESC\n"
+   "LIMIT 1\n"
+   "OPTIONAL MATCH (o)-[:contains]->(ol:OrderLine)\n"
+   "RETURN c.balance, c.first, c.middle, c.last, o.id, o.entry_d, o.carrier_id, ol.id, ol.quantity, ol.amount, "
+   "ol.delivery_d";
+
+std::string insertOrderLine(uint32_t district_number) {
+   char dist_column[8];
+   snprintf(dist_column, sizeof(dist_column), "dist_%02u", district_number);
+   return "MATCH (o:Order)\n"
+          "WHERE o.id = $o_id\n"
+          "MATCH (s:Stock)\n"
+          "WHERE s.id = $s_id\n"
+          "WITH o, s,\n"
+          "CASE\n"
+          "   WHEN toInteger(s.quantity) - $quantity >= 10 THEN -$quantity\n"
+          "   ELSE 91 - $quantity\n"
+          "END AS s_quantity_diff\n"
+          "SET s.quantity = toInteger(s.quantity) + s_quantity_diff, s.ytd = toInteger(s.ytd) + $quantity, "
+          "s.order_cnt = toInteger(s.order_cnt) + 1, s.remote_cnt = toInteger(s.remote_cnt) + $remote\n"
+          "CREATE (o)-[:contains]->(ol:OrderLine {id: $ol_id})-[:hasStock]->(s)\n"
+          "SET ol.number = $number, ol.delivery_d = datetime({epochMillis: 0}), ol.quantity = $quantity, "
+          "ol.amount = $amount, ol.dist_info = s." + std::string(dist_column) + "\n"
+          "RETURN s.quantity, s.data";
+}
+
+// Properties of a dataset imported from CSV without types are strings, so numbers are converted on the client.
+int64_t integerOf(const packstream::Value *value) {
+   if (!value) {
+      return 0;
+   }
+   switch (value->type) {
+      case packstream::Type::Integer:
+         return value->integer;
+      case packstream::Type::Float:
+         return value->real;
+      case packstream::Type::String:
+         return strtoll(value->string.c_str(), nullptr, 10);
+      default:
+         return 0;
+   }
+}
+
+double numberOf(const packstream::Value *value) {
+   if (!value) {
+      return 0;
+   }
+   switch (value->type) {
+      case packstream::Type::Integer:
+         return value->integer;
+      case packstream::Type::Float:
+         return value->real;
+      case packstream::Type::String:
+         return strtod(value->string.c_str(), nullptr);
+      default:
+         return 0;
+   }
+}
+
+class BoltSession : public Session {
+   bolt::ConnectionPool &pool;
+   const OltpStatements &statements;
+   const std::vector<std::string> &templates;
+   std::vector<bolt::Result> results;
+   std::string text;
+   bool reported = false;
+
+   // Reports the first failure of the session, the driver only counts the others.
+   Outcome failed(const std::string &reason) {
+      if (!reported) {
+         std::cout << "\nBolt session failed: " << reason << std::endl;
+         reported = true;
+      }
+      return Outcome::Failed;
+   }
+
+   Outcome newOrder(bolt::Connection &connection, const workload::Transaction &tx) {
+      connection.begin();
+      connection.run(statements.warehouse_tax).bind(tx.warehouse_id);
+      connection.run(statements.district_next_order).bind(tx.district_id);
+      connection.run(statements.customer_discount).bind(tx.customer_id);
+      for (uint32_t l = 0; l<tx.line_count; l++) {
+         connection.run(statements.item).bind(tx.lines[l].item_id);
+      }
+      if (!connection.sync(results)) {
+         return failed(connection.error());
+      }
+
+      // TPC-C 2.4.2.3: an unused item id rolls the transaction back.
+      if (std::any_of(results.begin() + 3, results.end(), [](const bolt::Result &item) {
+         return item.records.empty();
+      })) {
+         connection.rollback();
+         return connection.sync(results) ? Outcome::RolledBack : failed(connection.error());
+      }
+      if (results[1].records.empty() || results[1].records[0].size()<2) {
+         connection.rollback();
+         connection.sync(results);
+         return failed("No district with id " + std::to_string(tx.district_id));
+      }
+      int64_t order_id = kNewOrderBase + tx.district_index * kOrdersPerDistrict +
+                         integerOf(&results[1].records[0][1]);
+      std::array<double, 15> prices;
+      for (uint32_t l = 0; l<tx.line_count; l++) {
+         prices[l] = numberOf(results[3 + l].first());
+      }
+      bool all_local = std::all_of(tx.lines.begin(), tx.lines.begin() + tx.line_count,
+                                   [&](const workload::OrderLine &line) {
+                                      return line.supply_warehouse_id == tx.warehouse_id;
+                                   });
+
+      connection.run(statements.insert_order).bind(tx.customer_id).bind(order_id).bind(int64_t(tx.line_count))
+         .bind(int64_t(all_local));
+      const bolt::Statement &insert_line = statements.insert_order_line[tx.district_number - 1];
+      for (uint32_t l = 0; l<tx.line_count; l++) {
+         const workload::OrderLine &line = tx.lines[l];
+         connection.run(insert_line).bind(order_id).bind(line.stock_id).bind(int64_t(line.quantity))
+            .bind(int64_t(line.supply_warehouse_id != tx.warehouse_id)).bind(order_id * 100 + l + 1)
+            .bind(int64_t(l + 1)).bind(line.quantity * prices[l]);
+      }
+      connection.commit();
+      return connection.sync(results) ? Outcome::Committed : failed(connection.error());
+   }
+
+   Outcome payment(bolt::Connection &connection, const workload::Transaction &tx) {
+      double amount = tx.amount / 100.0;
+      connection.begin();
+      connection.run(statements.warehouse_payment).bind(tx.warehouse_id).bind(amount);
+      connection.run(statements.district_payment).bind(tx.district_id).bind(amount);
+      if (tx.by_last_name) {
+         connection.run(statements.customer_payment_by_name).bind(tx.customer_district_id)
+            .bind(workload::lastName(tx.last_name)).bind(amount);
+      } else {
+         connection.run(statements.customer_payment).bind(tx.customer_id).bind(amount);
+      }
+      connection.commit();
+      return connection.sync(results) ? Outcome::Committed : failed(connection.error());
+   }
+
+   Outcome orderStatus(bolt::Connection &connection, const workload::Transaction &tx) {
+      // Read only, so an auto-commit statement does.
+      if (tx.by_last_name) {
+         connection.run(statements.order_status_by_name).bind(tx.customer_district_id)
+            .bind(workload::lastName(tx.last_name));
+      } else {
+         connection.run(statements.order_status).bind(tx.customer_id);
+      }
+      return connection.sync(results) ? Outcome::Committed : failed(connection.error());
+   }
+
+   Outcome delivery(bolt::Connection &connection, const workload::Transaction &tx) {
+      // TPC-C 2.7.4: the oldest new order of each district of the warehouse, all in one transaction. The districts are
+      // found through :covers, their ids depend on the id space.
+      connection.begin();
+      for (int64_t d = 0; d<10; d++) {
+         connection.run(statements.delivery).bind(tx.warehouse_id).bind(d).bind(int64_t(tx.carrier_id));
+      }
+      connection.commit();
+      return connection.sync(results) ? Outcome::Committed : failed(connection.error());
+   }
+
+   Outcome stockLevel(bolt::Connection &connection, const workload::Transaction &tx) {
+      connection.run(statements.stock_level).bind(tx.district_id).bind(int64_t(tx.threshold));
+      return connection.sync(results) ? Outcome::Committed : failed(connection.error());
+   }
+
+   Outcome run(const workload::Transaction &tx, bolt::Connection &connection) {
+      switch (tx.type) {
+         case workload::TransactionType::NewOrder:
+            return newOrder(connection, tx);
+         case workload::TransactionType::Payment:
+            return payment(connection, tx);
+         case workload::TransactionType::OrderStatus:
+            return orderStatus(connection, tx);
+         case workload::TransactionType::Delivery:
+            return delivery(connection, tx);
+         case workload::TransactionType::StockLevel:
+            return stockLevel(connection, tx);
+      }
+      return Outcome::Failed;
+   }
+
+public:
+   BoltSession(bolt::ConnectionPool &pool, const OltpStatements &statements, const std::vector<std::string> &templates)
+      : pool(pool), statements(statements), templates(templates) {}
+
+   Outcome execute(const workload::Transaction &tx) override {
+      std::string error;
+      std::unique_ptr<bolt::Connection> connection = pool.acquire(error);
+      if (!connection) {
+         return failed(error);
+      }
+      Outcome outcome = run(tx, *connection);
+      pool.release(std::move(connection));
+      return outcome;
+   }
+
+   Outcome query(const qgen::Query &query) override {
+      // The templates take the parameters as literals, like the ready-to-run output of gtpc_qgen.
+      if (!qgen::substitute(templates[query.number - 1], query, text)) {
+         return failed("Template of query " + std::to_string(query.number) + " does not fit its parameters");
+      }
+      std::string error;
+      std::unique_ptr<bolt::Connection> connection = pool.acquire(error);
+      if (!connection) {
+         return failed(error);
+      }
+      bolt::Statement statement(text, {});
+      connection->run(statement);
+      Outcome outcome = connection->sync(results) ? Outcome::Committed : failed(connection->error());
+      pool.release(std::move(connection));
+      return outcome;
+   }
+};
+
+}
+
+OltpStatements::OltpStatements()
+   : warehouse_tax("MATCH (w:Warehouse)\n"
+                   "WHERE w.id = $w_id\n"
+                   "RETURN w.tax", {"w_id"}),
+     district_next_order("MATCH (d:District)\n"
+                         "WHERE d.id = $d_id\n"
+                         "SET d.next_o_id = toInteger(d.next_o_id) + 1\n"
+                         "RETURN d.tax, d.next_o_id", {"d_id"}),
+     customer_discount("MATCH (c:Customer)\n"
+                       "WHERE c.id = $c_id\n"
+                       "RETURN c.discount, c.last, c.credit", {"c_id"}),
+     item("MATCH (i:Item)\n"
+          "WHERE i.id = $i_id\n"
+          "RETURN i.price, i.name, i.data", {"i_id"}),
+     // Unlike oltp.cypher, the order is linked to its customer, which Order-Status, Delivery and the OLAP queries
+     // rely on.
+     insert_order("MATCH (c:Customer)\n"
+                  "WHERE c.id = $c_id\n"
+                  "CREATE (c)-[:hasPlaced]->(o:Order {id: $o_id})\n"
+                  "SET o.entry_d = datetime(), o.carrier_id = 0, o.ol_cnt = $ol_cnt, o.all_local = $all_local, "
+                  "o.new_order = 1\n"
+                  "RETURN o.id", {"c_id", "o_id", "ol_cnt", "all_local"}),
+     warehouse_payment("MATCH (w:Warehouse)\n"
+                       "WHERE w.id = $w_id\n"
+                       "SET w.ytd = toFloat(w.ytd) + $h_amount\n"
+                       "RETURN w.name, w.street_1, w.street_2, w.city, w.state, w.zip", {"w_id", "h_amount"}),
+     district_payment("MATCH (d:District)\n"
+                      "WHERE d.id = $d_id\n"
+                      "SET d.ytd = toFloat(d.ytd) + $h_amount\n"
+                      "RETURN d.name, d.street_1, d.street_2, d.city, d.state, d.zip, d.ytd", {"d_id", "h_amount"}),
+     customer_payment(kCustomerById + kPayment, {"c_id", "h_amount"}),
+     customer_payment_by_name(kCustomerByName + kPayment, {"c_d_id", "c_last", "h_amount"}),
+     order_status(kCustomerById + kOrderStatus, {"c_id"}),
+     order_status_by_name(kCustomerByName + kOrderStatus, {"c_d_id", "c_last"}),
+     // The generated new_order flags are strings, the ones of New-Order integers.
+     delivery("MATCH (w:Warehouse)-[:covers]->(d:District)\n"
+              "WHERE w.id = $w_id\n"
+              "WITH d\n"
+              "ORDER BY d.id\n"
+              "SKIP $d_index\n"
+              "LIMIT 1\n"
+              "MATCH (d)-[:serves]->(c:Customer)-[:hasPlaced]->(o:Order)\n"
+              "WHERE toInteger(o.new_order) = 1\n"
+              "WITH c, o\n"
+              "ORDER BY o.id\n"
+              "LIMIT 1\n"
+              "SET o.new_order = 0, o.carrier_id = $o_carrier_id\n"
+              "WITH c, o\n"
+              "MATCH (o)-[:contains]->(ol:OrderLine)\n"
+              "SET ol.delivery_d = datetime()\n"
+              "WITH c, sum(toFloat(ol.amount)) AS total_amount\n"
+              "SET c.balance = toFloat(c.balance) + total_amount, c.delivery_cnt = toInteger(c.delivery_cnt) + 1\n"
+              "RETURN c.id", {"w_id", "d_index", "o_carrier_id"}),
+     stock_level("MATCH (d:District)-[:serves]->(:Customer)-[:hasPlaced]->(o:Order)\n"
+                 "WHERE d.id = $d_id\n"
+                 "WITH o\n"
+                 "ORDER BY o.id DESC\n"
+                 "LIMIT 20\n"
+                 "MATCH (o)-[:contains]->(:OrderLine)-[:hasStock]->(s:Stock)<-[:hasStock]-(i:Item)\n"
+                 "WHERE toInteger(s.quantity) < $threshold\n"
+                 "RETURN count(DISTINCT i)", {"d_id", "threshold"}) {
+   for (uint32_t d = 1; d<=10; d++) {
+      insert_order_line.emplace_back(insertOrderLine(d), std::initializer_list<std::string_view>{
+         "o_id", "s_id", "quantity", "remote", "ol_id", "number", "amount"});
+   }
+}
+
+BoltBackend::BoltBackend(const bolt::Config &config, std::vector<std::string> templates, int64_t warehouse_count)
+   : pool(config), templates(std::move(templates)), warehouses(warehouse_count) {}
+
+bool BoltBackend::open(std::string &error) {
+   std::unique_ptr<bolt::Connection> connection = pool.acquire(error);
+   if (!connection) {
+      return false;
+   }
+   if (warehouses == 0) {
+      bolt::Statement count("MATCH (w:Warehouse)\n"
+                            "RETURN count(w)", {});
+      std::vector<bolt::Result> results;
+      connection->run(count);
+      if (!connection->sync(results)) {
+         error = connection->error();
+         return false;
+      }
+      warehouses = integerOf(results[0].first());
+   }
+   pool.release(std::move(connection));
+   return true;
+}
+
+std::unique_ptr<Session> BoltBackend::connect() {
+   return std::make_unique<BoltSession>(pool, statements, templates);
+}
+
+}
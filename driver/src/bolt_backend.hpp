@@ -0,0 +1,68 @@
+/*
+ * The implementation of the GTPC graph data generator was built on
+ * Florian Wolf's implementation of the CH-benCHmark data generator
+ * (https://db.in.tum.de/research/projects/CHbenCHmark/) and
+ * Alexander van Renen's implementation of the TPC-C data generator
+ * (https://github.com/alexandervanrenen/tpcc-generator)
+ * See the README file.
+ */
+
+#ifndef bolt_backend_hpp_
+#define bolt_backend_hpp_
+
+#include <array>
+#include <string>
+#include <vector>
+
+#include "backend.hpp"
+#include "bolt_client.hpp"
+
+namespace driver {
+
+// The statements of queries/oltp.cypher with $parameters instead of literals, grouped so that every transaction
+// needs as few round trips as possible: New-Order reads in one and writes in a second (it needs D_NEXT_O_ID and the
+// item prices for the writes), the others need one. Like the engine, the customer of a last name is searched in its
+// district and Stock-Level looks at the last 20 orders of the district.
+struct OltpStatements {
+   bolt::Statement warehouse_tax;
+   bolt::Statement district_next_order;
+   bolt::Statement customer_discount;
+   bolt::Statement item;
+   bolt::Statement insert_order;
+   // Stock update and order line insert, one per district number because of the S_DIST_xx column.
+   std::vector<bolt::Statement> insert_order_line;
+   bolt::Statement warehouse_payment;
+   bolt::Statement district_payment;
+   bolt::Statement customer_payment;
+   bolt::Statement customer_payment_by_name;
+   bolt::Statement order_status;
+   bolt::Statement order_status_by_name;
+   bolt::Statement delivery;
+   bolt::Statement stock_level;
+
+   OltpStatements();
+};
+
+// A database server speaking Bolt, e.g. Neo4j or Memgraph, loaded with a dataset of the generator. Every worker
+// thread keeps its own connection in the pool.
+class BoltBackend : public Backend {
+   bolt::ConnectionPool pool;
+   const OltpStatements statements;
+   std::vector<std::string> templates;
+   int64_t warehouses;
+
+public:
+   // warehouse_count 0 counts the warehouses of the database in open().
+   BoltBackend(const bolt::Config &config, std::vector<std::string> templates, int64_t warehouse_count);
+
+   // Checks that the server can be reached with the credentials; false with the reason in error if not.
+   bool open(std::string &error);
+
+   std::string name() const override { return "bolt"; }
+   int64_t warehouseCount() const override { return warehouses; }
+   std::unique_ptr<Session> connect() override;
+};
+
+}
+
+#endif
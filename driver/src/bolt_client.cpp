@@ -0,0 +1,523 @@
+/*
+ * The implementation of the GTPC graph data generator was built on
+ * Florian Wolf's implementation of the CH-benCHmark data generator
+ * (https://db.in.tum.de/research/projects/CHbenCHmark/) and
+ * Alexander van Renen's implementation of the TPC-C data generator
+ * (https://github.com/alexandervanrenen/tpcc-generator)
+ * See the README file.
+ */
+
+#include "bolt_client.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <functional>
+#include <thread>
+
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace bolt {
+
+namespace {
+
+// Message tags, see https://neo4j.com/docs/bolt/current/bolt/message/
+const uint8_t kHello = 0x01;
+const uint8_t kGoodbye = 0x02;
+const uint8_t kReset = 0x0F;
+const uint8_t kRun = 0x10;
+const uint8_t kBegin = 0x11;
+const uint8_t kCommit = 0x12;
+const uint8_t kRollback = 0x13;
+const uint8_t kPull = 0x3F;
+const uint8_t kLogon = 0x6A;
+const uint8_t kSuccess = 0x70;
+const uint8_t kRecord = 0x71;
+const uint8_t kIgnored = 0x7E;
+const uint8_t kFailure = 0x7F;
+
+const size_t kMaxChunk = 65535;
+const size_t kReceiveBuffer = 64 * 1024;
+
+// Magic and the proposed versions of the handshake, best first: 5.4 down to 5.0, 4.4 down to 4.2, and 4.1. Each is
+// [unused, range of older minors, minor, major].
+const unsigned char kHandshake[20] = {0x60, 0x60, 0xB0, 0x17, 0x00, 0x04, 0x04, 0x05, 0x00, 0x02, 0x04, 0x04,
+                                      0x00, 0x00, 0x01, 0x04, 0x00, 0x00, 0x00, 0x00};
+
+std::string failureText(const packstream::Value &metadata) {
+   const packstream::Value *code = metadata.find("code");
+   const packstream::Value *text = metadata.find("message");
+   std::string result = code && code->type == packstream::Type::String ? code->string : "Unknown failure";
+   if (text && text->type == packstream::Type::String) {
+      result += ": " + text->string;
+   }
+   return result;
+}
+
+}
+
+bool parseUri(const std::string &uri, Config &config, std::string &error) {
+   std::string_view rest = uri;
+   size_t scheme_end = rest.find("://");
+   if (scheme_end != std::string_view::npos) {
+      std::string_view scheme = rest.substr(0, scheme_end);
+      if (scheme != "bolt" && scheme != "neo4j") {
+         error = "Unsupported URI scheme '" + std::string(scheme) + "', only bolt:// and neo4j:// without TLS are "
+                                                                     "supported.";
+         return false;
+      }
+      rest.remove_prefix(scheme_end + 3);
+   }
+   rest = rest.substr(0, rest.find('/'));
+   size_t colon = rest.rfind(':');
+   if (!rest.empty() && rest.front() == '[') {
+      // IPv6 address, e.g. [::1]:7687
+      size_t bracket = rest.find(']');
+      if (bracket == std::string_view::npos) {
+         error = "Malformed URI '" + uri + "'.";
+         return false;
+      }
+      config.host = std::string(rest.substr(1, bracket - 1));
+      colon = rest.find(':', bracket);
+   } else {
+      config.host = std::string(rest.substr(0, colon));
+   }
+   if (colon != std::string_view::npos) {
+      std::string port(rest.substr(colon + 1));
+      char *end;
+      unsigned long number = strtoul(port.c_str(), &end, 10);
+      if (port.empty() || *end != '\0' || number == 0 || number>UINT16_MAX) {
+         error = "Malformed port in URI '" + uri + "'.";
+         return false;
+      }
+      config.port = number;
+   }
+   if (config.host.empty()) {
+      error = "No host in URI '" + uri + "'.";
+      return false;
+   }
+   return true;
+}
+
+Statement::Statement(std::string_view cypher, std::initializer_list<std::string_view> parameters) {
+   packstream::appendString(prefix, cypher);
+   packstream::appendMapHeader(prefix, parameters.size());
+   for (std::string_view name : parameters) {
+      keys.emplace_back();
+      packstream::appendString(keys.back(), name);
+   }
+}
+
+const packstream::Value *Result::first() const {
+   return records.empty() || records[0].empty() ? nullptr : &records[0][0];
+}
+
+Connection::~Connection() {
+   if (fd>=0) {
+      beginMessage(0, kGoodbye);
+      endMessage();
+      sendAll(out.data(), out.size());
+      close();
+   }
+}
+
+void Connection::close() {
+   if (fd>=0) {
+      ::close(fd);
+      fd = -1;
+   }
+   out.clear();
+   expected.clear();
+   open_statement = nullptr;
+   in_transaction = false;
+   in_begin = in_end = 0;
+}
+
+bool Connection::fail(const std::string &reason) {
+   message = reason;
+   close();
+   return false;
+}
+
+bool Connection::open() {
+   close();
+   addrinfo hints{};
+   hints.ai_family = AF_UNSPEC;
+   hints.ai_socktype = SOCK_STREAM;
+   addrinfo *addresses;
+   std::string port = std::to_string(config.port);
+   int status = getaddrinfo(config.host.c_str(), port.c_str(), &hints, &addresses);
+   if (status != 0) {
+      return fail("Can't resolve " + config.host + ": " + gai_strerror(status));
+   }
+   int last_error = 0;
+   for (addrinfo *address = addresses; address && fd<0; address = address->ai_next) {
+      fd = socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+      if (fd>=0 && connect(fd, address->ai_addr, address->ai_addrlen) != 0) {
+         last_error = errno;
+         ::close(fd);
+         fd = -1;
+      }
+   }
+   freeaddrinfo(addresses);
+   if (fd<0) {
+      return fail("Can't connect to " + config.host + ":" + port + ": " + strerror(last_error));
+   }
+   // The requests of a sync() leave in one segment; without this, Nagle would hold back every second one.
+   int one = 1;
+   setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+   in.resize(kReceiveBuffer);
+
+   if (!handshake()) {
+      return false;
+   }
+   beginMessage(1, kHello);
+   packstream::appendMapHeader(body, (negotiated>=0x0503 ? 2 : 1) + (negotiated<0x0501 ? 3 : 0));
+   packstream::appendString(body, "user_agent");
+   packstream::appendString(body, config.user_agent);
+   if (negotiated>=0x0503) {
+      packstream::appendString(body, "bolt_agent");
+      packstream::appendMapHeader(body, 1);
+      packstream::appendString(body, "product");
+      packstream::appendString(body, config.user_agent);
+   }
+   if (negotiated<0x0501) {
+      appendAuth();
+   }
+   endMessage();
+   expected.push_back(Request::Hello);
+   if (negotiated>=0x0501) {
+      // Since 5.1 the credentials have their own message.
+      beginMessage(1, kLogon);
+      packstream::appendMapHeader(body, 3);
+      appendAuth();
+      endMessage();
+      expected.push_back(Request::Logon);
+   }
+   std::vector<Result> none;
+   if (!sync(none)) {
+      return fail("Can't log in to " + config.host + ":" + port + ": " + message);
+   }
+   return true;
+}
+
+void Connection::appendAuth() {
+   // The three entries of the basic scheme; the callers include them in the size of their map.
+   packstream::appendString(body, "scheme");
+   packstream::appendString(body, "basic");
+   packstream::appendString(body, "principal");
+   packstream::appendString(body, config.user);
+   packstream::appendString(body, "credentials");
+   packstream::appendString(body, config.password);
+}
+
+bool Connection::handshake() {
+   if (!sendAll(reinterpret_cast<const char *>(kHandshake), sizeof(kHandshake)) || !receive(4)) {
+      return false;
+   }
+   const unsigned char *reply = reinterpret_cast<const unsigned char *>(in.data() + in_begin);
+   in_begin += 4;
+   if (memcmp(reply, "HTTP", 4) == 0) {
+      return fail("The server answered with HTTP, is " + std::to_string(config.port) + " the Bolt port?");
+   }
+   negotiated = reply[3] << 8 | reply[2];
+   if (negotiated<0x0401 || negotiated>0x0504) {
+      return fail("The server supports none of the Bolt versions 4.1 to 5.4.");
+   }
+   return true;
+}
+
+void Connection::beginMessage(uint8_t fields, uint8_t tag) {
+   finishRun();
+   body.clear();
+   packstream::appendStructHeader(body, fields, tag);
+}
+
+void Connection::endMessage() {
+   for (size_t pos = 0; pos<body.size(); pos += kMaxChunk) {
+      size_t size = std::min(kMaxChunk, body.size() - pos);
+      out += char(size >> 8);
+      out += char(size);
+      out.append(body, pos, size);
+   }
+   out += '\0';
+   out += '\0';
+}
+
+void Connection::finishRun() {
+   if (!open_statement) {
+      return;
+   }
+   if (bound != open_statement->keys.size()) {
+      usage_error = "Statement with " + std::to_string(open_statement->keys.size()) + " parameters got " +
+                    std::to_string(bound) + " values.";
+   }
+   open_statement = nullptr;
+   // Within a transaction the database is a field of BEGIN.
+   bool database = !in_transaction && !config.database.empty();
+   packstream::appendMapHeader(body, database);
+   if (database) {
+      packstream::appendString(body, "db");
+      packstream::appendString(body, config.database);
+   }
+   endMessage();
+   expected.push_back(Request::Run);
+
+   // Everything at once; the statements of the benchmark return a few records at most.
+   body.clear();
+   packstream::appendStructHeader(body, 1, kPull);
+   packstream::appendMapHeader(body, 1);
+   packstream::appendString(body, "n");
+   packstream::appendInteger(body, -1);
+   endMessage();
+   expected.push_back(Request::Pull);
+}
+
+Connection &Connection::run(const Statement &statement) {
+   beginMessage(3, kRun);
+   body += statement.prefix;
+   open_statement = &statement;
+   bound = 0;
+   return *this;
+}
+
+Connection &Connection::bind(int64_t value) {
+   if (open_statement && bound<open_statement->keys.size()) {
+      body += open_statement->keys[bound++];
+      packstream::appendInteger(body, value);
+   } else {
+      bound++;
+   }
+   return *this;
+}
+
+Connection &Connection::bind(double value) {
+   if (open_statement && bound<open_statement->keys.size()) {
+      body += open_statement->keys[bound++];
+      packstream::appendFloat(body, value);
+   } else {
+      bound++;
+   }
+   return *this;
+}
+
+Connection &Connection::bind(std::string_view value) {
+   if (open_statement && bound<open_statement->keys.size()) {
+      body += open_statement->keys[bound++];
+      packstream::appendString(body, value);
+   } else {
+      bound++;
+   }
+   return *this;
+}
+
+void Connection::begin() {
+   beginMessage(1, kBegin);
+   bool database = !config.database.empty();
+   packstream::appendMapHeader(body, database);
+   if (database) {
+      packstream::appendString(body, "db");
+      packstream::appendString(body, config.database);
+   }
+   endMessage();
+   expected.push_back(Request::Begin);
+   in_transaction = true;
+}
+
+void Connection::commit() {
+   beginMessage(0, kCommit);
+   endMessage();
+   expected.push_back(Request::Commit);
+   in_transaction = false;
+}
+
+void Connection::rollback() {
+   beginMessage(0, kRollback);
+   endMessage();
+   expected.push_back(Request::Rollback);
+   in_transaction = false;
+}
+
+bool Connection::sendAll(const char *data, size_t size) {
+   while (size>0) {
+      ssize_t sent = send(fd, data, size, MSG_NOSIGNAL);
+      if (sent<0 && errno == EINTR) {
+         continue;
+      }
+      if (sent<=0) {
+         return fail(std::string("Can't send to the server: ") + strerror(errno));
+      }
+      data += sent;
+      size -= sent;
+   }
+   return true;
+}
+
+bool Connection::receive(size_t size) {
+   while (in_end - in_begin<size) {
+      if (in_begin>0) {
+         memmove(in.data(), in.data() + in_begin, in_end - in_begin);
+         in_end -= in_begin;
+         in_begin = 0;
+      }
+      if (in.size()<size) {
+         in.resize(size);
+      }
+      ssize_t received = recv(fd, in.data() + in_end, in.size() - in_end, 0);
+      if (received<0 && errno == EINTR) {
+         continue;
+      }
+      if (received<=0) {
+         return fail(received == 0 ? "The server closed the connection."
+                                   : std::string("Can't receive from the server: ") + strerror(errno));
+      }
+      in_end += received;
+   }
+   return true;
+}
+
+bool Connection::readMessage(packstream::Value &value) {
+   response.clear();
+   while (true) {
+      if (!receive(2)) {
+         return false;
+      }
+      size_t size = uint8_t(in[in_begin]) << 8 | uint8_t(in[in_begin + 1]);
+      in_begin += 2;
+      if (size == 0) {
+         // The end of a message, or a NOOP chunk between messages.
+         if (!response.empty()) {
+            break;
+         }
+         continue;
+      }
+      if (!receive(size)) {
+         return false;
+      }
+      response.append(in.data() + in_begin, size);
+      in_begin += size;
+   }
+   const char *pos = response.data();
+   if (!packstream::decode(pos, response.data() + response.size(), value) ||
+       value.type != packstream::Type::Structure) {
+      return fail("Malformed message from the server.");
+   }
+   return true;
+}
+
+bool Connection::sync(std::vector<Result> &results) {
+   finishRun();
+   if (!usage_error.empty()) {
+      std::string reason = std::move(usage_error);
+      usage_error.clear();
+      return fail(reason);
+   }
+   if (fd<0) {
+      expected.clear();
+      out.clear();
+      return fail("Not connected.");
+   }
+   if (!sendAll(out.data(), out.size())) {
+      return false;
+   }
+   out.clear();
+
+   size_t run_count = 0;
+   for (Request request : expected) {
+      run_count += request == Request::Run;
+   }
+   results.resize(run_count);
+   for (Result &result : results) {
+      result.fields.clear();
+      result.records.clear();
+   }
+
+   bool failed = false;
+   size_t result = 0;
+   packstream::Value reply;
+   for (Request request : expected) {
+      while (true) {
+         if (!readMessage(reply)) {
+            return false;
+         }
+         if (reply.tag == kRecord && request == Request::Pull && !reply.list.empty()) {
+            results[result].records.push_back(std::move(reply.list[0].list));
+            continue;
+         }
+         if (reply.tag == kSuccess && request == Request::Run && !reply.list.empty()) {
+            if (const packstream::Value *fields = reply.list[0].find("fields")) {
+               for (const packstream::Value &field : fields->list) {
+                  results[result].fields.push_back(field.string);
+               }
+            }
+         } else if (reply.tag == kFailure) {
+            // The server ignores the rest of the requests until RESET.
+            failed = true;
+            message = reply.list.empty() ? "Unknown failure" : failureText(reply.list[0]);
+         } else if (reply.tag != kSuccess && reply.tag != kIgnored) {
+            return fail("Unexpected message " + std::to_string(reply.tag) + " from the server.");
+         }
+         break;
+      }
+      result += request == Request::Pull;
+   }
+   expected.clear();
+   if (!failed) {
+      return true;
+   }
+
+   // Back to READY, which also rolls an open transaction back.
+   in_transaction = false;
+   beginMessage(0, kReset);
+   endMessage();
+   if (!sendAll(out.data(), out.size())) {
+      return false;
+   }
+   out.clear();
+   do {
+      if (!readMessage(reply)) {
+         return false;
+      }
+   } while (reply.tag == kRecord || reply.tag == kIgnored);
+   if (reply.tag != kSuccess) {
+      std::string reason = message;
+      return fail(reason + " (and the RESET failed)");
+   }
+   return false;
+}
+
+ConnectionPool::Shard &ConnectionPool::shard() {
+   return shards[std::hash<std::thread::id>()(std::this_thread::get_id()) % kShards];
+}
+
+std::unique_ptr<Connection> ConnectionPool::acquire(std::string &error) {
+   Shard &own = shard();
+   {
+      std::lock_guard<std::mutex> lock(own.mutex);
+      if (!own.idle.empty()) {
+         std::unique_ptr<Connection> connection = std::move(own.idle.back());
+         own.idle.pop_back();
+         return connection;
+      }
+   }
+   auto connection = std::make_unique<Connection>(config);
+   if (!connection->open()) {
+      error = connection->error();
+      return nullptr;
+   }
+   return connection;
+}
+
+void ConnectionPool::release(std::unique_ptr<Connection> connection) {
+   if (!connection || connection->broken()) {
+      return;
+   }
+   Shard &own = shard();
+   std::lock_guard<std::mutex> lock(own.mutex);
+   own.idle.push_back(std::move(connection));
+}
+
+}
@@ -0,0 +1,159 @@
+/*
+ * The implementation of the GTPC graph data generator was built on
+ * Florian Wolf's implementation of the CH-benCHmark data generator
+ * (https://db.in.tum.de/research/projects/CHbenCHmark/) and
+ * Alexander van Renen's implementation of the TPC-C data generator
+ * (https://github.com/alexandervanrenen/tpcc-generator)
+ * See the README file.
+ */
+
+#ifndef bolt_client_hpp_
+#define bolt_client_hpp_
+
+#include <array>
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "packstream.hpp"
+
+// Native client of the Bolt protocol, versions 4.1 to 5.4 (https://neo4j.com/docs/bolt/current/bolt/), for the
+// measurement loop of the driver. It speaks plain TCP without TLS and without routing, so a neo4j:// URI connects to
+// the given server directly.
+//
+// Requests are only queued until sync(), which writes all of them with one send and then reads the responses, so a
+// transaction of several statements costs one round trip (pipelining). Errors are returned like in binary_reader:
+// false and a message in error(). After a FAILURE the connection resets itself and stays usable; after a network
+// error it is broken() and has to be replaced.
+namespace bolt {
+
+struct Config {
+   std::string host = "localhost";
+   uint16_t port = 7687;
+   std::string user = "neo4j";
+   std::string password;
+   std::string database;  // empty for the default database of the server
+   std::string user_agent = "gtpc-driver/1.0";
+};
+
+// Takes host and port of bolt://host:port or neo4j://host:port into config.
+bool parseUri(const std::string &uri, Config &config, std::string &error);
+
+// A Cypher statement with named parameters, e.g. Statement("MATCH (w:Warehouse) WHERE w.id = $w_id RETURN w.tax",
+// {"w_id"}). The RUN message up to the parameter values is encoded once here, so an execution only appends the values.
+class Statement {
+   friend class Connection;
+
+   std::string prefix;             // query string and parameter map header
+   std::vector<std::string> keys;  // encoded parameter names
+
+public:
+   Statement(std::string_view cypher, std::initializer_list<std::string_view> parameters);
+};
+
+// The records of one RUN, in the order of the RETURN clause.
+struct Result {
+   std::vector<std::string> fields;
+   std::vector<std::vector<packstream::Value>> records;
+
+   // First column of the first record, or nullptr for an empty result.
+   const packstream::Value *first() const;
+};
+
+class Connection {
+   enum class Request : uint8_t {
+      Hello, Logon, Run, Pull, Begin, Commit, Rollback, Reset
+   };
+
+   Config config;
+   int fd = -1;
+   uint32_t negotiated = 0;  // major << 8 | minor
+   bool in_transaction = false;
+   std::string message;
+   std::string usage_error;
+
+   // Requests queued by run() etc., chunked, and the responses they wait for.
+   std::string out;
+   std::string body;
+   std::vector<Request> expected;
+   const Statement *open_statement = nullptr;
+   size_t bound = 0;
+
+   // Bytes received but not consumed yet.
+   std::vector<char> in;
+   size_t in_begin = 0;
+   size_t in_end = 0;
+   std::string response;
+
+   void beginMessage(uint8_t fields, uint8_t tag);
+   void endMessage();
+   void finishRun();
+   bool sendAll(const char *data, size_t size);
+   bool receive(size_t size);
+   bool readMessage(packstream::Value &value);
+   bool fail(const std::string &reason);
+   bool handshake();
+   void appendAuth();
+
+public:
+   explicit Connection(const Config &config) : config(config) {}
+   ~Connection();
+   Connection(const Connection &) = delete;
+   Connection &operator=(const Connection &) = delete;
+
+   // Opens the socket, negotiates the version and authenticates.
+   bool open();
+   void close();
+   bool broken() const { return fd<0; }
+   const std::string &error() const { return message; }
+   // Negotiated version as major << 8 | minor, e.g. 0x0504.
+   uint32_t version() const { return negotiated; }
+
+   // Queue RUN and PULL of the statement. The parameter values follow with bind(), one per name and in the order of
+   // the names.
+   Connection &run(const Statement &statement);
+   Connection &bind(int64_t value);
+   Connection &bind(double value);
+   Connection &bind(std::string_view value);
+   // Queue an explicit transaction: the statements between begin() and commit() run in one transaction, which may
+   // span several sync() calls.
+   void begin();
+   void commit();
+   void rollback();
+
+   // Sends the queued requests and reads their responses, one Result per run(). False on a FAILURE of the server,
+   // which aborts an open transaction, or on a network error.
+   bool sync(std::vector<Result> &results);
+};
+
+// Idle connections of each thread, so a worker gets back the connection it used before without contending with the
+// other workers. A thread only touches the list of its shard, so the mutex is practically never contended.
+class ConnectionPool {
+   static const size_t kShards = 64;
+
+   struct Shard {
+      std::mutex mutex;
+      std::vector<std::unique_ptr<Connection>> idle;
+   };
+
+   const Config config;
+   std::array<Shard, kShards> shards;
+
+   Shard &shard();
+
+public:
+   explicit ConnectionPool(const Config &config) : config(config) {}
+
+   // An idle connection of this thread or a new one; nullptr if it can't connect, with the reason in error.
+   std::unique_ptr<Connection> acquire(std::string &error);
+   // Keeps the connection for the next acquire() of this thread unless it is broken.
+   void release(std::unique_ptr<Connection> connection);
+};
+
+}
+
+#endif
@@ -0,0 +1,285 @@
+#include <atomic>
+#include <cctype>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+#include "CLI/CLI.hpp"
+
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "packstream.hpp"
+
+// Minimal Bolt server for checking the client and measuring its overhead: it accepts any credentials and answers
+// every statement with one record of 1s, one per item of the last RETURN clause, without running anything.
+
+struct MockConfig {
+  uint32_t major = 5;
+  uint32_t minor = 4;
+  uint64_t fail_every = 0;  // every n-th RUN fails with a transient error; 0 for never
+};
+
+static std::atomic<uint64_t> run_count{0};
+static std::atomic<uint64_t> connection_count{0};
+
+// Number of items of the last RETURN clause, at least 1.
+static size_t returnItems(const std::string &query) {
+  std::string upper(query);
+  for (char &c : upper) {
+    c = toupper(c);
+  }
+  size_t start = upper.rfind("RETURN");
+  if (start == std::string::npos) {
+    return 1;
+  }
+  size_t items = 1;
+  int depth = 0;
+  for (size_t i = start; i<query.size(); i++) {
+    depth += (query[i] == '(' || query[i] == '[' || query[i] == '{') - (query[i] == ')' || query[i] == ']' ||
+                                                                      query[i] == '}');
+    items += depth == 0 && query[i] == ',';
+  }
+  return items;
+}
+
+static void appendMessage(std::string &out, const std::string &body) {
+  for (size_t pos = 0; pos<body.size(); pos += 65535) {
+    size_t size = std::min<size_t>(65535, body.size() - pos);
+    out += char(size >> 8);
+    out += char(size);
+    out.append(body, pos, size);
+  }
+  out += '\0';
+  out += '\0';
+}
+
+static void appendSuccess(std::string &out, const std::vector<std::pair<std::string, std::string>> &metadata) {
+  std::string body;
+  packstream::appendStructHeader(body, 1, 0x70);
+  packstream::appendMapHeader(body, metadata.size());
+  for (auto &[key, value] : metadata) {
+    packstream::appendString(body, key);
+    packstream::appendString(body, value);
+  }
+  appendMessage(out, body);
+}
+
+static void appendSimple(std::string &out, uint8_t tag) {
+  std::string body;
+  packstream::appendStructHeader(body, 0, tag);
+  appendMessage(out, body);
+}
+
+static bool sendAll(int fd, const std::string &out) {
+  size_t done = 0;
+  while (done<out.size()) {
+    ssize_t sent = send(fd, out.data() + done, out.size() - done, MSG_NOSIGNAL);
+    if (sent<=0) {
+      return false;
+    }
+    done += sent;
+  }
+  return true;
+}
+
+// Picks the configured version if the client proposes it, 0 otherwise.
+static uint32_t negotiate(const MockConfig &config, const unsigned char *proposals) {
+  for (uint32_t i = 0; i<4; i++) {
+    const unsigned char *proposal = proposals + 4 * i;
+    uint32_t major = proposal[3], minor = proposal[2], range = proposal[1];
+    if (major == config.major && config.minor<=minor && config.minor + range>=minor) {
+      return config.major << 8 | config.minor;
+    }
+  }
+  return 0;
+}
+
+static void serve(int fd, MockConfig config) {
+  uint64_t id = ++connection_count;
+  std::string in;
+  char buffer[64 * 1024];
+  auto receiveAtLeast = [&](size_t size) {
+    while (in.size()<size) {
+      ssize_t received = recv(fd, buffer, sizeof(buffer), 0);
+      if (received<=0) {
+        return false;
+      }
+      in.append(buffer, received);
+    }
+    return true;
+  };
+
+  uint32_t version = 0;
+  if (receiveAtLeast(20) && memcmp(in.data(), "\x60\x60\xB0\x17", 4) == 0) {
+    version = negotiate(config, reinterpret_cast<const unsigned char *>(in.data() + 4));
+    unsigned char reply[4] = {0, 0, uint8_t(version), uint8_t(version >> 8)};
+    sendAll(fd, std::string(reinterpret_cast<char *>(reply), 4));
+    in.erase(0, 20);
+  }
+
+  bool failed = false;
+  size_t columns = 1;
+  bool closing = version == 0;
+  std::string out, message;
+  while (!closing) {
+    // Answers all complete messages of what arrived, so pipelined requests get their responses in one send.
+    size_t pos = 0;
+    while (!closing) {
+      message.clear();
+      size_t scan = pos;
+      bool complete = false;
+      while (scan + 2<=in.size()) {
+        size_t size = uint8_t(in[scan]) << 8 | uint8_t(in[scan + 1]);
+        if (size == 0) {
+          scan += 2;
+          complete = !message.empty();
+          if (complete) {
+            break;
+          }
+          continue;
+        }
+        if (scan + 2 + size>in.size()) {
+          break;
+        }
+        message.append(in, scan + 2, size);
+        scan += 2 + size;
+      }
+      if (!complete) {
+        break;
+      }
+      pos = scan;
+
+      packstream::Value request;
+      const char *data = message.data();
+      if (!packstream::decode(data, message.data() + message.size(), request) ||
+          request.type != packstream::Type::Structure) {
+        std::cerr << "Connection " << id << ": malformed message, closing." << std::endl;
+        closing = true;
+        break;
+      }
+      if (failed && request.tag != 0x0F && request.tag != 0x02) {
+        appendSimple(out, 0x7E);
+        continue;
+      }
+      std::string body;
+      switch (request.tag) {
+        case 0x01:  // HELLO
+          appendSuccess(out, {{"server", "Neo4j/5.0.0-gtpc-mock"}, {"connection_id", "bolt-" + std::to_string(id)}});
+          break;
+        case 0x02:  // GOODBYE
+          closing = true;
+          break;
+        case 0x0F:  // RESET
+          failed = false;
+          appendSuccess(out, {});
+          break;
+        case 0x10: {  // RUN
+          uint64_t run = ++run_count;
+          if (config.fail_every>0 && run % config.fail_every == 0) {
+            failed = true;
+            packstream::appendStructHeader(body, 1, 0x7F);
+            packstream::appendMapHeader(body, 2);
+            packstream::appendString(body, "code");
+            packstream::appendString(body, "Neo.TransientError.Transaction.DeadlockDetected");
+            packstream::appendString(body, "message");
+            packstream::appendString(body, "Mock failure of RUN " + std::to_string(run));
+            appendMessage(out, body);
+            break;
+          }
+          columns = request.list.empty() ? 1 : returnItems(request.list[0].string);
+          packstream::appendStructHeader(body, 1, 0x70);
+          packstream::appendMapHeader(body, 2);
+          packstream::appendString(body, "fields");
+          packstream::appendListHeader(body, columns);
+          for (size_t c = 0; c<columns; c++) {
+            packstream::appendString(body, "value_" + std::to_string(c + 1));
+          }
+          packstream::appendString(body, "t_first");
+          packstream::appendInteger(body, 0);
+          appendMessage(out, body);
+          break;
+        }
+        case 0x3F:  // PULL
+          packstream::appendStructHeader(body, 1, 0x71);
+          packstream::appendListHeader(body, columns);
+          for (size_t c = 0; c<columns; c++) {
+            packstream::appendInteger(body, 1);
+          }
+          appendMessage(out, body);
+          appendSuccess(out, {});
+          break;
+        case 0x12:  // COMMIT
+          appendSuccess(out, {{"bookmark", "mock:" + std::to_string(run_count.load())}});
+          break;
+        case 0x11:  // BEGIN
+        case 0x13:  // ROLLBACK
+        case 0x6A:  // LOGON
+          appendSuccess(out, {});
+          break;
+        default:
+          std::cerr << "Connection " << id << ": unknown message " << int(request.tag) << ", closing." << std::endl;
+          closing = true;
+      }
+    }
+    in.erase(0, pos);
+    if (!out.empty()) {
+      if (!sendAll(fd, out)) {
+        break;
+      }
+      out.clear();
+    }
+    if (!closing) {
+      ssize_t received = recv(fd, buffer, sizeof(buffer), 0);
+      if (received<=0) {
+        break;
+      }
+      in.append(buffer, received);
+    }
+  }
+  close(fd);
+}
+
+int main(int argc, char **argv) {
+  uint16_t port = 7687;
+  std::string version = "5.4";
+  MockConfig config;
+
+  CLI::App app{"GTPC mock Bolt server, answers every statement with one record"};
+
+  app.add_option("-p,--port", port, "Port to listen on");
+  app.add_option("--bolt-version", version, "Bolt version to accept")
+     ->check(CLI::IsMember({"4.1", "4.2", "4.3", "4.4", "5.0", "5.1", "5.2", "5.3", "5.4"}));
+  app.add_option("--fail-every", config.fail_every, "Fail every n-th statement with a transient error (default: 0 = "
+                                                    "never)");
+
+  CLI11_PARSE(app, argc, argv);
+
+  config.major = version[0] - '0';
+  config.minor = version[2] - '0';
+
+  int server = socket(AF_INET, SOCK_STREAM, 0);
+  int one = 1;
+  setsockopt(server, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+  sockaddr_in address{};
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  address.sin_port = htons(port);
+  if (server<0 || bind(server, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0 ||
+      listen(server, 128) != 0) {
+    std::cerr << "Can't listen on port " << port << ": " << strerror(errno) << std::endl;
+    return 1;
+  }
+  std::cout << "--------- Mock Bolt " << version << " server listening on 127.0.0.1:" << port << std::endl;
+
+  while (true) {
+    int fd = accept(server, nullptr, nullptr);
+    if (fd<0) {
+      continue;
+    }
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    std::thread(serve, fd, config).detach();
+  }
+}
@@ -0,0 +1,189 @@
+/*
+ * The implementation of the GTPC graph data generator was built on
+ * Florian Wolf's implementation of the CH-benCHmark data generator
+ * (https://db.in.tum.de/research/projects/CHbenCHmark/) and
+ * Alexander van Renen's implementation of the TPC-C data generator
+ * (https://github.com/alexandervanrenen/tpcc-generator)
+ * See the README file.
+ */
+
+#include "driver.hpp"
+#include "random.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace driver {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Random table id of the think times; 100-102 are the transaction streams, 110-111 the query streams.
+const uint32_t kThinkTimeTable = 120;
+
+struct Window {
+   Clock::time_point begin;
+   Clock::time_point end;
+
+   bool contains(Clock::time_point time) const { return time>=begin && time<end; }
+};
+
+// Negative exponential think time with the given mean, truncated at 10 times the mean (TPC-C 5.2.5.4).
+std::chrono::nanoseconds thinkTime(rng::Random &ranny, double mean_millis) {
+   double u = (ranny() + 1.0) * (1.0 / 4294967297.0);
+   double millis = std::min(-std::log(u) * mean_millis, 10 * mean_millis);
+   return std::chrono::nanoseconds(int64_t(millis * 1e6));
+}
+
+void oltpWorker(Backend &backend, const Config &config, const Window &window, uint32_t worker, Report &report) {
+   // Every worker is a TPC-C terminal with a fixed home warehouse.
+   int64_t warehouses = backend.warehouseCount();
+   int64_t home = worker % warehouses + 1;
+   workload::TransactionGenerator generator(config.seed, worker, warehouses, home, home,
+                                            ids::IdLayout(config.id_space, warehouses));
+   rng::Random ranny(config.seed, kThinkTimeTable, worker, 0);
+   std::unique_ptr<Session> session = backend.connect();
+
+   while (Clock::now()<window.end) {
+      workload::Transaction tx = generator();
+      Clock::time_point start = Clock::now();
+      Outcome outcome = session->execute(tx);
+      Clock::time_point done = Clock::now();
+      if (window.contains(done)) {
+         size_t type = static_cast<size_t>(tx.type);
+         if (outcome == Outcome::Failed) {
+            report.failed[type]++;
+         } else {
+            report.transactions[type].record(std::chrono::duration_cast<std::chrono::nanoseconds>(done - start)
+                                                .count());
+            report.rolled_back += outcome == Outcome::RolledBack;
+         }
+      }
+      if (config.think_time>0) {
+         std::this_thread::sleep_until(std::min(window.end, Clock::now() + thinkTime(ranny, config.think_time)));
+      }
+   }
+}
+
+void olapStream(Backend &backend, const Config &config, const Window &window, uint32_t stream, Report &report) {
+   qgen::ParameterGenerator generator(config.seed, stream, backend.warehouseCount(),
+                                      ids::IdLayout(config.id_space, backend.warehouseCount()));
+   std::unique_ptr<Session> session = backend.connect();
+
+   for (uint64_t pass = 0; Clock::now()<window.end; pass++) {
+      for (uint32_t number : generator.order(pass)) {
+         if (Clock::now()>=window.end) {
+            break;
+         }
+         qgen::Query query = generator.draw(number, pass);
+         Clock::time_point start = Clock::now();
+         Outcome outcome = session->query(query);
+         Clock::time_point done = Clock::now();
+         if (window.contains(done)) {
+            if (outcome == Outcome::Failed) {
+               report.failed_queries[number - 1]++;
+            } else {
+               report.queries[number - 1].record(std::chrono::duration_cast<std::chrono::nanoseconds>(done - start)
+                                                    .count());
+            }
+         }
+      }
+   }
+}
+
+void writeLine(std::ostream &out, const char *name, const Histogram &histogram, uint64_t failed) {
+   char line[160];
+   snprintf(line, sizeof(line), "%-14s%10lu%8lu%12.3f%12.3f%12.3f%12.3f%12.3f\n", name, histogram.count(), failed,
+            histogram.mean() / 1e6, histogram.percentile(0.5) / 1e6, histogram.percentile(0.99) / 1e6,
+            histogram.percentile(0.999) / 1e6, histogram.max() / 1e6);
+   out << line;
+}
+
+}
+
+void Report::merge(const Report &other) {
+   for (size_t i = 0; i<kTransactionTypes; i++) {
+      transactions[i].merge(other.transactions[i]);
+      failed[i] += other.failed[i];
+   }
+   rolled_back += other.rolled_back;
+   for (size_t i = 0; i<qgen::kQueryCount; i++) {
+      queries[i].merge(other.queries[i]);
+      failed_queries[i] += other.failed_queries[i];
+   }
+}
+
+double Report::tpmC() const {
+   size_t new_order = static_cast<size_t>(workload::TransactionType::NewOrder);
+   return window>0 ? transactions[new_order].count() * 60 / window : 0;
+}
+
+double Report::qph() const {
+   uint64_t count = 0;
+   for (const Histogram &query : queries) {
+      count += query.count();
+   }
+   return window>0 ? count * 3600 / window : 0;
+}
+
+void Report::write(std::ostream &out) const {
+   char line[160];
+   snprintf(line, sizeof(line), "%-14s%10s%8s%12s%12s%12s%12s%12s\n", "", "count", "failed", "mean ms", "p50 ms",
+            "p99 ms", "p999 ms", "max ms");
+   out << line;
+   for (size_t i = 0; i<kTransactionTypes; i++) {
+      writeLine(out, workload::typeName(static_cast<workload::TransactionType>(i)), transactions[i], failed[i]);
+   }
+   bool any_query = false;
+   uint64_t failed_total = 0;
+   for (size_t i = 0; i<qgen::kQueryCount; i++) {
+      if (queries[i].count()>0 || failed_queries[i]>0) {
+         std::string name = "olap_" + std::to_string(i + 1);
+         writeLine(out, name.c_str(), queries[i], failed_queries[i]);
+      }
+      any_query = any_query || queries[i].count()>0;
+      failed_total += failed_queries[i];
+   }
+   snprintf(line, sizeof(line), "Window %.1f s, %lu rolled back New-Order, %lu failed queries%s\n", window,
+            rolled_back, failed_total, any_query ? "" : ", no query completed");
+   out << line;
+   snprintf(line, sizeof(line), "tpmC %.1f, queries per hour %.1f\n", tpmC(), qph());
+   out << line;
+}
+
+Report run(Backend &backend, const Config &config) {
+   Clock::time_point start = Clock::now();
+   Window window;
+   window.begin = start + std::chrono::nanoseconds(int64_t(config.warmup * 1e9));
+   window.end = window.begin + std::chrono::nanoseconds(int64_t(config.duration * 1e9));
+
+   uint32_t workers = config.oltp_workers + config.olap_streams;
+   std::vector<Report> reports(workers);
+   std::vector<std::thread> threads;
+   for (uint32_t w = 0; w<config.oltp_workers; w++) {
+      threads.emplace_back(oltpWorker, std::ref(backend), std::cref(config), std::cref(window), w,
+                           std::ref(reports[w]));
+   }
+   for (uint32_t s = 0; s<config.olap_streams; s++) {
+      threads.emplace_back(olapStream, std::ref(backend), std::cref(config), std::cref(window), s,
+                           std::ref(reports[config.oltp_workers + s]));
+   }
+   for (std::thread &thread : threads) {
+      thread.join();
+   }
+
+   Report report;
+   for (const Report &worker : reports) {
+      report.merge(worker);
+   }
+   report.window = config.duration;
+   return report;
+}
+
+}
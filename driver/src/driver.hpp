@@ -0,0 +1,59 @@
+/*
+ * The implementation of the GTPC graph data generator was built on
+ * Florian Wolf's implementation of the CH-benCHmark data generator
+ * (https://db.in.tum.de/research/projects/CHbenCHmark/) and
+ * Alexander van Renen's implementation of the TPC-C data generator
+ * (https://github.com/alexandervanrenen/tpcc-generator)
+ * See the README file.
+ */
+
+#ifndef driver_hpp_
+#define driver_hpp_
+
+#include <array>
+#include <cstdint>
+#include <ostream>
+
+#include "backend.hpp"
+#include "histogram.hpp"
+#include "id_layout.hpp"
+
+// HTAP run of the GTPC workload, like the CH-benCHmark: K transactional workers run the TPC-C mix and M analytical
+// streams run the 22 queries over and over, all at the same time against one backend. Every worker has its own
+// session, its own parameter stream (worker i uses stream i of gtpc_workload or gtpc_qgen) and its own histograms.
+namespace driver {
+
+const size_t kTransactionTypes = 5;
+
+struct Config {
+   uint32_t oltp_workers = 10;
+   uint32_t olap_streams = 1;
+   double warmup = 10;      // seconds before the measurement window
+   double duration = 60;    // seconds of the measurement window
+   double think_time = 0;   // mean milliseconds between two transactions of a worker, see TPC-C 5.2.5.4
+   uint32_t seed = 42;
+   ids::Space id_space = ids::Space::Dense;  // of the dataset, for the ids in the parameters
+};
+
+// The operations that completed within the measurement window. Latencies in nanoseconds.
+struct Report {
+   double window = 0;  // seconds
+   std::array<Histogram, kTransactionTypes> transactions;
+   std::array<uint64_t, kTransactionTypes> failed{};
+   uint64_t rolled_back = 0;
+   std::array<Histogram, qgen::kQueryCount> queries;
+   std::array<uint64_t, qgen::kQueryCount> failed_queries{};
+
+   void merge(const Report &other);
+   // New-Order transactions per minute, rollbacks included like TPC-C 5.4.2.
+   double tpmC() const;
+   // OLAP queries per hour over all streams; the plain throughput, not the geometric mean of TPC-H's QphH.
+   double qph() const;
+   void write(std::ostream &out) const;
+};
+
+Report run(Backend &backend, const Config &config);
+
+}
+
+#endif
@@ -0,0 +1,94 @@
+#include <iostream>
+#include <memory>
+#include <thread>
+#include "CLI/CLI.hpp"
+
+#include "bolt_backend.hpp"
+#include "driver.hpp"
+#include "engine_backend.hpp"
+
+int main(int argc, char **argv) {
+  std::string backend_name = "engine";
+  std::string directory;
+  uint32_t threads = std::max(1u, std::thread::hardware_concurrency());
+  std::string uri = "bolt://localhost:7687";
+  bolt::Config bolt_config;
+  int64_t warehouses = 0;
+  std::string templates_path = GTPC_QUERY_DIR "/olap_templates.cypher";
+  driver::Config config;
+  std::string id_space = "dense";
+
+  CLI::App app{"GTPC HTAP benchmark driver"};
+
+  app.add_option("--backend", backend_name, "Database under test: the in-process reference engine or a Bolt server")
+     ->check(CLI::IsMember({"engine", "bolt"}));
+  app.add_option("-d,--directory", directory, "Path to the generated dataset for the engine backend");
+  app.add_option("-t,--threads", threads, "Threads of the engine backend for loading and the OLAP queries")
+     ->check(CLI::PositiveNumber);
+  app.add_option("--uri", uri, "Bolt server, bolt://host:port or neo4j://host:port (no TLS, no routing)");
+  app.add_option("--user", bolt_config.user, "User of the Bolt server");
+  app.add_option("--password", bolt_config.password, "Password of the Bolt server");
+  app.add_option("--database", bolt_config.database, "Database of the Bolt server (default: the server's default)");
+  app.add_option("-w,--warehouses", warehouses, "Number of warehouses of the Bolt server's dataset (default: count "
+                                                "them)")->check(CLI::NonNegativeNumber);
+  app.add_option("--templates", templates_path, "OLAP query templates with {{name}} parameters for the Bolt backend");
+  app.add_option("-k,--oltp-workers", config.oltp_workers, "Number of transactional workers (TPC-C terminals)");
+  app.add_option("-m,--olap-streams", config.olap_streams, "Number of analytical query streams");
+  app.add_option("--warmup", config.warmup, "Seconds before the measurement window")
+     ->check(CLI::NonNegativeNumber);
+  app.add_option("--duration", config.duration, "Seconds of the measurement window")->check(CLI::PositiveNumber);
+  app.add_option("--think-time", config.think_time, "Mean think time of the transactional workers in milliseconds "
+                                                    "(default: 0 = none)")->check(CLI::NonNegativeNumber);
+  app.add_option("--seed", config.seed, "Random seed (default: 42, the seed of the data generator)");
+  app.add_option("--id-space", id_space, "Id space of the dataset (gtpc_datagen --id-space)")
+     ->check(CLI::IsMember({"dense", "global", "clustered"}));
+
+  CLI11_PARSE(app, argc, argv);
+
+  ids::parseSpace(id_space, config.id_space);
+
+  if (config.oltp_workers == 0 && config.olap_streams == 0) {
+    std::cerr << "Nothing to run, give at least one transactional worker or query stream." << std::endl;
+    return 1;
+  }
+
+  std::unique_ptr<driver::Backend> backend;
+  if (backend_name == "engine") {
+    if (directory.empty()) {
+      std::cerr << "The engine backend needs the dataset, see --directory." << std::endl;
+      return 1;
+    }
+    std::cout << "--------- Loading " << directory << " into the engine with " << threads << " threads" << std::endl;
+    backend = std::make_unique<driver::EngineBackend>(directory, threads);
+  } else {
+    std::string error;
+    std::vector<std::string> templates;
+    if (!bolt::parseUri(uri, bolt_config, error)) {
+      std::cerr << error << std::endl;
+      return 1;
+    }
+    if (!qgen::loadTemplates(templates_path, templates)) {
+      std::cerr << "Can't read the 22 query templates of " << templates_path << std::endl;
+      return 1;
+    }
+    std::cout << "--------- Connecting to " << uri << std::endl;
+    auto bolt_backend = std::make_unique<driver::BoltBackend>(bolt_config, std::move(templates), warehouses);
+    if (!bolt_backend->open(error)) {
+      std::cerr << error << std::endl;
+      return 1;
+    }
+    backend = std::move(bolt_backend);
+  }
+  if (backend->warehouseCount() == 0) {
+    std::cerr << "The dataset has no warehouses." << std::endl;
+    return 1;
+  }
+
+  std::cout << "--------- Running " << config.oltp_workers << " transactional workers and " << config.olap_streams
+            << " query streams against " << backend->name() << ": " << config.warmup << " s warm-up, "
+            << config.duration << " s measurement" << std::endl;
+  driver::Report report = driver::run(*backend, config);
+  report.write(std::cout);
+
+  return 0;
+}
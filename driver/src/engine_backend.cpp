@@ -0,0 +1,42 @@
+/*
+ * The implementation of the GTPC graph data generator was built on
+ * Florian Wolf's implementation of the CH-benCHmark data generator
+ * (https://db.in.tum.de/research/projects/CHbenCHmark/) and
+ * Alexander van Renen's implementation of the TPC-C data generator
+ * (https://github.com/alexandervanrenen/tpcc-generator)
+ * See the README file.
+ */
+
+#include "engine_backend.hpp"
+
+namespace driver {
+
+namespace {
+
+class EngineSession : public Session {
+   engine::Engine &engine;
+
+public:
+   explicit EngineSession(engine::Engine &engine) : engine(engine) {}
+
+   Outcome execute(const workload::Transaction &tx) override {
+      return engine.execute(tx).rolled_back ? Outcome::RolledBack : Outcome::Committed;
+   }
+
+   Outcome query(const qgen::Query &query) override {
+      engine.query(query);
+      return Outcome::Committed;
+   }
+};
+
+}
+
+EngineBackend::EngineBackend(const std::string &directory, uint32_t thread_count) : engine(thread_count) {
+   engine.load(directory);
+}
+
+std::unique_ptr<Session> EngineBackend::connect() {
+   return std::make_unique<EngineSession>(engine);
+}
+
+}
@@ -0,0 +1,34 @@
+/*
+ * The implementation of the GTPC graph data generator was built on
+ * Florian Wolf's implementation of the CH-benCHmark data generator
+ * (https://db.in.tum.de/research/projects/CHbenCHmark/) and
+ * Alexander van Renen's implementation of the TPC-C data generator
+ * (https://github.com/alexandervanrenen/tpcc-generator)
+ * See the README file.
+ */
+
+#ifndef engine_backend_hpp_
+#define engine_backend_hpp_
+
+#include "backend.hpp"
+#include "engine.hpp"
+
+namespace driver {
+
+// The in-memory reference engine as backend: no server and no network, so a run shows the overhead of the driver
+// itself and the upper bound of the workload on this machine.
+class EngineBackend : public Backend {
+   engine::Engine engine;
+
+public:
+   // Loads the dataset in directory with thread_count threads, which the OLAP queries use as well.
+   EngineBackend(const std::string &directory, uint32_t thread_count);
+
+   std::string name() const override { return "engine"; }
+   int64_t warehouseCount() const override { return engine.warehouseCount(); }
+   std::unique_ptr<Session> connect() override;
+};
+
+}
+
+#endif
@@ -0,0 +1,69 @@
+/*
+ * The implementation of the GTPC graph data generator was built on
+ * Florian Wolf's implementation of the CH-benCHmark data generator
+ * (https://db.in.tum.de/research/projects/CHbenCHmark/) and
+ * Alexander van Renen's implementation of the TPC-C data generator
+ * (https://github.com/alexandervanrenen/tpcc-generator)
+ * See the README file.
+ */
+
+#include "histogram.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace driver {
+
+Histogram::Histogram() : counts(kBucketCount) {}
+
+uint32_t Histogram::index(uint64_t value) {
+   if (value<(1u << kSubBucketBits)) {
+      return value;
+   }
+   uint32_t msb = 63 - __builtin_clzll(value);
+   uint32_t shift = msb - (kSubBucketBits - 1);
+   return (1u << kSubBucketBits) + (shift - 1) * kHalfCount + ((value >> shift) - kHalfCount);
+}
+
+uint64_t Histogram::highestEquivalent(uint32_t index) {
+   if (index<(1u << kSubBucketBits)) {
+      return index;
+   }
+   uint32_t offset = index - (1u << kSubBucketBits);
+   uint32_t shift = offset / kHalfCount + 1;
+   uint64_t lowest = uint64_t(offset % kHalfCount + kHalfCount) << shift;
+   return lowest + (uint64_t(1) << shift) - 1;
+}
+
+void Histogram::record(uint64_t value) {
+   counts[index(value)]++;
+   total++;
+   sum += value;
+   maximum = std::max(maximum, value);
+}
+
+void Histogram::merge(const Histogram &other) {
+   for (uint32_t i = 0; i<kBucketCount; i++) {
+      counts[i] += other.counts[i];
+   }
+   total += other.total;
+   sum += other.sum;
+   maximum = std::max(maximum, other.maximum);
+}
+
+uint64_t Histogram::percentile(double quantile) const {
+   if (total == 0) {
+      return 0;
+   }
+   uint64_t target = std::max<uint64_t>(1, std::ceil(quantile * total));
+   uint64_t seen = 0;
+   for (uint32_t i = 0; i<kBucketCount; i++) {
+      seen += counts[i];
+      if (seen>=target) {
+         return std::min(highestEquivalent(i), maximum);
+      }
+   }
+   return maximum;
+}
+
+}
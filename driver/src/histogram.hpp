@@ -0,0 +1,51 @@
+/*
+ * The implementation of the GTPC graph data generator was built on
+ * Florian Wolf's implementation of the CH-benCHmark data generator
+ * (https://db.in.tum.de/research/projects/CHbenCHmark/) and
+ * Alexander van Renen's implementation of the TPC-C data generator
+ * (https://github.com/alexandervanrenen/tpcc-generator)
+ * See the README file.
+ */
+
+#ifndef histogram_hpp_
+#define histogram_hpp_
+
+#include <cstdint>
+#include <vector>
+
+namespace driver {
+
+// Latency histogram with the log-linear buckets of HdrHistogram: values below 2^kSubBucketBits are exact, above
+// every power of two is split into 2^(kSubBucketBits - 1) buckets, i.e. a relative error below 1/128 over the whole
+// uint64_t range in 58 * 128 counters. Recording is a few instructions without allocation, so every worker records
+// into its own histogram and the driver merges them at the end.
+class Histogram {
+   static const uint32_t kSubBucketBits = 8;
+   static const uint32_t kHalfCount = 1u << (kSubBucketBits - 1);
+   static const uint32_t kBucketCount = (1u << kSubBucketBits) + (64 - kSubBucketBits) * kHalfCount;
+
+   std::vector<uint64_t> counts;
+   uint64_t total = 0;
+   uint64_t sum = 0;
+   uint64_t maximum = 0;
+
+   static uint32_t index(uint64_t value);
+   // The largest value that falls into the bucket.
+   static uint64_t highestEquivalent(uint32_t index);
+
+public:
+   Histogram();
+
+   void record(uint64_t value);
+   void merge(const Histogram &other);
+
+   uint64_t count() const { return total; }
+   uint64_t max() const { return maximum; }
+   double mean() const { return total ? double(sum) / total : 0; }
+   // The smallest recorded value (up to the bucket precision) that quantile of all values are less or equal to.
+   uint64_t percentile(double quantile) const;
+};
+
+}
+
+#endif
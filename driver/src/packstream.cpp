@@ -0,0 +1,309 @@
+/*
+ * The implementation of the GTPC graph data generator was built on
+ * Florian Wolf's implementation of the CH-benCHmark data generator
+ * (https://db.in.tum.de/research/projects/CHbenCHmark/) and
+ * Alexander van Renen's implementation of the TPC-C data generator
+ * (https://github.com/alexandervanrenen/tpcc-generator)
+ * See the README file.
+ */
+
+#include "packstream.hpp"
+
+#include <cstring>
+
+namespace packstream {
+
+namespace {
+
+// All sizes and numbers are big-endian.
+void appendBigEndian(std::string &out, uint64_t value, uint32_t bytes) {
+   for (uint32_t i = bytes; i>0; i--) {
+      out += char(value >> (8 * (i - 1)));
+   }
+}
+
+// Marker of a tiny value (size below 16) or of the 8, 16 and 32 bit sizes that follow the marker.
+void appendSized(std::string &out, uint32_t size, uint8_t tiny, uint8_t sized) {
+   if (tiny && size<16) {
+      out += char(tiny | size);
+   } else if (size<=UINT8_MAX) {
+      out += char(sized);
+      appendBigEndian(out, size, 1);
+   } else if (size<=UINT16_MAX) {
+      out += char(sized + 1);
+      appendBigEndian(out, size, 2);
+   } else {
+      out += char(sized + 2);
+      appendBigEndian(out, size, 4);
+   }
+}
+
+bool readBigEndian(const char *&pos, const char *end, uint32_t bytes, uint64_t &value) {
+   if (end - pos<int64_t(bytes)) {
+      return false;
+   }
+   value = 0;
+   for (uint32_t i = 0; i<bytes; i++) {
+      value = value << 8 | uint8_t(pos[i]);
+   }
+   pos += bytes;
+   return true;
+}
+
+bool readSigned(const char *&pos, const char *end, uint32_t bytes, int64_t &value) {
+   uint64_t raw;
+   if (!readBigEndian(pos, end, bytes, raw)) {
+      return false;
+   }
+   uint32_t shift = 64 - 8 * bytes;
+   value = int64_t(raw << shift) >> shift;
+   return true;
+}
+
+bool readBytes(const char *&pos, const char *end, uint64_t size, std::string &out) {
+   if (uint64_t(end - pos)<size) {
+      return false;
+   }
+   out.assign(pos, size);
+   pos += size;
+   return true;
+}
+
+bool readList(const char *&pos, const char *end, uint64_t size, std::vector<Value> &list) {
+   list.resize(size);
+   for (Value &value : list) {
+      if (!decode(pos, end, value)) {
+         return false;
+      }
+   }
+   return true;
+}
+
+bool readMap(const char *&pos, const char *end, uint64_t size, std::vector<std::pair<std::string, Value>> &map) {
+   map.resize(size);
+   for (auto &[key, value] : map) {
+      Value key_value;
+      if (!decode(pos, end, key_value) || key_value.type != Type::String || !decode(pos, end, value)) {
+         return false;
+      }
+      key = std::move(key_value.string);
+   }
+   return true;
+}
+
+}
+
+const Value *Value::find(std::string_view key) const {
+   for (auto &entry : map) {
+      if (entry.first == key) {
+         return &entry.second;
+      }
+   }
+   return nullptr;
+}
+
+void appendNull(std::string &out) {
+   out += char(0xC0);
+}
+
+void appendBoolean(std::string &out, bool value) {
+   out += char(value ? 0xC3 : 0xC2);
+}
+
+void appendInteger(std::string &out, int64_t value) {
+   if (value>=-16 && value<=127) {
+      out += char(value);
+   } else if (value>=INT8_MIN && value<=INT8_MAX) {
+      out += char(0xC8);
+      appendBigEndian(out, value, 1);
+   } else if (value>=INT16_MIN && value<=INT16_MAX) {
+      out += char(0xC9);
+      appendBigEndian(out, value, 2);
+   } else if (value>=INT32_MIN && value<=INT32_MAX) {
+      out += char(0xCA);
+      appendBigEndian(out, value, 4);
+   } else {
+      out += char(0xCB);
+      appendBigEndian(out, value, 8);
+   }
+}
+
+void appendFloat(std::string &out, double value) {
+   uint64_t bits;
+   memcpy(&bits, &value, sizeof(bits));
+   out += char(0xC1);
+   appendBigEndian(out, bits, 8);
+}
+
+void appendString(std::string &out, std::string_view value) {
+   appendSized(out, value.size(), 0x80, 0xD0);
+   out += value;
+}
+
+void appendListHeader(std::string &out, uint32_t size) {
+   appendSized(out, size, 0x90, 0xD4);
+}
+
+void appendMapHeader(std::string &out, uint32_t size) {
+   appendSized(out, size, 0xA0, 0xD8);
+}
+
+void appendStructHeader(std::string &out, uint8_t size, uint8_t tag) {
+   out += char(0xB0 | size);
+   out += char(tag);
+}
+
+void append(std::string &out, const Value &value) {
+   switch (value.type) {
+      case Type::Null:
+         appendNull(out);
+         break;
+      case Type::Boolean:
+         appendBoolean(out, value.boolean);
+         break;
+      case Type::Integer:
+         appendInteger(out, value.integer);
+         break;
+      case Type::Float:
+         appendFloat(out, value.real);
+         break;
+      case Type::Bytes:
+         appendSized(out, value.string.size(), 0, 0xCC);
+         out += value.string;
+         break;
+      case Type::String:
+         appendString(out, value.string);
+         break;
+      case Type::List:
+         appendListHeader(out, value.list.size());
+         for (const Value &element : value.list) {
+            append(out, element);
+         }
+         break;
+      case Type::Map:
+         appendMapHeader(out, value.map.size());
+         for (auto &[key, element] : value.map) {
+            appendString(out, key);
+            append(out, element);
+         }
+         break;
+      case Type::Structure:
+         appendStructHeader(out, value.list.size(), value.tag);
+         for (const Value &field : value.list) {
+            append(out, field);
+         }
+         break;
+   }
+}
+
+bool decode(const char *&pos, const char *end, Value &value) {
+   if (pos>=end) {
+      return false;
+   }
+   uint8_t marker = *pos++;
+   uint8_t high = marker & 0xF0;
+   uint64_t size;
+   value = Value{};
+   if (marker<0x80 || marker>=0xF0) {
+      value.type = Type::Integer;
+      value.integer = int8_t(marker);
+      return true;
+   }
+   switch (high) {
+      case 0x80:
+         value.type = Type::String;
+         return readBytes(pos, end, marker & 0x0F, value.string);
+      case 0x90:
+         value.type = Type::List;
+         return readList(pos, end, marker & 0x0F, value.list);
+      case 0xA0:
+         value.type = Type::Map;
+         return readMap(pos, end, marker & 0x0F, value.map);
+      case 0xB0:
+         if (pos>=end) {
+            return false;
+         }
+         value.type = Type::Structure;
+         value.tag = *pos++;
+         return readList(pos, end, marker & 0x0F, value.list);
+   }
+   switch (marker) {
+      case 0xC0:
+         return true;
+      case 0xC1: {
+         uint64_t bits;
+         if (!readBigEndian(pos, end, 8, bits)) {
+            return false;
+         }
+         value.type = Type::Float;
+         memcpy(&value.real, &bits, sizeof(bits));
+         return true;
+      }
+      case 0xC2:
+      case 0xC3:
+         value.type = Type::Boolean;
+         value.boolean = marker == 0xC3;
+         return true;
+      case 0xC8:
+      case 0xC9:
+      case 0xCA:
+      case 0xCB:
+         value.type = Type::Integer;
+         return readSigned(pos, end, 1u << (marker - 0xC8), value.integer);
+      case 0xCC:
+      case 0xCD:
+      case 0xCE:
+         value.type = Type::Bytes;
+         return readBigEndian(pos, end, 1u << (marker - 0xCC), size) && readBytes(pos, end, size, value.string);
+      case 0xD0:
+      case 0xD1:
+      case 0xD2:
+         value.type = Type::String;
+         return readBigEndian(pos, end, 1u << (marker - 0xD0), size) && readBytes(pos, end, size, value.string);
+      case 0xD4:
+      case 0xD5:
+      case 0xD6:
+         value.type = Type::List;
+         return readBigEndian(pos, end, 1u << (marker - 0xD4), size) && readList(pos, end, size, value.list);
+      case 0xD8:
+      case 0xD9:
+      case 0xDA:
+         value.type = Type::Map;
+         return readBigEndian(pos, end, 1u << (marker - 0xD8), size) && readMap(pos, end, size, value.map);
+   }
+   return false;
+}
+
+std::string toString(const Value &value) {
+   std::string out;
+   switch (value.type) {
+      case Type::Null:
+         return "null";
+      case Type::Boolean:
+         return value.boolean ? "true" : "false";
+      case Type::Integer:
+         return std::to_string(value.integer);
+      case Type::Float:
+         return std::to_string(value.real);
+      case Type::Bytes:
+         return "<" + std::to_string(value.string.size()) + " bytes>";
+      case Type::String:
+         return "\"" + value.string + "\"";
+      case Type::List:
+      case Type::Structure:
+         out = value.type == Type::List ? "[" : "Structure(" + std::to_string(value.tag) + ")[";
+         for (size_t i = 0; i<value.list.size(); i++) {
+            out += (i>0 ? ", " : "") + toString(value.list[i]);
+         }
+         return out + "]";
+      case Type::Map:
+         out = "{";
+         for (size_t i = 0; i<value.map.size(); i++) {
+            out += (i>0 ? ", " : "") + value.map[i].first + ": " + toString(value.map[i].second);
+         }
+         return out + "}";
+   }
+   return out;
+}
+
+}
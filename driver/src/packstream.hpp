@@ -0,0 +1,60 @@
+/*
+ * The implementation of the GTPC graph data generator was built on
+ * Florian Wolf's implementation of the CH-benCHmark data generator
+ * (https://db.in.tum.de/research/projects/CHbenCHmark/) and
+ * Alexander van Renen's implementation of the TPC-C data generator
+ * (https://github.com/alexandervanrenen/tpcc-generator)
+ * See the README file.
+ */
+
+#ifndef packstream_hpp_
+#define packstream_hpp_
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// PackStream v1, the serialization of Bolt (https://neo4j.com/docs/bolt/current/packstream/). Values are written
+// straight into a byte buffer with the append functions, so building a message does not allocate beyond the buffer;
+// decode() reads them back into Values, which is only needed for the responses.
+namespace packstream {
+
+enum class Type : uint8_t {
+   Null, Boolean, Integer, Float, Bytes, String, List, Map, Structure
+};
+
+struct Value {
+   Type type = Type::Null;
+   bool boolean = false;
+   int64_t integer = 0;
+   double real = 0;
+   uint8_t tag = 0;                                   // Structure
+   std::string string;                                // String and Bytes
+   std::vector<Value> list;                           // List and the fields of a Structure
+   std::vector<std::pair<std::string, Value>> map;
+
+   // The entry of a Map, nullptr if there is none.
+   const Value *find(std::string_view key) const;
+};
+
+void appendNull(std::string &out);
+void appendBoolean(std::string &out, bool value);
+void appendInteger(std::string &out, int64_t value);
+void appendFloat(std::string &out, double value);
+void appendString(std::string &out, std::string_view value);
+void appendListHeader(std::string &out, uint32_t size);
+void appendMapHeader(std::string &out, uint32_t size);
+void appendStructHeader(std::string &out, uint8_t size, uint8_t tag);
+void append(std::string &out, const Value &value);
+
+// Reads one value at pos and advances pos; false if the data is truncated or malformed.
+bool decode(const char *&pos, const char *end, Value &value);
+
+// Human readable form for error messages, e.g. {code: "Neo.ClientError...", message: "..."}.
+std::string toString(const Value &value);
+
+}
+
+#endif
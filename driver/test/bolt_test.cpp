@@ -0,0 +1,287 @@
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "bolt_client.hpp"
+#include "packstream.hpp"
+
+// Checks of the Bolt client: PackStream round trips, and sessions against gtpc_bolt_mock, whose path is the only
+// argument. Run by ctest.
+
+static int failures = 0;
+
+#define CHECK(condition)                                                                      \
+  do {                                                                                        \
+    if (!(condition)) {                                                                       \
+      std::cerr << __FILE__ << ":" << __LINE__ << ": check failed: " #condition << std::endl; \
+      failures++;                                                                             \
+    }                                                                                         \
+  } while (0)
+
+static packstream::Value roundTrip(const std::string &encoded, bool &complete) {
+  packstream::Value value;
+  const char *pos = encoded.data();
+  complete = packstream::decode(pos, encoded.data() + encoded.size(), value) &&
+             pos == encoded.data() + encoded.size();
+  return value;
+}
+
+static void checkInteger(int64_t number, uint8_t marker, size_t size) {
+  std::string encoded;
+  packstream::appendInteger(encoded, number);
+  bool complete;
+  packstream::Value value = roundTrip(encoded, complete);
+  if (!complete || value.type != packstream::Type::Integer || value.integer != number ||
+      uint8_t(encoded[0]) != marker || encoded.size() != size) {
+    std::cerr << "integer " << number << " does not round-trip" << std::endl;
+    failures++;
+  }
+}
+
+static void checkString(size_t length, uint8_t marker, size_t header) {
+  std::string text(length, 'x');
+  std::string encoded;
+  packstream::appendString(encoded, text);
+  bool complete;
+  packstream::Value value = roundTrip(encoded, complete);
+  if (!complete || value.type != packstream::Type::String || value.string != text ||
+      (length>0 && uint8_t(encoded[0]) != marker) || encoded.size() != header + length) {
+    std::cerr << "string of " << length << " bytes does not round-trip" << std::endl;
+    failures++;
+  }
+  // Every byte less is truncated.
+  const char *pos = encoded.data();
+  packstream::Value truncated;
+  CHECK(!packstream::decode(pos, encoded.data() + encoded.size() - 1, truncated));
+}
+
+static void checkContainers(uint32_t size, uint8_t list_marker, uint8_t map_marker) {
+  std::string encoded;
+  packstream::appendListHeader(encoded, size);
+  for (uint32_t i = 0; i<size; i++) {
+    packstream::appendInteger(encoded, -int64_t(i));
+  }
+  bool complete;
+  packstream::Value list = roundTrip(encoded, complete);
+  CHECK(complete && list.type == packstream::Type::List && list.list.size() == size);
+  CHECK(uint8_t(encoded[0]) == list_marker);
+  CHECK(size == 0 || list.list.back().integer == -int64_t(size - 1));
+
+  encoded.clear();
+  packstream::appendMapHeader(encoded, size);
+  for (uint32_t i = 0; i<size; i++) {
+    packstream::appendString(encoded, std::to_string(i));
+    packstream::appendInteger(encoded, i);
+  }
+  packstream::Value map = roundTrip(encoded, complete);
+  CHECK(complete && map.type == packstream::Type::Map && map.map.size() == size);
+  CHECK(uint8_t(encoded[0]) == map_marker);
+  const packstream::Value *last = size == 0 ? nullptr : map.find(std::to_string(size - 1));
+  CHECK(size == 0 || (last && last->integer == size - 1));
+}
+
+static void checkPackstream() {
+  checkInteger(0, 0x00, 1);
+  checkInteger(127, 0x7F, 1);
+  checkInteger(-1, 0xFF, 1);
+  checkInteger(-16, 0xF0, 1);
+  checkInteger(-17, 0xC8, 2);
+  checkInteger(-128, 0xC8, 2);
+  checkInteger(128, 0xC9, 3);
+  checkInteger(-129, 0xC9, 3);
+  checkInteger(32767, 0xC9, 3);
+  checkInteger(-32768, 0xC9, 3);
+  checkInteger(32768, 0xCA, 5);
+  checkInteger(-32769, 0xCA, 5);
+  checkInteger(INT32_MAX, 0xCA, 5);
+  checkInteger(INT32_MIN, 0xCA, 5);
+  checkInteger(int64_t(INT32_MAX) + 1, 0xCB, 9);
+  checkInteger(int64_t(INT32_MIN) - 1, 0xCB, 9);
+  checkInteger(INT64_MAX, 0xCB, 9);
+  checkInteger(INT64_MIN, 0xCB, 9);
+
+  checkString(0, 0x80, 1);
+  checkString(15, 0x8F, 1);
+  checkString(16, 0xD0, 2);
+  checkString(255, 0xD0, 2);
+  checkString(256, 0xD1, 3);
+  checkString(65535, 0xD1, 3);
+  checkString(65536, 0xD2, 5);
+
+  checkContainers(0, 0x90, 0xA0);
+  checkContainers(15, 0x9F, 0xAF);
+  checkContainers(16, 0xD4, 0xD8);
+  checkContainers(256, 0xD5, 0xD9);
+  checkContainers(65536, 0xD6, 0xDA);
+
+  std::string encoded;
+  packstream::appendStructHeader(encoded, 4, 0x71);
+  packstream::appendNull(encoded);
+  packstream::appendBoolean(encoded, true);
+  packstream::appendFloat(encoded, -0.125);
+  packstream::appendString(encoded, "w\xC3\xA4rehouse");
+  bool complete;
+  packstream::Value structure = roundTrip(encoded, complete);
+  CHECK(complete && structure.type == packstream::Type::Structure && structure.tag == 0x71);
+  CHECK(structure.list.size() == 4);
+  if (structure.list.size() == 4) {
+    CHECK(structure.list[0].type == packstream::Type::Null);
+    CHECK(structure.list[1].type == packstream::Type::Boolean && structure.list[1].boolean);
+    CHECK(structure.list[2].type == packstream::Type::Float && structure.list[2].real == -0.125);
+    CHECK(structure.list[3].string == "w\xC3\xA4rehouse");
+  }
+  // Re-encoding the decoded value gives the same bytes.
+  std::string again;
+  packstream::append(again, structure);
+  CHECK(again == encoded);
+}
+
+// A gtpc_bolt_mock process on its own port, killed when it goes out of scope.
+class Mock {
+  pid_t pid = -1;
+
+public:
+  bolt::Config config;
+
+  Mock(const std::string &path, const std::string &version, uint64_t fail_every) {
+    static uint16_t next_port = 20000 + getpid() % 20000;
+    config.host = "127.0.0.1";
+    config.port = next_port++;
+    std::string port = std::to_string(config.port);
+    std::string fail = std::to_string(fail_every);
+    pid = fork();
+    if (pid == 0) {
+      execl(path.c_str(), path.c_str(), "-p", port.c_str(), "--bolt-version", version.c_str(), "--fail-every",
+            fail.c_str(), static_cast<char *>(nullptr));
+      _exit(127);
+    }
+  }
+  ~Mock() {
+    if (pid>0) {
+      kill(pid, SIGTERM);
+      waitpid(pid, nullptr, 0);
+    }
+  }
+
+  // Connects once the mock listens, within a few seconds.
+  bool connect(bolt::Connection &connection) {
+    for (int attempt = 0; attempt<100; attempt++) {
+      if (connection.open()) {
+        return true;
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+    std::cerr << "Can't connect to the mock: " << connection.error() << std::endl;
+    return false;
+  }
+};
+
+static void checkHandshake(const std::string &mock, const std::string &version, uint32_t expected) {
+  Mock server(mock, version, 0);
+  bolt::Connection connection(server.config);
+  if (!server.connect(connection)) {
+    failures++;
+    return;
+  }
+  if (connection.version() != expected) {
+    std::cerr << "Bolt " << version << " negotiated as " << std::hex << connection.version() << std::dec << std::endl;
+    failures++;
+  }
+  // One statement to see that the messages of the version are understood.
+  bolt::Statement statement("MATCH (w:Warehouse) WHERE w.id = $w_id RETURN w.tax", {"w_id"});
+  std::vector<bolt::Result> results;
+  connection.run(statement).bind(int64_t(1));
+  CHECK(connection.sync(results));
+  CHECK(results.size() == 1 && results[0].first() && results[0].first()->integer == 1);
+}
+
+// The responses of pipelined statements land in the Result of their run(), told apart by the number of columns the
+// mock returns for each.
+static void checkPipelining(const std::string &mock) {
+  Mock server(mock, "5.4", 0);
+  bolt::Connection connection(server.config);
+  if (!server.connect(connection)) {
+    failures++;
+    return;
+  }
+  std::vector<bolt::Statement> statements;
+  for (int columns = 1; columns<=5; columns++) {
+    std::string cypher = "RETURN 1";
+    for (int c = 2; c<=columns; c++) {
+      cypher += ", " + std::to_string(c);
+    }
+    statements.emplace_back(cypher, std::initializer_list<std::string_view>{});
+  }
+  std::vector<bolt::Result> results;
+  connection.begin();
+  for (const bolt::Statement &statement : statements) {
+    connection.run(statement);
+  }
+  connection.commit();
+  CHECK(connection.sync(results));
+  CHECK(results.size() == statements.size());
+  for (size_t r = 0; r<results.size(); r++) {
+    CHECK(results[r].fields.size() == r + 1);
+    CHECK(results[r].records.size() == 1 && results[r].records[0].size() == r + 1);
+  }
+}
+
+// A FAILURE makes the mock ignore the rest of the requests; the client resets the connection and it stays usable.
+static void checkRecovery(const std::string &mock) {
+  Mock server(mock, "4.4", 3);
+  bolt::Connection connection(server.config);
+  if (!server.connect(connection)) {
+    failures++;
+    return;
+  }
+  bolt::Statement statement("RETURN $x", {"x"});
+  std::vector<bolt::Result> results;
+  connection.begin();
+  for (int64_t i = 0; i<4; i++) {
+    connection.run(statement).bind(i);
+  }
+  connection.commit();
+  CHECK(!connection.sync(results));
+  CHECK(connection.error().find("TransientError") != std::string::npos);
+  CHECK(!connection.broken());
+  CHECK(results.size() == 4 && results[0].records.size() == 1 && results[3].records.empty());
+
+  // RUNs 4 and 5 of the mock succeed, the 6th fails again.
+  connection.run(statement).bind(int64_t(5));
+  connection.run(statement).bind(int64_t(6));
+  CHECK(connection.sync(results));
+  CHECK(results.size() == 2 && results[1].first() && results[1].first()->integer == 1);
+  connection.run(statement).bind(int64_t(7));
+  CHECK(!connection.sync(results) && !connection.broken());
+}
+
+int main(int argc, char **argv) {
+  if (argc != 2) {
+    std::cerr << "Usage: " << argv[0] << " <path of gtpc_bolt_mock>" << std::endl;
+    return 1;
+  }
+  std::string mock = argv[1];
+
+  checkPackstream();
+  checkHandshake(mock, "4.1", 0x0401);
+  checkHandshake(mock, "4.4", 0x0404);
+  checkHandshake(mock, "5.0", 0x0500);
+  checkHandshake(mock, "5.4", 0x0504);
+  checkPipelining(mock);
+  checkRecovery(mock);
+
+  if (failures>0) {
+    std::cerr << failures << " checks failed." << std::endl;
+    return 1;
+  }
+  std::cout << "All checks passed." << std::endl;
+  return 0;
+}
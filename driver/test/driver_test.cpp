@@ -0,0 +1,190 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "generator.hpp"
+#include "histogram.hpp"
+
+// Checks of the driver: the buckets and percentiles of driver::Histogram, and a short gtpc_driver run against the
+// engine backend on a dataset of one warehouse. The path of gtpc_driver is the only argument. Run by ctest.
+
+static int failures = 0;
+
+#define CHECK(condition)                                                                      \
+  do {                                                                                        \
+    if (!(condition)) {                                                                       \
+      std::cerr << __FILE__ << ":" << __LINE__ << ": check failed: " #condition << std::endl; \
+      failures++;                                                                             \
+    }                                                                                         \
+  } while (0)
+
+// The largest value of the bucket of value: with a larger second value, the median is the end of its bucket.
+static uint64_t bucketEnd(uint64_t value) {
+  driver::Histogram histogram;
+  histogram.record(value);
+  histogram.record(uint64_t(1) << 40);
+  return histogram.percentile(0.5);
+}
+
+// The percentile of the values 1 to count, each recorded once, is at most one bucket, 1/128, above the exact one.
+static void checkPercentile(const driver::Histogram &histogram, double quantile, uint64_t count) {
+  uint64_t exact = uint64_t(quantile * count);
+  uint64_t value = histogram.percentile(quantile);
+  if (value<exact || value>exact + exact / 128 || value>histogram.max()) {
+    std::cerr << "percentile " << quantile << " is " << value << ", expected " << exact << std::endl;
+    failures++;
+  }
+}
+
+static void checkHistogram() {
+  // Values below 256 are exact, up to 511 buckets hold two values, up to 1023 four.
+  CHECK(bucketEnd(0) == 0);
+  CHECK(bucketEnd(255) == 255);
+  CHECK(bucketEnd(256) == 257);
+  CHECK(bucketEnd(257) == 257);
+  CHECK(bucketEnd(511) == 511);
+  CHECK(bucketEnd(512) == 515);
+  CHECK(bucketEnd(1023) == 1023);
+
+  // The last bucket ends at UINT64_MAX and holds the top 2^56 values.
+  driver::Histogram top;
+  top.record(UINT64_MAX);
+  top.record(uint64_t(0xFF) << 56);
+  CHECK(top.count() == 2);
+  CHECK(top.max() == UINT64_MAX);
+  CHECK(top.percentile(0.5) == UINT64_MAX);
+  driver::Histogram below;
+  below.record((uint64_t(0xFF) << 56) - 1);
+  below.record(UINT64_MAX);
+  CHECK(below.percentile(0.5) == (uint64_t(0xFF) << 56) - 1);
+
+  // A uniform distribution, recorded into two histograms and merged.
+  const uint64_t kCount = 10000;
+  driver::Histogram odd;
+  driver::Histogram even;
+  for (uint64_t value = 1; value<=kCount; value++) {
+    (value % 2 ? odd : even).record(value);
+  }
+  driver::Histogram all;
+  all.merge(odd);
+  all.merge(even);
+  CHECK(all.count() == kCount);
+  CHECK(all.max() == kCount);
+  CHECK(all.mean() == 5000.5);
+  checkPercentile(all, 0.5, kCount);
+  checkPercentile(all, 0.99, kCount);
+  checkPercentile(all, 0.999, kCount);
+  CHECK(all.percentile(1) == kCount);
+  CHECK(driver::Histogram().percentile(0.5) == 0);
+}
+
+// Generates a dataset of one warehouse like gtpc_datagen -w 1, with the Phase messages suppressed.
+static void generate(const std::string &directory) {
+  std::cout.setstate(std::ios::failbit);
+  {
+    GtpcGenerator generator(1, directory, 2);
+    generator.setOutputFormat(csv::Format::Csv, 0);
+    generator.generateWarehouses();
+    generator.generateDistricts();
+    generator.generateCustomerAndHistory();
+    generator.generateItems();
+    generator.generateSuppliers();
+    generator.generateStock();
+    generator.generateOrdersAndOrderLines();
+    generator.generateRegions();
+    generator.generateNations();
+    generator.writeManifest();
+  }
+  std::cout.clear();
+}
+
+// Runs gtpc_driver and returns its standard output, empty if it failed.
+static std::string runDriver(const std::string &driver, const std::string &directory) {
+  int pipe_fds[2];
+  if (pipe(pipe_fds)<0) {
+    return "";
+  }
+  pid_t pid = fork();
+  if (pid == 0) {
+    dup2(pipe_fds[1], STDOUT_FILENO);
+    close(pipe_fds[0]);
+    close(pipe_fds[1]);
+    execl(driver.c_str(), driver.c_str(), "--backend", "engine", "-d", directory.c_str(), "-t", "2", "-k", "2", "-m",
+          "1", "--warmup", "0", "--duration", "1", static_cast<char *>(nullptr));
+    _exit(127);
+  }
+  close(pipe_fds[1]);
+  std::string output;
+  char buffer[4096];
+  ssize_t length;
+  while ((length = read(pipe_fds[0], buffer, sizeof(buffer)))>0) {
+    output.append(buffer, length);
+  }
+  close(pipe_fds[0]);
+  int status = 0;
+  if (pid<0 || waitpid(pid, &status, 0) != pid || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+    std::cerr << "gtpc_driver failed:\n" << output << std::endl;
+    return "";
+  }
+  return output;
+}
+
+// New-Order transactions complete within the window and no query fails.
+static void checkEngineRun(const std::string &driver, const std::string &directory) {
+  generate(directory);
+  std::string output = runDriver(driver, directory);
+  if (output.empty()) {
+    failures++;
+    return;
+  }
+  std::istringstream lines(output);
+  std::string line;
+  uint64_t new_orders = 0;
+  uint64_t failed_new_orders = 1;
+  uint64_t failed_queries = 1;
+  while (std::getline(lines, line)) {
+    std::istringstream fields(line);
+    std::string name;
+    fields >> name;
+    if (name == "new_order") {
+      fields >> new_orders >> failed_new_orders;
+    } else if (name == "Window") {
+      sscanf(line.c_str(), "Window %*f s, %*u rolled back New-Order, %lu failed queries", &failed_queries);
+    }
+  }
+  if (new_orders == 0 || failed_new_orders != 0 || failed_queries != 0) {
+    std::cerr << "unexpected report of gtpc_driver:\n" << output << std::endl;
+    failures++;
+  }
+}
+
+int main(int argc, char **argv) {
+  if (argc != 2) {
+    std::cerr << "Usage: " << argv[0] << " <path of gtpc_driver>" << std::endl;
+    return 1;
+  }
+  std::string driver = argv[1];
+  char root[] = "/tmp/gtpc_driver_test_XXXXXX";
+  if (!mkdtemp(root)) {
+    std::cerr << "Cannot create a temporary directory." << std::endl;
+    return 1;
+  }
+
+  checkHistogram();
+  checkEngineRun(driver, root);
+
+  std::filesystem::remove_all(root);
+  if (failures>0) {
+    std::cerr << failures << " checks failed." << std::endl;
+    return 1;
+  }
+  std::cout << "All checks passed." << std::endl;
+  return 0;
+}
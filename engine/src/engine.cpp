@@ -0,0 +1,126 @@
+/*
+ * The implementation of the GTPC graph data generator was built on
+ * Florian Wolf's implementation of the CH-benCHmark data generator
+ * (https://db.in.tum.de/research/projects/CHbenCHmark/) and
+ * Alexander van Renen's implementation of the TPC-C data generator
+ * (https://github.com/alexandervanrenen/tpcc-generator)
+ * See the README file.
+ */
+
+#include "engine.hpp"
+#include "loader.hpp"
+#include "olap.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <mutex>
+
+namespace engine {
+
+Engine::Engine(uint32_t thread_count) : pool(thread_count) {}
+
+void Engine::load(const std::string &directory) {
+   std::unique_lock<std::shared_mutex> lock(mutex);
+   engine::load(graph, directory, pool);
+   buildIndexes();
+}
+
+void Engine::buildIndexes() {
+   const NodeTable &districts = graph[Label::District];
+   const NodeTable &customers = graph[Label::Customer];
+   const NodeTable &orders = graph[Label::Order];
+   const Adjacency &served_by = graph.in(Relationship::Serves);
+   const Adjacency &placed_by = graph.in(Relationship::HasPlaced);
+
+   district_orders.assign(districts.size(), {});
+   new_orders.assign(districts.size(), {});
+   customers_by_name.assign(districts.size(), {});
+
+   for (uint32_t order = 0; order<orders.size(); order++) {
+      uint32_t customer = placed_by.first(order);
+      uint32_t district = customer == kNoRow ? kNoRow : served_by.first(customer);
+      if (district != kNoRow) {
+         district_orders[district].push_back(order);
+      }
+   }
+   const std::vector<int64_t> &new_order = orders.ints(col::O_NEW_ORDER);
+   for (uint32_t district = 0; district<districts.size(); district++) {
+      std::vector<uint32_t> &rows = district_orders[district];
+      std::sort(rows.begin(), rows.end(), [&](uint32_t a, uint32_t b) { return orders.id(a)<orders.id(b); });
+      for (uint32_t order : rows) {
+         if (new_order[order] == 1) {
+            new_orders[district].push_back(order);
+         }
+      }
+   }
+
+   const StringColumn &last = customers.strings(col::C_LAST);
+   const StringColumn &first = customers.strings(col::C_FIRST);
+   for (uint32_t customer = 0; customer<customers.size(); customer++) {
+      uint32_t district = served_by.first(customer);
+      if (district != kNoRow) {
+         customers_by_name[district][std::string(last[customer])].push_back(customer);
+      }
+   }
+   for (auto &names : customers_by_name) {
+      for (auto &[name, rows] : names) {
+         std::sort(rows.begin(), rows.end(), [&](uint32_t a, uint32_t b) {
+            return first[a] != first[b] ? first[a]<first[b] : customers.id(a)<customers.id(b);
+         });
+      }
+   }
+}
+
+uint32_t Engine::lookup(Label label, int64_t id) const {
+   uint32_t row = graph[label].row(id);
+   if (row == kNoRow) {
+      std::cout << "\nNo " << graph[label].file << " with id " << id << ", does the transaction stream belong to the "
+                << "dataset?" << std::endl;
+      std::cout << "aborting..." << std::endl;
+      exit(-1);
+   }
+   return row;
+}
+
+uint32_t Engine::selectCustomer(const workload::Transaction &tx, int64_t district_id) const {
+   if (!tx.by_last_name) {
+      return lookup(Label::Customer, tx.customer_id);
+   }
+   // TPC-C 2.5.2.2: the customer at position ceil(n / 2) of the customers with that name, ordered by first name.
+   // Unlike the Cypher text, which matches the name in all districts, only the customers of the district count.
+   const auto &names = customers_by_name[lookup(Label::District, district_id)];
+   auto it = names.find(workload::lastName(tx.last_name));
+   if (it == names.end()) {
+      return kNoRow;
+   }
+   return it->second[(it->second.size() - 1) / 2];
+}
+
+Result Engine::execute(const workload::Transaction &tx) {
+   std::unique_lock<std::mutex> gate(turnstile);
+   std::unique_lock<std::shared_mutex> lock(mutex);
+   gate.unlock();
+   switch (tx.type) {
+      case workload::TransactionType::NewOrder:
+         return newOrder(tx);
+      case workload::TransactionType::Payment:
+         return payment(tx);
+      case workload::TransactionType::OrderStatus:
+         return orderStatus(tx);
+      case workload::TransactionType::Delivery:
+         return delivery(tx);
+      case workload::TransactionType::StockLevel:
+         return stockLevel(tx);
+   }
+   return Result{};
+}
+
+Result Engine::query(const qgen::Query &query) {
+   {
+      std::lock_guard<std::mutex> gate(turnstile);
+   }
+   std::shared_lock<std::shared_mutex> lock(mutex);
+   return runQuery(graph, pool, query);
+}
+
+}
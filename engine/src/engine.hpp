@@ -0,0 +1,75 @@
+/*
+ * The implementation of the GTPC graph data generator was built on
+ * Florian Wolf's implementation of the CH-benCHmark data generator
+ * (https://db.in.tum.de/research/projects/CHbenCHmark/) and
+ * Alexander van Renen's implementation of the TPC-C data generator
+ * (https://github.com/alexandervanrenen/tpcc-generator)
+ * See the README file.
+ */
+
+#ifndef engine_hpp_
+#define engine_hpp_
+
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "graph.hpp"
+#include "query_params.hpp"
+#include "result.hpp"
+#include "thread_pool.hpp"
+#include "workload.hpp"
+
+// Reference engine for the GTPC workloads: executes the transactions of queries/oltp.cypher and the queries of
+// queries/olap.cypher on an in-memory Graph with hand-written operators. The queries follow the Cypher texts
+// literally, including their quirks, so their results can be compared with a graph database on the same data. The
+// transactions follow TPC-C 2.4-2.8 on the nodes and relationships that oltp.cypher reads and writes.
+//
+// Concurrency is deliberately simple: a transaction holds the engine exclusively, queries share it and parallelize
+// over the pool. That gives serializable results, not the throughput of a real transaction manager.
+namespace engine {
+
+class Engine {
+   ThreadPool pool;
+   Graph graph;
+   std::shared_mutex mutex;
+   // Taken by a transaction while it waits for the exclusive lock and passed by every query before it takes the
+   // shared one, so a stream of queries can't starve the transactions.
+   std::mutex turnstile;
+
+   // District of the customer that placed an order, as (District)-[:serves]->(Customer)-[:hasPlaced]->(Order) of
+   // Delivery and Stock-Level. Per district row: the order rows by id and the undelivered ones (new_order = 1).
+   std::vector<std::vector<uint32_t>> district_orders;
+   std::vector<std::deque<uint32_t>> new_orders;
+   // Per district row: the customer rows by last name, ordered by first name.
+   std::vector<std::unordered_map<std::string, std::vector<uint32_t>>> customers_by_name;
+
+   void buildIndexes();
+   uint32_t lookup(Label label, int64_t id) const;
+   uint32_t selectCustomer(const workload::Transaction &tx, int64_t district_id) const;
+
+   Result newOrder(const workload::Transaction &tx);
+   Result payment(const workload::Transaction &tx);
+   Result orderStatus(const workload::Transaction &tx);
+   Result delivery(const workload::Transaction &tx);
+   Result stockLevel(const workload::Transaction &tx);
+
+public:
+   explicit Engine(uint32_t thread_count);
+
+   // Loads a dataset of the generator, see loader.hpp.
+   void load(const std::string &directory);
+   int64_t warehouseCount() const { return graph[Label::Warehouse].size(); }
+   const Graph &data() const { return graph; }
+
+   Result execute(const workload::Transaction &tx);
+   Result query(const qgen::Query &query);
+};
+
+}
+
+#endif
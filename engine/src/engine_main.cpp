@@ -0,0 +1,150 @@
+#include <array>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include "CLI/CLI.hpp"
+
+#include "engine.hpp"
+#include "olap.hpp"
+
+using Clock = std::chrono::steady_clock;
+
+static double millisSince(Clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// "1,3,5-7" -> 1 3 5 6 7; false on anything else.
+static bool parseQueryList(const std::string &text, std::vector<uint32_t> &numbers) {
+  std::stringstream list(text);
+  std::string item;
+  while (std::getline(list, item, ',')) {
+    uint32_t first, last;
+    char dash;
+    std::stringstream range(item);
+    if (!(range >> first)) {
+      return false;
+    }
+    last = first;
+    if (range >> dash && (dash != '-' || !(range >> last))) {
+      return false;
+    }
+    if (first < 1 || last > qgen::kQueryCount || first > last) {
+      return false;
+    }
+    for (uint32_t number = first; number <= last; number++) {
+      numbers.push_back(number);
+    }
+  }
+  return !numbers.empty();
+}
+
+int main(int argc, char **argv) {
+  std::string directory;
+  uint32_t threads = std::max(1u, std::thread::hardware_concurrency());
+  std::string query_list = "1-22";
+  bool original = false;
+  uint64_t passes = 1;
+  uint64_t transactions = 0;
+  uint32_t stream = 0;
+  uint32_t seed = 42;
+  std::string output;
+  std::string id_space = "dense";
+
+  CLI::App app{"GTPC in-memory reference engine"};
+
+  app.add_option("-d,--directory", directory, "Path to the generated dataset (--format csv or neo4j-admin, "
+                                              "uncompressed)")->required();
+  app.add_option("-t,--threads", threads, "Number of threads for loading and the OLAP queries")
+     ->check(CLI::PositiveNumber);
+  app.add_option("-q,--queries", query_list, "OLAP queries to run, e.g. 1,3,5-7 (default: all)");
+  app.add_flag("--original", original, "Use the parameters of queries/olap.cypher instead of a gtpc_qgen stream");
+  app.add_option("-n,--passes", passes, "Runs of every query; pass p uses the parameters of pass p of the stream");
+  app.add_option("--transactions", transactions, "Number of OLTP transactions of the gtpc_workload stream to run "
+                                                 "before the queries");
+  app.add_option("--stream", stream, "Stream of the transactions and the query parameters");
+  app.add_option("--seed", seed, "Random seed (default: 42, the seed of the data generator)");
+  app.add_option("--id-space", id_space, "Id space of the dataset (gtpc_datagen --id-space)")
+     ->check(CLI::IsMember({"dense", "global", "clustered"}));
+  app.add_option("-o,--output", output, "Directory for the query results, one file per query and pass");
+
+  CLI11_PARSE(app, argc, argv);
+
+  std::vector<uint32_t> numbers;
+  if (!parseQueryList(query_list, numbers)) {
+    std::cerr << "Invalid query list '" << query_list << "', expected numbers of 1 to " << qgen::kQueryCount
+              << " like 1,3,5-7." << std::endl;
+    return 1;
+  }
+  if (!output.empty()) {
+    std::error_code error;
+    std::filesystem::create_directories(output, error);
+  }
+
+  engine::Engine engine(threads);
+  std::cout << "--------- Loading " << directory << " with " << threads << " threads" << std::endl;
+  auto start = Clock::now();
+  engine.load(directory);
+  const engine::Graph &graph = engine.data();
+  std::cout << "Loaded " << engine.warehouseCount() << " warehouses, " << graph[engine::Label::OrderLine].size()
+            << " order lines in " << std::fixed << std::setprecision(1) << millisSince(start) << " ms" << std::endl;
+  if (engine.warehouseCount() == 0) {
+    std::cerr << "The dataset has no warehouses." << std::endl;
+    return 1;
+  }
+  ids::Space space = ids::Space::Dense;
+  ids::parseSpace(id_space, space);
+  ids::IdLayout layout(space, engine.warehouseCount());
+
+  if (transactions > 0) {
+    std::cout << "--------- Running " << transactions << " transactions of stream " << stream << std::endl;
+    workload::TransactionGenerator generator(seed, stream, engine.warehouseCount(), 1, engine.warehouseCount(),
+                                             layout);
+    std::array<uint64_t, 5> counts{};
+    std::array<double, 5> millis{};
+    uint64_t rollbacks = 0;
+    for (uint64_t i = 0; i < transactions; i++) {
+      workload::Transaction tx = generator();
+      auto tx_start = Clock::now();
+      engine::Result result = engine.execute(tx);
+      millis[static_cast<size_t>(tx.type)] += millisSince(tx_start);
+      counts[static_cast<size_t>(tx.type)]++;
+      rollbacks += result.rolled_back;
+    }
+    for (size_t type = 0; type < counts.size(); type++) {
+      std::cout << std::left << std::setw(14) << workload::typeName(static_cast<workload::TransactionType>(type))
+                << std::right << std::setw(10) << counts[type] << " tx  "
+                << std::setprecision(3) << (counts[type] ? millis[type] / counts[type] : 0) << " ms/tx" << std::endl;
+    }
+    std::cout << "Rolled back: " << rollbacks << std::endl;
+  }
+
+  std::cout << "--------- Running " << numbers.size() << " queries with " << passes << " passes" << std::endl;
+  qgen::ParameterGenerator generator(seed, stream, engine.warehouseCount(), layout);
+  for (uint64_t pass = 0; pass < passes; pass++) {
+    for (uint32_t number : numbers) {
+      qgen::Query query = original ? engine::originalQuery(number) : generator.draw(number, pass);
+      auto query_start = Clock::now();
+      engine::Result result = engine.query(query);
+      double elapsed = millisSince(query_start);
+      std::cout << "OLAP #" << std::left << std::setw(3) << number << std::right << " pass " << pass
+                << std::setw(10) << result.rows.size() << " rows " << std::setprecision(1) << std::setw(10)
+                << elapsed << " ms" << std::endl;
+      if (!output.empty()) {
+        std::string path = (std::filesystem::path(output) /
+                            ("olap_" + std::to_string(number) + "_" + std::to_string(pass) + ".txt")).string();
+        std::ofstream out(path);
+        result.write(out);
+        if (!out) {
+          std::cerr << "Cannot write '" << path << "'." << std::endl;
+          return 1;
+        }
+      }
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,238 @@
+/*
+ * The implementation of the GTPC graph data generator was built on
+ * Florian Wolf's implementation of the CH-benCHmark data generator
+ * (https://db.in.tum.de/research/projects/CHbenCHmark/) and
+ * Alexander van Renen's implementation of the TPC-C data generator
+ * (https://github.com/alexandervanrenen/tpcc-generator)
+ * See the README file.
+ */
+
+#include "graph.hpp"
+
+#include <algorithm>
+
+namespace engine {
+
+namespace {
+
+struct NodeSchema {
+   Label label;
+   const char *file;
+   std::vector<std::pair<const char *, Type>> columns;
+};
+
+// The property types of the typed neo4j-admin headers of the generator.
+// @formatter:off
+const NodeSchema kNodeSchemas[] = {
+   {Label::Warehouse, "warehouse", {{"id", Type::Int64}, {"name", Type::String}, {"street_1", Type::String},
+      {"street_2", Type::String}, {"city", Type::String}, {"state", Type::String}, {"zip", Type::String},
+      {"tax", Type::Float}, {"ytd", Type::Float}}},
+   {Label::District, "district", {{"id", Type::Int64}, {"name", Type::String}, {"street_1", Type::String},
+      {"street_2", Type::String}, {"city", Type::String}, {"state", Type::String}, {"zip", Type::String},
+      {"tax", Type::Float}, {"ytd", Type::Float}, {"next_o_id", Type::Int64}}},
+   {Label::Customer, "customer", {{"id", Type::Int64}, {"first", Type::String}, {"middle", Type::String},
+      {"last", Type::String}, {"street_1", Type::String}, {"street_2", Type::String}, {"city", Type::String},
+      {"state", Type::String}, {"zip", Type::String}, {"phone", Type::String}, {"since", Type::Timestamp},
+      {"credit", Type::String}, {"credit_lim", Type::Float}, {"discount", Type::Float}, {"balance", Type::Float},
+      {"ytd_payment", Type::Float}, {"payment_cnt", Type::Int64}, {"delivery_cnt", Type::Int64},
+      {"data", Type::String}, {"history_date", Type::Timestamp}, {"history_amount", Type::Float},
+      {"history_data", Type::String}}},
+   {Label::Item, "item", {{"id", Type::Int64}, {"im_id", Type::Int64}, {"name", Type::String}, {"price", Type::Float},
+      {"data", Type::String}}},
+   {Label::Stock, "stock", {{"id", Type::Int64}, {"quantity", Type::Int64}, {"dist_01", Type::String},
+      {"dist_02", Type::String}, {"dist_03", Type::String}, {"dist_04", Type::String}, {"dist_05", Type::String},
+      {"dist_06", Type::String}, {"dist_07", Type::String}, {"dist_08", Type::String}, {"dist_09", Type::String},
+      {"dist_10", Type::String}, {"ytd", Type::Int64}, {"order_cnt", Type::Int64}, {"remote_cnt", Type::Int64},
+      {"data", Type::String}}},
+   {Label::Order, "order", {{"id", Type::Int64}, {"entry_d", Type::Timestamp}, {"carrier_id", Type::Int64},
+      {"ol_cnt", Type::Int64}, {"all_local", Type::Int64}, {"new_order", Type::Int64}}},
+   {Label::OrderLine, "orderLine", {{"id", Type::Int64}, {"number", Type::Int64}, {"delivery_d", Type::Timestamp},
+      {"quantity", Type::Int64}, {"amount", Type::Float}, {"dist_info", Type::String}}},
+   {Label::Region, "region", {{"id", Type::Int64}, {"name", Type::String}, {"comment", Type::String}}},
+   {Label::Nation, "nation", {{"id", Type::Int64}, {"name", Type::String}, {"comment", Type::String}}},
+   {Label::Supplier, "supplier", {{"id", Type::Int64}, {"name", Type::String}, {"address", Type::String},
+      {"phone", Type::String}, {"acctbal", Type::Float}, {"comment", Type::String}}},
+};
+// @formatter:on
+
+struct EdgeSchema {
+   Relationship type;
+   Label from;
+   Label to;
+   const char *file;
+};
+
+const EdgeSchema kEdgeSchemas[] = {
+   {Relationship::Covers, Label::Warehouse, Label::District, "warehouse_covers_district"},
+   {Relationship::Serves, Label::District, Label::Customer, "district_serves_customer"},
+   {Relationship::CustomerIsLocatedIn, Label::Customer, Label::Nation, "customer_isLocatedIn_nation"},
+   {Relationship::WarehouseHasStock, Label::Warehouse, Label::Stock, "warehouse_hasStock_stock"},
+   {Relationship::ItemHasStock, Label::Item, Label::Stock, "item_hasStock_stock"},
+   {Relationship::HasSupplier, Label::Stock, Label::Supplier, "stock_hasSupplier_supplier"},
+   {Relationship::HasPlaced, Label::Customer, Label::Order, "customer_hasPlaced_order"},
+   {Relationship::OrderLineHasStock, Label::OrderLine, Label::Stock, "orderLine_hasStock_stock"},
+   {Relationship::Contains, Label::Order, Label::OrderLine, "order_contains_orderLine"},
+   {Relationship::IsPartOf, Label::Nation, Label::Region, "nation_isPartOf_region"},
+   {Relationship::SupplierIsLocatedIn, Label::Supplier, Label::Nation, "supplier_isLocatedIn_nation"},
+};
+
+}
+
+void StringColumn::push_back(std::string_view value) {
+   offsets.push_back(chars.size());
+   lengths.push_back(value.size());
+   chars.insert(chars.end(), value.begin(), value.end());
+}
+
+void StringColumn::set(size_t row, std::string_view value) {
+   offsets[row] = chars.size();
+   lengths[row] = value.size();
+   chars.insert(chars.end(), value.begin(), value.end());
+}
+
+void StringColumn::append(const StringColumn &other) {
+   uint64_t base = chars.size();
+   chars.insert(chars.end(), other.chars.begin(), other.chars.end());
+   for (uint64_t offset : other.offsets) {
+      offsets.push_back(base + offset);
+   }
+   lengths.insert(lengths.end(), other.lengths.begin(), other.lengths.end());
+}
+
+size_t Column::size() const {
+   switch (type) {
+      case Type::Float:
+         return floats.size();
+      case Type::String:
+         return strings.size();
+      default:
+         return ints.size();
+   }
+}
+
+void Column::append(const Column &other) {
+   switch (type) {
+      case Type::Float:
+         floats.insert(floats.end(), other.floats.begin(), other.floats.end());
+         break;
+      case Type::String:
+         strings.append(other.strings);
+         break;
+      default:
+         ints.insert(ints.end(), other.ints.begin(), other.ints.end());
+   }
+}
+
+void Column::pushDefault() {
+   switch (type) {
+      case Type::Float:
+         floats.push_back(0.0);
+         break;
+      case Type::String:
+         strings.push_back("");
+         break;
+      default:
+         ints.push_back(0);
+   }
+}
+
+uint32_t NodeTable::row(int64_t id) const {
+   if (dense) {
+      return id>=first_id && id - first_id<int64_t(size()) ? uint32_t(id - first_id) : kNoRow;
+   }
+   auto it = rows.find(id);
+   return it == rows.end() ? kNoRow : it->second;
+}
+
+void NodeTable::buildIndex() {
+   const std::vector<int64_t> &ids = columns[0].ints;
+   first_id = ids.empty() ? 1 : ids[0];
+   max_id = 0;
+   dense = true;
+   for (size_t row = 0; row<ids.size(); row++) {
+      dense = dense && ids[row] == first_id + int64_t(row);
+      max_id = std::max(max_id, ids[row]);
+   }
+   rows.clear();
+   if (!dense) {
+      for (size_t row = 0; row<ids.size(); row++) {
+         rows[ids[row]] = row;
+      }
+   }
+}
+
+uint32_t NodeTable::appendRow(int64_t id) {
+   uint32_t row = size();
+   for (Column &column : columns) {
+      column.pushDefault();
+   }
+   columns[0].ints[row] = id;
+   if (dense && id != first_id + int64_t(row)) {
+      dense = false;
+      for (uint32_t r = 0; r<row; r++) {
+         rows[this->id(r)] = r;
+      }
+   }
+   if (!dense) {
+      rows[id] = row;
+   }
+   max_id = std::max(max_id, id);
+   return row;
+}
+
+void Adjacency::build(size_t source_count, const std::vector<std::pair<uint32_t, uint32_t>> &edges, bool reverse) {
+   // Counting sort by source row, stable, so the neighbours keep the order of the files.
+   offsets.assign(source_count + 1, 0);
+   for (auto &edge : edges) {
+      offsets[(reverse ? edge.second : edge.first) + 1]++;
+   }
+   for (size_t i = 0; i<source_count; i++) {
+      offsets[i + 1] += offsets[i];
+   }
+   targets.resize(edges.size());
+   std::vector<uint64_t> next(offsets.begin(), offsets.end() - 1);
+   for (auto &edge : edges) {
+      uint32_t source = reverse ? edge.second : edge.first;
+      targets[next[source]++] = reverse ? edge.first : edge.second;
+   }
+   added.clear();
+}
+
+uint32_t Adjacency::first(uint32_t row) const {
+   if (row + 1<offsets.size() && offsets[row]<offsets[row + 1]) {
+      return targets[offsets[row]];
+   }
+   if (!added.empty()) {
+      auto it = added.find(row);
+      if (it != added.end() && !it->second.empty()) {
+         return it->second.front();
+      }
+   }
+   return kNoRow;
+}
+
+Graph::Graph() {
+   for (const NodeSchema &schema : kNodeSchemas) {
+      NodeTable &table = (*this)[schema.label];
+      table.label = schema.label;
+      table.file = schema.file;
+      for (auto &[name, type] : schema.columns) {
+         table.columns.push_back(Column{name, type});
+      }
+   }
+   for (const EdgeSchema &schema : kEdgeSchemas) {
+      Edges &edges = (*this)[schema.type];
+      edges.type = schema.type;
+      edges.from = schema.from;
+      edges.to = schema.to;
+      edges.file = schema.file;
+   }
+}
+
+void Graph::addEdge(Relationship type, uint32_t from, uint32_t to) {
+   Edges &edges = (*this)[type];
+   edges.out.add(from, to);
+   edges.in.add(to, from);
+}
+
+}
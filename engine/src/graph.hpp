@@ -0,0 +1,206 @@
+/*
+ * The implementation of the GTPC graph data generator was built on
+ * Florian Wolf's implementation of the CH-benCHmark data generator
+ * (https://db.in.tum.de/research/projects/CHbenCHmark/) and
+ * Alexander van Renen's implementation of the TPC-C data generator
+ * (https://github.com/alexandervanrenen/tpcc-generator)
+ * See the README file.
+ */
+
+#ifndef graph_hpp_
+#define graph_hpp_
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// In-memory property graph of a generated dataset. Nodes are partitioned by label; every label is a NodeTable with
+// one column per property, addressed by row. Relationships of one type between two labels are kept as CSR
+// adjacency in both directions, again by row. Rows are dense and never deleted, so the queries can use plain arrays
+// indexed by row for their intermediate state.
+namespace engine {
+
+const uint32_t kNoRow = UINT32_MAX;
+
+enum class Type : uint8_t {
+   Int64, Float, Timestamp, String
+};
+
+// The strings of one column in a single buffer. set() appends the new value and leaves the old bytes behind, which
+// is fine for the few updates of the transactions.
+class StringColumn {
+   std::vector<char> chars;
+   std::vector<uint64_t> offsets;
+   std::vector<uint32_t> lengths;
+
+public:
+   size_t size() const { return offsets.size(); }
+   std::string_view operator[](size_t row) const { return {chars.data() + offsets[row], lengths[row]}; }
+
+   void push_back(std::string_view value);
+   void set(size_t row, std::string_view value);
+   void append(const StringColumn &other);
+};
+
+struct Column {
+   std::string name;
+   Type type;
+   std::vector<int64_t> ints;    // Int64, and Timestamp as milliseconds since 1970-01-01T00:00:00Z
+   std::vector<double> floats;
+   StringColumn strings;
+
+   size_t size() const;
+   // Appends other, a column of the same type.
+   void append(const Column &other);
+   // Appends 0, 0.0 or the empty string.
+   void pushDefault();
+};
+
+enum class Label : uint8_t {
+   Warehouse, District, Customer, Item, Stock, Order, OrderLine, Region, Nation, Supplier
+};
+const size_t kLabelCount = 10;
+
+// Column indexes of the node tables, in the order of the generated files.
+namespace col {
+enum Warehouse : uint32_t {
+   W_ID, W_NAME, W_STREET_1, W_STREET_2, W_CITY, W_STATE, W_ZIP, W_TAX, W_YTD
+};
+enum District : uint32_t {
+   D_ID, D_NAME, D_STREET_1, D_STREET_2, D_CITY, D_STATE, D_ZIP, D_TAX, D_YTD, D_NEXT_O_ID
+};
+enum Customer : uint32_t {
+   C_ID, C_FIRST, C_MIDDLE, C_LAST, C_STREET_1, C_STREET_2, C_CITY, C_STATE, C_ZIP, C_PHONE, C_SINCE, C_CREDIT,
+   C_CREDIT_LIM, C_DISCOUNT, C_BALANCE, C_YTD_PAYMENT, C_PAYMENT_CNT, C_DELIVERY_CNT, C_DATA, C_HISTORY_DATE,
+   C_HISTORY_AMOUNT, C_HISTORY_DATA
+};
+enum Item : uint32_t {
+   I_ID, I_IM_ID, I_NAME, I_PRICE, I_DATA
+};
+enum Stock : uint32_t {
+   S_ID, S_QUANTITY, S_DIST_01, S_DIST_02, S_DIST_03, S_DIST_04, S_DIST_05, S_DIST_06, S_DIST_07, S_DIST_08,
+   S_DIST_09, S_DIST_10, S_YTD, S_ORDER_CNT, S_REMOTE_CNT, S_DATA
+};
+enum Order : uint32_t {
+   O_ID, O_ENTRY_D, O_CARRIER_ID, O_OL_CNT, O_ALL_LOCAL, O_NEW_ORDER
+};
+enum OrderLine : uint32_t {
+   OL_ID, OL_NUMBER, OL_DELIVERY_D, OL_QUANTITY, OL_AMOUNT, OL_DIST_INFO
+};
+enum Region : uint32_t {
+   R_ID, R_NAME, R_COMMENT
+};
+enum Nation : uint32_t {
+   N_ID, N_NAME, N_COMMENT
+};
+enum Supplier : uint32_t {
+   SU_ID, SU_NAME, SU_ADDRESS, SU_PHONE, SU_ACCTBAL, SU_COMMENT
+};
+}
+
+class NodeTable {
+   // Ids of the generator are consecutive per label, then the row is id - first_id; otherwise rows has them all.
+   bool dense = true;
+   int64_t first_id = 1;
+   int64_t max_id = 0;
+   std::unordered_map<int64_t, uint32_t> rows;
+
+public:
+   Label label;
+   const char *file;  // prefix of the data files
+   std::vector<Column> columns;
+
+   size_t size() const { return columns[0].ints.size(); }
+   int64_t id(uint32_t row) const { return columns[0].ints[row]; }
+   // Row of the node with the given id, kNoRow if there is none.
+   uint32_t row(int64_t id) const;
+   // An id above all ids of the table.
+   int64_t nextId() const { return max_id + 1; }
+   // Builds the id to row mapping after loading.
+   void buildIndex();
+   // Adds a node with default properties and the given id, returns its row.
+   uint32_t appendRow(int64_t id);
+
+   const std::vector<int64_t> &ints(uint32_t column) const { return columns[column].ints; }
+   const std::vector<double> &floats(uint32_t column) const { return columns[column].floats; }
+   const StringColumn &strings(uint32_t column) const { return columns[column].strings; }
+   std::vector<int64_t> &ints(uint32_t column) { return columns[column].ints; }
+   std::vector<double> &floats(uint32_t column) { return columns[column].floats; }
+   StringColumn &strings(uint32_t column) { return columns[column].strings; }
+};
+
+// Neighbours of every source row: targets[offsets[row], offsets[row + 1]), plus the relationships created after
+// loading, which are kept aside until the next rebuild.
+class Adjacency {
+   std::vector<uint64_t> offsets;
+   std::vector<uint32_t> targets;
+   std::unordered_map<uint32_t, std::vector<uint32_t>> added;
+
+public:
+   // edges are (source row, target row) pairs; source rows are below source_count.
+   void build(size_t source_count, const std::vector<std::pair<uint32_t, uint32_t>> &edges, bool reverse);
+   void add(uint32_t source, uint32_t target) { added[source].push_back(target); }
+
+   template<typename F>
+   void forEach(uint32_t row, F &&f) const {
+      if (row + 1<offsets.size()) {
+         for (uint64_t i = offsets[row]; i<offsets[row + 1]; i++) {
+            f(targets[i]);
+         }
+      }
+      if (!added.empty()) {
+         auto it = added.find(row);
+         if (it != added.end()) {
+            for (uint32_t target : it->second) {
+               f(target);
+            }
+         }
+      }
+   }
+
+   // The first neighbour, kNoRow if there is none; for the relationships with one neighbour per node.
+   uint32_t first(uint32_t row) const;
+   bool empty(uint32_t row) const { return first(row) == kNoRow; }
+   size_t edgeCount() const { return targets.size(); }
+};
+
+enum class Relationship : uint8_t {
+   Covers, Serves, CustomerIsLocatedIn, WarehouseHasStock, ItemHasStock, HasSupplier, HasPlaced, OrderLineHasStock,
+   Contains, IsPartOf, SupplierIsLocatedIn
+};
+const size_t kRelationshipCount = 11;
+
+struct Edges {
+   Relationship type;
+   Label from;
+   Label to;
+   const char *file;
+   Adjacency out;  // by start row
+   Adjacency in;   // by end row
+};
+
+class Graph {
+   std::array<NodeTable, kLabelCount> nodes;
+   std::array<Edges, kRelationshipCount> edges;
+
+public:
+   // Empty tables with the schema of the generator.
+   Graph();
+
+   NodeTable &operator[](Label label) { return nodes[static_cast<size_t>(label)]; }
+   const NodeTable &operator[](Label label) const { return nodes[static_cast<size_t>(label)]; }
+   Edges &operator[](Relationship type) { return edges[static_cast<size_t>(type)]; }
+   const Edges &operator[](Relationship type) const { return edges[static_cast<size_t>(type)]; }
+
+   const Adjacency &out(Relationship type) const { return (*this)[type].out; }
+   const Adjacency &in(Relationship type) const { return (*this)[type].in; }
+   void addEdge(Relationship type, uint32_t from, uint32_t to);
+};
+
+}
+
+#endif
@@ -0,0 +1,310 @@
+/*
+ * The implementation of the GTPC graph data generator was built on
+ * Florian Wolf's implementation of the CH-benCHmark data generator
+ * (https://db.in.tum.de/research/projects/CHbenCHmark/) and
+ * Alexander van Renen's implementation of the TPC-C data generator
+ * (https://github.com/alexandervanrenen/tpcc-generator)
+ * See the README file.
+ */
+
+#include "loader.hpp"
+#include "result.hpp"
+#include "thread_pool.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <regex>
+#include <tuple>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace engine {
+
+namespace {
+
+const size_t kRangeSize = 16 << 20;
+
+[[noreturn]] void fail(const std::string &message) {
+   std::cout << "\n" << message << std::endl;
+   std::cout << "aborting..." << std::endl;
+   exit(-1);
+}
+
+class MappedFile {
+   const char *data = nullptr;
+   size_t length = 0;
+
+public:
+   explicit MappedFile(const std::string &path) {
+      int fd = open(path.c_str(), O_RDONLY);
+      struct stat info;
+      if (fd<0 || fstat(fd, &info) != 0) {
+         fail("Cannot open file: '" + path + "'.");
+      }
+      length = info.st_size;
+      if (length>0) {
+         void *address = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+         if (address == MAP_FAILED) {
+            fail("Cannot map file: '" + path + "'.");
+         }
+         data = static_cast<const char *>(address);
+         madvise(address, length, MADV_SEQUENTIAL);
+      }
+      close(fd);
+   }
+   ~MappedFile() {
+      if (data) {
+         munmap(const_cast<char *>(data), length);
+      }
+   }
+   MappedFile(const MappedFile &) = delete;
+   MappedFile &operator=(const MappedFile &) = delete;
+
+   const char *begin() const { return data; }
+   const char *end() const { return data + length; }
+};
+
+struct Range {
+   const std::string *path;
+   const char *begin;
+   const char *end;
+};
+
+// The data files of a table in the order the generator wrote them: the parts and chunks of the initial run, then
+// the deltas. Relationship files may be grouped (--group-edges), but not mixed with ungrouped ones of the same table,
+// whose edges they would repeat. Compressed files can't be loaded.
+std::vector<std::string> dataFiles(const std::string &directory, const std::string &table) {
+   std::regex pattern(table + "(_grouped)?_(delta)?([0-9]+)_([0-9]+)[.]csv(.*)");
+   std::vector<std::tuple<bool, uint64_t, uint64_t, std::string>> files;
+   size_t grouped = 0;
+   std::error_code error;
+   for (auto &entry : std::filesystem::directory_iterator(directory, error)) {
+      std::string name = entry.path().filename().string();
+      std::smatch match;
+      if (!std::regex_match(name, match, pattern)) {
+         continue;
+      }
+      if (match[5].length()>0) {
+         fail("Cannot load compressed file: '" + entry.path().string() + "', generate without --compress.");
+      }
+      grouped += match[1].matched;
+      files.emplace_back(match[2].matched, std::stoull(match[3]), std::stoull(match[4]), entry.path().string());
+   }
+   if (grouped>0 && grouped<files.size()) {
+      fail("Both grouped and ungrouped data files of table '" + table + "' in '" + directory + "'.");
+   }
+   if (files.empty()) {
+      fail("No data files of table '" + table + "' in '" + directory + "'.");
+   }
+   std::sort(files.begin(), files.end());
+   std::vector<std::string> paths;
+   for (auto &file : files) {
+      paths.push_back(std::get<3>(file));
+   }
+   return paths;
+}
+
+// Splits the file into ranges of whole lines, without the header line of the plain format.
+void split(const std::string &path, const MappedFile &file, std::vector<Range> &ranges) {
+   const char *pos = file.begin();
+   const char *end = file.end();
+   if (pos<end && !(*pos>='0' && *pos<='9') && *pos != '-') {
+      pos = static_cast<const char *>(memchr(pos, '\n', end - pos));
+      pos = pos ? pos + 1 : end;
+   }
+   while (pos<end) {
+      const char *next = pos + std::min<size_t>(kRangeSize, end - pos);
+      if (next<end) {
+         const char *newline = static_cast<const char *>(memchr(next, '\n', end - next));
+         next = newline ? newline + 1 : end;
+      }
+      ranges.push_back(Range{&path, pos, next});
+      pos = next;
+   }
+}
+
+// Fields of one line, separated by |; the line ends at \n.
+class FieldReader {
+   const char *pos;
+   const char *end;
+
+public:
+   FieldReader(const char *pos, const char *end) : pos(pos), end(end) {}
+
+   bool atLineEnd() const { return pos>=end || *pos == '\n'; }
+
+   std::string_view next() {
+      const char *begin = pos;
+      while (pos<end && *pos != '|' && *pos != '\n' && *pos != '\r') {
+         pos++;
+      }
+      std::string_view field(begin, pos - begin);
+      if (pos<end && *pos == '|') {
+         pos++;
+      }
+      return field;
+   }
+
+   // Skips the rest of the line, e.g. the :LABEL column of the neo4j-admin format.
+   const char *skipLine() {
+      const char *newline = static_cast<const char *>(memchr(pos, '\n', end - pos));
+      return newline ? newline + 1 : end;
+   }
+};
+
+[[noreturn]] void failField(const Range &range, std::string_view field) {
+   fail("Cannot parse field '" + std::string(field) + "' of file: '" + *range.path + "'.");
+}
+
+int64_t parseInt(const Range &range, std::string_view field) {
+   int64_t value = 0;
+   auto [end, error] = std::from_chars(field.data(), field.data() + field.size(), value);
+   if (error != std::errc() || end != field.data() + field.size()) {
+      failField(range, field);
+   }
+   return value;
+}
+
+double parseFloat(const Range &range, std::string_view field) {
+   double value = 0;
+   auto [end, error] = std::from_chars(field.data(), field.data() + field.size(), value);
+   if (error != std::errc() || end != field.data() + field.size()) {
+      failField(range, field);
+   }
+   return value;
+}
+
+void parseNodes(const Range &range, std::vector<Column> &columns) {
+   const char *pos = range.begin;
+   while (pos<range.end) {
+      FieldReader reader(pos, range.end);
+      if (reader.atLineEnd()) {
+         pos = reader.skipLine();
+         continue;
+      }
+      for (Column &column : columns) {
+         std::string_view field = reader.next();
+         switch (column.type) {
+            case Type::Int64:
+               column.ints.push_back(parseInt(range, field));
+               break;
+            case Type::Float:
+               column.floats.push_back(parseFloat(range, field));
+               break;
+            case Type::Timestamp: {
+               int64_t millis;
+               if (!parseTimestamp(field, millis)) {
+                  failField(range, field);
+               }
+               column.ints.push_back(millis);
+               break;
+            }
+            case Type::String:
+               column.strings.push_back(field);
+               break;
+         }
+      }
+      pos = reader.skipLine();
+   }
+}
+
+struct EdgeChunk {
+   std::vector<std::pair<uint32_t, uint32_t>> edges;
+   uint64_t skipped = 0;
+};
+
+// Relationships to a missing node are skipped like neo4j-admin --skip-bad-relationships does: the generator writes
+// some, e.g. stocks of supplier 0 from the modulo of CH-benCHmark's su_suppkey. A row of a grouped file lists all end
+// ids of its start id, separated by ';'.
+void parseEdges(const Range &range, const NodeTable &from, const NodeTable &to, EdgeChunk &chunk) {
+   const char *pos = range.begin;
+   while (pos<range.end) {
+      FieldReader reader(pos, range.end);
+      if (reader.atLineEnd()) {
+         pos = reader.skipLine();
+         continue;
+      }
+      std::string_view start = reader.next();
+      std::string_view ends = reader.next();
+      uint32_t from_row = from.row(parseInt(range, start));
+      for (size_t begin = 0; begin<=ends.size();) {
+         size_t separator = std::min(ends.find(';', begin), ends.size());
+         uint32_t to_row = to.row(parseInt(range, ends.substr(begin, separator - begin)));
+         if (from_row == kNoRow || to_row == kNoRow) {
+            chunk.skipped++;
+         } else {
+            chunk.edges.emplace_back(from_row, to_row);
+         }
+         begin = separator + 1;
+      }
+      pos = reader.skipLine();
+   }
+}
+
+// Runs parse(range, chunk) for all ranges of the files of a table on the pool and returns the chunks in file order.
+template<typename Chunk, typename Parse>
+std::vector<Chunk> parseTable(const std::string &directory, const std::string &table, ThreadPool &pool,
+                              const Parse &parse) {
+   std::vector<std::string> paths = dataFiles(directory, table);
+   std::vector<std::unique_ptr<MappedFile>> files;
+   std::vector<Range> ranges;
+   for (const std::string &path : paths) {
+      files.push_back(std::make_unique<MappedFile>(path));
+      split(path, *files.back(), ranges);
+   }
+   std::vector<Chunk> chunks(ranges.size());
+   for (size_t i = 0; i<ranges.size(); i++) {
+      pool.submit([&, i] { parse(ranges[i], chunks[i]); });
+   }
+   pool.wait();
+   return chunks;
+}
+
+}
+
+void load(Graph &graph, const std::string &directory, ThreadPool &pool) {
+   for (size_t l = 0; l<kLabelCount; l++) {
+      NodeTable &table = graph[static_cast<Label>(l)];
+      std::vector<Column> empty = table.columns;
+      auto chunks = parseTable<std::vector<Column>>(directory, table.file, pool,
+                                                    [&](const Range &range, std::vector<Column> &chunk) {
+                                                       chunk = empty;
+                                                       parseNodes(range, chunk);
+                                                    });
+      for (auto &chunk : chunks) {
+         for (size_t c = 0; c<table.columns.size(); c++) {
+            table.columns[c].append(chunk[c]);
+         }
+      }
+      table.buildIndex();
+   }
+
+   for (size_t r = 0; r<kRelationshipCount; r++) {
+      Edges &edges = graph[static_cast<Relationship>(r)];
+      const NodeTable &from = graph[edges.from];
+      const NodeTable &to = graph[edges.to];
+      auto chunks = parseTable<EdgeChunk>(directory, edges.file, pool, [&](const Range &range, EdgeChunk &chunk) {
+         parseEdges(range, from, to, chunk);
+      });
+      std::vector<std::pair<uint32_t, uint32_t>> all;
+      uint64_t skipped = 0;
+      for (auto &chunk : chunks) {
+         all.insert(all.end(), chunk.edges.begin(), chunk.edges.end());
+         skipped += chunk.skipped;
+      }
+      if (skipped>0) {
+         std::cout << "Skipped " << skipped << " '" << edges.file << "' relationships to missing nodes" << std::endl;
+      }
+      edges.out.build(from.size(), all, false);
+      edges.in.build(to.size(), all, true);
+   }
+}
+
+}
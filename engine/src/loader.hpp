@@ -0,0 +1,28 @@
+/*
+ * The implementation of the GTPC graph data generator was built on
+ * Florian Wolf's implementation of the CH-benCHmark data generator
+ * (https://db.in.tum.de/research/projects/CHbenCHmark/) and
+ * Alexander van Renen's implementation of the TPC-C data generator
+ * (https://github.com/alexandervanrenen/tpcc-generator)
+ * See the README file.
+ */
+
+#ifndef loader_hpp_
+#define loader_hpp_
+
+#include <string>
+
+#include "graph.hpp"
+
+class ThreadPool;
+
+namespace engine {
+
+// Loads the uncompressed CSV files of the generator (--format csv or neo4j-admin, all parts, chunks and deltas) from
+// directory into graph. Every file is split at line boundaries and parsed on the pool. Aborts if a table is missing
+// or a line can't be parsed; relationships to missing nodes are skipped.
+void load(Graph &graph, const std::string &directory, ThreadPool &pool);
+
+}
+
+#endif
@@ -0,0 +1,1078 @@
+/*
+ * The implementation of the GTPC graph data generator was built on
+ * Florian Wolf's implementation of the CH-benCHmark data generator
+ * (https://db.in.tum.de/research/projects/CHbenCHmark/) and
+ * Alexander van Renen's implementation of the TPC-C data generator
+ * (https://github.com/alexandervanrenen/tpcc-generator)
+ * See the README file.
+ */
+
+#include "olap.hpp"
+#include "parallel.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <map>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
+
+// The 22 queries of queries/olap_templates.cypher. Every query is a parallel scan over the label the pattern starts
+// with, following the relationships of the pattern by row, and an aggregation into per-morsel state that is merged
+// at the end. The patterns are matched like Cypher does, path by path: a node reached over several paths counts
+// several times, and a query the text gets subtly wrong (e.g. #15, #17, #18, #19) returns what the text says.
+namespace engine {
+
+namespace {
+
+const int64_t kMillisPerHour = 3600000;
+
+bool startsWith(std::string_view text, std::string_view prefix) {
+   return text.substr(0, prefix.size()) == prefix;
+}
+
+bool endsWith(std::string_view text, std::string_view suffix) {
+   return text.size()>=suffix.size() && text.substr(text.size() - suffix.size()) == suffix;
+}
+
+// The nodes and relationships of the schema, by the names the queries use.
+struct Context {
+   const Graph &graph;
+   ThreadPool &pool;
+   const qgen::Query &query;
+
+   const NodeTable &warehouses = graph[Label::Warehouse];
+   const NodeTable &customers = graph[Label::Customer];
+   const NodeTable &items = graph[Label::Item];
+   const NodeTable &stocks = graph[Label::Stock];
+   const NodeTable &orders = graph[Label::Order];
+   const NodeTable &lines = graph[Label::OrderLine];
+   const NodeTable &regions = graph[Label::Region];
+   const NodeTable &nations = graph[Label::Nation];
+   const NodeTable &suppliers = graph[Label::Supplier];
+
+   const Adjacency &customer_nation = graph.out(Relationship::CustomerIsLocatedIn);
+   const Adjacency &placed = graph.out(Relationship::HasPlaced);
+   const Adjacency &contains = graph.out(Relationship::Contains);
+   const Adjacency &line_order = graph.in(Relationship::Contains);
+   const Adjacency &line_stock = graph.out(Relationship::OrderLineHasStock);
+   const Adjacency &stock_lines = graph.in(Relationship::OrderLineHasStock);
+   const Adjacency &item_stocks = graph.out(Relationship::ItemHasStock);
+   const Adjacency &stock_item = graph.in(Relationship::ItemHasStock);
+   const Adjacency &stock_warehouse = graph.in(Relationship::WarehouseHasStock);
+   const Adjacency &stock_supplier = graph.out(Relationship::HasSupplier);
+   const Adjacency &supplier_nation = graph.out(Relationship::SupplierIsLocatedIn);
+   const Adjacency &nation_region = graph.out(Relationship::IsPartOf);
+
+   const qgen::Parameter &parameter(const std::string &name) const {
+      const qgen::Parameter *parameter = query.find(name);
+      if (!parameter || parameter->values.empty()) {
+         std::cout << "\nQuery #" << query.number << " has no parameter '" << name << "'." << std::endl;
+         std::cout << "aborting..." << std::endl;
+         exit(-1);
+      }
+      return *parameter;
+   }
+   const std::string &text(const std::string &name) const { return parameter(name).values[0]; }
+   int64_t integer(const std::string &name) const { return std::stoll(text(name)); }
+   int64_t date(const std::string &name) const { return parseDate(text(name)); }
+
+   std::string_view nationName(uint32_t nation) const { return nations.strings(col::N_NAME)[nation]; }
+};
+
+int compare(const Value &a, const Value &b) {
+   if (a.kind != b.kind) {
+      return a.kind<b.kind ? -1 : 1;
+   }
+   switch (a.kind) {
+      case Value::Kind::Float:
+         return a.f<b.f ? -1 : a.f>b.f;
+      case Value::Kind::String:
+         return a.s.compare(b.s);
+      case Value::Kind::Null:
+         return 0;
+      default:
+         return a.i<b.i ? -1 : a.i>b.i;
+   }
+}
+
+// Sorts by the (column, descending) keys of the ORDER BY, then by all columns ascending.
+void sortRows(Result &result, std::vector<std::pair<size_t, bool>> keys) {
+   std::stable_sort(result.rows.begin(), result.rows.end(), [&](const auto &a, const auto &b) {
+      for (auto [column, descending] : keys) {
+         int order = compare(a[column], b[column]);
+         if (order != 0) {
+            return descending ? order>0 : order<0;
+         }
+      }
+      for (size_t column = 0; column<a.size(); column++) {
+         int order = compare(a[column], b[column]);
+         if (order != 0) {
+            return order<0;
+         }
+      }
+      return false;
+   });
+}
+
+template<typename Map>
+void mergeSums(Map &result, Map &state) {
+   for (auto &[key, value] : state) {
+      result[key] += value;
+   }
+}
+
+struct Rows {
+   std::vector<std::vector<Value>> rows;
+};
+
+void mergeRows(Rows &result, Rows &state) {
+   std::move(state.rows.begin(), state.rows.end(), std::back_inserter(result.rows));
+}
+
+Result q1(const Context &c) {
+   struct Group {
+      int64_t quantity = 0;
+      int64_t count = 0;
+      double amount = 0;
+   };
+   using State = std::map<int64_t, Group>;
+   int64_t date = c.date("date");
+   const auto &delivery_d = c.lines.ints(col::OL_DELIVERY_D);
+   State groups = parallelReduce<State>(c.pool, c.lines.size(), [&](uint64_t begin, uint64_t end, State &state) {
+      for (uint64_t line = begin; line<end; line++) {
+         if (delivery_d[line]>date) {
+            Group &group = state[c.lines.ints(col::OL_NUMBER)[line]];
+            group.quantity += c.lines.ints(col::OL_QUANTITY)[line];
+            group.count++;
+            group.amount += c.lines.floats(col::OL_AMOUNT)[line];
+         }
+      }
+   }, [](State &result, State &state) {
+      for (auto &[number, group] : state) {
+         Group &sum = result[number];
+         sum.quantity += group.quantity;
+         sum.count += group.count;
+         sum.amount += group.amount;
+      }
+   });
+
+   Result result;
+   result.columns = {"sum_qty", "count_order", "sum_amount", "avg_qty", "avg_amount", "ol.number"};
+   for (auto &[number, group] : groups) {
+      result.rows.push_back({Value::integer(group.quantity), Value::integer(group.count), Value::real(group.amount),
+                             Value::real(group.quantity / double(group.count)),
+                             Value::real(group.amount / group.count), Value::integer(number)});
+   }
+   return result;
+}
+
+Result q2(const Context &c) {
+   const std::string &region = c.text("region");
+   const std::string &suffix = c.text("suffix");
+   Rows rows = parallelReduce<Rows>(c.pool, c.items.size(), [&](uint64_t begin, uint64_t end, Rows &state) {
+      std::vector<std::tuple<uint32_t, uint32_t, uint32_t>> paths;  // stock, supplier, nation
+      for (uint32_t item = begin; item<end; item++) {
+         if (!endsWith(c.items.strings(col::I_DATA)[item], suffix)) {
+            continue;
+         }
+         paths.clear();
+         int64_t min_quantity = INT64_MAX;
+         c.item_stocks.forEach(item, [&](uint32_t stock) {
+            c.stock_supplier.forEach(stock, [&](uint32_t supplier) {
+               c.supplier_nation.forEach(supplier, [&](uint32_t nation) {
+                  c.nation_region.forEach(nation, [&](uint32_t r) {
+                     if (startsWith(c.regions.strings(col::R_NAME)[r], region)) {
+                        paths.emplace_back(stock, supplier, nation);
+                        min_quantity = std::min(min_quantity, c.stocks.ints(col::S_QUANTITY)[stock]);
+                     }
+                  });
+               });
+            });
+         });
+         for (auto [stock, supplier, nation] : paths) {
+            if (c.stocks.ints(col::S_QUANTITY)[stock] == min_quantity) {
+               state.rows.push_back({Value::integer(c.items.id(item)),
+                                     Value::string(c.suppliers.strings(col::SU_NAME)[supplier]),
+                                     Value::string(c.nationName(nation)),
+                                     Value::string(c.items.strings(col::I_NAME)[item]),
+                                     Value::string(c.suppliers.strings(col::SU_ADDRESS)[supplier]),
+                                     Value::string(c.suppliers.strings(col::SU_PHONE)[supplier]),
+                                     Value::string(c.suppliers.strings(col::SU_COMMENT)[supplier])});
+            }
+         }
+      }
+   }, mergeRows);
+
+   Result result;
+   result.columns = {"i.id", "sup.name", "n.name", "i.name", "sup.address", "sup.phone", "sup.comment"};
+   result.rows = std::move(rows.rows);
+   sortRows(result, {{2, false}, {1, false}, {0, false}});
+   return result;
+}
+
+Result q3(const Context &c) {
+   const std::string &state_prefix = c.text("state");
+   int64_t date = c.date("date");
+   Rows rows = parallelReduce<Rows>(c.pool, c.customers.size(), [&](uint64_t begin, uint64_t end, Rows &state) {
+      for (uint32_t customer = begin; customer<end; customer++) {
+         if (!startsWith(c.customers.strings(col::C_STATE)[customer], state_prefix)) {
+            continue;
+         }
+         c.placed.forEach(customer, [&](uint32_t order) {
+            int64_t entry_d = c.orders.ints(col::O_ENTRY_D)[order];
+            if (entry_d<=date) {
+               return;
+            }
+            double revenue = 0;
+            bool any = false;
+            c.contains.forEach(order, [&](uint32_t line) {
+               revenue += c.lines.floats(col::OL_AMOUNT)[line];
+               any = true;
+            });
+            if (any) {
+               state.rows.push_back({Value::real(revenue), Value::dateTime(entry_d),
+                                     Value::integer(c.orders.id(order))});
+            }
+         });
+      }
+   }, mergeRows);
+
+   Result result;
+   result.columns = {"revenue", "o_entry_d", "o_id"};
+   result.rows = std::move(rows.rows);
+   sortRows(result, {{0, true}});
+   return result;
+}
+
+Result q4(const Context &c) {
+   using State = std::map<int64_t, int64_t>;
+   int64_t date = c.date("date");
+   int64_t end_date = c.date("end_date");
+   State counts = parallelReduce<State>(c.pool, c.orders.size(), [&](uint64_t begin, uint64_t end, State &state) {
+      for (uint32_t order = begin; order<end; order++) {
+         int64_t entry_d = c.orders.ints(col::O_ENTRY_D)[order];
+         if (entry_d<date || entry_d>=end_date) {
+            continue;
+         }
+         c.contains.forEach(order, [&](uint32_t line) {
+            if (c.lines.ints(col::OL_DELIVERY_D)[line]>=entry_d) {
+               state[c.orders.ints(col::O_OL_CNT)[order]]++;
+            }
+         });
+      }
+   }, mergeSums<State>);
+
+   Result result;
+   result.columns = {"o_ol_cnt", "order_count"};
+   for (auto &[ol_cnt, count] : counts) {
+      result.rows.push_back({Value::integer(ol_cnt), Value::integer(count)});
+   }
+   return result;
+}
+
+Result q5(const Context &c) {
+   using State = std::map<std::string, double>;
+   const std::string &region = c.text("region");
+   int64_t date = c.date("date");
+   State revenues = parallelReduce<State>(c.pool, c.customers.size(), [&](uint64_t begin, uint64_t end, State &state) {
+      for (uint32_t customer = begin; customer<end; customer++) {
+         c.customer_nation.forEach(customer, [&](uint32_t nation) {
+            c.nation_region.forEach(nation, [&](uint32_t r) {
+               if (c.regions.strings(col::R_NAME)[r] != region) {
+                  return;
+               }
+               c.placed.forEach(customer, [&](uint32_t order) {
+                  if (c.orders.ints(col::O_ENTRY_D)[order]<date) {
+                     return;
+                  }
+                  c.contains.forEach(order, [&](uint32_t line) {
+                     state[std::string(c.nationName(nation))] += c.lines.floats(col::OL_AMOUNT)[line];
+                  });
+               });
+            });
+         });
+      }
+   }, mergeSums<State>);
+
+   Result result;
+   result.columns = {"n_name", "revenue"};
+   for (auto &[nation, revenue] : revenues) {
+      result.rows.push_back({Value::string(nation), Value::real(revenue)});
+   }
+   return result;
+}
+
+Result q6(const Context &c) {
+   struct State {
+      double revenue = 0;
+   };
+   int64_t date = c.date("date");
+   int64_t end_date = c.date("end_date");
+   State sum = parallelReduce<State>(c.pool, c.lines.size(), [&](uint64_t begin, uint64_t end, State &state) {
+      for (uint64_t line = begin; line<end; line++) {
+         int64_t delivery_d = c.lines.ints(col::OL_DELIVERY_D)[line];
+         int64_t quantity = c.lines.ints(col::OL_QUANTITY)[line];
+         if (delivery_d>=date && delivery_d<end_date && quantity>=1 && quantity<=100000) {
+            state.revenue += c.lines.floats(col::OL_AMOUNT)[line];
+         }
+      }
+   }, [](State &result, State &state) { result.revenue += state.revenue; });
+
+   Result result;
+   result.columns = {"revenue"};
+   result.rows.push_back({Value::real(sum.revenue)});
+   return result;
+}
+
+Result q7(const Context &c) {
+   // (cust_state, cust_nation, sup_nation, l_year)
+   using State = std::map<std::tuple<std::string, std::string, std::string, int64_t>, double>;
+   int64_t date = c.date("date");
+   int64_t end_date = c.date("end_date");
+   const std::string &nation1 = c.text("nation1");
+   const std::string &nation2 = c.text("nation2");
+   State revenues = parallelReduce<State>(c.pool, c.customers.size(), [&](uint64_t begin, uint64_t end, State &state) {
+      for (uint32_t customer = begin; customer<end; customer++) {
+         c.customer_nation.forEach(customer, [&](uint32_t n1) {
+            std::string_view cust_nation = c.nationName(n1);
+            if (cust_nation != nation1 && cust_nation != nation2) {
+               return;
+            }
+            std::string_view sup_wanted = cust_nation == nation1 ? nation2 : nation1;
+            c.placed.forEach(customer, [&](uint32_t order) {
+               int64_t year = yearOf(c.orders.ints(col::O_ENTRY_D)[order]);
+               c.contains.forEach(order, [&](uint32_t line) {
+                  int64_t delivery_d = c.lines.ints(col::OL_DELIVERY_D)[line];
+                  if (delivery_d<date || delivery_d>=end_date) {
+                     return;
+                  }
+                  c.line_stock.forEach(line, [&](uint32_t stock) {
+                     c.stock_supplier.forEach(stock, [&](uint32_t supplier) {
+                        c.supplier_nation.forEach(supplier, [&](uint32_t n2) {
+                           if (c.nationName(n2) == sup_wanted) {
+                              auto key = std::make_tuple(
+                                 std::string(c.customers.strings(col::C_STATE)[customer].substr(0, 1)),
+                                 std::string(cust_nation), std::string(sup_wanted), year);
+                              state[key] += c.lines.floats(col::OL_AMOUNT)[line];
+                           }
+                        });
+                     });
+                  });
+               });
+            });
+         });
+      }
+   }, mergeSums<State>);
+
+   // cust_nation is only needed for the ORDER BY and dropped afterwards.
+   Result result;
+   result.columns = {"cust_state", "sup_nation", "l_year", "revenue"};
+   for (auto &[key, revenue] : revenues) {
+      auto &[cust_state, cust_nation, sup_nation, year] = key;
+      result.rows.push_back({Value::string(cust_state), Value::string(sup_nation), Value::integer(year),
+                             Value::real(revenue), Value::string(cust_nation)});
+   }
+   sortRows(result, {{1, false}, {4, false}, {2, false}});
+   for (auto &row : result.rows) {
+      row.pop_back();
+   }
+   return result;
+}
+
+Result q8(const Context &c) {
+   using State = std::map<int64_t, double>;
+   const std::string &suffix = c.text("suffix");
+   const std::string &region = c.text("region");
+   const std::string &nation = c.text("nation");
+   int64_t date = c.date("date");
+   int64_t end_date = c.date("end_date");
+   State shares = parallelReduce<State>(c.pool, c.customers.size(), [&](uint64_t begin, uint64_t end, State &state) {
+      for (uint32_t customer = begin; customer<end; customer++) {
+         // (c)-[:isLocatedIn]->(n)-[:isPartOf]->(r) only multiplies the rows by the number of such paths.
+         uint64_t region_paths = 0;
+         c.customer_nation.forEach(customer, [&](uint32_t n) {
+            c.nation_region.forEach(n, [&](uint32_t r) {
+               region_paths += c.regions.strings(col::R_NAME)[r] == region;
+            });
+         });
+         if (region_paths == 0) {
+            continue;
+         }
+         c.placed.forEach(customer, [&](uint32_t order) {
+            int64_t entry_d = c.orders.ints(col::O_ENTRY_D)[order];
+            if (entry_d<date || entry_d>=end_date) {
+               return;
+            }
+            int64_t year = yearOf(entry_d);
+            c.contains.forEach(order, [&](uint32_t line) {
+               c.line_stock.forEach(line, [&](uint32_t stock) {
+                  c.stock_item.forEach(stock, [&](uint32_t item) {
+                     if (c.items.id(item)>=1000 || !endsWith(c.items.strings(col::I_DATA)[item], suffix)) {
+                        return;
+                     }
+                     c.stock_supplier.forEach(stock, [&](uint32_t supplier) {
+                        c.supplier_nation.forEach(supplier, [&](uint32_t n2) {
+                           // Every matching row creates the group, the CASE only decides what it adds.
+                           double &share = state[year];
+                           if (c.nationName(n2) == nation) {
+                              share += region_paths * c.lines.floats(col::OL_AMOUNT)[line];
+                           }
+                        });
+                     });
+                  });
+               });
+            });
+         });
+      }
+   }, mergeSums<State>);
+
+   Result result;
+   result.columns = {"l_year", "mkt_share"};
+   for (auto &[year, share] : shares) {
+      result.rows.push_back({Value::integer(year), Value::real(share)});
+   }
+   return result;
+}
+
+
+Result q9(const Context &c) {
+   using State = std::map<std::pair<std::string, int64_t>, double>;
+   const std::string &suffix = c.text("suffix");
+   State profits = parallelReduce<State>(c.pool, c.lines.size(), [&](uint64_t begin, uint64_t end, State &state) {
+      for (uint32_t line = begin; line<end; line++) {
+         c.line_stock.forEach(line, [&](uint32_t stock) {
+            c.stock_item.forEach(stock, [&](uint32_t item) {
+               if (!endsWith(c.items.strings(col::I_DATA)[item], suffix)) {
+                  return;
+               }
+               c.line_order.forEach(line, [&](uint32_t order) {
+                  int64_t year = yearOf(c.orders.ints(col::O_ENTRY_D)[order]);
+                  c.stock_supplier.forEach(stock, [&](uint32_t supplier) {
+                     c.supplier_nation.forEach(supplier, [&](uint32_t nation) {
+                        state[{std::string(c.nationName(nation)), year}] += c.lines.floats(col::OL_AMOUNT)[line];
+                     });
+                  });
+               });
+            });
+         });
+      }
+   }, mergeSums<State>);
+
+   Result result;
+   result.columns = {"n_name", "entry_d_year", "sum_profit"};
+   for (auto &[key, profit] : profits) {
+      result.rows.push_back({Value::string(key.first), Value::integer(key.second), Value::real(profit)});
+   }
+   sortRows(result, {{0, false}, {1, true}});
+   return result;
+}
+
+Result q10(const Context &c) {
+   int64_t date = c.date("date");
+   Rows rows = parallelReduce<Rows>(c.pool, c.customers.size(), [&](uint64_t begin, uint64_t end, Rows &state) {
+      for (uint32_t customer = begin; customer<end; customer++) {
+         double revenue = 0;
+         uint64_t count = 0;
+         c.placed.forEach(customer, [&](uint32_t order) {
+            int64_t entry_d = c.orders.ints(col::O_ENTRY_D)[order];
+            if (entry_d<date) {
+               return;
+            }
+            c.contains.forEach(order, [&](uint32_t line) {
+               if (entry_d<=c.lines.ints(col::OL_DELIVERY_D)[line]) {
+                  revenue += c.lines.floats(col::OL_AMOUNT)[line];
+                  count++;
+               }
+            });
+         });
+         if (count == 0) {
+            continue;
+         }
+         c.customer_nation.forEach(customer, [&](uint32_t nation) {
+            state.rows.push_back({Value::integer(c.customers.id(customer)),
+                                  Value::string(c.customers.strings(col::C_LAST)[customer]),
+                                  Value::string(c.customers.strings(col::C_CITY)[customer]),
+                                  Value::string(c.customers.strings(col::C_PHONE)[customer]),
+                                  Value::string(c.nationName(nation)), Value::real(revenue)});
+         });
+      }
+   }, mergeRows);
+
+   Result result;
+   result.columns = {"c_id", "c_last", "c_city", "c_phone", "n_name", "revenue"};
+   result.rows = std::move(rows.rows);
+   sortRows(result, {{5, true}});
+   return result;
+}
+
+Result q11(const Context &c) {
+   struct Sum {
+      int64_t order_cnt = 0;
+   };
+   const std::string &nation = c.text("nation");
+   auto inNation = [&](uint32_t stock, auto &&f) {
+      c.stock_supplier.forEach(stock, [&](uint32_t supplier) {
+         c.supplier_nation.forEach(supplier, [&](uint32_t n) {
+            if (c.nationName(n) == nation) {
+               f();
+            }
+         });
+      });
+   };
+   Sum total = parallelReduce<Sum>(c.pool, c.stocks.size(), [&](uint64_t begin, uint64_t end, Sum &state) {
+      for (uint32_t stock = begin; stock<end; stock++) {
+         inNation(stock, [&] { state.order_cnt += c.stocks.ints(col::S_ORDER_CNT)[stock]; });
+      }
+   }, [](Sum &result, Sum &state) { result.order_cnt += state.order_cnt; });
+   double order_count = total.order_cnt * 0.005;
+
+   Rows rows = parallelReduce<Rows>(c.pool, c.items.size(), [&](uint64_t begin, uint64_t end, Rows &state) {
+      for (uint32_t item = begin; item<end; item++) {
+         int64_t order_cnt = 0;
+         bool any = false;
+         c.item_stocks.forEach(item, [&](uint32_t stock) {
+            inNation(stock, [&] {
+               order_cnt += c.stocks.ints(col::S_ORDER_CNT)[stock];
+               any = true;
+            });
+         });
+         if (any && order_cnt>order_count) {
+            state.rows.push_back({Value::integer(c.items.id(item)), Value::integer(order_cnt)});
+         }
+      }
+   }, mergeRows);
+
+   Result result;
+   result.columns = {"i_id", "s_order_cnt"};
+   result.rows = std::move(rows.rows);
+   sortRows(result, {{1, false}});
+   return result;
+}
+
+Result q12(const Context &c) {
+   using State = std::map<int64_t, std::pair<int64_t, int64_t>>;
+   int64_t date = c.date("date");
+   int64_t carrier1 = c.integer("carrier1");
+   int64_t carrier2 = c.integer("carrier2");
+   State counts = parallelReduce<State>(c.pool, c.orders.size(), [&](uint64_t begin, uint64_t end, State &state) {
+      for (uint32_t order = begin; order<end; order++) {
+         int64_t entry_d = c.orders.ints(col::O_ENTRY_D)[order];
+         int64_t carrier = c.orders.ints(col::O_CARRIER_ID)[order];
+         bool high = carrier == carrier1 || carrier == carrier2;
+         c.contains.forEach(order, [&](uint32_t line) {
+            int64_t delivery_d = c.lines.ints(col::OL_DELIVERY_D)[line];
+            if (entry_d<=delivery_d && delivery_d<date) {
+               auto &count = state[c.orders.ints(col::O_OL_CNT)[order]];
+               count.first += high;
+               count.second += !high;
+            }
+         });
+      }
+   }, [](State &result, State &state) {
+      for (auto &[ol_cnt, count] : state) {
+         result[ol_cnt].first += count.first;
+         result[ol_cnt].second += count.second;
+      }
+   });
+
+   Result result;
+   result.columns = {"o_ol_cnt", "high_line_count", "low_line_count"};
+   for (auto &[ol_cnt, count] : counts) {
+      result.rows.push_back({Value::integer(ol_cnt), Value::integer(count.first), Value::integer(count.second)});
+   }
+   return result;
+}
+
+Result q13(const Context &c) {
+   using State = std::map<int64_t, int64_t>;
+   int64_t carrier = c.integer("carrier");
+   State distribution = parallelReduce<State>(c.pool, c.customers.size(),
+                                              [&](uint64_t begin, uint64_t end, State &state) {
+      for (uint32_t customer = begin; customer<end; customer++) {
+         int64_t count = 0;
+         c.placed.forEach(customer, [&](uint32_t order) {
+            count += c.orders.ints(col::O_CARRIER_ID)[order]>carrier;
+         });
+         if (count>0) {
+            state[count]++;
+         }
+      }
+   }, mergeSums<State>);
+
+   Result result;
+   result.columns = {"c_count", "cust_dist"};
+   for (auto &[count, customers] : distribution) {
+      result.rows.push_back({Value::integer(count), Value::integer(customers)});
+   }
+   sortRows(result, {{1, true}, {0, true}});
+   return result;
+}
+
+Result q14(const Context &c) {
+   struct Sums {
+      double promo = 0;
+      double total = 0;
+   };
+   const std::string &prefix = c.text("prefix");
+   Sums sums = parallelReduce<Sums>(c.pool, c.lines.size(), [&](uint64_t begin, uint64_t end, Sums &state) {
+      for (uint32_t line = begin; line<end; line++) {
+         double amount = c.lines.floats(col::OL_AMOUNT)[line];
+         c.line_stock.forEach(line, [&](uint32_t stock) {
+            c.stock_item.forEach(stock, [&](uint32_t item) {
+               if (startsWith(c.items.strings(col::I_DATA)[item], prefix)) {
+                  state.promo += amount;
+               }
+               state.total += amount;
+            });
+         });
+      }
+   }, [](Sums &result, Sums &state) {
+      result.promo += state.promo;
+      result.total += state.total;
+   });
+
+   Result result;
+   result.columns = {"amount1/amount2"};
+   result.rows.push_back({Value::real(100.0 * sums.promo / (1 + sums.total))});
+   return result;
+}
+
+Result q15(const Context &c) {
+   // The WITH groups by total_revenue and supplier_no, so MAX(total_revenue) is the revenue of the supplier itself
+   // and every supplier with revenue is returned.
+   using State = std::unordered_map<uint32_t, double>;
+   int64_t date = c.date("date");
+   State revenues = parallelReduce<State>(c.pool, c.lines.size(), [&](uint64_t begin, uint64_t end, State &state) {
+      for (uint32_t line = begin; line<end; line++) {
+         if (c.lines.ints(col::OL_DELIVERY_D)[line]<date) {
+            continue;
+         }
+         c.line_stock.forEach(line, [&](uint32_t stock) {
+            c.stock_supplier.forEach(stock, [&](uint32_t supplier) {
+               state[supplier] += c.lines.floats(col::OL_AMOUNT)[line];
+            });
+         });
+      }
+   }, mergeSums<State>);
+
+   Result result;
+   result.columns = {"supp2.id", "supp2.name", "supp2.address", "supp2.phone", "supp_revenue"};
+   for (auto &[supplier, revenue] : revenues) {
+      result.rows.push_back({Value::integer(c.suppliers.id(supplier)),
+                             Value::string(c.suppliers.strings(col::SU_NAME)[supplier]),
+                             Value::string(c.suppliers.strings(col::SU_ADDRESS)[supplier]),
+                             Value::string(c.suppliers.strings(col::SU_PHONE)[supplier]), Value::real(revenue)});
+   }
+   sortRows(result, {});
+   return result;
+}
+
+Result q16(const Context &c) {
+   // (i.name, i.price, brand) -> supplier ids, made distinct after the merge
+   using State = std::map<std::tuple<std::string, double, std::string>, std::vector<int64_t>>;
+   const std::string &prefix = c.text("prefix");
+   std::vector<bool> bad(c.suppliers.size());
+   for (uint32_t supplier = 0; supplier<c.suppliers.size(); supplier++) {
+      bad[supplier] = c.suppliers.strings(col::SU_COMMENT)[supplier].find("bad") != std::string_view::npos;
+   }
+   State groups = parallelReduce<State>(c.pool, c.items.size(), [&](uint64_t begin, uint64_t end, State &state) {
+      for (uint32_t item = begin; item<end; item++) {
+         std::string_view data = c.items.strings(col::I_DATA)[item];
+         if (startsWith(data, prefix)) {
+            continue;
+         }
+         std::vector<int64_t> ids;
+         c.item_stocks.forEach(item, [&](uint32_t stock) {
+            c.stock_supplier.forEach(stock, [&](uint32_t supplier) {
+               if (!bad[supplier]) {
+                  ids.push_back(c.suppliers.id(supplier));
+               }
+            });
+         });
+         if (!ids.empty()) {
+            auto &group = state[{std::string(c.items.strings(col::I_NAME)[item]), c.items.floats(col::I_PRICE)[item],
+                                 std::string(data.substr(0, 3))}];
+            group.insert(group.end(), ids.begin(), ids.end());
+         }
+      }
+   }, [](State &result, State &state) {
+      for (auto &[key, ids] : state) {
+         auto &group = result[key];
+         group.insert(group.end(), ids.begin(), ids.end());
+      }
+   });
+
+   Result result;
+   result.columns = {"i.name", "i.price", "supplier_count", "brand"};
+   for (auto &[key, ids] : groups) {
+      std::sort(ids.begin(), ids.end());
+      int64_t distinct = std::unique(ids.begin(), ids.end()) - ids.begin();
+      result.rows.push_back({Value::string(std::get<0>(key)), Value::real(std::get<1>(key)),
+                             Value::integer(distinct), Value::string(std::get<2>(key))});
+   }
+   sortRows(result, {{2, true}});
+   return result;
+}
+
+Result q17(const Context &c) {
+   // The outer match joins the order line *id* with the item id, as written.
+   struct Sum {
+      double amount = 0;
+   };
+   const std::string &suffix = c.text("suffix");
+   Sum sum = parallelReduce<Sum>(c.pool, c.items.size(), [&](uint64_t begin, uint64_t end, Sum &state) {
+      for (uint32_t item = begin; item<end; item++) {
+         if (!endsWith(c.items.strings(col::I_DATA)[item], suffix)) {
+            continue;
+         }
+         int64_t quantity = 0;
+         int64_t count = 0;
+         c.item_stocks.forEach(item, [&](uint32_t stock) {
+            c.stock_lines.forEach(stock, [&](uint32_t line) {
+               quantity += c.lines.ints(col::OL_QUANTITY)[line];
+               count++;
+            });
+         });
+         if (count == 0) {
+            continue;
+         }
+         uint32_t line = c.lines.row(c.items.id(item));
+         if (line != kNoRow && c.lines.ints(col::OL_QUANTITY)[line]<quantity / double(count)) {
+            state.amount += c.lines.floats(col::OL_AMOUNT)[line];
+         }
+      }
+   }, [](Sum &result, Sum &state) { result.amount += state.amount; });
+
+   Result result;
+   result.columns = {"avg_yearly"};
+   result.rows.push_back({Value::real(sum.amount / 2.0)});
+   return result;
+}
+
+Result q18(const Context &c) {
+   // Grouped by the supplying warehouse as well, so an order can appear once per warehouse; OrderLine has no cnt
+   // property, so ol_cnt is always null.
+   double amount = c.integer("amount");
+   Rows rows = parallelReduce<Rows>(c.pool, c.customers.size(), [&](uint64_t begin, uint64_t end, Rows &state) {
+      std::map<uint32_t, double> sums;
+      for (uint32_t customer = begin; customer<end; customer++) {
+         c.placed.forEach(customer, [&](uint32_t order) {
+            sums.clear();
+            c.contains.forEach(order, [&](uint32_t line) {
+               c.line_stock.forEach(line, [&](uint32_t stock) {
+                  c.stock_warehouse.forEach(stock, [&](uint32_t warehouse) {
+                     sums[warehouse] += c.lines.floats(col::OL_AMOUNT)[line];
+                  });
+               });
+            });
+            for (auto &[warehouse, sum] : sums) {
+               if (sum>amount) {
+                  state.rows.push_back({Value::real(sum), Value::integer(c.customers.id(customer)),
+                                        Value::dateTime(c.orders.ints(col::O_ENTRY_D)[order]), Value::null(),
+                                        Value::integer(c.orders.id(order)),
+                                        Value::string(c.customers.strings(col::C_LAST)[customer])});
+               }
+            }
+         });
+      }
+   }, mergeRows);
+
+   Result result;
+   result.columns = {"sum_amount", "c_id", "o_entry_d", "ol_cnt", "o_id", "c_last"};
+   result.rows = std::move(rows.rows);
+   sortRows(result, {{0, true}, {2, false}});
+   return result;
+}
+
+Result q19(const Context &c) {
+   // AND binds stronger than OR: the quantity and price filters only apply to the first suffix.
+   struct Sum {
+      double revenue = 0;
+   };
+   std::array<std::string, 3> suffixes;
+   std::array<std::vector<int64_t>, 3> warehouse_ids;
+   for (size_t i = 0; i<3; i++) {
+      suffixes[i] = c.text("suffix" + std::to_string(i + 1));
+      for (const std::string &id : c.parameter("warehouses" + std::to_string(i + 1)).values) {
+         warehouse_ids[i].push_back(std::stoll(id));
+      }
+   }
+   auto matches = [&](size_t i, std::string_view data, int64_t warehouse_id) {
+      return endsWith(data, suffixes[i]) &&
+             std::find(warehouse_ids[i].begin(), warehouse_ids[i].end(), warehouse_id) != warehouse_ids[i].end();
+   };
+   Sum sum = parallelReduce<Sum>(c.pool, c.lines.size(), [&](uint64_t begin, uint64_t end, Sum &state) {
+      for (uint32_t line = begin; line<end; line++) {
+         int64_t quantity = c.lines.ints(col::OL_QUANTITY)[line];
+         c.line_stock.forEach(line, [&](uint32_t stock) {
+            c.stock_item.forEach(stock, [&](uint32_t item) {
+               std::string_view data = c.items.strings(col::I_DATA)[item];
+               double price = c.items.floats(col::I_PRICE)[item];
+               bool filters = quantity>=1 && quantity<=10 && price>=1 && price<=400000;
+               c.line_stock.forEach(line, [&](uint32_t stock2) {
+                  c.stock_warehouse.forEach(stock2, [&](uint32_t warehouse) {
+                     int64_t warehouse_id = c.warehouses.id(warehouse);
+                     if ((filters && matches(0, data, warehouse_id)) || matches(1, data, warehouse_id) ||
+                         matches(2, data, warehouse_id)) {
+                        state.revenue += c.lines.floats(col::OL_AMOUNT)[line];
+                     }
+                  });
+               });
+            });
+         });
+      }
+   }, [](Sum &result, Sum &state) { result.revenue += state.revenue; });
+
+   Result result;
+   result.columns = {"revenue"};
+   result.rows.push_back({Value::real(sum.revenue)});
+   return result;
+}
+
+Result q20(const Context &c) {
+   const std::string &prefix = c.text("prefix");
+   const std::string &nation = c.text("nation");
+   int64_t date = c.date("date") + 12 * kMillisPerHour;
+   Rows rows = parallelReduce<Rows>(c.pool, c.items.size(), [&](uint64_t begin, uint64_t end, Rows &state) {
+      for (uint32_t item = begin; item<end; item++) {
+         if (!startsWith(c.items.strings(col::I_DATA)[item], prefix)) {
+            continue;
+         }
+         c.item_stocks.forEach(item, [&](uint32_t stock) {
+            int64_t quantity = 0;
+            bool any = false;
+            c.stock_lines.forEach(stock, [&](uint32_t line) {
+               if (c.lines.ints(col::OL_DELIVERY_D)[line]>date) {
+                  quantity += c.lines.ints(col::OL_QUANTITY)[line];
+                  any = true;
+               }
+            });
+            if (!any || 2 * c.stocks.ints(col::S_QUANTITY)[stock]<=quantity) {
+               return;
+            }
+            c.stock_supplier.forEach(stock, [&](uint32_t supplier) {
+               c.supplier_nation.forEach(supplier, [&](uint32_t n) {
+                  if (c.nationName(n) == nation) {
+                     state.rows.push_back({Value::string(c.suppliers.strings(col::SU_NAME)[supplier]),
+                                           Value::string(c.suppliers.strings(col::SU_ADDRESS)[supplier])});
+                  }
+               });
+            });
+         });
+      }
+   }, mergeRows);
+
+   Result result;
+   result.columns = {"supp.name", "supp.address"};
+   result.rows = std::move(rows.rows);
+   sortRows(result, {{0, false}});
+   return result;
+}
+
+Result q21(const Context &c) {
+   using State = std::map<std::string, int64_t>;
+   const std::string &nation = c.text("nation");
+   State waits = parallelReduce<State>(c.pool, c.orders.size(), [&](uint64_t begin, uint64_t end, State &state) {
+      for (uint32_t order = begin; order<end; order++) {
+         int64_t entry_d = c.orders.ints(col::O_ENTRY_D)[order];
+         int64_t last_delivery = INT64_MIN;
+         c.contains.forEach(order, [&](uint32_t line) {
+            last_delivery = std::max(last_delivery, c.lines.ints(col::OL_DELIVERY_D)[line]);
+         });
+         c.contains.forEach(order, [&](uint32_t line) {
+            int64_t delivery_d = c.lines.ints(col::OL_DELIVERY_D)[line];
+            if (delivery_d<last_delivery || delivery_d<=entry_d) {
+               return;
+            }
+            c.line_stock.forEach(line, [&](uint32_t stock) {
+               c.stock_supplier.forEach(stock, [&](uint32_t supplier) {
+                  c.supplier_nation.forEach(supplier, [&](uint32_t n) {
+                     if (c.nationName(n) == nation) {
+                        state[std::string(c.suppliers.strings(col::SU_NAME)[supplier])]++;
+                     }
+                  });
+               });
+            });
+         });
+      }
+   }, mergeSums<State>);
+
+   Result result;
+   result.columns = {"sup.name", "numwait"};
+   for (auto &[name, count] : waits) {
+      result.rows.push_back({Value::string(name), Value::integer(count)});
+   }
+   sortRows(result, {{1, true}});
+   return result;
+}
+
+Result q22(const Context &c) {
+   struct Average {
+      double balance = 0;
+      int64_t count = 0;
+   };
+   using State = std::map<std::string, std::pair<int64_t, double>>;
+   std::array<bool, 256> codes{};
+   for (const std::string &code : c.parameter("codes").values) {
+      if (!code.empty()) {
+         codes[uint8_t(code[0])] = true;
+      }
+   }
+   auto selected = [&](uint32_t customer) {
+      std::string_view phone = c.customers.strings(col::C_PHONE)[customer];
+      return !phone.empty() && codes[uint8_t(phone[0])];
+   };
+   const auto &balances = c.customers.floats(col::C_BALANCE);
+   Average average = parallelReduce<Average>(c.pool, c.customers.size(),
+                                             [&](uint64_t begin, uint64_t end, Average &state) {
+      for (uint32_t customer = begin; customer<end; customer++) {
+         if (selected(customer) && balances[customer]>0) {
+            state.balance += balances[customer];
+            state.count++;
+         }
+      }
+   }, [](Average &result, Average &state) {
+      result.balance += state.balance;
+      result.count += state.count;
+   });
+
+   Result result;
+   result.columns = {"c_state", "numcust", "totacctbal"};
+   if (average.count == 0) {
+      return result;  // AVG is null, so no balance is above it
+   }
+   double avg_balance = average.balance / average.count;
+   State groups = parallelReduce<State>(c.pool, c.customers.size(), [&](uint64_t begin, uint64_t end, State &state) {
+      for (uint32_t customer = begin; customer<end; customer++) {
+         if (selected(customer) && balances[customer]>avg_balance && c.placed.empty(customer)) {
+            auto &group = state[std::string(c.customers.strings(col::C_STATE)[customer].substr(0, 1))];
+            group.first++;
+            group.second += balances[customer];
+         }
+      }
+   }, [](State &result, State &state) {
+      for (auto &[key, group] : state) {
+         result[key].first += group.first;
+         result[key].second += group.second;
+      }
+   });
+   for (auto &[state, group] : groups) {
+      result.rows.push_back({Value::string(state), Value::integer(group.first), Value::real(group.second)});
+   }
+   return result;
+}
+
+using Query = Result (*)(const Context &);
+
+const Query kQueries[qgen::kQueryCount] = {
+   q1, q2, q3, q4, q5, q6, q7, q8, q9, q10, q11, q12, q13, q14, q15, q16, q17, q18, q19, q20, q21, q22
+};
+
+}
+
+Result runQuery(const Graph &graph, ThreadPool &pool, const qgen::Query &query) {
+   if (query.number<1 || query.number>qgen::kQueryCount) {
+      std::cout << "\nThere is no OLAP query #" << query.number << "." << std::endl;
+      std::cout << "aborting..." << std::endl;
+      exit(-1);
+   }
+   return kQueries[query.number - 1](Context{graph, pool, query});
+}
+
+qgen::Query originalQuery(uint32_t number) {
+   using qgen::Kind;
+   qgen::Query query{number, 0, {}};
+   auto add = [&](const char *name, Kind kind, std::vector<std::string> values) {
+      query.parameters.push_back(qgen::Parameter{name, kind, std::move(values)});
+   };
+   switch (number) {
+      case 1:
+         add("date", Kind::Date, {"2007-01-02"});
+         break;
+      case 2:
+         add("region", Kind::String, {"EUROP"});
+         add("suffix", Kind::String, {"b"});
+         break;
+      case 3:
+         add("state", Kind::String, {"A"});
+         add("date", Kind::Date, {"2007-01-02"});
+         break;
+      case 4:
+      case 7:
+         add("date", Kind::Date, {"2007-01-02"});
+         add("end_date", Kind::Date, {"2012-01-02"});
+         if (number == 7) {
+            add("nation1", Kind::String, {"CAMBODIA"});
+            add("nation2", Kind::String, {"GERMANY"});
+         }
+         break;
+      case 5:
+         add("region", Kind::String, {"EUROPE"});
+         add("date", Kind::Date, {"2007-01-02"});
+         break;
+      case 6:
+         add("date", Kind::Date, {"1970-01-01"});
+         add("end_date", Kind::Date, {"2020-01-01"});
+         break;
+      case 8:
+         add("suffix", Kind::String, {"b"});
+         add("region", Kind::String, {"EUROPE"});
+         add("nation", Kind::String, {"GREECE"});
+         add("date", Kind::Date, {"2007-01-02"});
+         add("end_date", Kind::Date, {"2012-01-02"});
+         break;
+      case 9:
+         add("suffix", Kind::String, {"BB"});
+         break;
+      case 10:
+         add("date", Kind::Date, {"2007-01-02"});
+         break;
+      case 11:
+      case 21:
+         add("nation", Kind::String, {"GERMANY"});
+         break;
+      case 12:
+         add("date", Kind::Date, {"2020-01-01"});
+         add("carrier1", Kind::Integer, {"1"});
+         add("carrier2", Kind::Integer, {"2"});
+         break;
+      case 13:
+         add("carrier", Kind::Integer, {"8"});
+         break;
+      case 14:
+         add("prefix", Kind::String, {"PR"});
+         break;
+      case 15:
+         add("date", Kind::Date, {"2011-01-02"});
+         break;
+      case 16:
+         add("prefix", Kind::String, {"zz"});
+         break;
+      case 17:
+         add("suffix", Kind::String, {"b"});
+         break;
+      case 18:
+         add("amount", Kind::Integer, {"100"});
+         break;
+      case 19:
+         add("suffix1", Kind::String, {"a"});
+         add("warehouses1", Kind::IntegerList, {"1", "2", "3"});
+         add("suffix2", Kind::String, {"b"});
+         add("warehouses2", Kind::IntegerList, {"1", "2", "4"});
+         add("suffix3", Kind::String, {"c"});
+         add("warehouses3", Kind::IntegerList, {"1", "5", "3"});
+         break;
+      case 20:
+         add("prefix", Kind::String, {"co"});
+         add("date", Kind::Date, {"2010-05-23"});
+         add("nation", Kind::String, {"TAIWAN"});
+         break;
+      case 22:
+         add("codes", Kind::StringList, {"1", "2", "3", "4", "5", "6", "7"});
+         break;
+   }
+   return query;
+}
+
+}
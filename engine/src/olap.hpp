@@ -0,0 +1,32 @@
+/*
+ * The implementation of the GTPC graph data generator was built on
+ * Florian Wolf's implementation of the CH-benCHmark data generator
+ * (https://db.in.tum.de/research/projects/CHbenCHmark/) and
+ * Alexander van Renen's implementation of the TPC-C data generator
+ * (https://github.com/alexandervanrenen/tpcc-generator)
+ * See the README file.
+ */
+
+#ifndef olap_hpp_
+#define olap_hpp_
+
+#include "graph.hpp"
+#include "query_params.hpp"
+#include "result.hpp"
+
+class ThreadPool;
+
+namespace engine {
+
+// Runs OLAP query #number of queries/olap_templates.cypher with the parameters of query. Columns are named like the
+// Cypher result; queries without ORDER BY, and ties of the ORDER BY, are sorted by the remaining columns, so the
+// result is deterministic.
+Result runQuery(const Graph &graph, ThreadPool &pool, const qgen::Query &query);
+
+// The parameters written into queries/olap.cypher. #11 uses 'GERMANY' for both nations; the file has 'Germany' in the
+// outer match, which matches no nation of the generator.
+qgen::Query originalQuery(uint32_t number);
+
+}
+
+#endif
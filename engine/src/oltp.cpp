@@ -0,0 +1,256 @@
+/*
+ * The implementation of the GTPC graph data generator was built on
+ * Florian Wolf's implementation of the CH-benCHmark data generator
+ * (https://db.in.tum.de/research/projects/CHbenCHmark/) and
+ * Alexander van Renen's implementation of the TPC-C data generator
+ * (https://github.com/alexandervanrenen/tpcc-generator)
+ * See the README file.
+ */
+
+#include "engine.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <unordered_set>
+
+// The five transactions of queries/oltp.cypher. They run under the exclusive lock of Engine::execute, so they read
+// and write the columns directly.
+namespace engine {
+
+namespace {
+
+const size_t kMaxCustomerData = 500;
+
+int64_t now() {
+   return std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+}
+
+// TPC-C 2.4.2: creates the order with its lines and updates the stock. An unused item id rolls the whole transaction
+// back before anything is changed.
+Result Engine::newOrder(const workload::Transaction &tx) {
+   Result result;
+   result.columns = {"o_id", "ol_number", "i_id", "i_name", "s_quantity", "ol_amount", "total_amount"};
+
+   NodeTable &items = graph[Label::Item];
+   std::array<uint32_t, 15> item_rows;
+   for (uint32_t l = 0; l<tx.line_count; l++) {
+      item_rows[l] = items.row(tx.lines[l].item_id);
+      if (item_rows[l] == kNoRow) {
+         result.rolled_back = true;
+         return result;
+      }
+   }
+
+   NodeTable &warehouses = graph[Label::Warehouse];
+   NodeTable &districts = graph[Label::District];
+   NodeTable &customers = graph[Label::Customer];
+   NodeTable &stocks = graph[Label::Stock];
+   NodeTable &orders = graph[Label::Order];
+   NodeTable &order_lines = graph[Label::OrderLine];
+
+   uint32_t warehouse = lookup(Label::Warehouse, tx.warehouse_id);
+   uint32_t district = lookup(Label::District, tx.district_id);
+   uint32_t customer = lookup(Label::Customer, tx.customer_id);
+   double w_tax = warehouses.floats(col::W_TAX)[warehouse];
+   double d_tax = districts.floats(col::D_TAX)[district];
+   double discount = customers.floats(col::C_DISCOUNT)[customer];
+   districts.ints(col::D_NEXT_O_ID)[district]++;
+
+   bool all_local = std::all_of(tx.lines.begin(), tx.lines.begin() + tx.line_count,
+                                [&](const workload::OrderLine &line) {
+                                   return line.supply_warehouse_id == tx.warehouse_id;
+                                });
+   int64_t entry_d = now();
+   int64_t order_id = orders.nextId();
+   uint32_t order = orders.appendRow(order_id);
+   orders.ints(col::O_ENTRY_D)[order] = entry_d;
+   orders.ints(col::O_CARRIER_ID)[order] = 0;
+   orders.ints(col::O_OL_CNT)[order] = tx.line_count;
+   orders.ints(col::O_ALL_LOCAL)[order] = all_local;
+   orders.ints(col::O_NEW_ORDER)[order] = 1;
+   graph.addEdge(Relationship::HasPlaced, customer, order);
+   district_orders[district].push_back(order);
+   new_orders[district].push_back(order);
+
+   uint32_t dist_column = col::S_DIST_01 + tx.district_number - 1;
+   double total = 0;
+   for (uint32_t l = 0; l<tx.line_count; l++) {
+      const workload::OrderLine &line = tx.lines[l];
+      uint32_t stock = lookup(Label::Stock, line.stock_id);
+      int64_t &quantity = stocks.ints(col::S_QUANTITY)[stock];
+      quantity = quantity - line.quantity>=10 ? quantity - line.quantity : quantity - line.quantity + 91;
+      stocks.ints(col::S_YTD)[stock] += line.quantity;
+      stocks.ints(col::S_ORDER_CNT)[stock]++;
+      if (line.supply_warehouse_id != tx.warehouse_id) {
+         stocks.ints(col::S_REMOTE_CNT)[stock]++;
+      }
+
+      double amount = line.quantity * items.floats(col::I_PRICE)[item_rows[l]];
+      total += amount;
+      uint32_t order_line = order_lines.appendRow(order_lines.nextId());
+      order_lines.ints(col::OL_NUMBER)[order_line] = l + 1;
+      order_lines.ints(col::OL_DELIVERY_D)[order_line] = 0;
+      order_lines.ints(col::OL_QUANTITY)[order_line] = line.quantity;
+      order_lines.floats(col::OL_AMOUNT)[order_line] = amount;
+      order_lines.strings(col::OL_DIST_INFO).set(order_line, stocks.strings(dist_column)[stock]);
+      graph.addEdge(Relationship::Contains, order, order_line);
+      graph.addEdge(Relationship::OrderLineHasStock, order_line, stock);
+
+      result.rows.push_back({Value::integer(order_id), Value::integer(l + 1), Value::integer(line.item_id),
+                             Value::string(items.strings(col::I_NAME)[item_rows[l]]), Value::integer(quantity),
+                             Value::real(amount), Value::null()});
+   }
+   total *= (1 - discount) * (1 + w_tax + d_tax);
+   for (auto &row : result.rows) {
+      row.back() = Value::real(total);
+   }
+   return result;
+}
+
+// TPC-C 2.5.2: books the payment on warehouse, district and customer. The generator keeps the last payment of a
+// customer in its history_* properties instead of History nodes, so the payment replaces them.
+Result Engine::payment(const workload::Transaction &tx) {
+   Result result;
+   result.columns = {"c.id", "c.first", "c.middle", "c.last", "c.balance", "c.credit", "c.data"};
+
+   NodeTable &warehouses = graph[Label::Warehouse];
+   NodeTable &districts = graph[Label::District];
+   NodeTable &customers = graph[Label::Customer];
+   uint32_t warehouse = lookup(Label::Warehouse, tx.warehouse_id);
+   uint32_t district = lookup(Label::District, tx.district_id);
+   uint32_t customer = selectCustomer(tx, tx.customer_district_id);
+   if (customer == kNoRow) {
+      return result;
+   }
+
+   double amount = tx.amount / 100.0;
+   warehouses.floats(col::W_YTD)[warehouse] += amount;
+   districts.floats(col::D_YTD)[district] += amount;
+   customers.floats(col::C_BALANCE)[customer] -= amount;
+   customers.floats(col::C_YTD_PAYMENT)[customer] += amount;
+   customers.ints(col::C_PAYMENT_CNT)[customer]++;
+   if (customers.strings(col::C_CREDIT)[customer] == "BC") {
+      std::string data = std::to_string(customers.id(customer)) + " " + std::to_string(tx.customer_district_id) +
+                         " " + std::to_string(tx.district_id) + " " + std::to_string(tx.warehouse_id) + " " +
+                         std::to_string(tx.amount) + " ";
+      data += customers.strings(col::C_DATA)[customer];
+      data.resize(std::min(data.size(), kMaxCustomerData));
+      customers.strings(col::C_DATA).set(customer, data);
+   }
+   std::string history = std::string(warehouses.strings(col::W_NAME)[warehouse]) + "    ";
+   history += districts.strings(col::D_NAME)[district];
+   customers.ints(col::C_HISTORY_DATE)[customer] = now();
+   customers.floats(col::C_HISTORY_AMOUNT)[customer] = amount;
+   customers.strings(col::C_HISTORY_DATA).set(customer, history);
+
+   result.rows.push_back({Value::integer(customers.id(customer)),
+                          Value::string(customers.strings(col::C_FIRST)[customer]),
+                          Value::string(customers.strings(col::C_MIDDLE)[customer]),
+                          Value::string(customers.strings(col::C_LAST)[customer]),
+                          Value::real(customers.floats(col::C_BALANCE)[customer]),
+                          Value::string(customers.strings(col::C_CREDIT)[customer]),
+                          Value::string(customers.strings(col::C_DATA)[customer])});
+   return result;
+}
+
+// TPC-C 2.6.2: the latest order of the customer with its lines, one row per line.
+Result Engine::orderStatus(const workload::Transaction &tx) {
+   Result result;
+   result.columns = {"c.id", "c.balance", "o.id", "o.entry_d", "o.carrier_id", "ol.id", "ol.quantity", "ol.amount",
+                     "ol.delivery_d"};
+
+   const NodeTable &customers = graph[Label::Customer];
+   const NodeTable &orders = graph[Label::Order];
+   const NodeTable &order_lines = graph[Label::OrderLine];
+   uint32_t customer = selectCustomer(tx, tx.district_id);
+   if (customer == kNoRow) {
+      return result;
+   }
+   uint32_t latest = kNoRow;
+   graph.out(Relationship::HasPlaced).forEach(customer, [&](uint32_t order) {
+      if (latest == kNoRow || orders.id(order)>orders.id(latest)) {
+         latest = order;
+      }
+   });
+   if (latest == kNoRow) {
+      return result;
+   }
+   graph.out(Relationship::Contains).forEach(latest, [&](uint32_t line) {
+      result.rows.push_back({Value::integer(customers.id(customer)),
+                             Value::real(customers.floats(col::C_BALANCE)[customer]),
+                             Value::integer(orders.id(latest)),
+                             Value::dateTime(orders.ints(col::O_ENTRY_D)[latest]),
+                             Value::integer(orders.ints(col::O_CARRIER_ID)[latest]),
+                             Value::integer(order_lines.id(line)),
+                             Value::integer(order_lines.ints(col::OL_QUANTITY)[line]),
+                             Value::real(order_lines.floats(col::OL_AMOUNT)[line]),
+                             Value::dateTime(order_lines.ints(col::OL_DELIVERY_D)[line])});
+   });
+   return result;
+}
+
+// TPC-C 2.7.4: delivers the oldest undelivered order of every district of the warehouse, one row per district.
+Result Engine::delivery(const workload::Transaction &tx) {
+   Result result;
+   result.columns = {"d.id", "o.id", "c.id", "total_amount"};
+
+   NodeTable &districts = graph[Label::District];
+   NodeTable &customers = graph[Label::Customer];
+   NodeTable &orders = graph[Label::Order];
+   NodeTable &order_lines = graph[Label::OrderLine];
+   uint32_t warehouse = lookup(Label::Warehouse, tx.warehouse_id);
+   int64_t delivery_d = now();
+
+   std::vector<uint32_t> covered;
+   graph.out(Relationship::Covers).forEach(warehouse, [&](uint32_t district) { covered.push_back(district); });
+   std::sort(covered.begin(), covered.end(),
+             [&](uint32_t a, uint32_t b) { return districts.id(a)<districts.id(b); });
+   for (uint32_t district : covered) {
+      if (new_orders[district].empty()) {
+         continue;  // skipped, TPC-C 2.7.4.2
+      }
+      uint32_t order = new_orders[district].front();
+      new_orders[district].pop_front();
+      orders.ints(col::O_NEW_ORDER)[order] = 0;
+      orders.ints(col::O_CARRIER_ID)[order] = tx.carrier_id;
+      double total = 0;
+      graph.out(Relationship::Contains).forEach(order, [&](uint32_t line) {
+         order_lines.ints(col::OL_DELIVERY_D)[line] = delivery_d;
+         total += order_lines.floats(col::OL_AMOUNT)[line];
+      });
+      uint32_t customer = graph.in(Relationship::HasPlaced).first(order);
+      customers.floats(col::C_BALANCE)[customer] += total;
+      customers.ints(col::C_DELIVERY_CNT)[customer]++;
+      result.rows.push_back({Value::integer(districts.id(district)), Value::integer(orders.id(order)),
+                             Value::integer(customers.id(customer)), Value::real(total)});
+   }
+   return result;
+}
+
+// TPC-C 2.8.2: the number of distinct items of the last 20 orders of the district whose stock is below the
+// threshold. The Cypher text compares global order ids with d.next_o_id; the engine takes the last 20 orders of the
+// district's customers instead, which is what the comparison means in TPC-C.
+Result Engine::stockLevel(const workload::Transaction &tx) {
+   Result result;
+   result.columns = {"count(DISTINCT i)"};
+
+   const NodeTable &stocks = graph[Label::Stock];
+   uint32_t district = lookup(Label::District, tx.district_id);
+   const std::vector<uint32_t> &orders = district_orders[district];
+   std::unordered_set<uint32_t> items;
+   for (size_t i = orders.size()>20 ? orders.size() - 20 : 0; i<orders.size(); i++) {
+      graph.out(Relationship::Contains).forEach(orders[i], [&](uint32_t line) {
+         uint32_t stock = graph.out(Relationship::OrderLineHasStock).first(line);
+         if (stock != kNoRow && stocks.ints(col::S_QUANTITY)[stock]<int64_t(tx.threshold)) {
+            graph.in(Relationship::ItemHasStock).forEach(stock, [&](uint32_t item) { items.insert(item); });
+         }
+      });
+   }
+   result.rows.push_back({Value::integer(items.size())});
+   return result;
+}
+
+}
@@ -0,0 +1,55 @@
+/*
+ * The implementation of the GTPC graph data generator was built on
+ * Florian Wolf's implementation of the CH-benCHmark data generator
+ * (https://db.in.tum.de/research/projects/CHbenCHmark/) and
+ * Alexander van Renen's implementation of the TPC-C data generator
+ * (https://github.com/alexandervanrenen/tpcc-generator)
+ * See the README file.
+ */
+
+#ifndef parallel_hpp_
+#define parallel_hpp_
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+
+#include "thread_pool.hpp"
+
+namespace engine {
+
+// Runs body(begin, end, state) over morsels of [0, count) on the pool; every morsel starts from its own State() and
+// is merged into the result with merge(result, state), never concurrently. Only waits for its own morsels, so
+// several queries can share the pool.
+template<typename State, typename Body, typename Merge>
+State parallelReduce(ThreadPool &pool, uint64_t count, const Body &body, const Merge &merge) {
+   State result{};
+   if (count == 0) {
+      return result;
+   }
+   uint64_t morsel = std::max<uint64_t>(1024, count / (pool.size() * 8));
+   uint64_t morsels = (count + morsel - 1) / morsel;
+
+   std::mutex mutex;
+   std::condition_variable done;
+   uint64_t remaining = morsels;
+   for (uint64_t m = 0; m<morsels; m++) {
+      pool.submit([&, m] {
+         State state{};
+         body(m * morsel, std::min(count, (m + 1) * morsel), state);
+         std::lock_guard<std::mutex> lock(mutex);
+         merge(result, state);
+         if (--remaining == 0) {
+            done.notify_all();
+         }
+      });
+   }
+   std::unique_lock<std::mutex> lock(mutex);
+   done.wait(lock, [&] { return remaining == 0; });
+   return result;
+}
+
+}
+
+#endif
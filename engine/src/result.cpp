@@ -0,0 +1,116 @@
+/*
+ * The implementation of the GTPC graph data generator was built on
+ * Florian Wolf's implementation of the CH-benCHmark data generator
+ * (https://db.in.tum.de/research/projects/CHbenCHmark/) and
+ * Alexander van Renen's implementation of the TPC-C data generator
+ * (https://github.com/alexandervanrenen/tpcc-generator)
+ * See the README file.
+ */
+
+#include "result.hpp"
+#include "timestamp.hpp"
+
+#include <charconv>
+#include <cstdio>
+
+namespace engine {
+
+namespace {
+
+const int64_t kMillisPerDay = 86400000;
+
+// Date of days since 1970-01-01 (H. Hinnant's civil_from_days), the inverse of csv::daysFromCivil.
+void civilFromDays(int64_t days, int64_t &year, int64_t &month, int64_t &day) {
+   days += 719468;
+   int64_t era = (days>=0 ? days : days - 146096) / 146097;
+   int64_t doe = days - era * 146097;
+   int64_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+   int64_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+   int64_t mp = (5 * doy + 2) / 153;
+   day = doy - (153 * mp + 2) / 5 + 1;
+   month = mp<10 ? mp + 3 : mp - 9;
+   year = yoe + era * 400 + (month<=2);
+}
+
+bool parseNumber(std::string_view text, size_t pos, size_t length, int64_t &value) {
+   if (pos + length>text.size()) {
+      return false;
+   }
+   auto [end, error] = std::from_chars(text.data() + pos, text.data() + pos + length, value);
+   return error == std::errc() && end == text.data() + pos + length;
+}
+
+}
+
+int64_t parseDate(std::string_view date) {
+   int64_t year = 1970, month = 1, day = 1;
+   parseNumber(date, 0, 4, year);
+   parseNumber(date, 5, 2, month);
+   parseNumber(date, 8, 2, day);
+   return csv::makeTimestamp(year, month, day, 0, 0, 0, 0).millis;
+}
+
+bool parseTimestamp(std::string_view text, int64_t &millis) {
+   int64_t year, month, day, hour, minute, second, fraction;
+   if (!parseNumber(text, 0, 4, year) || !parseNumber(text, 5, 2, month) || !parseNumber(text, 8, 2, day) ||
+       !parseNumber(text, 11, 2, hour) || !parseNumber(text, 14, 2, minute) || !parseNumber(text, 17, 2, second) ||
+       !parseNumber(text, 20, 3, fraction)) {
+      return false;
+   }
+   millis = csv::makeTimestamp(year, month, day, hour, minute, second, fraction).millis;
+   return true;
+}
+
+std::string formatTimestamp(int64_t millis) {
+   int64_t days = (millis>=0 ? millis : millis - kMillisPerDay + 1) / kMillisPerDay;
+   int64_t rest = millis - days * kMillisPerDay;
+   int64_t year, month, day;
+   civilFromDays(days, year, month, day);
+   char buffer[128];
+   snprintf(buffer, sizeof(buffer), "%04ld-%02ld-%02ldT%02ld:%02ld:%02ld.%03ld+0000", year, month, day,
+            rest / 3600000, rest / 60000 % 60, rest / 1000 % 60, rest % 1000);
+   return buffer;
+}
+
+int64_t yearOf(int64_t millis) {
+   int64_t days = (millis>=0 ? millis : millis - kMillisPerDay + 1) / kMillisPerDay;
+   int64_t year, month, day;
+   civilFromDays(days, year, month, day);
+   return year;
+}
+
+void Result::write(std::ostream &out) const {
+   for (size_t i = 0; i<columns.size(); i++) {
+      out << (i>0 ? "|" : "") << columns[i];
+   }
+   out << "\n";
+   char number[64];
+   for (const std::vector<Value> &row : rows) {
+      for (size_t i = 0; i<row.size(); i++) {
+         if (i>0) {
+            out << '|';
+         }
+         const Value &value = row[i];
+         switch (value.kind) {
+            case Value::Kind::Null:
+               break;
+            case Value::Kind::Int:
+               out << value.i;
+               break;
+            case Value::Kind::Float:
+               snprintf(number, sizeof(number), "%.4f", value.f);
+               out << number;
+               break;
+            case Value::Kind::String:
+               out << value.s;
+               break;
+            case Value::Kind::DateTime:
+               out << formatTimestamp(value.i);
+               break;
+         }
+      }
+      out << "\n";
+   }
+}
+
+}
@@ -0,0 +1,59 @@
+/*
+ * The implementation of the GTPC graph data generator was built on
+ * Florian Wolf's implementation of the CH-benCHmark data generator
+ * (https://db.in.tum.de/research/projects/CHbenCHmark/) and
+ * Alexander van Renen's implementation of the TPC-C data generator
+ * (https://github.com/alexandervanrenen/tpcc-generator)
+ * See the README file.
+ */
+
+#ifndef result_hpp_
+#define result_hpp_
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace engine {
+
+// A value of a result row, typed like the Cypher result: integers for ids and counts, floats for sums of float
+// properties, datetimes as milliseconds since 1970-01-01T00:00:00Z.
+struct Value {
+   enum class Kind : uint8_t {
+      Null, Int, Float, String, DateTime
+   };
+
+   Kind kind = Kind::Null;
+   int64_t i = 0;
+   double f = 0;
+   std::string s;
+
+   static Value null() { return Value{}; }
+   static Value integer(int64_t value) { return Value{Kind::Int, value}; }
+   static Value real(double value) { return Value{Kind::Float, 0, value}; }
+   static Value string(std::string_view value) { return Value{Kind::String, 0, 0, std::string(value)}; }
+   static Value dateTime(int64_t millis) { return Value{Kind::DateTime, millis}; }
+};
+
+struct Result {
+   std::vector<std::string> columns;
+   std::vector<std::vector<Value>> rows;
+   bool rolled_back = false;  // transactions only, e.g. New-Order with an unused item
+
+   // The header and one line per row, separated by |, floats with 4 decimals.
+   void write(std::ostream &out) const;
+};
+
+// Milliseconds since 1970-01-01T00:00:00Z of a yyyy-mm-dd date at midnight.
+int64_t parseDate(std::string_view date);
+// Milliseconds of 2010-02-14T15:32:10.447+0000 as written by the generator; false if text is no such timestamp.
+bool parseTimestamp(std::string_view text, int64_t &millis);
+// 2010-02-14T15:32:10.447+0000
+std::string formatTimestamp(int64_t millis);
+int64_t yearOf(int64_t millis);
+
+}
+
+#endif